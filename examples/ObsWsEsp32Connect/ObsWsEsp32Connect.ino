@@ -68,6 +68,16 @@ const char *errorToString(ObsWsError error)
         return "AuthenticationFailed";
     case ObsWsError::NotImplemented:
         return "NotImplemented";
+    case ObsWsError::MessageTooLarge:
+        return "MessageTooLarge";
+    case ObsWsError::ProtocolError:
+        return "ProtocolError";
+    case ObsWsError::RequestTimeout:
+        return "RequestTimeout";
+    case ObsWsError::RequestNotExecuted:
+        return "RequestNotExecuted";
+    case ObsWsError::OutOfMemory:
+        return "OutOfMemory";
     default:
         return "Unknown";
     }
@@ -1,7 +1,10 @@
 #include "ObsWsEsp32.h"
+#include "ObsWsMask.h"
 
 #include <algorithm>
 #include <cctype>
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -10,54 +13,400 @@
 #include <mbedtls/base64.h>
 #include <mbedtls/md.h>
 
+#if __has_include(<rom/miniz.h>)
+#include <rom/miniz.h>
+#define OBSWS_HAS_INFLATE 1
+#else
+#define OBSWS_HAS_INFLATE 0
+#endif
+
 namespace
 {
-    constexpr size_t kEventQueueLength = 10;
+    constexpr size_t kEventPoolIdBytes = 64;
     constexpr size_t kAuthSecretBufferSize = 64;
     constexpr size_t kAuthResultBufferSize = 128;
+    constexpr size_t kAuthFieldBufferSize = 128;
     constexpr size_t kMaxHandshakeHeaderSize = 1024;
+    constexpr size_t kMinRxBufferSize = kMaxHandshakeHeaderSize;
+    constexpr size_t kMaxFrameHeaderSize = 14;
+    constexpr size_t kMinTxBufferSize = 512;
+    constexpr size_t kMaxDeferredTxBytes = 4096;
+    constexpr uint8_t kMinDeflateWindowBits = 9;
+    constexpr uint8_t kMaxDeflateWindowBits = 15;
     constexpr const char *kWebSocketGuid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    constexpr uint32_t kFnvOffsetBasis = 2166136261u;
+    constexpr uint32_t kFnvPrime = 16777619u;
+    // Longest data: URI prefix stripped from a streamed imageData.
+    constexpr size_t kMaxDataUriPrefix = 64;
+
+    const char *const kDefaultCoalescedEvents[] = {
+        "InputVolumeMeters",
+        "InputVolumeChanged",
+        "InputAudioBalanceChanged",
+        "MediaInputPlaybackStarted",
+        "SceneItemTransformChanged",
+    };
+
+    // Event data members that narrow a coalescing key down to one input, scene or item.
+    const char *const kCoalesceKeyMembers[] = {"inputName", "sceneName", "sceneItemId"};
+
+    uint32_t hashBytes(uint32_t hash, const char *data, size_t length)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash = (hash ^ static_cast<uint8_t>(data[i])) * kFnvPrime;
+        }
+        return hash;
+    }
+
+    // Confirms a coalescing key match by comparing the key members the hashes were built from.
+    // Both events come from the same session, so both carry raw MessagePack or neither does.
+    bool sameCoalesceMembers(const ObsJsonSlice &json, const ObsMsgPackSlice &raw, const ObsJsonSlice &otherJson, const ObsMsgPackSlice &otherRaw, uint8_t members)
+    {
+        for (size_t i = 0; i < sizeof(kCoalesceKeyMembers) / sizeof(kCoalesceKeyMembers[0]); ++i)
+        {
+            if ((members & (1U << i)) == 0)
+            {
+                continue;
+            }
+
+            bool same = false;
+            if (!raw.empty())
+            {
+                ObsMsgPackSlice value;
+                ObsMsgPackSlice other;
+                same = ObsMsgPackReader::findMember(raw, kCoalesceKeyMembers[i], value) && ObsMsgPackReader::findMember(otherRaw, kCoalesceKeyMembers[i], other) &&
+                       value.length == other.length && std::memcmp(value.data, other.data, value.length) == 0;
+            }
+            else
+            {
+                ObsJsonSlice value;
+                ObsJsonSlice other;
+                same = ObsJsonReader::findMember(json, kCoalesceKeyMembers[i], value) && ObsJsonReader::findMember(otherJson, kCoalesceKeyMembers[i], other) &&
+                       value.length == other.length && std::memcmp(value.data, other.data, value.length) == 0;
+            }
+            if (!same)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void copyTerminated(char *out, const ObsJsonSlice &slice)
+    {
+        if (slice.length > 0)
+        {
+            std::memcpy(out, slice.data, slice.length);
+        }
+        out[slice.length] = '\0';
+    }
+
+    size_t alignSlotSize(size_t size)
+    {
+        constexpr size_t alignment = alignof(std::max_align_t);
+        return (size + alignment - 1) & ~(alignment - 1);
+    }
+
+    // NUL-terminates a slice for the duration of a callback and puts the original byte back
+    // afterwards, so a reader can keep walking the surrounding JSON or MessagePack. Slices
+    // that are already terminated, string literals included, are left untouched.
+    class ScopedTerminator
+    {
+    public:
+        explicit ScopedTerminator(const ObsJsonSlice &slice)
+            : end_(slice.data != nullptr && slice.data[slice.length] != '\0' ? const_cast<char *>(slice.data + slice.length) : nullptr)
+        {
+            if (end_ != nullptr)
+            {
+                saved_ = *end_;
+                *end_ = '\0';
+            }
+        }
+
+        ~ScopedTerminator()
+        {
+            if (end_ != nullptr)
+            {
+                *end_ = saved_;
+            }
+        }
+
+        ScopedTerminator(const ScopedTerminator &) = delete;
+        ScopedTerminator &operator=(const ScopedTerminator &) = delete;
+
+    private:
+        char *end_;
+        char saved_ = '\0';
+    };
+
+    // The members the response scanners follow to d.responseData.imageData, one per depth.
+    enum ScanKey : uint8_t
+    {
+        kScanOther,
+        kScanData,
+        kScanRequestId,
+        kScanResponseData,
+        kScanImageData
+    };
 
-    struct InternalEvent
+    enum class PackKind : uint8_t
     {
-        char *id = nullptr;
-        char *payload = nullptr;
+        Scalar,
+        String,
+        Bytes,
+        Array,
+        Map,
+        Invalid
     };
 
-    char *duplicateString(const char *source)
+    // Length of the MessagePack header starting with `tag`: the tag, its length, count or
+    // extension type bytes, and the value itself for numbers.
+    size_t msgPackHeaderSize(uint8_t tag)
     {
-        if (source == nullptr)
+        static const uint8_t kSizes[32] = {
+            1, 1, 1, 1, 2, 3, 5, 3, 4, 6, 5, 9, 2, 3, 5, 9, // 0xC0-0xCF
+            2, 3, 5, 9, 2, 2, 2, 2, 2, 2, 3, 5, 3, 5, 3, 5, // 0xD0-0xDF
+        };
+        return tag >= 0xC0 && tag < 0xE0 ? kSizes[tag - 0xC0] : 1;
+    }
+
+    uint32_t readBigEndian(const uint8_t *bytes, size_t count)
+    {
+        uint32_t value = 0;
+        for (size_t i = 0; i < count; ++i)
         {
-            return nullptr;
+            value = (value << 8) | bytes[i];
         }
+        return value;
+    }
 
-        const size_t length = std::strlen(source);
-        char *copy = static_cast<char *>(std::malloc(length + 1));
-        if (copy == nullptr)
+    // `length` is the entry count of containers and the byte count following strings, binary
+    // and extension headers.
+    PackKind classifyMsgPackHeader(const uint8_t *header, size_t size, uint32_t &length)
+    {
+        const uint8_t tag = header[0];
+        length = 0;
+        if (tag <= 0x7F || tag >= 0xE0)
+        {
+            return PackKind::Scalar;
+        }
+        if (tag <= 0x9F)
+        {
+            length = tag & 0x0F;
+            return tag <= 0x8F ? PackKind::Map : PackKind::Array;
+        }
+        if (tag <= 0xBF)
         {
-            return nullptr;
+            length = tag & 0x1F;
+            return PackKind::String;
         }
 
-        std::memcpy(copy, source, length);
-        copy[length] = '\0';
-        return copy;
+        switch (tag)
+        {
+        case 0xC1:
+            return PackKind::Invalid;
+        case 0xC4:
+        case 0xC5:
+        case 0xC6:
+            length = readBigEndian(header + 1, size - 1);
+            return PackKind::Bytes;
+        case 0xC7:
+        case 0xC8:
+        case 0xC9:
+            // The extension type byte follows the length.
+            length = readBigEndian(header + 1, size - 2);
+            return PackKind::Bytes;
+        case 0xD4:
+        case 0xD5:
+        case 0xD6:
+        case 0xD7:
+        case 0xD8:
+            length = 1u << (tag - 0xD4);
+            return PackKind::Bytes;
+        case 0xD9:
+        case 0xDA:
+        case 0xDB:
+            length = readBigEndian(header + 1, size - 1);
+            return PackKind::String;
+        case 0xDC:
+        case 0xDD:
+            length = readBigEndian(header + 1, size - 1);
+            return PackKind::Array;
+        case 0xDE:
+        case 0xDF:
+            length = readBigEndian(header + 1, size - 1);
+            return PackKind::Map;
+        default:
+            return PackKind::Scalar;
+        }
     }
 
-    void releaseInternalEvent(InternalEvent *evt)
+    // -1 for characters outside the standard base64 alphabet.
+    int base64Value(char c)
     {
-        if (evt == nullptr)
+        if (c >= 'A' && c <= 'Z')
         {
-            return;
+            return c - 'A';
         }
-        if (evt->id != nullptr)
+        if (c >= 'a' && c <= 'z')
         {
-            std::free(evt->id);
+            return c - 'a' + 26;
         }
-        if (evt->payload != nullptr)
+        if (c >= '0' && c <= '9')
         {
-            std::free(evt->payload);
+            return c - '0' + 52;
         }
-        std::free(evt);
+        return c == '+' ? 62 : c == '/' ? 63 : -1;
+    }
+
+    bool parseRequestId(const ObsJsonSlice &slice, uint32_t &id)
+    {
+        if (slice.empty() || slice.length > 10)
+        {
+            return false;
+        }
+
+        uint64_t value = 0;
+        for (size_t i = 0; i < slice.length; ++i)
+        {
+            const char c = slice.data[i];
+            if (c < '0' || c > '9')
+            {
+                return false;
+            }
+            value = value * 10 + static_cast<uint64_t>(c - '0');
+        }
+        if (value == 0 || value > UINT32_MAX)
+        {
+            return false;
+        }
+
+        id = static_cast<uint32_t>(value);
+        return true;
+    }
+
+    // Requests the state cache sends for itself are named
+    // "obsws-state/<generation>/<kind>[/<slot>.<serial>]", which never parses as the numeric
+    // id of an application request.
+    constexpr char kStateRequestPrefix[] = "obsws-state/";
+    constexpr size_t kStateRequestIdSize = 48;
+    constexpr uint32_t kNoStateSource = 0xFFFF;
+    constexpr uint64_t kStateCacheSubscriptions = ObsEventSubscription::Config | ObsEventSubscription::Scenes | ObsEventSubscription::Inputs |
+                                                  ObsEventSubscription::SceneItems | ObsEventSubscription::Ui;
+
+    struct StateRequestId
+    {
+        uint32_t generation = 0;
+        ObsJsonSlice kind;
+        uint32_t slot = kNoStateSource;
+        uint32_t serial = 0;
+    };
+
+    bool parseDecimal(const char *&cur, const char *end, uint32_t &value)
+    {
+        const char *begin = cur;
+        uint64_t number = 0;
+        while (cur < end && *cur >= '0' && *cur <= '9' && number <= UINT32_MAX)
+        {
+            number = number * 10 + static_cast<uint64_t>(*cur++ - '0');
+        }
+        value = static_cast<uint32_t>(number);
+        return cur != begin && number <= UINT32_MAX;
+    }
+
+    // Returns true for every id with the state prefix; a malformed one leaves `id.kind` empty.
+    bool parseStateRequestId(const ObsJsonSlice &slice, StateRequestId &id)
+    {
+        constexpr size_t prefixLength = sizeof(kStateRequestPrefix) - 1;
+        if (slice.length <= prefixLength || std::memcmp(slice.data, kStateRequestPrefix, prefixLength) != 0)
+        {
+            return false;
+        }
+
+        const char *cur = slice.data + prefixLength;
+        const char *end = slice.data + slice.length;
+        if (!parseDecimal(cur, end, id.generation) || cur == end || *cur++ != '/')
+        {
+            return true;
+        }
+        const char *kind = cur;
+        while (cur < end && *cur != '/')
+        {
+            ++cur;
+        }
+        const char *kindEnd = cur;
+        if (cur < end)
+        {
+            ++cur;
+            if (!parseDecimal(cur, end, id.slot) || cur == end || *cur++ != '.' || !parseDecimal(cur, end, id.serial) || cur != end)
+            {
+                id.slot = kNoStateSource;
+                return true;
+            }
+        }
+        id.kind.data = kind;
+        id.kind.length = static_cast<size_t>(kindEnd - kind);
+        return true;
+    }
+
+    void formatStateRequestId(char *out, uint32_t generation, const char *kind, uint32_t slot = kNoStateSource, uint32_t serial = 0)
+    {
+        if (slot == kNoStateSource)
+        {
+            std::snprintf(out, kStateRequestIdSize, "%s%lu/%s", kStateRequestPrefix, static_cast<unsigned long>(generation), kind);
+        }
+        else
+        {
+            std::snprintf(out, kStateRequestIdSize, "%s%lu/%s/%lu.%lu", kStateRequestPrefix, static_cast<unsigned long>(generation), kind,
+                          static_cast<unsigned long>(slot), static_cast<unsigned long>(serial));
+        }
+    }
+
+    bool copySlice(const ObsJsonSlice &slice, char *out, size_t outSize)
+    {
+        if (slice.length >= outSize)
+        {
+            return false;
+        }
+
+        if (slice.length > 0)
+        {
+            std::memcpy(out, slice.data, slice.length);
+        }
+        out[slice.length] = '\0';
+        return true;
+    }
+
+    // Writes a final, masked client frame header with a fresh mask key; the key is the last
+    // four bytes. Returns the header length.
+    size_t writeFrameHeader(uint8_t *header, uint8_t opcode, size_t length)
+    {
+        size_t headerLen = 0;
+        header[headerLen++] = static_cast<uint8_t>(0x80 | (opcode & 0x0F));
+
+        if (length < 126)
+        {
+            header[headerLen++] = static_cast<uint8_t>(0x80 | length);
+        }
+        else if (length <= 0xFFFF)
+        {
+            header[headerLen++] = 0x80 | 126;
+            header[headerLen++] = static_cast<uint8_t>((length >> 8) & 0xFF);
+            header[headerLen++] = static_cast<uint8_t>(length & 0xFF);
+        }
+        else
+        {
+            header[headerLen++] = 0x80 | 127;
+            for (int i = 7; i >= 0; --i)
+            {
+                header[headerLen++] = static_cast<uint8_t>((static_cast<uint64_t>(length) >> (8 * i)) & 0xFF);
+            }
+        }
+
+        const uint32_t maskWord = esp_random();
+        std::memcpy(header + headerLen, &maskWord, sizeof(maskWord));
+        return headerLen + sizeof(maskWord);
     }
 
     std::string trim(const std::string &value)
@@ -76,15 +425,44 @@ namespace
     }
 }
 
+ObsWsClient::~ObsWsClient()
+{
+    stopNetworkTask();
+    ensureTransportStopped();
+    drainEventQueue();
+    std::free(eventRing_);
+    eventRing_ = nullptr;
+    eventRingCapacity_ = 0;
+    releaseEventPool();
+    std::free(meterBuffer_);
+    meterBuffer_ = nullptr;
+    std::free(pendingRequests_);
+    pendingRequests_ = nullptr;
+    std::free(txBuffer_);
+    txBuffer_ = nullptr;
+    std::free(rxJson_);
+    rxJson_ = nullptr;
+    releaseMessageBuffer();
+    releaseRxBuffer();
+    releaseInflater();
+}
+
 bool ObsWsClient::begin(const Config &config)
 {
     close();
 
-    config_ = config;
+    // Auto-reconnect passes config_ itself; skipping the self-copy keeps the network task
+    // from rewriting fields other tasks read.
+    if (&config != &config_)
+    {
+        config_ = config;
+        portENTER_CRITICAL(&subscriptionLock_);
+        requestedSubscriptions_ = config_.eventSubscriptions;
+        portEXIT_CRITICAL(&subscriptionLock_);
+    }
     placeholderEventDispatched_ = false;
     lastError_ = ObsWsError::None;
-    handshakeBuffer_.clear();
-    rxBuffer_.clear();
+    resetRxDecoder();
 
     if (config_.host == nullptr || config_.host[0] == '\0')
     {
@@ -100,6 +478,53 @@ bool ObsWsClient::begin(const Config &config)
         return false;
     }
 
+    if (!ensurePendingRequests())
+    {
+        emitLog("OBSWS: Failed to allocate pending request table.");
+        emitError(ObsWsError::TransportUnavailable);
+        return false;
+    }
+
+    // The cache drops its references before the table it holds them in can be rebuilt.
+    state_.clear();
+    if (!names_.allocate(config_.maxNames, config_.namePoolBytes))
+    {
+        emitLog("OBSWS: Failed to allocate name table.");
+        emitError(ObsWsError::TransportUnavailable);
+        return false;
+    }
+
+    if (!config_.enableStateCache)
+    {
+        state_.release();
+    }
+    else if (config_.maxNames == 0)
+    {
+        emitLog("OBSWS: The state cache needs maxNames greater than 0.");
+        emitError(ObsWsError::TransportUnavailable);
+        return false;
+    }
+    else if (!state_.allocate(&names_, config_.stateCacheSceneItems))
+    {
+        emitLog("OBSWS: Failed to allocate state cache.");
+        emitError(ObsWsError::TransportUnavailable);
+        return false;
+    }
+
+    if (!ensureMeterBuffers())
+    {
+        emitLog("OBSWS: Failed to allocate volume meter buffers.");
+        emitError(ObsWsError::TransportUnavailable);
+        return false;
+    }
+
+    if (!ensureRxBuffer(std::max(config_.rxBufferSize, kMinRxBufferSize)))
+    {
+        emitLog("OBSWS: Failed to allocate receive buffer.");
+        emitError(ObsWsError::TransportUnavailable);
+        return false;
+    }
+
     changeStatus(ObsWsStatus::Connecting);
 
     if (!connectTransport())
@@ -116,13 +541,176 @@ bool ObsWsClient::begin(const Config &config)
 
     lastReconnectAttemptMs_ = millis();
     emitLog("OBSWS: WebSocket connection initiated.");
+
+    if (config_.useNetworkTask && !startNetworkTask())
+    {
+        emitLog("OBSWS: Failed to start network task; servicing the socket from poll().");
+    }
     return true;
 }
 
 void ObsWsClient::poll()
+{
+    if (networkTask_ != nullptr)
+    {
+        deliverQueuedEvents();
+        return;
+    }
+
+    serviceConnection();
+    deliverQueuedEvents();
+
+    // With deferFlush, frames queued by this poll and by the application since the last one
+    // leave in a single write.
+    if (txLength_ > txStart_)
+    {
+        flushTx();
+    }
+}
+
+bool ObsWsClient::onNetworkTask() const
+{
+    return networkTask_ != nullptr && xTaskGetCurrentTaskHandle() == networkTask_;
+}
+
+bool ObsWsClient::startNetworkTask()
+{
+    if (networkTask_ != nullptr)
+    {
+        return true;
+    }
+
+    networkTaskStop_ = false;
+    networkTaskRunning_ = true;
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreatePinnedToCore(&ObsWsClient::networkTaskEntry, "obsws-net", config_.networkTaskStackSize, this, config_.networkTaskPriority, &handle, config_.networkTaskCore) != pdPASS)
+    {
+        networkTaskRunning_ = false;
+        return false;
+    }
+    networkTask_ = handle;
+    return true;
+}
+
+void ObsWsClient::stopNetworkTask()
+{
+    if (networkTask_ == nullptr)
+    {
+        return;
+    }
+
+    networkTaskStop_ = true;
+    xTaskNotifyGive(networkTask_);
+    while (networkTaskRunning_)
+    {
+        vTaskDelay(1);
+    }
+    networkTask_ = nullptr;
+    discardSendQueue();
+}
+
+void ObsWsClient::networkTaskEntry(void *arg)
+{
+    ObsWsClient *client = static_cast<ObsWsClient *>(arg);
+    // Set here as well so onNetworkTask() holds even before xTaskCreatePinnedToCore() returns.
+    client->networkTask_ = xTaskGetCurrentTaskHandle();
+    client->runNetworkTask();
+    client->networkTaskRunning_ = false;
+    vTaskDelete(nullptr);
+}
+
+void ObsWsClient::runNetworkTask()
+{
+    while (!networkTaskStop_)
+    {
+        serviceConnection();
+        drainSendQueue();
+        if (txLength_ > txStart_)
+        {
+            flushTx();
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(config_.networkTaskIntervalMs));
+    }
+}
+
+// Producers push onto a lock-free stack; the network task takes the whole stack with one
+// exchange, so there is no ABA window, and reverses it to restore submission order.
+bool ObsWsClient::submitFrame(OutboundFrame *frame)
+{
+    if (sendQueued_.fetch_add(1) >= std::max<size_t>(config_.sendQueueLength, 1))
+    {
+        sendQueued_.fetch_sub(1);
+        return false;
+    }
+
+    frame->next = sendStack_.load(std::memory_order_relaxed);
+    while (!sendStack_.compare_exchange_weak(frame->next, frame, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+    return true;
+}
+
+ObsWsClient::OutboundFrame *ObsWsClient::takeSubmittedFrames()
+{
+    OutboundFrame *frame = sendStack_.exchange(nullptr, std::memory_order_acquire);
+    OutboundFrame *ordered = nullptr;
+    while (frame != nullptr)
+    {
+        OutboundFrame *next = frame->next;
+        frame->next = ordered;
+        ordered = frame;
+        frame = next;
+        sendQueued_.fetch_sub(1);
+    }
+    return ordered;
+}
+
+// Moves frames formatted by application tasks into the transmit buffer so everything queued
+// since the last pass leaves in one write.
+void ObsWsClient::drainSendQueue()
+{
+    OutboundFrame *frame = takeSubmittedFrames();
+    while (frame != nullptr)
+    {
+        OutboundFrame *next = frame->next;
+        const bool writable = transport_ != nullptr && handshakeState_ == HandshakeState::Established;
+        if (writable && ensureTxBuffer(txLength_ + frame->length))
+        {
+            std::memcpy(txBuffer_ + txLength_, frame->bytes() + frame->start, frame->length);
+            txLength_ += frame->length;
+        }
+        std::free(frame);
+        frame = next;
+    }
+}
+
+void ObsWsClient::discardSendQueue()
+{
+    OutboundFrame *frame = takeSubmittedFrames();
+    while (frame != nullptr)
+    {
+        OutboundFrame *next = frame->next;
+        std::free(frame);
+        frame = next;
+    }
+}
+
+void ObsWsClient::serviceConnection()
 {
     const unsigned long now = millis();
 
+    if (pendingCount_ > 0)
+    {
+        if (handshakeState_ != HandshakeState::Established)
+        {
+            failPendingRequests(ObsWsError::TransportUnavailable);
+        }
+        else
+        {
+            expirePendingRequests(now);
+        }
+    }
+
     if (status_ == ObsWsStatus::Error || status_ == ObsWsStatus::Disconnected)
     {
         if (config_.autoReconnect && config_.host != nullptr && config_.host[0] != '\0')
@@ -144,48 +732,57 @@ void ObsWsClient::poll()
             emitLog("OBSWS: Transport disconnected.");
             ensureTransportStopped();
             handshakeState_ = HandshakeState::Idle;
+            // Events may have been missed, so the snapshot is forgotten until the next seed.
+            state_.clear();
+            stateSeedPending_ = 0;
             changeStatus(ObsWsStatus::Disconnected);
         }
         else
         {
-            while (transport_->available() > 0)
+            // Read whatever the transport has buffered in as few calls as possible,
+            // decoding after every block so the receive buffer never has to hold more
+            // than the frame currently being assembled.
+            while (transport_ != nullptr && transport_->available() > 0)
             {
-                const int byteRead = transport_->read();
-                if (byteRead < 0)
+                if (rxWritePos_ == rxCapacity_)
                 {
-                    break;
-                }
-
-                if (handshakeState_ == HandshakeState::AwaitUpgrade)
-                {
-                    handshakeBuffer_.push_back(static_cast<char>(byteRead));
-                    if (handshakeBuffer_.size() > kMaxHandshakeHeaderSize)
+                    compactRxBuffer();
+                    if (rxWritePos_ == rxCapacity_)
                     {
-                        emitLog("OBSWS: Handshake header too large.");
-                        emitError(ObsWsError::HandshakeRejected);
-                        ensureTransportStopped();
-                        handshakeState_ = HandshakeState::Idle;
-                        return;
+                        break;
                     }
                 }
-                else
+
+                const int received = transport_->read(rxBuffer_ + rxWritePos_, rxCapacity_ - rxWritePos_);
+                if (received <= 0)
                 {
-                    rxBuffer_.push_back(static_cast<uint8_t>(byteRead));
+                    break;
                 }
-            }
+                rxWritePos_ += static_cast<size_t>(received);
 
-            if (handshakeState_ == HandshakeState::AwaitUpgrade)
-            {
-                if (processHandshakeBuffer())
+                if (handshakeState_ == HandshakeState::AwaitUpgrade)
                 {
+                    if (!processHandshakeBuffer())
+                    {
+                        if (handshakeState_ == HandshakeState::AwaitUpgrade && rxWritePos_ - rxReadPos_ >= kMaxHandshakeHeaderSize)
+                        {
+                            emitLog("OBSWS: Handshake header too large.");
+                            emitError(ObsWsError::HandshakeRejected);
+                            ensureTransportStopped();
+                            handshakeState_ = HandshakeState::Idle;
+                            return;
+                        }
+                        continue;
+                    }
+
                     handshakeState_ = HandshakeState::AwaitHello;
                     changeStatus(ObsWsStatus::Authenticating);
                 }
-            }
 
-            if (handshakeState_ != HandshakeState::AwaitUpgrade && !rxBuffer_.empty())
-            {
-                processRxBuffer();
+                if (rxWritePos_ > rxReadPos_)
+                {
+                    processRxBuffer();
+                }
             }
         }
     }
@@ -203,35 +800,43 @@ void ObsWsClient::poll()
             return;
         }
     }
-
-    if (eventQueue_ != nullptr)
-    {
-        InternalEvent *evt = nullptr;
-        while (xQueueReceive(eventQueue_, &evt, 0) == pdTRUE)
-        {
-            if (evt != nullptr)
-            {
-                if (config_.onEvent != nullptr)
-                {
-                    ObsEvent event{evt->id != nullptr ? evt->id : "", evt->payload != nullptr ? evt->payload : ""};
-                    config_.onEvent(event);
-                }
-                releaseInternalEvent(evt);
-            }
-        }
-    }
 }
 
 void ObsWsClient::close()
 {
+    // close() also runs on the network task when auto-reconnect calls begin(); the task only
+    // stops itself when the application closes the client.
+    const bool fromNetworkTask = onNetworkTask();
+    if (!fromNetworkTask)
+    {
+        stopNetworkTask();
+    }
+
     placeholderEventDispatched_ = false;
     handshakeState_ = HandshakeState::Idle;
     handshakeStartMs_ = 0;
-    handshakeBuffer_.clear();
-    rxBuffer_.clear();
+    resetRxDecoder();
+
+    portENTER_CRITICAL(&subscriptionLock_);
+    identifyPending_ = 0;
+    activeSubscriptions_ = 0;
+    portEXIT_CRITICAL(&subscriptionLock_);
+
+    state_.clear();
+    stateSeedPending_ = 0;
+    portENTER_CRITICAL(&meterLock_);
+    const ObsInputMeter *undeliveredMeters = meterPending_;
+    const size_t undeliveredCount = meterPendingReady_ ? meterPendingCount_ : 0;
+    meterPendingReady_ = false;
+    portEXIT_CRITICAL(&meterLock_);
+    releaseObsVolumeMeters(names_, undeliveredMeters, undeliveredCount);
 
     ensureTransportStopped();
-    drainEventQueue();
+    if (!fromNetworkTask)
+    {
+        drainEventQueue();
+    }
+    failPendingRequests(ObsWsError::TransportUnavailable);
 
     if (status_ != ObsWsStatus::Disconnected)
     {
@@ -243,76 +848,541 @@ void ObsWsClient::close()
 }
 
 bool ObsWsClient::sendRequest(const char *requestType, const char *payload)
+{
+    return sendRequestMessage(requestType, payload) != 0;
+}
+
+uint32_t ObsWsClient::sendRequest(const char *requestType, const char *payload, RequestCallback onComplete, void *context, uint32_t timeoutMs)
+{
+    return sendRequestMessage(requestType, payload, onComplete, context, timeoutMs);
+}
+
+uint32_t ObsWsClient::sendStreamingRequest(const char *requestType, const char *payload, ObsResponseSink sink, RequestCallback onComplete, void *context, uint32_t timeoutMs)
+{
+    if (sink == nullptr)
+    {
+        emitLog("OBSWS: sendStreamingRequest requires a sink.");
+        return 0;
+    }
+    return sendRequestMessage(requestType, payload, onComplete, context, timeoutMs, sink);
+}
+
+uint32_t ObsWsClient::sendRequestBatch(const ObsRequestBatch &batch, uint32_t timeoutMs)
+{
+    if (batch.count_ == 0)
+    {
+        emitLog("OBSWS: sendRequestBatch requires at least one request.");
+        return 0;
+    }
+
+    if (handshakeState_ != HandshakeState::Established)
+    {
+        emitLog("OBSWS: sendRequestBatch called before handshake completion.");
+        lastError_ = ObsWsError::TransportUnavailable;
+        return 0;
+    }
+
+    size_t callbacks = 0;
+    for (size_t i = 0; i < batch.count_; ++i)
+    {
+        const ObsRequestBatch::Item &item = batch.items_[i];
+        if (item.requestType == nullptr || item.requestType[0] == '\0')
+        {
+            emitLog("OBSWS: sendRequestBatch requires a request type for every request.");
+            return 0;
+        }
+        if (item.payload != nullptr && item.payload[0] != '\0' && !isJsonObject(item.payload, std::strlen(item.payload)))
+        {
+            emitLog("OBSWS: Request payload is not valid JSON.");
+            return 0;
+        }
+        callbacks += item.onComplete != nullptr ? 1 : 0;
+    }
+
+    if (pendingCount_ + callbacks > pendingCapacity_)
+    {
+        emitLog("OBSWS: Too many pending requests.");
+        return 0;
+    }
+
+    // Another task may claim table slots between the check above and here, so a failed
+    // registration still unwinds the entries made so far. The writer may run more than once,
+    // so ids are settled before it runs.
+    const uint32_t batchId = nextRequestId();
+    uint32_t ids[ObsRequestBatch::kMaxRequests];
+    for (size_t i = 0; i < batch.count_; ++i)
+    {
+        const ObsRequestBatch::Item &item = batch.items_[i];
+        ids[i] = item.onComplete != nullptr ? registerPendingRequest(batchId, item.onComplete, item.context, timeoutMs) : nextRequestId();
+        if (ids[i] == 0)
+        {
+            emitLog("OBSWS: Too many pending requests.");
+            releaseBatchRequests(batchId, false);
+            return 0;
+        }
+    }
+
+    const bool sent = sendJsonMessage([&](ObsJsonWriter &json)
+    {
+        char requestId[16];
+        json.beginObject();
+        json.key("op");
+        json.integer(8);
+        json.key("d");
+        json.beginObject();
+        std::snprintf(requestId, sizeof(requestId), "%lu", static_cast<unsigned long>(batchId));
+        json.key("requestId");
+        json.string(requestId);
+        json.key("haltOnFailure");
+        json.boolean(batch.haltOnFailure);
+        json.key("executionType");
+        json.integer(static_cast<int64_t>(batch.executionType));
+        json.key("requests");
+        json.beginArray();
+        for (size_t i = 0; i < batch.count_; ++i)
+        {
+            const ObsRequestBatch::Item &item = batch.items_[i];
+            json.beginObject();
+            json.key("requestType");
+            json.string(item.requestType);
+            std::snprintf(requestId, sizeof(requestId), "%lu", static_cast<unsigned long>(ids[i]));
+            json.key("requestId");
+            json.string(requestId);
+            if (item.payload != nullptr && item.payload[0] != '\0')
+            {
+                json.key("requestData");
+                json.raw(item.payload, std::strlen(item.payload));
+            }
+            json.endObject();
+        }
+        json.endArray();
+        json.endObject();
+        json.endObject();
+    });
+
+    if (!sent)
+    {
+        emitLog("OBSWS: Failed to send request batch.");
+        lastError_ = ObsWsError::TransportUnavailable;
+        releaseBatchRequests(batchId, false);
+        return 0;
+    }
+
+    return batchId;
+}
+
+bool ObsWsClient::reidentify(uint64_t eventSubscriptions)
+{
+    if (config_.enableStateCache)
+    {
+        eventSubscriptions |= kStateCacheSubscriptions;
+    }
+
+    portENTER_CRITICAL(&subscriptionLock_);
+    requestedSubscriptions_ = eventSubscriptions;
+    portEXIT_CRITICAL(&subscriptionLock_);
+
+    if (handshakeState_ != HandshakeState::Established)
+    {
+        // Not identified yet: the next Identify carries the new mask, or op 3 follows the
+        // Identified reply when Identify has already gone out.
+        emitLog("OBSWS: Reidentify deferred until the handshake completes.");
+        return true;
+    }
+
+    // Recorded before sending so an op 2 handled by the network task is never unexpected.
+    portENTER_CRITICAL(&subscriptionLock_);
+    const uint64_t previous = sentSubscriptions_;
+    sentSubscriptions_ = eventSubscriptions;
+    ++identifyPending_;
+    portEXIT_CRITICAL(&subscriptionLock_);
+
+    const bool sent = sendJsonMessage([&](ObsJsonWriter &json)
+    {
+        json.beginObject();
+        json.key("op");
+        json.integer(3);
+        json.key("d");
+        json.beginObject();
+        json.key("eventSubscriptions");
+        json.integer(static_cast<int64_t>(eventSubscriptions));
+        json.endObject();
+        json.endObject();
+    });
+
+    if (!sent)
+    {
+        portENTER_CRITICAL(&subscriptionLock_);
+        if (identifyPending_ > 0)
+        {
+            --identifyPending_;
+        }
+        if (sentSubscriptions_ == eventSubscriptions)
+        {
+            sentSubscriptions_ = previous;
+        }
+        portEXIT_CRITICAL(&subscriptionLock_);
+        emitLog("OBSWS: Failed to send Reidentify.");
+        lastError_ = ObsWsError::TransportUnavailable;
+        return false;
+    }
+
+    return true;
+}
+
+uint32_t ObsWsClient::sendRequestMessage(const char *requestType, const char *payload, RequestCallback onComplete, void *context, uint32_t timeoutMs, ObsResponseSink sink)
 {
     if (requestType == nullptr || requestType[0] == '\0')
     {
         emitLog("OBSWS: sendRequest requires a request type.");
-        return false;
+        return 0;
+    }
+
+    // The payload is spliced in verbatim after a structural check instead of being parsed
+    // into a tree and printed again.
+    const ObsJsonSlice data{payload, payload != nullptr ? std::strlen(payload) : 0};
+    if (data.length > 0 && !isJsonObject(data.data, data.length))
+    {
+        emitLog("OBSWS: Request payload is not valid JSON.");
+        return 0;
     }
 
+    return sendRequestData(requestType, data.length > 0 ? &writeRawRequestData : nullptr, &data, onComplete, context, timeoutMs, sink);
+}
+
+void ObsWsClient::writeRawRequestData(ObsJsonWriter &json, const void *data)
+{
+    const ObsJsonSlice *payload = static_cast<const ObsJsonSlice *>(data);
+    json.raw(payload->data, payload->length);
+}
+
+// Shared by the string and typed request paths; `writeData` emits the requestData value,
+// or is nullptr when the request has none.
+uint32_t ObsWsClient::sendRequestData(const char *requestType, RequestDataWriter writeData, const void *data, RequestCallback onComplete, void *context, uint32_t timeoutMs, ObsResponseSink sink)
+{
     if (handshakeState_ != HandshakeState::Established)
     {
         emitLog("OBSWS: sendRequest called before handshake completion.");
         lastError_ = ObsWsError::TransportUnavailable;
-        return false;
+        return 0;
     }
 
-    cJSON *root = cJSON_CreateObject();
-    if (root == nullptr)
+    // A streamed response is only finished by its completion callback.
+    if (sink != nullptr && onComplete == nullptr)
     {
-        emitLog("OBSWS: Failed to allocate request JSON.");
-        return false;
+        emitLog("OBSWS: Streaming requests need a completion callback.");
+        return 0;
+    }
+
+    // The entry is registered before the frame can leave, so a fast reply handled by the
+    // network task always finds it.
+    const uint32_t id = onComplete != nullptr ? registerPendingRequest(0, onComplete, context, timeoutMs, sink) : nextRequestId();
+    if (id == 0)
+    {
+        emitLog("OBSWS: Too many pending requests.");
+        return 0;
+    }
+    char requestId[16];
+    std::snprintf(requestId, sizeof(requestId), "%lu", static_cast<unsigned long>(id));
+
+    const bool sent = sendJsonMessage([&](ObsJsonWriter &json)
+    {
+        json.beginObject();
+        json.key("op");
+        json.integer(6);
+        json.key("d");
+        json.beginObject();
+        json.key("requestType");
+        json.string(requestType);
+        json.key("requestId");
+        json.string(requestId);
+        if (writeData != nullptr)
+        {
+            json.key("requestData");
+            writeData(json, data);
+        }
+        json.endObject();
+        json.endObject();
+    });
+
+    if (!sent)
+    {
+        PendingRequest unused;
+        takePendingRequest(id, unused);
+        emitLog("OBSWS: Failed to send request.");
+        lastError_ = ObsWsError::TransportUnavailable;
+        return 0;
+    }
+
+    return id;
+}
+
+bool ObsWsClient::ensurePendingRequests()
+{
+    const size_t capacity = std::max<size_t>(config_.maxPendingRequests, 1);
+    if (pendingRequests_ != nullptr && (pendingCapacity_ == capacity || pendingCount_ > 0))
+    {
+        return true;
     }
 
-    cJSON_AddNumberToObject(root, "op", 6);
-    cJSON *dataNode = cJSON_AddObjectToObject(root, "d");
-    if (dataNode == nullptr)
+    PendingRequest *table = static_cast<PendingRequest *>(std::realloc(pendingRequests_, capacity * sizeof(PendingRequest)));
+    if (table == nullptr)
     {
-        cJSON_Delete(root);
-        emitLog("OBSWS: Failed to build request payload.");
         return false;
     }
 
-    cJSON_AddStringToObject(dataNode, "requestType", requestType);
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        table[i] = PendingRequest{};
+    }
+    pendingRequests_ = table;
+    pendingCapacity_ = capacity;
+    return true;
+}
 
-    char requestId[16];
-    std::snprintf(requestId, sizeof(requestId), "%lu", static_cast<unsigned long>(requestCounter_++));
-    cJSON_AddStringToObject(dataNode, "requestId", requestId);
+// Safe from any task; 0 is never issued because it marks a free table slot.
+uint32_t ObsWsClient::nextRequestId()
+{
+    uint32_t id = 0;
+    while (id == 0)
+    {
+        id = requestCounter_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return id;
+}
 
-    if (payload != nullptr && payload[0] != '\0')
+// Request ids double as table indices (id % capacity), so ids whose slot is still occupied
+// are skipped. Picking the id and filling its slot happen under one lock so concurrent
+// callers never share a slot. Returns 0 when the table is full.
+uint32_t ObsWsClient::registerPendingRequest(uint32_t batchId, RequestCallback onComplete, void *context, uint32_t timeoutMs, ObsResponseSink sink)
+{
+    PendingRequest entry;
+    entry.batchId = batchId;
+    entry.onComplete = onComplete;
+    entry.context = context;
+    entry.sink = sink;
+    entry.sentMs = millis();
+    entry.timeoutMs = timeoutMs != 0 ? timeoutMs : config_.requestTimeoutMs;
+
+    portENTER_CRITICAL(&pendingLock_);
+    if (pendingRequests_ != nullptr && pendingCount_ < pendingCapacity_)
     {
-        cJSON *payloadNode = cJSON_Parse(payload);
-        if (payloadNode == nullptr)
+        for (size_t attempt = 0; attempt < pendingCapacity_ && entry.id == 0; ++attempt)
         {
-            emitLog("OBSWS: Request payload is not valid JSON.");
-            cJSON_Delete(root);
-            return false;
+            const uint32_t id = nextRequestId();
+            PendingRequest &slot = pendingRequests_[id % pendingCapacity_];
+            if (slot.id == 0)
+            {
+                entry.id = id;
+                slot = entry;
+                ++pendingCount_;
+            }
         }
-        cJSON_AddItemToObject(dataNode, "requestData", payloadNode);
     }
+    portEXIT_CRITICAL(&pendingLock_);
+    return entry.id;
+}
 
-    char *jsonOut = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
+// Removes the entry for `id` from the table. Returns false when nothing is pending under it.
+bool ObsWsClient::takePendingRequest(uint32_t id, PendingRequest &out)
+{
+    bool found = false;
+    portENTER_CRITICAL(&pendingLock_);
+    if (pendingCount_ > 0)
+    {
+        PendingRequest &slot = pendingRequests_[id % pendingCapacity_];
+        if (slot.id == id)
+        {
+            out = slot;
+            slot = PendingRequest{};
+            --pendingCount_;
+            found = true;
+        }
+    }
+    portEXIT_CRITICAL(&pendingLock_);
+    return found;
+}
 
-    if (jsonOut == nullptr)
+// Takes the first pending entry at or after `index` that `expired` selects, so callbacks can
+// run without the table locked.
+template <typename Predicate>
+bool ObsWsClient::takeNextPendingRequest(size_t &index, Predicate expired, PendingRequest &out)
+{
+    bool found = false;
+    portENTER_CRITICAL(&pendingLock_);
+    for (; index < pendingCapacity_ && pendingCount_ > 0; ++index)
     {
-        emitLog("OBSWS: Failed to serialise request JSON.");
-        return false;
+        PendingRequest &slot = pendingRequests_[index];
+        if (slot.id != 0 && expired(slot))
+        {
+            out = slot;
+            slot = PendingRequest{};
+            --pendingCount_;
+            found = true;
+            break;
+        }
     }
+    portEXIT_CRITICAL(&pendingLock_);
+    return found;
+}
 
-    const bool sent = sendText(jsonOut, std::strlen(jsonOut));
-    std::free(jsonOut);
+// Drops the entries still pending for a batch: silently when the batch never went out, or
+// with RequestNotExecuted once its response has been processed (haltOnFailure skipped them).
+void ObsWsClient::releaseBatchRequests(uint32_t batchId, bool notify)
+{
+    PendingRequest pending;
+    size_t index = 0;
+    while (takeNextPendingRequest(index, [batchId](const PendingRequest &slot)
+                                  { return slot.batchId == batchId; },
+                                  pending))
+    {
+        if (notify)
+        {
+            ObsRequestResult result;
+            result.requestId = pending.id;
+            result.error = ObsWsError::RequestNotExecuted;
+            finishRequest(pending, result);
+        }
+    }
+}
 
-    if (!sent)
+bool ObsWsClient::completePendingRequest(const ObsWsMessage &message, const ObsMsgPackSlice &rawResponseData)
+{
+    uint32_t id = 0;
+    PendingRequest pending;
+    if (pendingCount_.load() == 0 || !parseRequestId(message.requestId, id) || !takePendingRequest(id, pending))
     {
-        emitLog("OBSWS: Failed to send request.");
-        lastError_ = ObsWsError::TransportUnavailable;
         return false;
     }
 
+    // Responses that were buffered whole (small ones, or imageData arriving before requestId)
+    // reach the sink here; streamed ones already did, leaving imageData empty.
+    ObsJsonSlice image;
+    ObsMsgPackSlice packedImage;
+    bool hasImage = false;
+    if (pending.sink != nullptr && !rawResponseData.empty())
+    {
+        if (ObsMsgPackReader::findMember(rawResponseData, "imageData", packedImage))
+        {
+            ObsMsgPackReader reader(packedImage);
+            hasImage = reader.readString(packedImage);
+            image = ObsJsonSlice{reinterpret_cast<const char *>(packedImage.data), packedImage.length};
+        }
+    }
+    else if (pending.sink != nullptr && ObsJsonReader::findMember(message.responseData, "imageData", image))
+    {
+        ObsJsonReader reader(image);
+        hasImage = reader.readString(image);
+    }
+    if (hasImage)
+    {
+        beginResponseStream(pending.sink, pending.context);
+        feedResponseStream(image.data, image.length);
+        finishResponseStream();
+    }
+
+    const ObsJsonSlice responseData = deliveredJson(message.responseData, rawResponseData);
+    const ScopedTerminator commentEnd(message.comment);
+    const ScopedTerminator responseEnd(responseData);
+
+    ObsRequestResult result;
+    result.requestId = pending.id;
+    result.success = message.requestResult;
+    result.code = message.requestCode;
+    result.comment = message.comment.data;
+    result.responseData = responseData.data;
+    result.responseDataLength = responseData.length;
+    result.rawResponseData = rawResponseData;
+    finishRequest(pending, result);
     return true;
 }
 
+void ObsWsClient::expirePendingRequests(unsigned long now)
+{
+    PendingRequest pending;
+    size_t index = 0;
+    while (takeNextPendingRequest(index, [now](const PendingRequest &slot)
+                                  { return slot.timeoutMs != 0 && now - slot.sentMs >= slot.timeoutMs; },
+                                  pending))
+    {
+        ObsRequestResult result;
+        result.requestId = pending.id;
+        result.error = ObsWsError::RequestTimeout;
+        finishRequest(pending, result);
+    }
+}
+
+void ObsWsClient::failPendingRequests(ObsWsError error)
+{
+    PendingRequest pending;
+    size_t index = 0;
+    while (takeNextPendingRequest(index, [](const PendingRequest &)
+                                  { return true; },
+                                  pending))
+    {
+        ObsRequestResult result;
+        result.requestId = pending.id;
+        result.error = error;
+        finishRequest(pending, result);
+    }
+}
+
+// Completion callbacks always run on the application side: directly when called from there,
+// or from poll() when the network task saw the reply. Completions are kept on their own
+// list rather than the event ring, whose drop policies would lose them under load, and take
+// a heap copy whatever eventPoolOverflow says. Without memory for the response the request
+// completes with OutOfMemory instead, on the network task as a last resort.
+void ObsWsClient::finishRequest(const PendingRequest &pending, const ObsRequestResult &result)
+{
+    if (!onNetworkTask())
+    {
+        pending.onComplete(result, pending.context);
+        return;
+    }
+
+    ObsRequestResult kept = result;
+    InternalEvent *evt = allocateEvent(result.comment != nullptr ? std::strlen(result.comment) : 0,
+                                       InternalEvent::storageFor(ObsJsonSlice{result.responseData, result.responseDataLength}, result.rawResponseData), false);
+    if (evt == nullptr)
+    {
+        kept = ObsRequestResult();
+        kept.requestId = result.requestId;
+        kept.error = ObsWsError::OutOfMemory;
+        evt = allocateEvent(0, 0, false);
+    }
+    if (evt == nullptr)
+    {
+        emitLog("OBSWS: Failed to allocate request completion.");
+        pending.onComplete(kept, pending.context);
+        return;
+    }
+
+    const ObsJsonSlice responseData{kept.responseData, kept.responseDataLength};
+    copyTerminated(evt->id, ObsJsonSlice{kept.comment, kept.comment != nullptr ? std::strlen(kept.comment) : 0});
+    evt->store(responseData, kept.rawResponseData);
+    evt->next = nullptr;
+    evt->onComplete = pending.onComplete;
+    evt->context = pending.context;
+    evt->requestId = kept.requestId;
+    evt->requestError = kept.error;
+    evt->requestSuccess = kept.success;
+    evt->requestCode = kept.code;
+    evt->hasComment = kept.comment != nullptr;
+    evt->hasResponseData = kept.responseData != nullptr;
+
+    portENTER_CRITICAL(&pendingLock_);
+    if (completedTail_ != nullptr)
+    {
+        completedTail_->next = evt;
+    }
+    else
+    {
+        completedHead_ = evt;
+    }
+    completedTail_ = evt;
+    portEXIT_CRITICAL(&pendingLock_);
+}
+
 ObsWsStatus ObsWsClient::status() const
 {
     return status_;
@@ -323,6 +1393,14 @@ ObsWsError ObsWsClient::lastError() const
     return lastError_;
 }
 
+uint64_t ObsWsClient::eventSubscriptions() const
+{
+    portENTER_CRITICAL(&subscriptionLock_);
+    const uint64_t subscriptions = activeSubscriptions_;
+    portEXIT_CRITICAL(&subscriptionLock_);
+    return subscriptions;
+}
+
 void ObsWsClient::changeStatus(ObsWsStatus next)
 {
     if (status_ == next)
@@ -403,8 +1481,7 @@ bool ObsWsClient::connectTransport()
 
     handshakeState_ = HandshakeState::AwaitUpgrade;
     handshakeStartMs_ = millis();
-    handshakeBuffer_.clear();
-    rxBuffer_.clear();
+    resetRxDecoder();
     return true;
 }
 
@@ -417,599 +1494,2738 @@ bool ObsWsClient::performHandshake()
 
 void ObsWsClient::drainEventQueue()
 {
-    if (eventQueue_ == nullptr)
+    InternalEvent *evt = nullptr;
+    while ((evt = popQueuedEvent()) != nullptr)
     {
-        return;
+        releaseEvent(evt);
     }
 
+    // Events are discarded, but request completions still reach their callbacks so every
+    // request completes exactly once.
+    deliverCompletedRequests();
+}
+
+void ObsWsClient::deliverQueuedEvents()
+{
+    deliverCompletedRequests();
+    deliverVolumeMeters();
+
     InternalEvent *evt = nullptr;
-    while (xQueueReceive(eventQueue_, &evt, 0) == pdTRUE)
+    while ((evt = popQueuedEvent()) != nullptr)
     {
-        releaseInternalEvent(evt);
+        // Known event types are queued without their name.
+        const char *typeName = obsEventTypeName(evt->eventType);
+        const char *id = typeName != nullptr ? typeName : evt->id != nullptr ? evt->id : "";
+        const ObsEvent event{id, evt->payload != nullptr ? evt->payload : "", evt->payloadLength, evt->eventType, evt->names, evt->raw()};
+        deliverEvent(event, evt->eventType);
+        releaseEvent(evt);
     }
 }
 
-bool ObsWsClient::ensureQueues()
+void ObsWsClient::deliverCompletedRequests()
 {
-    if (eventQueue_ != nullptr)
+    portENTER_CRITICAL(&pendingLock_);
+    InternalEvent *evt = completedHead_;
+    completedHead_ = nullptr;
+    completedTail_ = nullptr;
+    portEXIT_CRITICAL(&pendingLock_);
+
+    while (evt != nullptr)
     {
-        return true;
+        InternalEvent *next = evt->next;
+        ObsRequestResult result;
+        result.requestId = evt->requestId;
+        result.error = evt->requestError;
+        result.success = evt->requestSuccess;
+        result.code = evt->requestCode;
+        result.comment = evt->hasComment ? evt->id : nullptr;
+        result.responseData = evt->hasResponseData ? evt->payload : nullptr;
+        result.responseDataLength = evt->payloadLength;
+        result.rawResponseData = evt->raw();
+        evt->onComplete(result, evt->context);
+        releaseEvent(evt);
+        evt = next;
     }
-
-    eventQueue_ = xQueueCreate(kEventQueueLength, sizeof(InternalEvent *));
-    return eventQueue_ != nullptr;
 }
 
-bool ObsWsClient::ensureTransportStopped()
+bool ObsWsClient::ensureQueues()
 {
-    if (transport_ != nullptr)
+    const size_t capacity = std::max<size_t>(config_.eventQueueLength, 1);
+    if (eventRing_ == nullptr || (eventRingCapacity_ != capacity && eventRingCount_ == 0))
     {
-        transport_->stop();
-        transport_ = nullptr;
+        InternalEvent **ring = static_cast<InternalEvent **>(std::realloc(eventRing_, capacity * sizeof(InternalEvent *)));
+        if (ring == nullptr)
+        {
+            return false;
+        }
+        eventRing_ = ring;
+        eventRingCapacity_ = capacity;
+        eventRingHead_ = 0;
     }
 
-    plainClient_.stop();
-    secureClient_.stop();
-    return true;
+    return ensureEventPool();
 }
 
-bool ObsWsClient::sendText(const char *text, size_t length)
+ObsWsClient::InternalEvent *ObsWsClient::popQueuedEvent()
 {
-    if (text == nullptr)
+    InternalEvent *evt = nullptr;
+    portENTER_CRITICAL(&eventRingLock_);
+    if (eventRingCount_ > 0)
     {
-        return false;
+        evt = eventRing_[eventRingHead_];
+        eventRingHead_ = (eventRingHead_ + 1) % eventRingCapacity_;
+        --eventRingCount_;
     }
-
-    return sendFrame(0x1, reinterpret_cast<const uint8_t *>(text), length);
+    portEXIT_CRITICAL(&eventRingLock_);
+    return evt;
 }
 
-bool ObsWsClient::sendFrame(uint8_t opcode, const uint8_t *data, size_t length)
+bool ObsWsClient::pushQueuedEvent(InternalEvent *evt)
 {
-    if (transport_ == nullptr || !transport_->connected())
+    InternalEvent *evicted = nullptr;
+    bool queued = true;
+
+    portENTER_CRITICAL(&eventRingLock_);
+    if (eventRingCount_ == eventRingCapacity_)
     {
-        return false;
+        evicted = evictQueuedEventLocked(*evt);
+        queued = evicted != nullptr;
     }
-
-    uint8_t header[14];
-    size_t headerLen = 0;
-    header[headerLen++] = static_cast<uint8_t>(0x80 | (opcode & 0x0F));
-
-    if (length < 126)
+    if (queued)
     {
-        header[headerLen++] = static_cast<uint8_t>(0x80 | length);
+        eventRing_[(eventRingHead_ + eventRingCount_) % eventRingCapacity_] = evt;
+        ++eventRingCount_;
+        stats_.eventQueueHighWater = std::max(stats_.eventQueueHighWater, static_cast<uint32_t>(eventRingCount_));
     }
-    else if (length <= 0xFFFF)
+    else if (evt->response)
     {
-        header[headerLen++] = 0x80 | 126;
-        header[headerLen++] = static_cast<uint8_t>((length >> 8) & 0xFF);
-        header[headerLen++] = static_cast<uint8_t>(length & 0xFF);
+        ++stats_.responsesDropped;
     }
     else
     {
-        header[headerLen++] = 0x80 | 127;
-        for (int i = 7; i >= 0; --i)
-        {
-            header[headerLen++] = static_cast<uint8_t>((static_cast<uint64_t>(length) >> (8 * i)) & 0xFF);
-        }
+        ++stats_.eventsDroppedNewest;
     }
+    portEXIT_CRITICAL(&eventRingLock_);
 
-    uint8_t maskKey[4];
-    for (int i = 0; i < 4; ++i)
-    {
-        maskKey[i] = static_cast<uint8_t>(esp_random() & 0xFF);
-        header[headerLen++] = maskKey[i];
-    }
+    releaseEvent(evicted);
+    return queued;
+}
 
-    if (transport_->write(header, headerLen) != headerLen)
-    {
+// Picks the queued event that gives way to `incoming` when the ring is full and unlinks it,
+// or returns nullptr when `incoming` should be dropped instead. Caller holds eventRingLock_.
+ObsWsClient::InternalEvent *ObsWsClient::evictQueuedEventLocked(const InternalEvent &incoming)
+{
+    size_t victim = eventRingCount_;
+
+    if (config_.eventQueuePolicy == ObsWsQueuePolicy::CoalesceByType && !incoming.response)
+    {
+        for (size_t i = 0; i < eventRingCount_; ++i)
+        {
+            const InternalEvent *queued = eventRing_[(eventRingHead_ + i) % eventRingCapacity_];
+            const bool sameType = incoming.eventType != ObsEventType::Unknown ? queued->eventType == incoming.eventType
+                                                                                 : queued->eventType == ObsEventType::Unknown && std::strcmp(queued->id, incoming.id) == 0;
+            if (!queued->response && sameType)
+            {
+                victim = i;
+                ++stats_.eventsEvicted;
+                break;
+            }
+        }
+    }
+
+    const bool protectResponse = incoming.response && config_.neverDropResponses;
+    if (victim == eventRingCount_ && (config_.eventQueuePolicy == ObsWsQueuePolicy::DropOldest || protectResponse))
+    {
+        for (size_t i = 0; i < eventRingCount_; ++i)
+        {
+            const InternalEvent *queued = eventRing_[(eventRingHead_ + i) % eventRingCapacity_];
+            if (!queued->response || !config_.neverDropResponses)
+            {
+                victim = i;
+                ++(queued->response ? stats_.responsesDropped : stats_.eventsDroppedOldest);
+                break;
+            }
+        }
+    }
+
+    if (victim == eventRingCount_)
+    {
+        return nullptr;
+    }
+
+    return unlinkQueuedEventLocked(victim);
+}
+
+ObsWsClient::InternalEvent *ObsWsClient::unlinkQueuedEventLocked(size_t index)
+{
+    InternalEvent *evt = eventRing_[(eventRingHead_ + index) % eventRingCapacity_];
+    for (size_t i = index + 1; i < eventRingCount_; ++i)
+    {
+        eventRing_[(eventRingHead_ + i - 1) % eventRingCapacity_] = eventRing_[(eventRingHead_ + i) % eventRingCapacity_];
+    }
+    --eventRingCount_;
+    return evt;
+}
+
+bool ObsWsClient::coalesceKeyFor(const ObsJsonSlice &eventType, const ObsJsonSlice &eventData, const ObsMsgPackSlice &raw, uint32_t &key, uint8_t &members) const
+{
+    const char *const *types = config_.coalescedEventTypes;
+    size_t typeCount = config_.coalescedEventTypeCount;
+    if (types == nullptr)
+    {
+        types = kDefaultCoalescedEvents;
+        typeCount = sizeof(kDefaultCoalescedEvents) / sizeof(kDefaultCoalescedEvents[0]);
+    }
+
+    bool listed = false;
+    for (size_t i = 0; i < typeCount && !listed; ++i)
+    {
+        listed = types[i] != nullptr && eventType.equals(types[i]);
+    }
+    if (!listed)
+    {
         return false;
     }
 
-    if (length == 0)
+    // The type itself is compared when matching, so only the narrowing members are hashed.
+    // `members` records which were present so a hash match can be confirmed against them.
+    key = kFnvOffsetBasis;
+    members = 0;
+    if (!raw.empty())
     {
-        transport_->flush();
+        for (size_t i = 0; i < sizeof(kCoalesceKeyMembers) / sizeof(kCoalesceKeyMembers[0]); ++i)
+        {
+            const char *name = kCoalesceKeyMembers[i];
+            ObsMsgPackSlice value;
+            if (ObsMsgPackReader::findMember(raw, name, value))
+            {
+                key = hashBytes(hashBytes(key, name, std::strlen(name)), reinterpret_cast<const char *>(value.data), value.length);
+                members |= static_cast<uint8_t>(1U << i);
+            }
+        }
         return true;
     }
 
-    size_t written = 0;
-    while (written < length)
+    ObsJsonReader reader(eventData);
+    ObsJsonSlice member;
+    if (!reader.beginObject())
+    {
+        return true;
+    }
+    while (reader.nextMember(member))
     {
-        const size_t chunk = std::min(static_cast<size_t>(128), length - written);
-        uint8_t buffer[128];
-        for (size_t i = 0; i < chunk; ++i)
+        ObsJsonSlice value;
+        if (!reader.skipValue(&value))
         {
-            const uint8_t source = data != nullptr ? data[written + i] : 0;
-            buffer[i] = static_cast<uint8_t>(source ^ maskKey[(written + i) % 4]);
+            break;
         }
-        if (transport_->write(buffer, chunk) != chunk)
+        for (size_t i = 0; i < sizeof(kCoalesceKeyMembers) / sizeof(kCoalesceKeyMembers[0]); ++i)
         {
-            return false;
+            const char *name = kCoalesceKeyMembers[i];
+            if (member.equals(name))
+            {
+                key = hashBytes(hashBytes(key, name, std::strlen(name)), value.data, value.length);
+                members |= static_cast<uint8_t>(1U << i);
+            }
         }
-        written += chunk;
     }
-
-    transport_->flush();
     return true;
 }
 
-bool ObsWsClient::sendControlFrame(uint8_t opcode, const uint8_t *data, size_t length)
+// Overwrites the queued event with the same coalescing key when the new payload fits in its
+// storage. The hash only narrows the search; the key members themselves must match too. A
+// match that is too small is unlinked and returned through `stale` so the caller queues the
+// update at the tail instead.
+bool ObsWsClient::coalesceQueuedEvent(const ObsJsonSlice &eventType, ObsEventType type, const ObsJsonSlice &payload, const ObsMsgPackSlice &raw, uint32_t key, uint8_t members, InternalEvent *&stale)
 {
-    return sendFrame(opcode, data, length);
+    bool replaced = false;
+    stale = nullptr;
+
+    portENTER_CRITICAL(&eventRingLock_);
+    for (size_t i = 0; i < eventRingCount_; ++i)
+    {
+        InternalEvent *queued = eventRing_[(eventRingHead_ + i) % eventRingCapacity_];
+        const bool sameType = type != ObsEventType::Unknown ? queued->eventType == type
+                                                            : queued->eventType == ObsEventType::Unknown && eventType.equals(queued->id);
+        if (!queued->coalescable || queued->coalesceKey != key || queued->coalesceMembers != members || !sameType ||
+            !sameCoalesceMembers(payload, raw, ObsJsonSlice{queued->payload, queued->payloadLength}, queued->raw(), members))
+        {
+            continue;
+        }
+
+        if (InternalEvent::storageFor(payload, raw) <= queued->payloadCapacity)
+        {
+            queued->store(payload, raw);
+            replaced = true;
+        }
+        else
+        {
+            stale = unlinkQueuedEventLocked(i);
+        }
+        ++stats_.eventsCoalesced;
+        break;
+    }
+    portEXIT_CRITICAL(&eventRingLock_);
+
+    return replaced;
 }
 
-bool ObsWsClient::sendHandshakeRequest()
+bool ObsWsClient::ensureEventPool()
 {
-    if (transport_ == nullptr)
+    if (eventPool_ != nullptr && eventPoolSlots_ == config_.eventPoolSlots && eventPoolPayloadBytes_ == config_.eventPoolPayloadBytes)
     {
-        return false;
+        return true;
     }
 
-    unsigned char rawKey[16];
-    for (unsigned char &byte : rawKey)
+    // Resizing is only safe once every slot is back on the free list.
+    if (eventPool_ != nullptr && uxQueueMessagesWaiting(eventPoolFree_) != eventPoolSlots_)
     {
-        byte = static_cast<unsigned char>(esp_random() & 0xFF);
+        return true;
     }
 
-    size_t keyLen = 0;
-    if (mbedtls_base64_encode(reinterpret_cast<unsigned char *>(secWebsocketKey_), sizeof(secWebsocketKey_) - 1, &keyLen, rawKey, sizeof(rawKey)) != 0)
+    releaseEventPool();
+    if (config_.eventPoolSlots == 0)
+    {
+        return true;
+    }
+
+    const size_t slotSize = alignSlotSize(sizeof(InternalEvent) + kEventPoolIdBytes + config_.eventPoolPayloadBytes + 1);
+    eventPool_ = static_cast<uint8_t *>(std::malloc(slotSize * config_.eventPoolSlots));
+    eventPoolFree_ = xQueueCreate(config_.eventPoolSlots, sizeof(InternalEvent *));
+    if (eventPool_ == nullptr || eventPoolFree_ == nullptr)
     {
+        releaseEventPool();
         return false;
     }
-    secWebsocketKey_[keyLen] = '\0';
 
-    transport_->print("GET / HTTP/1.1\r\n");
-    transport_->print("Host: ");
-    transport_->print(config_.host);
-    transport_->print(":");
-    transport_->print(config_.port);
-    transport_->print("\r\n");
-    transport_->print("Upgrade: websocket\r\n");
-    transport_->print("Connection: Upgrade\r\n");
-    transport_->print("Sec-WebSocket-Version: 13\r\n");
-    transport_->print("Sec-WebSocket-Protocol: obswebsocket.json\r\n");
-    transport_->print("User-Agent: OBSWS-ESP32\r\n");
-    transport_->print("Sec-WebSocket-Key: ");
-    transport_->print(secWebsocketKey_);
-    transport_->print("\r\n\r\n");
+    eventPoolSlots_ = config_.eventPoolSlots;
+    eventPoolPayloadBytes_ = config_.eventPoolPayloadBytes;
+    for (size_t i = 0; i < eventPoolSlots_; ++i)
+    {
+        uint8_t *slot = eventPool_ + i * slotSize;
+        InternalEvent *evt = reinterpret_cast<InternalEvent *>(slot);
+        evt->id = reinterpret_cast<char *>(slot + sizeof(InternalEvent));
+        evt->payload = evt->id + kEventPoolIdBytes;
+        evt->payloadLength = 0;
+        evt->payloadCapacity = config_.eventPoolPayloadBytes;
+        evt->pooled = true;
+        xQueueSend(eventPoolFree_, &evt, 0);
+    }
+    return true;
+}
 
-    transport_->flush();
+void ObsWsClient::releaseEventPool()
+{
+    if (eventPoolFree_ != nullptr)
+    {
+        vQueueDelete(eventPoolFree_);
+        eventPoolFree_ = nullptr;
+    }
+    std::free(eventPool_);
+    eventPool_ = nullptr;
+    eventPoolSlots_ = 0;
+    eventPoolPayloadBytes_ = 0;
+}
+
+// Pool slots first; past that, eventPoolOverflow decides unless the caller cannot drop.
+ObsWsClient::InternalEvent *ObsWsClient::allocateEvent(size_t idLength, size_t payloadLength, bool droppable)
+{
+    InternalEvent *evt = nullptr;
+    if (eventPoolFree_ != nullptr && idLength < kEventPoolIdBytes && payloadLength <= eventPoolPayloadBytes_ && xQueueReceive(eventPoolFree_, &evt, 0) == pdTRUE)
+    {
+        const uint32_t inUse = static_cast<uint32_t>(eventPoolSlots_ - uxQueueMessagesWaiting(eventPoolFree_));
+        portENTER_CRITICAL(&eventRingLock_);
+        stats_.eventPoolHighWater = std::max(stats_.eventPoolHighWater, inUse);
+        portEXIT_CRITICAL(&eventRingLock_);
+        return evt;
+    }
+
+    if (droppable && eventPool_ != nullptr && config_.eventPoolOverflow == ObsWsPoolOverflow::Drop)
+    {
+        portENTER_CRITICAL(&eventRingLock_);
+        ++stats_.eventPoolDrops;
+        portEXIT_CRITICAL(&eventRingLock_);
+        return nullptr;
+    }
+
+    // Heap fallback keeps the container and both strings in a single allocation.
+    evt = static_cast<InternalEvent *>(std::malloc(sizeof(InternalEvent) + idLength + 1 + payloadLength + 1));
+    if (evt == nullptr)
+    {
+        return nullptr;
+    }
+
+    portENTER_CRITICAL(&eventRingLock_);
+    ++stats_.eventPoolHeapFallbacks;
+    portEXIT_CRITICAL(&eventRingLock_);
+    evt->id = reinterpret_cast<char *>(evt + 1);
+    evt->payload = evt->id + idLength + 1;
+    evt->payloadLength = 0;
+    evt->payloadCapacity = payloadLength;
+    evt->pooled = false;
+    return evt;
+}
+
+size_t ObsWsClient::InternalEvent::storageFor(const ObsJsonSlice &payload, const ObsMsgPackSlice &bytes)
+{
+    return payload.length + (bytes.length > 0 ? 1 + bytes.length : 0);
+}
+
+void ObsWsClient::InternalEvent::store(const ObsJsonSlice &json, const ObsMsgPackSlice &bytes)
+{
+    copyTerminated(payload, json);
+    payloadLength = json.length;
+    rawLength = bytes.length;
+    if (rawLength > 0)
+    {
+        std::memcpy(payload + payloadLength + 1, bytes.data, rawLength);
+    }
+}
+
+ObsMsgPackSlice ObsWsClient::InternalEvent::raw() const
+{
+    ObsMsgPackSlice bytes;
+    if (rawLength > 0)
+    {
+        bytes.data = reinterpret_cast<const uint8_t *>(payload + payloadLength + 1);
+        bytes.length = rawLength;
+    }
+    return bytes;
+}
+
+void ObsWsClient::releaseEvent(InternalEvent *evt)
+{
+    if (evt == nullptr)
+    {
+        return;
+    }
+
+    if (evt->pooled)
+    {
+        xQueueSend(eventPoolFree_, &evt, 0);
+    }
+    else
+    {
+        std::free(evt);
+    }
+}
+
+ObsWsStats ObsWsClient::stats() const
+{
+    const uint32_t poolInUse = eventPoolFree_ != nullptr ? static_cast<uint32_t>(eventPoolSlots_ - uxQueueMessagesWaiting(eventPoolFree_)) : 0;
+
+    portENTER_CRITICAL(&eventRingLock_);
+    ObsWsStats snapshot = stats_;
+    snapshot.eventQueueLength = static_cast<uint32_t>(eventRingCapacity_);
+    snapshot.eventQueueDepth = static_cast<uint32_t>(eventRingCount_);
+    portEXIT_CRITICAL(&eventRingLock_);
+
+    snapshot.eventPoolSlots = static_cast<uint32_t>(eventPoolSlots_);
+    snapshot.eventPoolInUse = poolInUse;
+    return snapshot;
+}
+
+bool ObsWsClient::ensureTransportStopped()
+{
+    if (transport_ != nullptr)
+    {
+        transport_->stop();
+        transport_ = nullptr;
+    }
+
+    plainClient_.stop();
+    secureClient_.stop();
+    txStart_ = 0;
+    txLength_ = 0;
     return true;
 }
 
-bool ObsWsClient::processHandshakeBuffer()
+bool ObsWsClient::sendText(const char *text, size_t length)
 {
-    const std::string::size_type terminator = handshakeBuffer_.find("\r\n\r\n");
-    if (terminator == std::string::npos)
+    if (text == nullptr)
     {
         return false;
     }
 
-    const std::string headerSection = handshakeBuffer_.substr(0, terminator);
-    const std::string remaining = handshakeBuffer_.substr(terminator + 4);
+    return sendFrame(0x1, reinterpret_cast<const uint8_t *>(text), length);
+}
+
+bool ObsWsClient::ensureTxBuffer(size_t capacity)
+{
+    if (txCapacity_ >= capacity)
+    {
+        return true;
+    }
 
-    const std::string::size_type statusEnd = headerSection.find("\r\n");
-    if (statusEnd == std::string::npos)
+    const size_t grown = std::max(capacity, txCapacity_ + txCapacity_ / 2);
+    uint8_t *buffer = static_cast<uint8_t *>(std::realloc(txBuffer_, std::max(grown, kMinTxBufferSize)));
+    if (buffer == nullptr)
     {
-        emitLog("OBSWS: Malformed handshake response.");
-        emitError(ObsWsError::HandshakeRejected);
-        ensureTransportStopped();
-        handshakeState_ = HandshakeState::Idle;
         return false;
     }
 
-    const std::string statusLine = headerSection.substr(0, statusEnd);
-    if (statusLine.find("101") == std::string::npos)
+    txBuffer_ = buffer;
+    txCapacity_ = std::max(grown, kMinTxBufferSize);
+    return true;
+}
+
+// Formats the message into `out`, as MessagePack in MessagePack sessions: builders write
+// through ObsJsonWriter either way. `length` receives the payload length, or a length larger
+// than `capacity` to retry with. Returns false when the message cannot be formatted at all.
+template <typename Build>
+bool ObsWsClient::formatMessage(Build &build, bool msgPack, uint8_t *out, size_t capacity, size_t &length)
+{
+    ObsJsonWriter writer = msgPack ? ObsJsonWriter::msgPack(out, capacity) : ObsJsonWriter(reinterpret_cast<char *>(out), capacity);
+    build(writer);
+    length = writer.overflowed() ? writer.required() : writer.length();
+    return !writer.failed();
+}
+
+template <typename Build>
+bool ObsWsClient::sendJsonMessage(Build build)
+{
+    if (networkTask_ != nullptr && !onNetworkTask())
+    {
+        return queueJsonMessage(build);
+    }
+
+    if (transport_ == nullptr || !transport_->connected())
     {
-        emitLog("OBSWS: HTTP upgrade rejected by OBS.");
-        emitError(ObsWsError::HandshakeRejected);
-        ensureTransportStopped();
-        handshakeState_ = HandshakeState::Idle;
         return false;
     }
 
-    std::string acceptHeader;
-    std::string::size_type searchPos = statusEnd + 2;
-    const std::string needle = "Sec-WebSocket-Accept:";
-    while (searchPos < headerSection.size())
+    // The message is formatted straight into the payload area of the next frame in the
+    // transmit buffer. A message that does not fit grows the buffer to the size the writer
+    // counted and is formatted once more.
+    const bool msgPack = msgPackActive_;
+    size_t needed = txLength_ + kMaxFrameHeaderSize + 1;
+    for (;;)
     {
-        const std::string::size_type lineEnd = headerSection.find("\r\n", searchPos);
-        const std::string line = headerSection.substr(searchPos, lineEnd - searchPos);
-        if (line.find(needle) == 0)
+        if (!ensureTxBuffer(needed))
         {
-            acceptHeader = trim(line.substr(needle.size()));
-            break;
+            emitLog("OBSWS: Failed to allocate transmit buffer.");
+            return false;
         }
-        if (lineEnd == std::string::npos)
+
+        const size_t payloadOffset = txLength_ + kMaxFrameHeaderSize;
+        const size_t capacity = txCapacity_ - payloadOffset;
+        size_t length = 0;
+        if (!formatMessage(build, msgPack, txBuffer_ + payloadOffset, capacity, length))
         {
-            break;
+            emitLog("OBSWS: Message holds JSON that could not be encoded.");
+            return false;
         }
-        searchPos = lineEnd + 2;
+        if (length <= capacity)
+        {
+            return commitFrame(msgPack ? 0x2 : 0x1, length);
+        }
+        needed = payloadOffset + length;
+    }
+}
+
+// Formats and masks a complete frame on the calling task and hands it to the network task,
+// so application tasks never wait on the transport.
+template <typename Build>
+bool ObsWsClient::queueJsonMessage(Build build)
+{
+    const bool msgPack = msgPackActive_;
+    size_t capacity = kMinTxBufferSize;
+    for (;;)
+    {
+        OutboundFrame *frame = static_cast<OutboundFrame *>(std::malloc(sizeof(OutboundFrame) + kMaxFrameHeaderSize + capacity));
+        if (frame == nullptr)
+        {
+            emitLog("OBSWS: Failed to allocate outbound frame.");
+            return false;
+        }
+
+        uint8_t *payload = frame->bytes() + kMaxFrameHeaderSize;
+        size_t length = 0;
+        if (!formatMessage(build, msgPack, payload, capacity, length))
+        {
+            emitLog("OBSWS: Message holds JSON that could not be encoded.");
+            std::free(frame);
+            return false;
+        }
+        if (length > capacity)
+        {
+            std::free(frame);
+            capacity = length;
+            continue;
+        }
+
+        uint8_t header[kMaxFrameHeaderSize];
+        const size_t headerLen = writeFrameHeader(header, msgPack ? 0x2 : 0x1, length);
+        applyObsWsMask(payload, length, header + headerLen - 4, 0);
+        frame->start = kMaxFrameHeaderSize - headerLen;
+        frame->length = headerLen + length;
+        std::memcpy(frame->bytes() + frame->start, header, headerLen);
+
+        if (!submitFrame(frame))
+        {
+            emitLog("OBSWS: Send queue full, dropping message.");
+            std::free(frame);
+            return false;
+        }
+        xTaskNotifyGive(networkTask_);
+        return true;
+    }
+}
+
+bool ObsWsClient::sendFrame(uint8_t opcode, const uint8_t *data, size_t length)
+{
+    if (transport_ == nullptr || !transport_->connected())
+    {
+        return false;
+    }
+
+    if (!ensureTxBuffer(txLength_ + kMaxFrameHeaderSize + length))
+    {
+        emitLog("OBSWS: Failed to allocate transmit buffer.");
+        return false;
+    }
+
+    uint8_t *payload = txBuffer_ + txLength_ + kMaxFrameHeaderSize;
+    if (data != nullptr)
+    {
+        std::memcpy(payload, data, length);
     }
+    else
+    {
+        std::memset(payload, 0, length);
+    }
+    return commitFrame(opcode, length);
+}
+
+// Turns the payload staged kMaxFrameHeaderSize bytes past the end of the pending data into a
+// masked frame. The header is written directly in front of the payload; only when earlier
+// frames are still pending is the frame moved down to close the gap.
+bool ObsWsClient::commitFrame(uint8_t opcode, size_t length)
+{
+    uint8_t header[kMaxFrameHeaderSize];
+    const size_t headerLen = writeFrameHeader(header, opcode, length);
+    const uint8_t *maskKey = header + headerLen - 4;
+
+    uint8_t *payload = txBuffer_ + txLength_ + kMaxFrameHeaderSize;
+    applyObsWsMask(payload, length, maskKey, 0);
+
+    size_t frameStart = txLength_ + kMaxFrameHeaderSize - headerLen;
+    if (txLength_ == txStart_)
+    {
+        txStart_ = frameStart;
+    }
+    else if (frameStart != txLength_)
+    {
+        std::memmove(txBuffer_ + txLength_ + headerLen, payload, length);
+        frameStart = txLength_;
+    }
+    std::memcpy(txBuffer_ + frameStart, header, headerLen);
+    txLength_ = frameStart + headerLen + length;
+
+    if (!config_.deferFlush || txLength_ - txStart_ >= kMaxDeferredTxBytes)
+    {
+        return flushTx();
+    }
+    return true;
+}
+
+bool ObsWsClient::flushTx()
+{
+    const size_t pending = txLength_ - txStart_;
+    const uint8_t *data = txBuffer_ + txStart_;
+    txStart_ = 0;
+    txLength_ = 0;
+
+    if (pending == 0)
+    {
+        return true;
+    }
+
+    if (transport_ == nullptr || transport_->write(data, pending) != pending)
+    {
+        emitLog("OBSWS: Failed to write to transport.");
+        return false;
+    }
+
+    transport_->flush();
+    return true;
+}
+
+bool ObsWsClient::sendControlFrame(uint8_t opcode, const uint8_t *data, size_t length)
+{
+    // Control frames go out immediately, together with any deferred data frames ahead of them.
+    return sendFrame(opcode, data, length) && flushTx();
+}
+
+bool ObsWsClient::sendHandshakeRequest()
+{
+    if (transport_ == nullptr)
+    {
+        return false;
+    }
+
+    unsigned char rawKey[16];
+    for (unsigned char &byte : rawKey)
+    {
+        byte = static_cast<unsigned char>(esp_random() & 0xFF);
+    }
+
+    size_t keyLen = 0;
+    if (mbedtls_base64_encode(reinterpret_cast<unsigned char *>(secWebsocketKey_), sizeof(secWebsocketKey_) - 1, &keyLen, rawKey, sizeof(rawKey)) != 0)
+    {
+        return false;
+    }
+    secWebsocketKey_[keyLen] = '\0';
+
+    transport_->print("GET / HTTP/1.1\r\n");
+    transport_->print("Host: ");
+    transport_->print(config_.host);
+    transport_->print(":");
+    transport_->print(config_.port);
+    transport_->print("\r\n");
+    transport_->print("Upgrade: websocket\r\n");
+    transport_->print("Connection: Upgrade\r\n");
+    transport_->print("Sec-WebSocket-Version: 13\r\n");
+    transport_->print(config_.useMsgPack ? "Sec-WebSocket-Protocol: obswebsocket.msgpack, obswebsocket.json\r\n" : "Sec-WebSocket-Protocol: obswebsocket.json\r\n");
+    if (config_.enableCompression && OBSWS_HAS_INFLATE)
+    {
+        // Only the server's window is constrained: outbound frames are never compressed,
+        // so client_max_window_bits is not offered.
+        transport_->print("Sec-WebSocket-Extensions: permessage-deflate; server_max_window_bits=");
+        transport_->print(static_cast<unsigned int>(deflateWindowBits()));
+        transport_->print("\r\n");
+    }
+    transport_->print("User-Agent: OBSWS-ESP32\r\n");
+    transport_->print("Sec-WebSocket-Key: ");
+    transport_->print(secWebsocketKey_);
+    transport_->print("\r\n\r\n");
+
+    transport_->flush();
+    return true;
+}
+
+bool ObsWsClient::ensureRxBuffer(size_t capacity)
+{
+    if (rxBuffer_ != nullptr && rxCapacity_ >= capacity)
+    {
+        return true;
+    }
+
+    // One byte past the capacity lets a slice that ends the buffer be NUL-terminated in place.
+    uint8_t *grown = static_cast<uint8_t *>(std::realloc(rxBuffer_, capacity + 1));
+    if (grown == nullptr)
+    {
+        return false;
+    }
+
+    rxBuffer_ = grown;
+    rxCapacity_ = capacity;
+    return true;
+}
+
+void ObsWsClient::releaseRxBuffer()
+{
+    std::free(rxBuffer_);
+    rxBuffer_ = nullptr;
+    rxCapacity_ = 0;
+    rxReadPos_ = 0;
+    rxWritePos_ = 0;
+}
+
+void ObsWsClient::consumeRxBuffer(size_t length)
+{
+    rxReadPos_ += length;
+    if (rxReadPos_ >= rxWritePos_)
+    {
+        // Fully drained: rewind both cursors for free instead of compacting later.
+        rxReadPos_ = 0;
+        rxWritePos_ = 0;
+    }
+}
+
+void ObsWsClient::compactRxBuffer()
+{
+    if (rxReadPos_ == 0)
+    {
+        return;
+    }
+
+    const size_t pending = rxWritePos_ - rxReadPos_;
+    if (pending > 0)
+    {
+        std::memmove(rxBuffer_, rxBuffer_ + rxReadPos_, pending);
+    }
+    rxReadPos_ = 0;
+    rxWritePos_ = pending;
+}
+
+bool ObsWsClient::processHandshakeBuffer()
+{
+    static const char kTerminator[] = "\r\n\r\n";
+    const char *begin = reinterpret_cast<const char *>(rxBuffer_ + rxReadPos_);
+    const char *end = reinterpret_cast<const char *>(rxBuffer_ + rxWritePos_);
+    const char *terminatorPos = std::search(begin, end, kTerminator, kTerminator + 4);
+    if (terminatorPos == end)
+    {
+        return false;
+    }
+
+    const size_t terminator = static_cast<size_t>(terminatorPos - begin);
+    const std::string headerSection(begin, terminator);
+
+    const std::string::size_type statusEnd = headerSection.find("\r\n");
+    if (statusEnd == std::string::npos)
+    {
+        emitLog("OBSWS: Malformed handshake response.");
+        emitError(ObsWsError::HandshakeRejected);
+        ensureTransportStopped();
+        handshakeState_ = HandshakeState::Idle;
+        return false;
+    }
+
+    const std::string statusLine = headerSection.substr(0, statusEnd);
+    if (statusLine.find("101") == std::string::npos)
+    {
+        emitLog("OBSWS: HTTP upgrade rejected by OBS.");
+        emitError(ObsWsError::HandshakeRejected);
+        ensureTransportStopped();
+        handshakeState_ = HandshakeState::Idle;
+        return false;
+    }
+
+    std::string acceptHeader;
+    std::string extensionsHeader;
+    std::string protocolHeader;
+    std::string::size_type searchPos = statusEnd + 2;
+    const std::string needle = "Sec-WebSocket-Accept:";
+    const std::string extensionsNeedle = "Sec-WebSocket-Extensions:";
+    const std::string protocolNeedle = "Sec-WebSocket-Protocol:";
+    while (searchPos < headerSection.size())
+    {
+        const std::string::size_type lineEnd = headerSection.find("\r\n", searchPos);
+        const std::string line = headerSection.substr(searchPos, lineEnd - searchPos);
+        if (line.find(needle) == 0)
+        {
+            acceptHeader = trim(line.substr(needle.size()));
+        }
+        else if (line.find(extensionsNeedle) == 0)
+        {
+            extensionsHeader = trim(line.substr(extensionsNeedle.size()));
+        }
+        else if (line.find(protocolNeedle) == 0)
+        {
+            protocolHeader = trim(line.substr(protocolNeedle.size()));
+        }
+        if (lineEnd == std::string::npos)
+        {
+            break;
+        }
+        searchPos = lineEnd + 2;
+    }
+
+    if (acceptHeader.empty())
+    {
+        emitLog("OBSWS: Handshake missing Sec-WebSocket-Accept header.");
+        emitError(ObsWsError::HandshakeRejected);
+        ensureTransportStopped();
+        handshakeState_ = HandshakeState::Idle;
+        return false;
+    }
+
+    char expectedAccept[64] = {0};
+    if (!computeAcceptKey(expectedAccept, sizeof(expectedAccept)))
+    {
+        emitLog("OBSWS: Failed to compute handshake digest.");
+        emitError(ObsWsError::HandshakeRejected);
+        ensureTransportStopped();
+        handshakeState_ = HandshakeState::Idle;
+        return false;
+    }
+
+    if (acceptHeader != expectedAccept)
+    {
+        emitLog("OBSWS: Sec-WebSocket-Accept mismatch.");
+        emitError(ObsWsError::HandshakeRejected);
+        ensureTransportStopped();
+        handshakeState_ = HandshakeState::Idle;
+        return false;
+    }
+
+    compressionActive_ = false;
+    if (!extensionsHeader.empty())
+    {
+        if (extensionsHeader.find("permessage-deflate") != 0 || !config_.enableCompression || !OBSWS_HAS_INFLATE)
+        {
+            emitLog("OBSWS: Server accepted an extension that was not offered.");
+            emitError(ObsWsError::HandshakeRejected);
+            ensureTransportStopped();
+            handshakeState_ = HandshakeState::Idle;
+            return false;
+        }
+
+        if (!ensureInflater())
+        {
+            emitLog("OBSWS: Failed to allocate inflate window.");
+            emitError(ObsWsError::HandshakeRejected);
+            ensureTransportStopped();
+            handshakeState_ = HandshakeState::Idle;
+            return false;
+        }
+
+        compressionActive_ = true;
+        emitLog("OBSWS: permessage-deflate negotiated.");
+    }
+
+    // A server that leaves the header out speaks JSON.
+    msgPackActive_ = false;
+    if (protocolHeader == "obswebsocket.msgpack" && config_.useMsgPack)
+    {
+        msgPackActive_ = true;
+        emitLog("OBSWS: MessagePack subprotocol negotiated.");
+    }
+    else if (!protocolHeader.empty() && protocolHeader != "obswebsocket.json")
+    {
+        emitLog("OBSWS: Server selected a subprotocol that was not offered.");
+        emitError(ObsWsError::HandshakeRejected);
+        ensureTransportStopped();
+        handshakeState_ = HandshakeState::Idle;
+        return false;
+    }
+    else if (config_.useMsgPack)
+    {
+        emitLog("OBSWS: Server declined MessagePack, using JSON.");
+    }
+
+    consumeRxBuffer(terminator + 4);
+    emitLog("OBSWS: WebSocket upgrade acknowledged.");
+    return true;
+}
+
+uint8_t ObsWsClient::deflateWindowBits() const
+{
+    return std::min(std::max(config_.compressionWindowBits, kMinDeflateWindowBits), kMaxDeflateWindowBits);
+}
+
+bool ObsWsClient::ensureInflater()
+{
+#if OBSWS_HAS_INFLATE
+    const size_t windowSize = static_cast<size_t>(1) << deflateWindowBits();
+    if (inflater_ != nullptr && inflateWindowSize_ == windowSize)
+    {
+        inflateWindowPos_ = 0;
+        return true;
+    }
+
+    releaseInflater();
+    inflater_ = std::malloc(sizeof(tinfl_decompressor));
+    inflateWindow_ = static_cast<uint8_t *>(std::malloc(windowSize));
+    if (inflater_ == nullptr || inflateWindow_ == nullptr)
+    {
+        releaseInflater();
+        return false;
+    }
+
+    inflateWindowSize_ = windowSize;
+    inflateWindowPos_ = 0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ObsWsClient::releaseInflater()
+{
+    std::free(inflater_);
+    std::free(inflateWindow_);
+    inflater_ = nullptr;
+    inflateWindow_ = nullptr;
+    inflateWindowSize_ = 0;
+    inflateWindowPos_ = 0;
+}
+
+bool ObsWsClient::inflatePayload(const uint8_t *data, size_t length, bool final)
+{
+#if OBSWS_HAS_INFLATE
+    // RFC 7692 strips the trailing empty stored block from every message; feed it back so
+    // the inflater flushes all pending output. The window persists across messages because
+    // the server may keep its compression context (no server_no_context_takeover).
+    static const uint8_t kTail[4] = {0x00, 0x00, 0xFF, 0xFF};
+    tinfl_decompressor *inflater = static_cast<tinfl_decompressor *>(inflater_);
+    const uint8_t *input = data;
+    size_t inputLen = length;
+    bool tailPending = final;
+
+    for (;;)
+    {
+        if (inputLen == 0 && tailPending)
+        {
+            input = kTail;
+            inputLen = sizeof(kTail);
+            tailPending = false;
+        }
+
+        size_t consumed = inputLen;
+        size_t produced = inflateWindowSize_ - inflateWindowPos_;
+        const tinfl_status status = tinfl_decompress(inflater, input, &consumed, inflateWindow_, inflateWindow_ + inflateWindowPos_, &produced, TINFL_FLAG_HAS_MORE_INPUT);
+        input += consumed;
+        inputLen -= consumed;
+
+        if (produced > 0 && !appendMessageData(inflateWindow_ + inflateWindowPos_, produced, false))
+        {
+            return false;
+        }
+        inflateWindowPos_ = (inflateWindowPos_ + produced) & (inflateWindowSize_ - 1);
+
+        if (status < TINFL_STATUS_DONE)
+        {
+            failConnection(1007, ObsWsError::ProtocolError, "OBSWS: Failed to inflate compressed message.");
+            return false;
+        }
+        if (status == TINFL_STATUS_DONE)
+        {
+            tinfl_init(inflater);
+            break;
+        }
+        if (status == TINFL_STATUS_NEEDS_MORE_INPUT && inputLen == 0 && !tailPending)
+        {
+            break;
+        }
+    }
+
+    return !final || appendMessageData(data, 0, true);
+#else
+    (void)data;
+    (void)length;
+    (void)final;
+    return false;
+#endif
+}
+
+void ObsWsClient::processRxBuffer()
+{
+    // Incremental decoder: a frame header is consumed as soon as it is complete, then its
+    // payload is decoded in place when it fits in the receive buffer, copied into a message
+    // buffer bounded by Config::maxMessageSize, or handed to onMessageChunk as it arrives.
+    while (transport_ != nullptr)
+    {
+        if (rxMode_ == RxMode::Header)
+        {
+            if (!decodeFrameHeader())
+            {
+                return;
+            }
+            continue;
+        }
+
+        uint8_t *data = rxBuffer_ + rxReadPos_;
+        const size_t buffered = rxWritePos_ - rxReadPos_;
+        const size_t remaining = rxFrame_.length - rxFrame_.received;
+
+        if (rxMode_ == RxMode::Buffered)
+        {
+            if (buffered < rxFrame_.length)
+            {
+                if (rxReadPos_ + rxFrame_.length > rxCapacity_)
+                {
+                    compactRxBuffer();
+                }
+                return;
+            }
+
+            if (rxFrame_.masked)
+            {
+                applyObsWsMask(data, rxFrame_.length, rxFrame_.maskKey, 0);
+            }
+
+            rxMode_ = RxMode::Header;
+            handleIncomingFrame(rxFrame_.opcode, data, rxFrame_.length);
+            consumeRxBuffer(rxFrame_.length);
+            continue;
+        }
+
+        const size_t chunk = std::min(buffered, remaining);
+        if (chunk == 0 && remaining > 0)
+        {
+            return;
+        }
+
+        const size_t frameOffset = rxFrame_.received;
+        rxFrame_.received += chunk;
+        const bool frameComplete = rxFrame_.received == rxFrame_.length;
+        const bool messageComplete = frameComplete && rxFrame_.fin;
+        if (frameComplete)
+        {
+            rxMode_ = RxMode::Header;
+        }
+        if (messageComplete)
+        {
+            rxMessage_.active = false;
+        }
+
+        if (rxFrame_.masked)
+        {
+            applyObsWsMask(data, chunk, rxFrame_.maskKey, frameOffset);
+        }
+
+        const bool appended = rxMessage_.compressed ? inflatePayload(data, chunk, messageComplete) : appendMessageData(data, chunk, messageComplete);
+        if (!appended)
+        {
+            return;
+        }
+        consumeRxBuffer(chunk);
+
+        if (messageComplete && !rxMessage_.streaming)
+        {
+            handleIncomingFrame(rxMessage_.opcode, messageBuffer_, rxMessage_.length);
+            releaseMessageBuffer();
+        }
+    }
+}
+
+bool ObsWsClient::appendMessageData(const uint8_t *data, size_t length, bool final)
+{
+    if (rxMessage_.streaming)
+    {
+        const size_t offset = rxMessage_.length;
+        rxMessage_.length += length;
+        if (length > 0 || final)
+        {
+            const ObsMessageChunk piece{data, length, offset, rxMessage_.totalLength, rxMessage_.opcode == 0x2, final};
+            config_.onMessageChunk(piece);
+        }
+        return true;
+    }
+
+    if (rxMessage_.scanning)
+    {
+        const bool binary = rxMessage_.opcode == 0x2;
+        const bool scanned = binary ? scanMsgPackData(data, length) : scanMessageData(data, length);
+        bool &decoding = binary ? rxPackScan_.decoding : rxScan_.decoding;
+        if (scanned && final && decoding)
+        {
+            // The message ended inside imageData; the buffered rest will not parse.
+            decoding = false;
+            finishResponseStream();
+        }
+        return scanned;
+    }
+
+    return bufferMessageData(data, length);
+}
+
+bool ObsWsClient::bufferMessageData(const uint8_t *data, size_t length)
+{
+    const size_t offset = rxMessage_.length;
+    if (length == 0)
+    {
+        return true;
+    }
+
+    if (length > SIZE_MAX - offset || (config_.maxMessageSize > 0 && offset + length > config_.maxMessageSize))
+    {
+        failConnection(1009, ObsWsError::MessageTooLarge, "OBSWS: Incoming message exceeds maxMessageSize.");
+        return false;
+    }
+
+    if (!ensureMessageBuffer(offset + length))
+    {
+        failConnection(1009, ObsWsError::MessageTooLarge, "OBSWS: Failed to allocate buffer for incoming message.");
+        return false;
+    }
+
+    std::memcpy(messageBuffer_ + offset, data, length);
+    rxMessage_.length += length;
+    return true;
+}
+
+// Bytes outside a streamed imageData string are buffered as usual; the string's contents go
+// to the sink instead, so the buffered message still parses, with imageData empty.
+bool ObsWsClient::scanMessageData(const uint8_t *data, size_t length)
+{
+    const char *text = reinterpret_cast<const char *>(data);
+    size_t run = 0;
+    size_t i = 0;
+    while (i < length)
+    {
+        if (rxScan_.decoding)
+        {
+            size_t end = i;
+            while (end < length && (rxScan_.escape || (text[end] != '"' && text[end] != '\\')))
+            {
+                rxScan_.escape = false;
+                ++end;
+            }
+            feedResponseStream(text + i, end - i);
+            i = end;
+            if (i == length)
+            {
+                run = length;
+                break;
+            }
+            if (text[i] == '\\')
+            {
+                rxScan_.escape = true;
+                ++i;
+                continue;
+            }
+            // The closing quote is buffered and ends the (now empty) string.
+            rxScan_.decoding = false;
+            finishResponseStream();
+            run = i++;
+            continue;
+        }
+
+        if (scanJsonByte(text[i++]))
+        {
+            if (!bufferMessageData(data + run, i - run))
+            {
+                return false;
+            }
+            run = i;
+        }
+    }
+    return rxScan_.decoding || bufferMessageData(data + run, length - run);
+}
+
+// Returns true when `c` opened the imageData string of a response being streamed.
+bool ObsWsClient::scanJsonByte(char c)
+{
+    RxScan &scan = rxScan_;
+    if (scan.inString)
+    {
+        if (scan.escape)
+        {
+            scan.escape = false;
+        }
+        else if (c == '\\')
+        {
+            scan.escape = true;
+            return false;
+        }
+        else if (c == '"')
+        {
+            scan.inString = false;
+            // Texts cut short at the buffer size match nothing.
+            const ObsJsonSlice text{scan.text, scan.textLength <= sizeof(scan.text) ? scan.textLength : size_t{0}};
+            if (scan.isKey && scan.depth < 4)
+            {
+                uint8_t key = kScanOther;
+                if (scan.depth == 1 && text.equals("d"))
+                {
+                    key = kScanData;
+                }
+                else if (scan.depth == 2 && text.equals("requestId"))
+                {
+                    key = kScanRequestId;
+                }
+                else if (scan.depth == 2 && text.equals("responseData"))
+                {
+                    key = kScanResponseData;
+                }
+                else if (scan.depth == 3 && text.equals("imageData"))
+                {
+                    key = kScanImageData;
+                }
+                scan.path[scan.depth] = key;
+            }
+            else if (!scan.isKey && scan.depth == 2 && scan.path[1] == kScanData && scan.path[2] == kScanRequestId)
+            {
+                parseRequestId(text, scan.requestId);
+            }
+            return false;
+        }
+
+        if (scan.textLength < sizeof(scan.text))
+        {
+            scan.text[scan.textLength] = c;
+        }
+        scan.textLength = static_cast<uint8_t>(std::min<size_t>(scan.textLength + 1u, sizeof(scan.text) + 1));
+        return false;
+    }
+
+    const bool inArray = scan.depth < 32 && (scan.arrays & (1u << scan.depth)) != 0;
+    switch (c)
+    {
+    case '{':
+    case '[':
+        ++scan.depth;
+        if (scan.depth < 32)
+        {
+            scan.arrays = c == '[' ? scan.arrays | (1u << scan.depth) : scan.arrays & ~(1u << scan.depth);
+        }
+        scan.expectKey = c == '{';
+        break;
+    case '}':
+    case ']':
+        scan.depth = scan.depth > 0 ? scan.depth - 1 : 0;
+        scan.expectKey = false;
+        break;
+    case ',':
+        scan.expectKey = scan.depth > 0 && !inArray;
+        break;
+    case ':':
+        scan.expectKey = false;
+        break;
+    case '"':
+    {
+        scan.inString = true;
+        scan.isKey = scan.expectKey;
+        scan.textLength = 0;
+        const bool target = !scan.isKey && scan.depth == 3 && (scan.arrays & 0xE) == 0 && scan.path[1] == kScanData &&
+                            scan.path[2] == kScanResponseData && scan.path[3] == kScanImageData;
+        ObsResponseSink sink = nullptr;
+        void *context = nullptr;
+        if (target && scan.requestId != 0 && findPendingSink(scan.requestId, sink, context))
+        {
+            scan.inString = false;
+            scan.decoding = true;
+            beginResponseStream(sink, context);
+            return true;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return false;
+}
+
+// scanMessageData() for MessagePack sessions. Headers are assembled here, since a chunk may
+// end inside one, and buffered once complete; the header of a streamed imageData string is
+// buffered as an empty string and its bytes go to the sink.
+bool ObsWsClient::scanMsgPackData(const uint8_t *data, size_t length)
+{
+    RxPackScan &scan = rxPackScan_;
+    size_t run = 0;
+    size_t i = 0;
+    while (i < length && !scan.lost)
+    {
+        if (scan.payload > 0)
+        {
+            const size_t count = std::min<size_t>(scan.payload, length - i);
+            if (scan.decoding)
+            {
+                feedResponseStream(reinterpret_cast<const char *>(data + i), count);
+                run = i + count;
+            }
+            else if (scan.collecting)
+            {
+                for (size_t k = 0; k < count; ++k)
+                {
+                    if (scan.textLength < sizeof(scan.text))
+                    {
+                        scan.text[scan.textLength] = static_cast<char>(data[i + k]);
+                    }
+                    scan.textLength = static_cast<uint8_t>(std::min<size_t>(scan.textLength + 1u, sizeof(scan.text) + 1));
+                }
+            }
+            i += count;
+            scan.payload -= count;
+            if (scan.payload == 0)
+            {
+                endMsgPackValue();
+            }
+            continue;
+        }
+
+        if (scan.headerLength == 0 && !bufferMessageData(data + run, i - run))
+        {
+            return false;
+        }
+        scan.header[scan.headerLength++] = data[i++];
+        run = i;
+        if (scan.headerLength < msgPackHeaderSize(scan.header[0]))
+        {
+            continue;
+        }
+
+        static const uint8_t kEmptyString = 0xA0;
+        const bool streamed = scanMsgPackHeader();
+        if (!bufferMessageData(streamed ? &kEmptyString : scan.header, streamed ? 1 : scan.headerLength))
+        {
+            return false;
+        }
+        scan.headerLength = 0;
+    }
+    return bufferMessageData(data + run, length - run);
+}
+
+// Returns true when the complete header in rxPackScan_ opened the imageData string of a
+// response being streamed.
+bool ObsWsClient::scanMsgPackHeader()
+{
+    RxPackScan &scan = rxPackScan_;
+    uint32_t length = 0;
+    const PackKind kind = classifyMsgPackHeader(scan.header, scan.headerLength, length);
+    if (kind == PackKind::Invalid)
+    {
+        scan.lost = true;
+        return false;
+    }
+
+    if (scan.skipValues > 0)
+    {
+        --scan.skipValues;
+    }
+    else if (scan.depth == 0)
+    {
+        scan.lost = kind != PackKind::Map;
+        scan.depth = 1;
+        scan.entries[1] = 2 * length;
+        endMsgPackValue();
+        return false;
+    }
+    else
+    {
+        const uint8_t depth = scan.depth;
+        const bool isKey = scan.entries[depth] % 2 == 0;
+        --scan.entries[depth];
+        if (isKey)
+        {
+            scan.path[depth] = kScanOther;
+            scan.collecting = kind == PackKind::String;
+            scan.isKey = true;
+            scan.textLength = 0;
+        }
+        else if (kind == PackKind::Map && scan.path[1] == kScanData && (depth == 1 || (depth == 2 && scan.path[2] == kScanResponseData)))
+        {
+            scan.depth = depth + 1;
+            scan.entries[scan.depth] = 2 * length;
+            endMsgPackValue();
+            return false;
+        }
+        else if (kind == PackKind::String && depth == 2 && scan.path[1] == kScanData && scan.path[2] == kScanRequestId)
+        {
+            scan.collecting = true;
+            scan.isKey = false;
+            scan.textLength = 0;
+        }
+        else if (kind == PackKind::String && depth == 3 && scan.path[1] == kScanData && scan.path[2] == kScanResponseData && scan.path[3] == kScanImageData)
+        {
+            ObsResponseSink sink = nullptr;
+            void *context = nullptr;
+            if (scan.requestId != 0 && findPendingSink(scan.requestId, sink, context))
+            {
+                scan.decoding = true;
+                beginResponseStream(sink, context);
+                scan.payload = length;
+                if (length == 0)
+                {
+                    endMsgPackValue();
+                }
+                return true;
+            }
+        }
+    }
+
+    // Containers nobody looks into are counted through; string bytes are passed over.
+    if (kind == PackKind::Array)
+    {
+        scan.skipValues += length;
+    }
+    else if (kind == PackKind::Map)
+    {
+        scan.skipValues += 2ull * length;
+    }
+    else if (kind == PackKind::String || kind == PackKind::Bytes)
+    {
+        scan.payload = length;
+    }
+    if (scan.payload == 0)
+    {
+        endMsgPackValue();
+    }
+    return false;
+}
+
+// Called as each value ends: finishes a streamed or collected string and leaves the maps it
+// completed.
+void ObsWsClient::endMsgPackValue()
+{
+    RxPackScan &scan = rxPackScan_;
+    if (scan.decoding)
+    {
+        scan.decoding = false;
+        finishResponseStream();
+    }
+    if (scan.collecting)
+    {
+        scan.collecting = false;
+        const ObsJsonSlice text{scan.text, scan.textLength <= sizeof(scan.text) ? scan.textLength : size_t{0}};
+        if (!scan.isKey)
+        {
+            parseRequestId(text, scan.requestId);
+        }
+        else if (scan.depth == 1 && text.equals("d"))
+        {
+            scan.path[1] = kScanData;
+        }
+        else if (scan.depth == 2 && text.equals("requestId"))
+        {
+            scan.path[2] = kScanRequestId;
+        }
+        else if (scan.depth == 2 && text.equals("responseData"))
+        {
+            scan.path[2] = kScanResponseData;
+        }
+        else if (scan.depth == 3 && text.equals("imageData"))
+        {
+            scan.path[3] = kScanImageData;
+        }
+    }
+    while (scan.skipValues == 0 && scan.depth > 0 && scan.entries[scan.depth] == 0)
+    {
+        --scan.depth;
+    }
+}
+
+// Responses to requests with a callback, state cache seed replies and the handshake are
+// parsed by the client, so they must be assembled rather than streamed.
+bool ObsWsClient::awaitingInternalReply() const
+{
+    return handshakeState_ != HandshakeState::Established || pendingCount_.load() > 0 || stateSeedPending_ > 0;
+}
+
+bool ObsWsClient::hasPendingSink()
+{
+    if (pendingCount_.load() == 0)
+    {
+        return false;
+    }
+
+    bool found = false;
+    portENTER_CRITICAL(&pendingLock_);
+    for (size_t i = 0; i < pendingCapacity_ && !found; ++i)
+    {
+        found = pendingRequests_[i].id != 0 && pendingRequests_[i].sink != nullptr;
+    }
+    portEXIT_CRITICAL(&pendingLock_);
+    return found;
+}
+
+// Looks the entry up without taking it; the response completes it once fully received.
+bool ObsWsClient::findPendingSink(uint32_t id, ObsResponseSink &sink, void *&context)
+{
+    portENTER_CRITICAL(&pendingLock_);
+    const PendingRequest *slot = pendingCount_ > 0 ? &pendingRequests_[id % pendingCapacity_] : nullptr;
+    const bool found = slot != nullptr && slot->id == id && slot->sink != nullptr;
+    if (found)
+    {
+        sink = slot->sink;
+        context = slot->context;
+    }
+    portEXIT_CRITICAL(&pendingLock_);
+    return found;
+}
+
+void ObsWsClient::beginResponseStream(ObsResponseSink sink, void *context)
+{
+    responseStream_.sink = sink;
+    responseStream_.context = context;
+    responseStream_.bits = 0;
+    responseStream_.bitCount = 0;
+    responseStream_.charsSeen = 0;
+    responseStream_.chunkLength = 0;
+}
+
+// Characters outside the base64 alphabet (padding, escapes, whitespace) are skipped. A comma
+// near the start ends a data: URI prefix ("data:image/png;base64,"), and whatever it decoded
+// to is discarded; it is well short of a chunk, so none of it has reached the sink yet.
+void ObsWsClient::feedResponseStream(const char *data, size_t length)
+{
+    ResponseStream &stream = responseStream_;
+    for (size_t i = 0; i < length; ++i)
+    {
+        const int value = base64Value(data[i]);
+        ++stream.charsSeen;
+        if (value < 0)
+        {
+            if (data[i] == ',' && stream.charsSeen <= kMaxDataUriPrefix)
+            {
+                stream.bits = 0;
+                stream.bitCount = 0;
+                stream.chunkLength = 0;
+            }
+            continue;
+        }
+
+        stream.bits = (stream.bits << 6) | static_cast<uint32_t>(value);
+        stream.bitCount += 6;
+        if (stream.bitCount >= 8)
+        {
+            stream.bitCount -= 8;
+            stream.chunk[stream.chunkLength++] = static_cast<uint8_t>(stream.bits >> stream.bitCount);
+            if (stream.chunkLength == sizeof(stream.chunk))
+            {
+                stream.sink(stream.chunk, stream.chunkLength, stream.context);
+                stream.chunkLength = 0;
+            }
+        }
+    }
+}
+
+void ObsWsClient::finishResponseStream()
+{
+    ResponseStream &stream = responseStream_;
+    if (stream.sink != nullptr && stream.chunkLength > 0)
+    {
+        stream.sink(stream.chunk, stream.chunkLength, stream.context);
+    }
+    stream.sink = nullptr;
+    stream.context = nullptr;
+    stream.chunkLength = 0;
+}
+
+bool ObsWsClient::decodeFrameHeader()
+{
+    const uint8_t *frame = rxBuffer_ + rxReadPos_;
+    const size_t buffered = rxWritePos_ - rxReadPos_;
+    if (buffered < 2)
+    {
+        if (rxReadPos_ + kMaxFrameHeaderSize > rxCapacity_)
+        {
+            compactRxBuffer();
+        }
+        return false;
+    }
+
+    const uint8_t byte0 = frame[0];
+    const uint8_t byte1 = frame[1];
+    const bool fin = (byte0 & 0x80U) != 0;
+    const bool compressed = (byte0 & 0x40U) != 0;
+    const uint8_t opcode = byte0 & 0x0FU;
+    const bool masked = (byte1 & 0x80U) != 0;
+    uint64_t payloadLen = byte1 & 0x7FU;
+    size_t index = 2;
+
+    size_t headerLen = index + (masked ? 4 : 0);
+    if (payloadLen == 126)
+    {
+        headerLen += 2;
+    }
+    else if (payloadLen == 127)
+    {
+        headerLen += 8;
+    }
+
+    if (buffered < headerLen)
+    {
+        if (rxReadPos_ + kMaxFrameHeaderSize > rxCapacity_)
+        {
+            compactRxBuffer();
+        }
+        return false;
+    }
+
+    if (payloadLen == 126)
+    {
+        payloadLen = (static_cast<uint64_t>(frame[index]) << 8) | frame[index + 1];
+        index += 2;
+    }
+    else if (payloadLen == 127)
+    {
+        payloadLen = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            payloadLen = (payloadLen << 8) | frame[index + i];
+        }
+        index += 8;
+    }
+
+    rxFrame_ = RxFrame{};
+    rxFrame_.opcode = opcode;
+    rxFrame_.fin = fin;
+    rxFrame_.masked = masked;
+    if (masked)
+    {
+        std::memcpy(rxFrame_.maskKey, frame + index, sizeof(rxFrame_.maskKey));
+        index += 4;
+    }
+
+    if (payloadLen > SIZE_MAX)
+    {
+        failConnection(1009, ObsWsError::MessageTooLarge, "OBSWS: Incoming frame length is not addressable.");
+        return false;
+    }
+    rxFrame_.length = static_cast<size_t>(payloadLen);
+    consumeRxBuffer(index);
+
+    // RSV1 marks the first frame of a permessage-deflate message; every other reserved
+    // bit, and RSV1 anywhere else, is a protocol violation.
+    if ((byte0 & 0x30U) != 0 || (compressed && (!compressionActive_ || opcode == 0x0 || (opcode & 0x08U) != 0)))
+    {
+        failConnection(1002, ObsWsError::ProtocolError, "OBSWS: Unexpected reserved bits in frame header.");
+        return false;
+    }
+
+    // Control frames may arrive between the fragments of a message; they are always
+    // small and unfragmented, so they are decoded in place without touching rxMessage_.
+    if ((opcode & 0x08U) != 0)
+    {
+        if (!fin || rxFrame_.length > 125)
+        {
+            failConnection(1002, ObsWsError::ProtocolError, "OBSWS: Invalid control frame.");
+            return false;
+        }
+        rxMode_ = RxMode::Buffered;
+        return true;
+    }
+
+    const bool continuation = opcode == 0x0;
+    if (continuation != rxMessage_.active)
+    {
+        failConnection(1002, ObsWsError::ProtocolError, continuation ? "OBSWS: Continuation frame without a message in progress." : "OBSWS: New message started before the previous one completed.");
+        return false;
+    }
+
+    if (!continuation)
+    {
+        rxMessage_ = RxMessage{};
+        rxMessage_.opcode = opcode;
+        rxMessage_.fragmented = !fin;
+        rxMessage_.compressed = compressed;
+        rxMessage_.totalLength = (fin && !compressed) ? rxFrame_.length : 0;
+        rxMessage_.active = true;
+
+#if OBSWS_HAS_INFLATE
+        if (compressed)
+        {
+            tinfl_init(static_cast<tinfl_decompressor *>(inflater_));
+        }
+#endif
+
+        // Messages larger than the receive buffer may hold a streamed screenshot; those are
+        // scanned instead, and only what they buffer counts against maxMessageSize. They are
+        // only handed to onMessageChunk while no reply the client parses itself is due, since
+        // a streamed response would never reach its callback or the state cache.
+        const bool inPlace = fin && !compressed && rxFrame_.length <= rxCapacity_;
+        rxMessage_.streaming = !inPlace && config_.onMessageChunk != nullptr && (fin || config_.streamFragments) && !awaitingInternalReply();
+        rxMessage_.scanning = !inPlace && !rxMessage_.streaming && (opcode == 0x1 || (opcode == 0x2 && msgPackActive_)) && hasPendingSink();
+        if (rxMessage_.scanning)
+        {
+            rxScan_ = RxScan{};
+            rxPackScan_ = RxPackScan{};
+        }
+
+        if (fin && !compressed && !rxMessage_.streaming && !rxMessage_.scanning && config_.maxMessageSize > 0 && rxFrame_.length > config_.maxMessageSize)
+        {
+            failConnection(1009, ObsWsError::MessageTooLarge, "OBSWS: Incoming message exceeds maxMessageSize.");
+            return false;
+        }
+
+        if (inPlace)
+        {
+            rxMessage_.active = false;
+            rxMode_ = RxMode::Buffered;
+            return true;
+        }
+    }
+
+    rxMode_ = RxMode::Payload;
+    if (rxMessage_.streaming || rxMessage_.compressed || rxMessage_.scanning)
+    {
+        // Inflated size is only known as output is produced; appendMessageData enforces
+        // maxMessageSize on the decompressed bytes.
+        return true;
+    }
+
+    if (rxFrame_.length > SIZE_MAX - rxMessage_.length || (config_.maxMessageSize > 0 && rxMessage_.length + rxFrame_.length > config_.maxMessageSize))
+    {
+        failConnection(1009, ObsWsError::MessageTooLarge, "OBSWS: Incoming message exceeds maxMessageSize.");
+        return false;
+    }
+
+    if (!ensureMessageBuffer(rxMessage_.length + rxFrame_.length))
+    {
+        failConnection(1009, ObsWsError::MessageTooLarge, "OBSWS: Failed to allocate buffer for incoming message.");
+        return false;
+    }
+
+    return true;
+}
+
+bool ObsWsClient::ensureMessageBuffer(size_t capacity)
+{
+    if (messageBuffer_ != nullptr && messageCapacity_ >= capacity)
+    {
+        return true;
+    }
+
+    // Fragmented and compressed messages grow geometrically (capped by maxMessageSize) so a message split
+    // into many small fragments does not reallocate on every one of them.
+    size_t target = capacity;
+    if (rxMessage_.fragmented || rxMessage_.compressed)
+    {
+        target = std::max(capacity, messageCapacity_ * 2);
+        if (config_.maxMessageSize > 0)
+        {
+            target = std::min(target, std::max(capacity, config_.maxMessageSize));
+        }
+    }
+
+    // As in ensureRxBuffer(), one spare byte past the capacity for in-place termination.
+    uint8_t *grown = static_cast<uint8_t *>(std::realloc(messageBuffer_, target + 1));
+    if (grown == nullptr)
+    {
+        return false;
+    }
+
+    messageBuffer_ = grown;
+    messageCapacity_ = target;
+    return true;
+}
+
+void ObsWsClient::releaseMessageBuffer()
+{
+    std::free(messageBuffer_);
+    messageBuffer_ = nullptr;
+    messageCapacity_ = 0;
+}
+
+void ObsWsClient::resetRxDecoder()
+{
+    rxMode_ = RxMode::Header;
+    rxFrame_ = RxFrame{};
+    rxMessage_ = RxMessage{};
+    rxReadPos_ = 0;
+    rxWritePos_ = 0;
+    releaseMessageBuffer();
+    std::free(rxJson_);
+    rxJson_ = nullptr;
+    rxJsonCapacity_ = 0;
+}
+
+void ObsWsClient::failConnection(uint16_t closeCode, ObsWsError error, const char *message)
+{
+    emitLog(message);
+
+    const uint8_t reason[2] = {static_cast<uint8_t>(closeCode >> 8), static_cast<uint8_t>(closeCode & 0xFF)};
+    sendControlFrame(0x8, reason, sizeof(reason));
+
+    emitError(error);
+    ensureTransportStopped();
+    handshakeState_ = HandshakeState::Idle;
+    resetRxDecoder();
+}
+
+void ObsWsClient::handleIncomingFrame(uint8_t opcode, uint8_t *payload, size_t length)
+{
+    switch (opcode)
+    {
+    case 0x1: // Text
+        handleTextMessage(reinterpret_cast<const char *>(payload), length);
+        break;
+    case 0x2: // Binary
+        if (!msgPackActive_)
+        {
+            emitLog("OBSWS: Ignoring binary frame outside a MessagePack session.");
+            break;
+        }
+        handleMsgPackMessage(payload, length);
+        break;
+    case 0x8: // Close
+        emitLog("OBSWS: Close frame received from server.");
+        sendControlFrame(0x8, nullptr, 0);
+        ensureTransportStopped();
+        handshakeState_ = HandshakeState::Idle;
+        changeStatus(ObsWsStatus::Disconnected);
+        break;
+    case 0x9: // Ping
+        handlePingFrame(payload, length);
+        break;
+    case 0xA: // Pong
+        break;
+    default:
+        emitLog("OBSWS: Unsupported frame opcode received.");
+        break;
+    }
+}
+
+void ObsWsClient::handleTextMessage(const char *text, size_t length)
+{
+    ObsWsMessage message;
+    if (text == nullptr || !parseObsWsMessage(text, length, message))
+    {
+        emitLog("OBSWS: Failed to parse incoming JSON.");
+        return;
+    }
+
+    if (message.op < 0 || message.data.empty())
+    {
+        emitLog("OBSWS: Incoming message missing op or data.");
+        return;
+    }
+    routeMessage(message);
+}
+
+// MessagePack messages are routed straight from the frame: the envelope fields are read into
+// an ObsWsMessage and the payload members stay encoded in rxPacked_ while the message is
+// handled. JSON is only rendered for what needs it as text: the data of events and responses
+// the state cache applies and, with Config::msgPackJsonPayloads, the payloads callbacks get.
+void ObsWsClient::handleMsgPackMessage(const uint8_t *payload, size_t length)
+{
+    ObsWsMessage message;
+    ObsWsMsgPackData packed;
+    if (payload == nullptr || !parseObsWsMsgPackMessage(payload, length, message, packed))
+    {
+        emitLog("OBSWS: Failed to decode incoming MessagePack.");
+        return;
+    }
+
+    if (message.op < 0 || packed.data.empty())
+    {
+        emitLog("OBSWS: Incoming message missing op or data.");
+        return;
+    }
+    rxPacked_ = &packed;
+    routeMessage(message);
+    rxPacked_ = nullptr;
+}
+
+void ObsWsClient::routeMessage(const ObsWsMessage &message)
+{
+    switch (message.op)
+    {
+    case 0:
+        handleHelloMessage(message);
+        break;
+    case 2:
+        handleIdentifiedMessage();
+        break;
+    case 5:
+        handleEventMessage(message);
+        break;
+    case 7:
+        handleRequestResponse(message);
+        break;
+    case 9:
+        handleRequestBatchResponse(message);
+        break;
+    default:
+        emitLog("OBSWS: Ignoring unsupported opcode.");
+        break;
+    }
+}
+
+// Renders one MessagePack value as JSON into rxJson_, which keeps its size until the
+// connection is reset. The result is valid until the next rendering; empty on failure.
+ObsJsonSlice ObsWsClient::renderJson(const ObsMsgPackSlice &value)
+{
+    for (;;)
+    {
+        ObsJsonWriter json(rxJson_, rxJsonCapacity_);
+        if (!writeObsMsgPackAsJson(value, json))
+        {
+            emitLog("OBSWS: Failed to render MessagePack as JSON.");
+            return ObsJsonSlice();
+        }
+        if (!json.overflowed())
+        {
+            return ObsJsonSlice{json.data(), json.length()};
+        }
+
+        char *grown = static_cast<char *>(std::realloc(rxJson_, json.required()));
+        if (grown == nullptr)
+        {
+            emitLog("OBSWS: Failed to allocate MessagePack rendering buffer.");
+            return ObsJsonSlice();
+        }
+        rxJson_ = grown;
+        rxJsonCapacity_ = json.required();
+    }
+}
+
+// The JSON handed to callbacks alongside `raw`: rendered from it in MessagePack sessions, or
+// left out there when Config::msgPackJsonPayloads is off.
+ObsJsonSlice ObsWsClient::deliveredJson(const ObsJsonSlice &json, const ObsMsgPackSlice &raw)
+{
+    if (raw.empty())
+    {
+        return json;
+    }
+    return config_.msgPackJsonPayloads ? renderJson(raw) : ObsJsonSlice();
+}
+
+void ObsWsClient::handlePingFrame(const uint8_t *payload, size_t length)
+{
+    if (!sendControlFrame(0xA, payload, length))
+    {
+        emitLog("OBSWS: Failed to send pong response.");
+    }
+}
+
+void ObsWsClient::handleHelloMessage(const ObsWsMessage &message)
+{
+    if (handshakeState_ != HandshakeState::AwaitHello)
+    {
+        return;
+    }
+
+    if (message.rpcVersion == 0)
+    {
+        emitLog("OBSWS: Hello message missing rpcVersion.");
+        emitError(ObsWsError::HandshakeRejected);
+        return;
+    }
+
+    char challenge[kAuthFieldBufferSize] = {0};
+    char salt[kAuthFieldBufferSize] = {0};
+    if (!copySlice(message.challenge, challenge, sizeof(challenge)) || !copySlice(message.salt, salt, sizeof(salt)))
+    {
+        emitLog("OBSWS: Hello authentication fields too long.");
+        emitError(ObsWsError::AuthenticationFailed);
+        return;
+    }
+
+    const bool authRequired = !message.challenge.empty() && !message.salt.empty();
+    if (!sendIdentifyMessage(message.rpcVersion, authRequired ? challenge : nullptr, authRequired ? salt : nullptr))
+    {
+        emitError(ObsWsError::AuthenticationFailed);
+        return;
+    }
+
+    handshakeState_ = HandshakeState::AwaitIdentifyResponse;
+}
+
+void ObsWsClient::handleIdentifiedMessage()
+{
+    if (handshakeState_ == HandshakeState::Established)
+    {
+        acknowledgeSubscriptions();
+        emitLog("OBSWS: Reidentify acknowledged.");
+        return;
+    }
+
+    if (handshakeState_ != HandshakeState::AwaitIdentifyResponse)
+    {
+        return;
+    }
+
+    acknowledgeSubscriptions();
+    handshakeState_ = HandshakeState::Established;
+    changeStatus(ObsWsStatus::Connected);
+    emitLog("OBSWS: Handshake complete.");
+
+    // A reidentify() made while Identify was in flight is sent now.
+    portENTER_CRITICAL(&subscriptionLock_);
+    const uint64_t requested = requestedSubscriptions_;
+    const bool changed = (requested | (config_.enableStateCache ? kStateCacheSubscriptions : 0)) != sentSubscriptions_;
+    portEXIT_CRITICAL(&subscriptionLock_);
+    if (changed)
+    {
+        reidentify(requested);
+    }
+
+    if (config_.enableStateCache)
+    {
+        seedStateCache();
+    }
+}
+
+void ObsWsClient::handleEventMessage(const ObsWsMessage &message)
+{
+    static const ObsJsonSlice kUnknownEvent{"unknown", 7};
+    const ObsJsonSlice &eventType = message.eventType.empty() ? kUnknownEvent : message.eventType;
+    const ObsEventType type = findObsEventType(message.eventType.data, message.eventType.length);
+    const ObsMsgPackSlice raw = rxPacked_ != nullptr ? rxPacked_->eventData : ObsMsgPackSlice();
+    if (type == ObsEventType::InputVolumeMeters && config_.onVolumeMeters != nullptr)
+    {
+        handleVolumeMeters(message.eventData, raw);
+        return;
+    }
+    if (config_.enableStateCache && (raw.empty() || ObsStateCache::tracks(type)))
+    {
+        applyStateEvent(type, raw.empty() ? message.eventData : renderJson(raw));
+    }
+    if (config_.onEvent == nullptr && !isEventRouted(type))
+    {
+        portENTER_CRITICAL(&eventRingLock_);
+        ++stats_.eventsFiltered;
+        portEXIT_CRITICAL(&eventRingLock_);
+        return;
+    }
+
+    ObsEventNames names;
+    resolveEventNames(message.eventData, raw, names);
+    dispatchEvent(eventType, message.eventData, raw, false, type, names);
+}
+
+// On the network task the levels wait for poll(), replacing any that were not delivered yet;
+// otherwise this already runs inside poll() and they are delivered at once. Each buffer holds
+// references to its input names until its levels are delivered or replaced.
+void ObsWsClient::handleVolumeMeters(const ObsJsonSlice &eventData, const ObsMsgPackSlice &raw)
+{
+    const size_t count = raw.empty() ? decodeObsVolumeMeters(eventData, names_, meterDecode_, meterCapacity_)
+                                     : decodeObsVolumeMeters(raw, names_, meterDecode_, meterCapacity_);
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (!onNetworkTask())
+    {
+        config_.onVolumeMeters(meterDecode_, count);
+        releaseObsVolumeMeters(names_, meterDecode_, count);
+        return;
+    }
+
+    portENTER_CRITICAL(&meterLock_);
+    const size_t replaced = meterPendingReady_ ? meterPendingCount_ : 0;
+    std::swap(meterDecode_, meterPending_);
+    meterPendingCount_ = count;
+    meterPendingReady_ = true;
+    portEXIT_CRITICAL(&meterLock_);
+    releaseObsVolumeMeters(names_, meterDecode_, replaced);
+}
 
-    if (acceptHeader.empty())
+void ObsWsClient::deliverVolumeMeters()
+{
+    portENTER_CRITICAL(&meterLock_);
+    const bool ready = meterPendingReady_;
+    const size_t count = meterPendingCount_;
+    if (ready)
     {
-        emitLog("OBSWS: Handshake missing Sec-WebSocket-Accept header.");
-        emitError(ObsWsError::HandshakeRejected);
-        ensureTransportStopped();
-        handshakeState_ = HandshakeState::Idle;
-        return false;
+        std::swap(meterPending_, meterDeliver_);
+        meterPendingReady_ = false;
     }
+    portEXIT_CRITICAL(&meterLock_);
 
-    char expectedAccept[64] = {0};
-    if (!computeAcceptKey(expectedAccept, sizeof(expectedAccept)))
+    if (!ready)
     {
-        emitLog("OBSWS: Failed to compute handshake digest.");
-        emitError(ObsWsError::HandshakeRejected);
-        ensureTransportStopped();
-        handshakeState_ = HandshakeState::Idle;
-        return false;
+        return;
+    }
+    if (config_.onVolumeMeters != nullptr)
+    {
+        config_.onVolumeMeters(meterDeliver_, count);
     }
+    releaseObsVolumeMeters(names_, meterDeliver_, count);
+}
 
-    if (acceptHeader != expectedAccept)
+bool ObsWsClient::ensureMeterBuffers()
+{
+    const size_t capacity = config_.onVolumeMeters != nullptr ? config_.maxMeterInputs : 0;
+    if (capacity == meterCapacity_ && (capacity == 0 || meterBuffer_ != nullptr))
     {
-        emitLog("OBSWS: Sec-WebSocket-Accept mismatch.");
-        emitError(ObsWsError::HandshakeRejected);
-        ensureTransportStopped();
-        handshakeState_ = HandshakeState::Idle;
-        return false;
+        return true;
     }
 
-    if (!remaining.empty())
+    std::free(meterBuffer_);
+    meterBuffer_ = nullptr;
+    meterCapacity_ = 0;
+    meterDecode_ = nullptr;
+    meterPending_ = nullptr;
+    meterDeliver_ = nullptr;
+    meterPendingReady_ = false;
+    if (capacity == 0)
     {
-        rxBuffer_.insert(rxBuffer_.end(), remaining.begin(), remaining.end());
+        return true;
     }
 
-    handshakeBuffer_.clear();
-    emitLog("OBSWS: WebSocket upgrade acknowledged.");
+    meterBuffer_ = static_cast<ObsInputMeter *>(std::malloc(3 * capacity * sizeof(ObsInputMeter)));
+    if (meterBuffer_ == nullptr)
+    {
+        return false;
+    }
+    meterCapacity_ = capacity;
+    meterDecode_ = meterBuffer_;
+    meterPending_ = meterBuffer_ + capacity;
+    meterDeliver_ = meterBuffer_ + 2 * capacity;
     return true;
 }
 
-void ObsWsClient::processRxBuffer()
+// One pass over the top-level members; names nobody interned are looked up but not stored.
+void ObsWsClient::resolveEventNames(const ObsJsonSlice &eventData, const ObsMsgPackSlice &raw, ObsEventNames &names) const
 {
-    while (rxBuffer_.size() >= 2)
+    if (names_.size() == 0)
     {
-        const uint8_t byte0 = rxBuffer_[0];
-        const uint8_t byte1 = rxBuffer_[1];
-        const bool fin = (byte0 & 0x80U) != 0;
-        const uint8_t opcode = byte0 & 0x0FU;
-        const bool masked = (byte1 & 0x80U) != 0;
-        uint64_t payloadLen = byte1 & 0x7FU;
-        size_t index = 2;
-
-        if (!fin)
-        {
-            emitLog("OBSWS: Fragmented frames are not supported.");
-            emitError(ObsWsError::NotImplemented);
-            return;
-        }
+        return;
+    }
+    if (!raw.empty())
+    {
+        resolveEventNames(raw, names);
+        return;
+    }
 
-        if (payloadLen == 126)
+    ObsJsonReader reader(eventData);
+    ObsJsonSlice key;
+    ObsJsonSlice value;
+    if (!reader.beginObject())
+    {
+        return;
+    }
+    while (reader.nextMember(key))
+    {
+        ObsNameHandle *handle = key.equals("sceneName") ? &names.scene : key.equals("inputName") ? &names.input : key.equals("sourceName") ? &names.source : nullptr;
+        if (handle == nullptr)
         {
-            if (rxBuffer_.size() < index + 2)
+            if (!reader.skipValue())
             {
                 return;
             }
-            payloadLen = (static_cast<uint64_t>(rxBuffer_[index]) << 8) | rxBuffer_[index + 1];
-            index += 2;
+            continue;
         }
-        else if (payloadLen == 127)
+        if (!reader.readString(value))
         {
-            if (rxBuffer_.size() < index + 8)
-            {
-                return;
-            }
-            payloadLen = 0;
-            for (int i = 0; i < 8; ++i)
-            {
-                payloadLen = (payloadLen << 8) | rxBuffer_[index + i];
-            }
-            index += 8;
+            return;
         }
+        *handle = names_.findJson(value);
+    }
+}
 
-        uint8_t maskKey[4] = {0, 0, 0, 0};
-        if (masked)
+void ObsWsClient::resolveEventNames(const ObsMsgPackSlice &eventData, ObsEventNames &names) const
+{
+    ObsMsgPackReader reader(eventData);
+    uint32_t count = 0;
+    if (!reader.readMap(count))
+    {
+        return;
+    }
+    ObsMsgPackSlice key;
+    ObsMsgPackSlice value;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ObsNameHandle *handle = nullptr;
+        if (reader.readString(key))
         {
-            if (rxBuffer_.size() < index + 4)
-            {
-                return;
-            }
-            for (int i = 0; i < 4; ++i)
-            {
-                maskKey[i] = rxBuffer_[index + i];
-            }
-            index += 4;
+            handle = key.equals("sceneName") ? &names.scene : key.equals("inputName") ? &names.input : key.equals("sourceName") ? &names.source : nullptr;
         }
-
-        if (rxBuffer_.size() < index + payloadLen)
+        else if (!reader.skipValue())
         {
             return;
         }
-
-        uint8_t *payload = rxBuffer_.data() + index;
-        if (masked)
+        if (handle == nullptr || !reader.readString(value))
         {
-            for (uint64_t i = 0; i < payloadLen; ++i)
+            if (!reader.skipValue())
             {
-                payload[i] = static_cast<uint8_t>(payload[i] ^ maskKey[i % 4]);
+                return;
             }
+            continue;
         }
+        *handle = names_.findDecoded(reinterpret_cast<const char *>(value.data), value.length);
+    }
+}
 
-        handleIncomingFrame(opcode, payload, static_cast<size_t>(payloadLen));
-        rxBuffer_.erase(rxBuffer_.begin(), rxBuffer_.begin() + index + static_cast<size_t>(payloadLen));
+void ObsWsClient::handleRequestResponse(const ObsWsMessage &message)
+{
+    const ObsMsgPackSlice rawResponseData = rxPacked_ != nullptr ? rxPacked_->responseData : ObsMsgPackSlice();
+    if (handleStateResponse(message, false) || completePendingRequest(message, rawResponseData))
+    {
+        return;
     }
+
+    // Responses nobody is waiting on forward the whole "d" object verbatim so callers see
+    // requestStatus and responseData exactly as OBS sent them.
+    static const ObsJsonSlice kUnknownRequest{"unknown-request", 15};
+    const ObsJsonSlice &requestId = message.requestId.empty() ? kUnknownRequest : message.requestId;
+    dispatchEvent(requestId, message.data, rxPacked_ != nullptr ? rxPacked_->data : ObsMsgPackSlice(), true);
 }
 
-void ObsWsClient::handleIncomingFrame(uint8_t opcode, const uint8_t *payload, size_t length)
+void ObsWsClient::handleRequestBatchResponse(const ObsWsMessage &message)
 {
-    switch (opcode)
+    if (handleStateResponse(message, true))
     {
-    case 0x1: // Text
+        return;
+    }
+
+    bool unclaimed = false;
+    if (!forEachBatchResult(message, [&](const ObsWsMessage &result, const ObsMsgPackSlice &rawResponseData)
+                            { unclaimed = !completePendingRequest(result, rawResponseData) || unclaimed; }))
     {
-        char *jsonBuffer = static_cast<char *>(std::malloc(length + 1));
-        if (jsonBuffer == nullptr)
-        {
-            emitLog("OBSWS: Failed to allocate buffer for incoming message.");
-            return;
-        }
-        if (payload != nullptr && length > 0)
-        {
-            std::memcpy(jsonBuffer, payload, length);
-        }
-        jsonBuffer[length] = '\0';
+        emitLog("OBSWS: Malformed RequestBatchResponse result.");
+    }
 
-        cJSON *root = cJSON_ParseWithLength(jsonBuffer, length);
-        std::free(jsonBuffer);
+    uint32_t batchId = 0;
+    if (parseRequestId(message.requestId, batchId))
+    {
+        releaseBatchRequests(batchId, true);
+    }
 
-        if (root == nullptr)
-        {
-            emitLog("OBSWS: Failed to parse incoming JSON.");
-            return;
-        }
+    if (unclaimed)
+    {
+        static const ObsJsonSlice kUnknownRequest{"unknown-request", 15};
+        const ObsJsonSlice &requestId = message.requestId.empty() ? kUnknownRequest : message.requestId;
+        dispatchEvent(requestId, message.data, rxPacked_ != nullptr ? rxPacked_->data : ObsMsgPackSlice(), true);
+    }
+}
 
-        cJSON *opNode = cJSON_GetObjectItemCaseSensitive(root, "op");
-        cJSON *dataNode = cJSON_GetObjectItemCaseSensitive(root, "d");
-        if (!cJSON_IsNumber(opNode) || dataNode == nullptr)
+// Calls visit(result, rawResponseData) for each entry of a RequestBatchResponse, reading the
+// MessagePack results directly in MessagePack sessions. False when an entry is malformed.
+template <typename Visit>
+bool ObsWsClient::forEachBatchResult(const ObsWsMessage &message, Visit visit)
+{
+    ObsWsMessage result;
+    if (rxPacked_ != nullptr)
+    {
+        ObsMsgPackReader reader(rxPacked_->results);
+        ObsWsMsgPackData packed;
+        uint32_t count = 0;
+        reader.readArray(count);
+        for (uint32_t i = 0; i < count; ++i)
         {
-            cJSON_Delete(root);
-            emitLog("OBSWS: Incoming message missing op or data.");
-            return;
+            if (!parseObsWsMsgPackRequestResult(reader, result, packed))
+            {
+                return false;
+            }
+            visit(result, packed.responseData);
         }
+        return true;
+    }
 
-        const int messageOpcode = opNode->valueint;
-        switch (messageOpcode)
+    ObsJsonReader reader(message.results);
+    if (reader.beginArray())
+    {
+        while (reader.nextElement())
         {
-        case 0:
-            handleHelloMessage(dataNode);
-            break;
-        case 2:
-            handleIdentifiedMessage();
-            break;
-        case 5:
-            handleEventMessage(dataNode);
-            break;
-        case 7:
-            handleRequestResponse(dataNode);
-            break;
-        default:
-            emitLog("OBSWS: Ignoring unsupported opcode.");
-            break;
+            if (!parseObsWsRequestResult(reader, result))
+            {
+                return false;
+            }
+            visit(result, ObsMsgPackSlice());
         }
-
-        cJSON_Delete(root);
-        break;
-    }
-    case 0x8: // Close
-        emitLog("OBSWS: Close frame received from server.");
-        sendControlFrame(0x8, nullptr, 0);
-        ensureTransportStopped();
-        handshakeState_ = HandshakeState::Idle;
-        changeStatus(ObsWsStatus::Disconnected);
-        break;
-    case 0x9: // Ping
-        handlePingFrame(payload, length);
-        break;
-    case 0xA: // Pong
-        break;
-    default:
-        emitLog("OBSWS: Unsupported frame opcode received.");
-        break;
     }
+    return true;
 }
 
-void ObsWsClient::handlePingFrame(const uint8_t *payload, size_t length)
+void ObsWsClient::dispatchEvent(const ObsJsonSlice &id, const ObsJsonSlice &payload, const ObsMsgPackSlice &raw, bool response, ObsEventType type, const ObsEventNames &names)
 {
-    if (!sendControlFrame(0xA, payload, length))
+    if (!config_.deliverEventsInline)
     {
-        emitLog("OBSWS: Failed to send pong response.");
+        enqueueEvent(id, payload, raw, response, type, names);
+        return;
     }
+
+    const ObsJsonSlice json = deliveredJson(payload, raw);
+    const ScopedTerminator idEnd(id);
+    const ScopedTerminator jsonEnd(json);
+    const ObsEvent event{id.data != nullptr ? id.data : "", json.data != nullptr ? json.data : "", json.length, type, names, raw};
+    deliverEvent(event, type);
 }
 
-void ObsWsClient::handleHelloMessage(cJSON *dataNode)
+// The cache is rebuilt from scratch on every Identify and scene collection change: scene and
+// input lists come first in one batch, mute states and scene items follow once the names are
+// known. Responses are applied on the socket side like events, so the cache sees the snapshot
+// and later changes in the order OBS sent them.
+void ObsWsClient::seedStateCache()
 {
-    if (dataNode == nullptr || handshakeState_ != HandshakeState::AwaitHello)
+    state_.clear();
+    ++stateGeneration_;
+    stateSeedPending_ = 0;
+
+    char batchId[kStateRequestIdSize];
+    char scenesId[kStateRequestIdSize];
+    char inputsId[kStateRequestIdSize];
+    formatStateRequestId(batchId, stateGeneration_, "seed");
+    formatStateRequestId(scenesId, stateGeneration_, "scenes");
+    formatStateRequestId(inputsId, stateGeneration_, "inputs");
+
+    const bool sent = sendJsonMessage([&](ObsJsonWriter &json)
     {
-        return;
-    }
+        json.beginObject();
+        json.key("op");
+        json.integer(8);
+        json.key("d");
+        json.beginObject();
+        json.key("requestId");
+        json.string(batchId);
+        json.key("requests");
+        json.beginArray();
+        json.beginObject();
+        json.key("requestType");
+        json.string("GetSceneList");
+        json.key("requestId");
+        json.string(scenesId);
+        json.endObject();
+        json.beginObject();
+        json.key("requestType");
+        json.string("GetInputList");
+        json.key("requestId");
+        json.string(inputsId);
+        json.endObject();
+        json.endArray();
+        json.endObject();
+        json.endObject();
+    });
 
-    cJSON *rpcNode = cJSON_GetObjectItemCaseSensitive(dataNode, "rpcVersion");
-    if (!cJSON_IsNumber(rpcNode))
+    if (!sent)
     {
-        emitLog("OBSWS: Hello message missing rpcVersion.");
-        emitError(ObsWsError::HandshakeRejected);
+        emitLog("OBSWS: Failed to request the state cache snapshot.");
         return;
     }
+    stateSeedPending_ = 1;
+}
 
-    uint32_t rpcVersion = static_cast<uint32_t>(rpcNode->valuedouble);
-    const char *challenge = nullptr;
-    const char *salt = nullptr;
-
-    cJSON *authNode = cJSON_GetObjectItemCaseSensitive(dataNode, "authentication");
-    if (authNode != nullptr)
+// Mute states of every input go out as one batch; scene item lists, which carry a transform
+// per item, are requested one scene at a time to keep each response small.
+void ObsWsClient::requestStateDetails()
+{
+    ObsStateCache::SourceRef ref;
+    size_t slot = 0;
+    if (state_.nextSource(ObsStateCache::SourceKind::Input, slot, ref))
     {
-        cJSON *challengeNode = cJSON_GetObjectItemCaseSensitive(authNode, "challenge");
-        cJSON *saltNode = cJSON_GetObjectItemCaseSensitive(authNode, "salt");
-        if (cJSON_IsString(challengeNode) && challengeNode->valuestring != nullptr)
+        char batchId[kStateRequestIdSize];
+        formatStateRequestId(batchId, stateGeneration_, "mutes");
+        const bool sent = sendJsonMessage([&](ObsJsonWriter &json)
+        {
+            char requestId[kStateRequestIdSize];
+            json.beginObject();
+            json.key("op");
+            json.integer(8);
+            json.key("d");
+            json.beginObject();
+            json.key("requestId");
+            json.string(batchId);
+            json.key("requests");
+            json.beginArray();
+            size_t input = 0;
+            while (state_.nextSource(ObsStateCache::SourceKind::Input, input, ref))
+            {
+                formatStateRequestId(requestId, stateGeneration_, "mute", ref.slot, ref.serial);
+                json.beginObject();
+                json.key("requestType");
+                json.string("GetInputMute");
+                json.key("requestId");
+                json.string(requestId);
+                json.key("requestData");
+                json.beginObject();
+                json.key("inputName");
+                if (!state_.writeSourceName(ref, json))
+                {
+                    json.string("");
+                }
+                json.endObject();
+                json.endObject();
+            }
+            json.endArray();
+            json.endObject();
+            json.endObject();
+        });
+
+        if (sent)
         {
-            challenge = challengeNode->valuestring;
+            ++stateSeedPending_;
         }
-        if (cJSON_IsString(saltNode) && saltNode->valuestring != nullptr)
+        else
         {
-            salt = saltNode->valuestring;
+            emitLog("OBSWS: Failed to request input mute states.");
         }
     }
 
-    if (!sendIdentifyMessage(rpcVersion, challenge, salt))
+    slot = 0;
+    while (state_.nextSource(ObsStateCache::SourceKind::Scene, slot, ref))
+    {
+        if (sendStateRequest("GetSceneItemList", "items", ref, "sceneName"))
+        {
+            ++stateSeedPending_;
+        }
+    }
+}
+
+void ObsWsClient::finishStateSeedStep()
+{
+    if (stateSeedPending_ == 0 || --stateSeedPending_ > 0)
     {
-        emitError(ObsWsError::AuthenticationFailed);
         return;
     }
 
-    handshakeState_ = HandshakeState::AwaitIdentifyResponse;
+    state_.setReady(true);
+    if (state_.takeOverflow())
+    {
+        emitLog("OBSWS: State cache is full; some scenes, inputs or scene items are not tracked.");
+    }
+    emitLog("OBSWS: State cache ready.");
 }
 
-void ObsWsClient::handleIdentifiedMessage()
+bool ObsWsClient::handleStateResponse(const ObsWsMessage &message, bool batch)
 {
-    if (handshakeState_ != HandshakeState::AwaitIdentifyResponse)
+    StateRequestId id;
+    if (!parseStateRequestId(message.requestId, id))
     {
-        return;
+        return false;
+    }
+    if (!config_.enableStateCache || id.generation != stateGeneration_)
+    {
+        return true;
     }
 
-    handshakeState_ = HandshakeState::Established;
-    changeStatus(ObsWsStatus::Connected);
-    emitLog("OBSWS: Handshake complete.");
+    if (!batch)
+    {
+        applyStateResult(message, rxPacked_ != nullptr ? rxPacked_->responseData : ObsMsgPackSlice());
+    }
+    else
+    {
+        forEachBatchResult(message, [this](const ObsWsMessage &result, const ObsMsgPackSlice &rawResponseData)
+                           { applyStateResult(result, rawResponseData); });
+    }
+
+    if (id.kind.equals("seed"))
+    {
+        requestStateDetails();
+        finishStateSeedStep();
+    }
+    else if (id.kind.equals("mutes") || id.kind.equals("items"))
+    {
+        finishStateSeedStep();
+    }
+    return true;
 }
 
-void ObsWsClient::handleEventMessage(cJSON *dataNode)
+void ObsWsClient::applyStateResult(const ObsWsMessage &result, const ObsMsgPackSlice &rawResponseData)
 {
-    if (dataNode == nullptr)
+    StateRequestId id;
+    if (!parseStateRequestId(result.requestId, id) || id.generation != stateGeneration_ || !result.requestResult)
     {
         return;
     }
 
-    cJSON *eventTypeNode = cJSON_GetObjectItemCaseSensitive(dataNode, "eventType");
-    cJSON *eventDataNode = cJSON_GetObjectItemCaseSensitive(dataNode, "eventData");
+    const ObsJsonSlice responseData = rawResponseData.empty() ? result.responseData : renderJson(rawResponseData);
+    ObsStateCache::SourceRef ref;
+    ref.slot = static_cast<uint16_t>(id.slot);
+    ref.serial = static_cast<uint16_t>(id.serial);
+    if (id.kind.equals("scenes"))
+    {
+        state_.applySceneList(responseData);
+    }
+    else if (id.kind.equals("inputs"))
+    {
+        state_.applyInputList(responseData);
+    }
+    else if (id.kind.equals("mute"))
+    {
+        state_.applyInputMute(ref, responseData);
+    }
+    else if (id.kind.equals("items") || id.kind.equals("refresh"))
+    {
+        state_.applySceneItemList(ref, responseData);
+    }
+}
 
-    const char *eventType = cJSON_IsString(eventTypeNode) ? eventTypeNode->valuestring : "unknown";
-    char *payload = eventDataNode != nullptr ? cJSON_PrintUnformatted(eventDataNode) : duplicateString("");
-    if (payload == nullptr)
+void ObsWsClient::applyStateEvent(ObsEventType type, const ObsJsonSlice &eventData)
+{
+    ObsStateCache::SourceRef subject;
+    switch (state_.applyEvent(type, eventData, subject))
     {
-        payload = duplicateString("");
+    case ObsStateCache::FollowUp::InputMute:
+        sendStateRequest("GetInputMute", "mute", subject, "inputName");
+        break;
+    case ObsStateCache::FollowUp::SceneItems:
+        sendStateRequest("GetSceneItemList", "refresh", subject, "sceneName");
+        break;
+    case ObsStateCache::FollowUp::Reseed:
+        seedStateCache();
+        break;
+    default:
+        break;
     }
 
-    enqueueEvent(eventType, payload);
-    if (payload != nullptr)
+    if (state_.takeOverflow())
     {
-        std::free(payload);
+        emitLog("OBSWS: State cache is full; some scenes, inputs or scene items are not tracked.");
     }
 }
 
-void ObsWsClient::handleRequestResponse(cJSON *dataNode)
+bool ObsWsClient::sendStateRequest(const char *requestType, const char *kind, ObsStateCache::SourceRef ref, const char *nameKey)
 {
-    if (dataNode == nullptr)
+    if (!state_.hasSource(ref))
     {
-        return;
+        return false;
     }
 
-    cJSON *requestIdNode = cJSON_GetObjectItemCaseSensitive(dataNode, "requestId");
-    const char *requestId = cJSON_IsString(requestIdNode) ? requestIdNode->valuestring : "unknown-request";
+    char requestId[kStateRequestIdSize];
+    formatStateRequestId(requestId, stateGeneration_, kind, ref.slot, ref.serial);
+    const bool sent = sendJsonMessage([&](ObsJsonWriter &json)
+    {
+        json.beginObject();
+        json.key("op");
+        json.integer(6);
+        json.key("d");
+        json.beginObject();
+        json.key("requestType");
+        json.string(requestType);
+        json.key("requestId");
+        json.string(requestId);
+        json.key("requestData");
+        json.beginObject();
+        json.key(nameKey);
+        if (!state_.writeSourceName(ref, json))
+        {
+            json.string("");
+        }
+        json.endObject();
+        json.endObject();
+        json.endObject();
+    });
 
-    char *payload = cJSON_PrintUnformatted(dataNode);
-    if (payload == nullptr)
+    if (!sent)
     {
-        payload = duplicateString("");
+        emitLog("OBSWS: Failed to send state cache request.");
     }
+    return sent;
+}
+
+bool ObsWsClient::isEventRouted(ObsEventType type) const
+{
+    const size_t index = static_cast<size_t>(type);
+    return index < kObsEventTypeCount && (eventRouteMask_[index / 32].load(std::memory_order_acquire) & (1u << (index % 32))) != 0;
+}
 
-    enqueueEvent(requestId, payload);
-    if (payload != nullptr)
+void ObsWsClient::deliverEvent(const ObsEvent &event, ObsEventType type)
+{
+    if (isEventRouted(type))
+    {
+        const EventRoute &route = eventRoutes_[static_cast<size_t>(type)];
+        route.handler(event, route.context);
+    }
+    else if (config_.onEvent != nullptr)
     {
-        std::free(payload);
+        config_.onEvent(event);
     }
 }
 
-bool ObsWsClient::sendIdentifyMessage(uint32_t rpcVersion, const char *challenge, const char *salt)
+bool ObsWsClient::on(ObsEventType type, EventHandler handler, void *context)
 {
-    cJSON *root = cJSON_CreateObject();
-    if (root == nullptr)
+    const size_t index = static_cast<size_t>(type);
+    if (index >= kObsEventTypeCount)
     {
-        emitLog("OBSWS: Failed to allocate Identify message.");
         return false;
     }
 
-    cJSON_AddNumberToObject(root, "op", 1);
-    cJSON *dataNode = cJSON_AddObjectToObject(root, "d");
-    if (dataNode == nullptr)
+    if (handler == nullptr)
     {
-        cJSON_Delete(root);
-        emitLog("OBSWS: Failed to create Identify payload.");
+        off(type);
+        return true;
+    }
+
+    eventRoutes_[index].handler = handler;
+    eventRoutes_[index].context = context;
+    eventRouteMask_[index / 32].fetch_or(1u << (index % 32), std::memory_order_release);
+    return true;
+}
+
+bool ObsWsClient::on(const char *eventType, EventHandler handler, void *context)
+{
+    const ObsEventType type = findObsEventType(eventType, eventType != nullptr ? std::strlen(eventType) : 0);
+    if (type == ObsEventType::Unknown)
+    {
+        emitLog("OBSWS: Unknown event type passed to on().");
         return false;
     }
+    return on(type, handler, context);
+}
+
+void ObsWsClient::off(ObsEventType type)
+{
+    const size_t index = static_cast<size_t>(type);
+    if (index >= kObsEventTypeCount)
+    {
+        return;
+    }
+
+    eventRouteMask_[index / 32].fetch_and(~(1u << (index % 32)), std::memory_order_release);
+}
 
-    cJSON_AddNumberToObject(dataNode, "rpcVersion", static_cast<double>(rpcVersion));
-    cJSON_AddNumberToObject(dataNode, "eventSubscriptions", static_cast<double>(config_.eventSubscriptions));
+// OBS answers Identify and every Reidentify with op 2 in order, so the mask is only known to
+// be active once the last outstanding one is acknowledged.
+void ObsWsClient::acknowledgeSubscriptions()
+{
+    portENTER_CRITICAL(&subscriptionLock_);
+    if (identifyPending_ > 0 && --identifyPending_ == 0)
+    {
+        activeSubscriptions_ = sentSubscriptions_;
+    }
+    portEXIT_CRITICAL(&subscriptionLock_);
+}
 
-    if (challenge != nullptr && salt != nullptr)
+bool ObsWsClient::sendIdentifyMessage(uint32_t rpcVersion, const char *challenge, const char *salt)
+{
+    char authBuffer[kAuthResultBufferSize] = {0};
+    const bool authenticate = challenge != nullptr && salt != nullptr;
+    if (authenticate)
     {
         if (config_.credentials.password == nullptr || config_.credentials.password[0] == '\0')
         {
             emitLog("OBSWS: Server requires authentication but no password was provided.");
-            cJSON_Delete(root);
             return false;
         }
 
-        char authBuffer[kAuthResultBufferSize] = {0};
         if (!computeAuthentication(config_.credentials.password, salt, challenge, authBuffer, sizeof(authBuffer)))
         {
             emitLog("OBSWS: Failed to compute authentication signature.");
-            cJSON_Delete(root);
             return false;
         }
-
-        cJSON_AddStringToObject(dataNode, "authentication", authBuffer);
     }
 
-    char *jsonOut = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
+    portENTER_CRITICAL(&subscriptionLock_);
+    const uint64_t subscriptions = requestedSubscriptions_ | (config_.enableStateCache ? kStateCacheSubscriptions : 0);
+    sentSubscriptions_ = subscriptions;
+    identifyPending_ = 1;
+    activeSubscriptions_ = 0;
+    portEXIT_CRITICAL(&subscriptionLock_);
 
-    if (jsonOut == nullptr)
+    return sendJsonMessage([&](ObsJsonWriter &json)
     {
-        emitLog("OBSWS: Failed to serialise Identify message.");
-        return false;
-    }
-
-    const bool sent = sendText(jsonOut, std::strlen(jsonOut));
-    std::free(jsonOut);
-
-    return sent;
+        json.beginObject();
+        json.key("op");
+        json.integer(1);
+        json.key("d");
+        json.beginObject();
+        json.key("rpcVersion");
+        json.integer(rpcVersion);
+        json.key("eventSubscriptions");
+        json.integer(static_cast<int64_t>(subscriptions));
+        if (authenticate)
+        {
+            json.key("authentication");
+            json.string(authBuffer);
+        }
+        json.endObject();
+        json.endObject();
+    });
 }
 
-bool ObsWsClient::enqueueEvent(const char *id, const char *payload)
+bool ObsWsClient::enqueueEvent(const ObsJsonSlice &id, const ObsJsonSlice &payload, const ObsMsgPackSlice &raw, bool response, ObsEventType type, const ObsEventNames &names)
 {
     if (!ensureQueues())
     {
         return false;
     }
 
-    InternalEvent *evt = static_cast<InternalEvent *>(std::malloc(sizeof(InternalEvent)));
-    if (evt == nullptr)
+    uint32_t coalesceKey = 0;
+    uint8_t coalesceMembers = 0;
+    const bool coalescable = config_.coalesceEvents && !response && coalesceKeyFor(id, payload, raw, coalesceKey, coalesceMembers);
+    const ObsJsonSlice json = deliveredJson(payload, raw);
+    if (coalescable)
     {
-        emitLog("OBSWS: Failed to allocate event container.");
-        return false;
+        InternalEvent *stale = nullptr;
+        const bool replaced = coalesceQueuedEvent(id, type, json, raw, coalesceKey, coalesceMembers, stale);
+        releaseEvent(stale);
+        if (replaced)
+        {
+            return true;
+        }
     }
 
-    evt->id = duplicateString(id != nullptr ? id : "");
-    evt->payload = duplicateString(payload != nullptr ? payload : "");
-
-    if (evt->id == nullptr || evt->payload == nullptr)
+    static const ObsJsonSlice kNoId{"", 0};
+    const ObsJsonSlice &storedId = type != ObsEventType::Unknown ? kNoId : id;
+    InternalEvent *evt = allocateEvent(storedId.length, InternalEvent::storageFor(json, raw));
+    if (evt == nullptr)
     {
-        emitLog("OBSWS: Failed to duplicate event strings.");
-        releaseInternalEvent(evt);
+        emitLog(config_.eventPoolOverflow == ObsWsPoolOverflow::Drop ? "OBSWS: Event pool exhausted, dropping message." : "OBSWS: Failed to allocate event container.");
         return false;
     }
 
-    if (xQueueSend(eventQueue_, &evt, 0) != pdTRUE)
+    copyTerminated(evt->id, storedId);
+    evt->store(json, raw);
+    evt->response = response;
+    evt->coalescable = coalescable;
+    evt->coalesceKey = coalesceKey;
+    evt->coalesceMembers = coalesceMembers;
+    evt->eventType = type;
+    evt->names = names;
+
+    if (!pushQueuedEvent(evt))
     {
         emitLog("OBSWS: Event queue full, dropping message.");
-        releaseInternalEvent(evt);
+        releaseEvent(evt);
         return false;
     }
 
@@ -1132,3 +4348,23 @@ bool ObsWsClient::computeAuthentication(const char *password, const char *salt,
     out[authLen] = '\0';
     return true;
 }
+
+bool ObsRequestBatch::add(const char *requestType, const char *payload, ObsRequestCallback onComplete, void *context)
+{
+    if (requestType == nullptr || requestType[0] == '\0' || count_ >= kMaxRequests)
+    {
+        return false;
+    }
+
+    Item &item = items_[count_++];
+    item.requestType = requestType;
+    item.payload = payload;
+    item.onComplete = onComplete;
+    item.context = context;
+    return true;
+}
+
+void ObsRequestBatch::clear()
+{
+    count_ = 0;
+}
@@ -3,16 +3,52 @@
 #include <Arduino.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
+#include <freertos/task.h>
 #include <WiFiClient.h>
 #include <WiFiClientSecure.h>
-#include <cJSON.h>
+#include "ObsWsEventTypes.h"
+#include "ObsWsJson.h"
+#include "ObsWsMeters.h"
+#include "ObsWsMsgPack.h"
+#include "ObsWsNames.h"
+#include "ObsWsRequests.h"
+#include "ObsWsState.h"
+#include <atomic>
 #include <string>
 #include <vector>
 
+// Handles in ObsWsClient::names() of the names an event refers to; kObsNoName when the event
+// has no such member or the name was never interned.
+struct ObsEventNames
+{
+    ObsNameHandle scene = kObsNoName;
+    ObsNameHandle input = kObsNoName;
+    ObsNameHandle source = kObsNoName;
+};
+
 struct ObsEvent
 {
     const char *id;
     const char *payload;
+    size_t payloadLength = 0;
+    // Unknown for request responses and event types ObsEventType does not list; compare this
+    // instead of `id`.
+    ObsEventType type = ObsEventType::Unknown;
+    ObsEventNames names;
+    // MessagePack sessions (Config::useMsgPack): the eventData, or for responses the "d"
+    // object, as received. payload then holds its JSON rendering, or is empty when
+    // Config::msgPackJsonPayloads is off.
+    ObsMsgPackSlice raw;
+};
+
+struct ObsMessageChunk
+{
+    const uint8_t *data;
+    size_t length;
+    size_t offset;
+    size_t totalLength;
+    bool binary;
+    bool final;
 };
 
 enum class ObsWsStatus
@@ -24,6 +60,37 @@ enum class ObsWsStatus
     Error
 };
 
+enum class ObsWsPoolOverflow
+{
+    HeapFallback,
+    Drop
+};
+
+enum class ObsWsQueuePolicy
+{
+    DropNewest,
+    DropOldest,
+    CoalesceByType
+};
+
+struct ObsWsStats
+{
+    uint32_t eventQueueLength = 0;
+    uint32_t eventQueueDepth = 0;
+    uint32_t eventQueueHighWater = 0;
+    uint32_t eventsDroppedNewest = 0;
+    uint32_t eventsDroppedOldest = 0;
+    uint32_t eventsCoalesced = 0;
+    uint32_t eventsEvicted = 0;
+    uint32_t responsesDropped = 0;
+    uint32_t eventPoolSlots = 0;
+    uint32_t eventPoolInUse = 0;
+    uint32_t eventPoolHighWater = 0;
+    uint32_t eventPoolHeapFallbacks = 0;
+    uint32_t eventPoolDrops = 0;
+    uint32_t eventsFiltered = 0;
+};
+
 enum class ObsWsError
 {
     None,
@@ -31,16 +98,93 @@ enum class ObsWsError
     TransportUnavailable,
     HandshakeRejected,
     AuthenticationFailed,
-    NotImplemented
+    NotImplemented,
+    MessageTooLarge,
+    ProtocolError,
+    RequestTimeout,
+    RequestNotExecuted,
+    OutOfMemory
+};
+
+// Outcome of a request sent with a completion callback. Pointers refer to the received frame
+// and are only valid during the callback. When OBS never answered, error is RequestTimeout or
+// TransportUnavailable and the status fields are left empty; OutOfMemory means a reply arrived
+// on the network task but could not be kept for poll().
+struct ObsRequestResult
+{
+    uint32_t requestId = 0;
+    ObsWsError error = ObsWsError::None;
+    bool success = false;
+    int32_t code = 0;
+    const char *comment = nullptr;
+    const char *responseData = nullptr;
+    size_t responseDataLength = 0;
+    // The responseData as received in MessagePack sessions; see ObsEvent::raw.
+    ObsMsgPackSlice rawResponseData;
 };
 
+using ObsRequestCallback = void (*)(const ObsRequestResult &result, void *context);
+
+// Receives the decoded image of a streamed response (ObsWsClient::sendStreamingRequest()) in
+// order, in pieces of at most kObsResponseChunkBytes.
+using ObsResponseSink = void (*)(const uint8_t *data, size_t length, void *context);
+constexpr size_t kObsResponseChunkBytes = 512;
+
+enum class ObsBatchExecution
+{
+    SerialRealtime = 0,
+    SerialFrame = 1,
+    Parallel = 2
+};
+
+// Collects requests sent together as one RequestBatch (op 8). Strings are referenced, not
+// copied, and must stay valid until sendRequestBatch() returns. Requests skipped by
+// haltOnFailure complete with RequestNotExecuted.
+class ObsRequestBatch
+{
+public:
+    static constexpr size_t kMaxRequests = 16;
+
+    bool haltOnFailure = false;
+    ObsBatchExecution executionType = ObsBatchExecution::SerialRealtime;
+
+    bool add(const char *requestType, const char *payload = nullptr, ObsRequestCallback onComplete = nullptr, void *context = nullptr);
+    void clear();
+    size_t size() const { return count_; }
+
+private:
+    friend class ObsWsClient;
+
+    struct Item
+    {
+        const char *requestType = nullptr;
+        const char *payload = nullptr;
+        ObsRequestCallback onComplete = nullptr;
+        void *context = nullptr;
+    };
+
+    Item items_[kMaxRequests];
+    size_t count_ = 0;
+};
+
+// Concurrency: begin(), poll() and close() belong to one application task. With
+// Config::useNetworkTask, the socket is owned by the network task, and sendRequest(),
+// sendRequestBatch(), reidentify(), status(), lastError(), stats() and eventSubscriptions()
+// may be called from any task.
+// onEvent and request callbacks still run inside poll(). onStatus, onError and onLog may
+// run on the network task. Without the network task, every call must come from the
+// task that calls poll().
 class ObsWsClient
 {
 public:
     using EventCallback = void (*)(const ObsEvent &);
+    using EventHandler = void (*)(const ObsEvent &, void *context);
     using StatusCallback = void (*)(ObsWsStatus);
     using ErrorCallback = void (*)(ObsWsError);
     using LogCallback = void (*)(const char *message);
+    using MessageChunkCallback = void (*)(const ObsMessageChunk &);
+    using RequestCallback = ObsRequestCallback;
+    using VolumeMetersCallback = void (*)(const ObsInputMeter *meters, size_t count);
 
     struct Credentials
     {
@@ -61,24 +205,249 @@ public:
         uint32_t reconnectIntervalMs = 5000;
         uint32_t handshakeTimeoutMs = 8000;
         uint64_t eventSubscriptions = 0xFFFFFFFFULL;
+        size_t rxBufferSize = 4096;
+        // Largest message assembled on the heap when it does not fit in the receive buffer;
+        // larger messages close the connection with 1009. 0 disables the limit.
+        size_t maxMessageSize = 64 * 1024;
+        // When set, messages that do not fit in the receive buffer are delivered here in
+        // chunks as they arrive instead of being assembled (maxMessageSize is not applied).
+        // While the client itself waits for a reply (the handshake, a request sent with a
+        // callback or the state cache seed), large messages are assembled as usual instead,
+        // since the awaited response could otherwise never be matched.
+        MessageChunkCallback onMessageChunk = nullptr;
+        // Pass fragmented messages to onMessageChunk fragment by fragment instead of
+        // reassembling them; totalLength is reported as 0 for such messages.
+        bool streamFragments = false;
+        // Offer permessage-deflate for inbound messages. The inflate window is
+        // 1 << compressionWindowBits bytes (9-15) plus about 11 KB of decoder state.
+        bool enableCompression = false;
+        uint8_t compressionWindowBits = 12;
+        // Call onEvent from inside poll() with pointers into the decoded frame instead of
+        // queueing heap copies. ObsEvent fields are only valid for the duration of the
+        // callback; keep the default queued mode when events are consumed from another task.
+        bool deliverEventsInline = false;
+        // Depth of the queue drained by poll() and what to discard when it is full.
+        // CoalesceByType replaces the oldest queued event of the same type (counted in
+        // ObsWsStats::eventsEvicted) and otherwise drops the newest. With neverDropResponses, RequestResponse messages displace the
+        // oldest queued event instead and are only dropped if the queue holds nothing else.
+        size_t eventQueueLength = 10;
+        ObsWsQueuePolicy eventQueuePolicy = ObsWsQueuePolicy::DropNewest;
+        bool neverDropResponses = true;
+        // Keep at most one queued event per coalescing key: a new event overwrites the pending
+        // one in place, so low-rate events keep their order. The key is the event type plus
+        // inputName, sceneName and sceneItemId when present. coalescedEventTypes lists the
+        // types to coalesce; nullptr selects InputVolumeMeters, InputVolumeChanged,
+        // InputAudioBalanceChanged, MediaInputPlaybackStarted and SceneItemTransformChanged.
+        bool coalesceEvents = false;
+        const char *const *coalescedEventTypes = nullptr;
+        size_t coalescedEventTypeCount = 0;
+        // Queued events are copied into preallocated slots so long sessions do not fragment
+        // the heap. Events that find no free slot or exceed eventPoolPayloadBytes are handled
+        // by eventPoolOverflow; request completions from the network task always fall back
+        // to the heap. Set eventPoolSlots to 0 to always use the heap.
+        size_t eventPoolSlots = 10;
+        size_t eventPoolPayloadBytes = 512;
+        ObsWsPoolOverflow eventPoolOverflow = ObsWsPoolOverflow::HeapFallback;
+        // Requests sent with a completion callback are tracked in a table of this many
+        // entries. A request without a reply within requestTimeoutMs completes with
+        // RequestTimeout (0 waits forever).
+        size_t maxPendingRequests = 16;
+        uint32_t requestTimeoutMs = 10000;
+        // Hold data frames in the transmit buffer until the end of poll() (or until 4 KB are
+        // pending) so requests sent together share one write, TLS record and TCP segment.
+        // Control frames are always written immediately.
+        bool deferFlush = false;
+        // Run the socket on a dedicated FreeRTOS task. sendRequest() then only formats the
+        // frame and queues it, and poll() just delivers events and request completions.
+        bool useNetworkTask = false;
+        BaseType_t networkTaskCore = 0;
+        UBaseType_t networkTaskPriority = 5;
+        uint32_t networkTaskStackSize = 6144;
+        uint32_t networkTaskIntervalMs = 5; // Longest wait between socket polls when idle.
+        size_t sendQueueLength = 16;        // Frames waiting for the network task.
+        // Mirror scenes, inputs and scene items locally so state() answers without a
+        // round-trip. The cache is seeded with a request batch after Identified, follows
+        // events and is emptied when the connection closes or drops; the Config, Scenes,
+        // Inputs, SceneItems and Ui subscriptions it needs are added to eventSubscriptions.
+        // Scenes and inputs are tracked by their handle in names(), so maxNames also bounds
+        // how many the cache can hold.
+        bool enableStateCache = false;
+        size_t stateCacheSceneItems = 128;
+        // Capacity of names() and of the pool its names are stored in. Events carry the
+        // handles of interned scene, input and source names; 0 disables the table.
+        size_t maxNames = 64;
+        size_t namePoolBytes = 1024;
+        // Decode InputVolumeMeters straight into fixed-point levels (ObsWsMeters.h) and pass
+        // them to onVolumeMeters from poll() instead of onEvent or on(). Up to maxMeterInputs
+        // inputs are reported; their names are interned in names() while the levels are held,
+        // so inputs the table has no room for are skipped. If poll() falls behind, only the
+        // latest levels are delivered. The event needs ObsEventSubscription::InputVolumeMeters
+        // in eventSubscriptions.
+        VolumeMetersCallback onVolumeMeters = nullptr;
+        size_t maxMeterInputs = 8;
+        // Offer the obswebsocket.msgpack subprotocol ahead of obswebsocket.json. Once OBS picks
+        // it, messages travel as binary MessagePack frames (ObsWsMsgPack.h): outgoing ones are
+        // formatted as MessagePack directly, incoming ones are routed from the frame, and
+        // ObsEvent::raw and ObsRequestResult::rawResponseData expose the bytes as received.
+        // JSON is rendered only for payload and responseData and for data the state cache
+        // applies; clear msgPackJsonPayloads to leave it out of payloads, which also keeps it
+        // out of queued copies.
+        bool useMsgPack = false;
+        bool msgPackJsonPayloads = true;
     };
 
+    ~ObsWsClient();
+
     bool begin(const Config &config);
     void poll();
     void close();
     bool sendRequest(const char *requestType, const char *payload);
+    // Returns the requestId, or 0 when the request could not be sent. onComplete is called
+    // from poll() exactly once; timeoutMs of 0 uses Config::requestTimeoutMs.
+    uint32_t sendRequest(const char *requestType, const char *payload, RequestCallback onComplete, void *context, uint32_t timeoutMs = 0);
+    // Sends every request in `batch` as a single op 8 message and returns the batch requestId,
+    // or 0 on failure. Per-request callbacks are completed from the RequestBatchResponse.
+    uint32_t sendRequestBatch(const ObsRequestBatch &batch, uint32_t timeoutMs = 0);
+    // Sends a typed request from ObsWsRequests.h (e.g. ObsRequests::SetInputMute). Its fields
+    // are formatted straight into the transmit buffer; only fields holding JSON text are
+    // checked, and a request whose valid() fails is not sent. Returns the requestId like
+    // sendRequest(), or 0 on failure.
+    template <typename Request>
+    uint32_t send(const Request &request, RequestCallback onComplete = nullptr, void *context = nullptr, uint32_t timeoutMs = 0)
+    {
+        if (!request.valid())
+        {
+            emitLog("OBSWS: Request data is not valid JSON.");
+            return 0;
+        }
+        return sendRequestData(Request::kRequestType, Request::kHasData ? &ObsWsClient::writeRequestData<Request> : nullptr, &request, onComplete, context, timeoutMs);
+    }
+    // For responses carrying a base64 imageData (GetSourceScreenshot): the image is decoded
+    // while the message arrives and passed to `sink`, so only the rest of the response is
+    // buffered and maxMessageSize applies to that rest alone. `sink` runs where the socket is
+    // serviced (the network task when enabled); onComplete follows the last chunk as usual,
+    // with imageData left empty. Both callbacks are required and share `context`.
+    uint32_t sendStreamingRequest(const char *requestType, const char *payload, ObsResponseSink sink, RequestCallback onComplete, void *context, uint32_t timeoutMs = 0);
+    template <typename Request>
+    uint32_t sendStreaming(const Request &request, ObsResponseSink sink, RequestCallback onComplete, void *context = nullptr, uint32_t timeoutMs = 0)
+    {
+        if (!request.valid())
+        {
+            emitLog("OBSWS: Request data is not valid JSON.");
+            return 0;
+        }
+        return sink != nullptr ? sendRequestData(Request::kRequestType, Request::kHasData ? &ObsWsClient::writeRequestData<Request> : nullptr, &request, onComplete, context, timeoutMs, sink) : 0;
+    }
+    // Changes the event subscriptions of the live session with op 3 (Reidentify) instead of
+    // reconnecting; later reconnects identify with the new mask too. Before the handshake
+    // completes the mask is kept for Identify, or sent with op 3 as soon as Identified arrives
+    // when Identify has already gone out, and true is returned; begin() with another Config
+    // replaces it with Config::eventSubscriptions. Returns false when op 3 could not be sent.
+    bool reidentify(uint64_t eventSubscriptions);
+    // The subscriptions OBS last acknowledged with op 2 (Identified); 0 before the first.
+    uint64_t eventSubscriptions() const;
+
+    // Routes one event type to `handler` instead of onEvent; handlers run from poll() like
+    // onEvent. onEvent receives every event no handler claims, so nothing is filtered while it
+    // is set. Without it, events of types with no handler (and all unknown types) are dropped
+    // right after the envelope is parsed, before anything is copied or queued, and counted in
+    // ObsWsStats::eventsFiltered. Call from the task that calls poll().
+    bool on(ObsEventType type, EventHandler handler, void *context = nullptr);
+    // Same, by wire name; returns false for names ObsEventType does not list.
+    bool on(const char *eventType, EventHandler handler, void *context = nullptr);
+    void off(ObsEventType type);
 
     ObsWsStatus status() const;
     ObsWsError lastError() const;
+    ObsWsStats stats() const;
+    // The local state mirror (Config::enableStateCache); lookups are safe from any task.
+    const ObsStateCache &state() const { return state_; }
+    // Intern the names the application compares against once, then match ObsEvent::names
+    // and query state() by handle. Safe from any task; handles survive reconnects.
+    ObsNameTable &names() { return names_; }
+    const ObsNameTable &names() const { return names_; }
 
 private:
+    struct InternalEvent
+    {
+        char *id = nullptr;
+        char *payload = nullptr;
+        size_t payloadLength = 0;
+        size_t payloadCapacity = 0;
+        bool pooled = false;
+        bool response = false;
+        bool coalescable = false;
+        uint32_t coalesceKey = 0;
+        // Which kCoalesceKeyMembers the key was hashed from.
+        uint8_t coalesceMembers = 0;
+        ObsEventType eventType = ObsEventType::Unknown;
+        ObsEventNames names;
+        // ObsEvent::raw, stored after the payload's terminator.
+        size_t rawLength = 0;
+        // Request completions from the network task: id holds the comment and payload the
+        // response data.
+        InternalEvent *next = nullptr;
+        RequestCallback onComplete = nullptr;
+        void *context = nullptr;
+        uint32_t requestId = 0;
+        ObsWsError requestError = ObsWsError::None;
+        bool requestSuccess = false;
+        bool hasComment = false;
+        bool hasResponseData = false;
+        int32_t requestCode = 0;
+
+        // Storage store() needs for the payload and the raw bytes behind it.
+        static size_t storageFor(const ObsJsonSlice &payload, const ObsMsgPackSlice &bytes);
+        void store(const ObsJsonSlice &payload, const ObsMsgPackSlice &bytes);
+        ObsMsgPackSlice raw() const;
+    };
+
+    // A masked frame formatted by an application task; the bytes follow the struct.
+    struct OutboundFrame
+    {
+        OutboundFrame *next = nullptr;
+        size_t start = 0;
+        size_t length = 0;
+
+        uint8_t *bytes() { return reinterpret_cast<uint8_t *>(this + 1); }
+    };
+
+    struct EventRoute
+    {
+        EventHandler handler = nullptr;
+        void *context = nullptr;
+    };
+
+    struct PendingRequest
+    {
+        uint32_t id = 0;
+        uint32_t batchId = 0;
+        RequestCallback onComplete = nullptr;
+        void *context = nullptr;
+        ObsResponseSink sink = nullptr;
+        unsigned long sentMs = 0;
+        uint32_t timeoutMs = 0;
+    };
+
     void changeStatus(ObsWsStatus next);
     void emitError(ObsWsError error);
     void emitLog(const char *message);
 
     bool connectTransport();
     bool performHandshake();
+    void serviceConnection();
     void drainEventQueue();
+    void deliverQueuedEvents();
+    void deliverCompletedRequests();
+    bool startNetworkTask();
+    void stopNetworkTask();
+    static void networkTaskEntry(void *arg);
+    void runNetworkTask();
+    bool onNetworkTask() const;
+    bool submitFrame(OutboundFrame *frame);
+    OutboundFrame *takeSubmittedFrames();
+    void drainSendQueue();
+    void discardSendQueue();
 
     enum class HandshakeState
     {
@@ -89,39 +458,280 @@ private:
         Established
     };
 
-    void handleHelloMessage(cJSON *dataNode);
+    enum class RxMode
+    {
+        Header,
+        Buffered,
+        Payload
+    };
+
+    struct RxFrame
+    {
+        uint8_t opcode = 0;
+        bool fin = false;
+        bool masked = false;
+        uint8_t maskKey[4] = {0, 0, 0, 0};
+        size_t length = 0;
+        size_t received = 0;
+    };
+
+    struct RxMessage
+    {
+        uint8_t opcode = 0;
+        bool active = false;
+        bool fragmented = false;
+        bool streaming = false;
+        bool compressed = false;
+        // Text messages scanned for a streamed imageData while a streaming request is pending.
+        bool scanning = false;
+        size_t length = 0;
+        size_t totalLength = 0;
+    };
+
+    // Just enough JSON structure to spot d.responseData.imageData and the requestId before it;
+    // obs-websocket writes object keys in sorted order, so requestId always comes first.
+    struct RxScan
+    {
+        uint32_t arrays = 0; // Bit n is set when the container at depth n is an array.
+        uint8_t depth = 0;
+        bool inString = false;
+        bool escape = false;
+        bool isKey = false;
+        bool expectKey = false;
+        bool decoding = false;
+        uint8_t path[4] = {0, 0, 0, 0};
+        char text[16] = {0};
+        uint8_t textLength = 0;
+        uint32_t requestId = 0;
+    };
+
+    // The same for binary messages in MessagePack sessions. Maps announce their size, so it
+    // counts the keys and values left at each depth and skips whatever it does not look into.
+    struct RxPackScan
+    {
+        uint8_t header[9] = {0};
+        uint8_t headerLength = 0;
+        uint8_t depth = 0;
+        bool isKey = false;
+        bool collecting = false;
+        bool decoding = false;
+        bool lost = false; // Set on malformed input; the rest is buffered as is.
+        uint8_t path[4] = {0, 0, 0, 0};
+        uint32_t entries[4] = {0, 0, 0, 0};
+        uint64_t skipValues = 0;
+        uint32_t payload = 0; // String, binary or extension bytes still to come.
+        char text[16] = {0};
+        uint8_t textLength = 0;
+        uint32_t requestId = 0;
+    };
+
+    // Base64 decoder feeding a response sink in fixed-size chunks.
+    struct ResponseStream
+    {
+        ObsResponseSink sink = nullptr;
+        void *context = nullptr;
+        uint32_t bits = 0;
+        uint8_t bitCount = 0;
+        size_t charsSeen = 0;
+        size_t chunkLength = 0;
+        uint8_t chunk[kObsResponseChunkBytes];
+    };
+
+    void handleTextMessage(const char *text, size_t length);
+    void handleMsgPackMessage(const uint8_t *payload, size_t length);
+    void routeMessage(const ObsWsMessage &message);
+    ObsJsonSlice renderJson(const ObsMsgPackSlice &value);
+    ObsJsonSlice deliveredJson(const ObsJsonSlice &json, const ObsMsgPackSlice &raw);
+    void handleHelloMessage(const ObsWsMessage &message);
     void handleIdentifiedMessage();
-    void handleEventMessage(cJSON *dataNode);
-    void handleRequestResponse(cJSON *dataNode);
+    void handleEventMessage(const ObsWsMessage &message);
+    void handleVolumeMeters(const ObsJsonSlice &eventData, const ObsMsgPackSlice &raw);
+    void deliverVolumeMeters();
+    bool ensureMeterBuffers();
+    void handleRequestResponse(const ObsWsMessage &message);
+    void handleRequestBatchResponse(const ObsWsMessage &message);
+    template <typename Visit>
+    bool forEachBatchResult(const ObsWsMessage &message, Visit visit);
     bool sendIdentifyMessage(uint32_t rpcVersion, const char *challenge, const char *salt);
-    bool enqueueEvent(const char *id, const char *payload);
+    void acknowledgeSubscriptions();
+    void dispatchEvent(const ObsJsonSlice &id, const ObsJsonSlice &payload, const ObsMsgPackSlice &raw, bool response, ObsEventType type = ObsEventType::Unknown, const ObsEventNames &names = ObsEventNames());
+    bool enqueueEvent(const ObsJsonSlice &id, const ObsJsonSlice &payload, const ObsMsgPackSlice &raw, bool response, ObsEventType type, const ObsEventNames &names);
+    void resolveEventNames(const ObsJsonSlice &eventData, const ObsMsgPackSlice &raw, ObsEventNames &names) const;
+    void resolveEventNames(const ObsMsgPackSlice &eventData, ObsEventNames &names) const;
+    bool isEventRouted(ObsEventType type) const;
+    void seedStateCache();
+    void requestStateDetails();
+    void finishStateSeedStep();
+    bool handleStateResponse(const ObsWsMessage &message, bool batch);
+    void applyStateResult(const ObsWsMessage &result, const ObsMsgPackSlice &rawResponseData);
+    void applyStateEvent(ObsEventType type, const ObsJsonSlice &eventData);
+    bool sendStateRequest(const char *requestType, const char *kind, ObsStateCache::SourceRef ref, const char *nameKey);
+    void deliverEvent(const ObsEvent &event, ObsEventType type);
     bool ensureQueues();
+    InternalEvent *popQueuedEvent();
+    bool pushQueuedEvent(InternalEvent *evt);
+    InternalEvent *evictQueuedEventLocked(const InternalEvent &incoming);
+    InternalEvent *unlinkQueuedEventLocked(size_t index);
+    bool coalesceKeyFor(const ObsJsonSlice &eventType, const ObsJsonSlice &eventData, const ObsMsgPackSlice &raw, uint32_t &key, uint8_t &members) const;
+    bool coalesceQueuedEvent(const ObsJsonSlice &eventType, ObsEventType type, const ObsJsonSlice &payload, const ObsMsgPackSlice &raw, uint32_t key, uint8_t members, InternalEvent *&stale);
+    bool ensureEventPool();
+    void releaseEventPool();
+    InternalEvent *allocateEvent(size_t idLength, size_t payloadLength, bool droppable = true);
+    void releaseEvent(InternalEvent *evt);
+    bool ensurePendingRequests();
+    uint32_t nextRequestId();
+    uint32_t registerPendingRequest(uint32_t batchId, RequestCallback onComplete, void *context, uint32_t timeoutMs, ObsResponseSink sink = nullptr);
+    bool takePendingRequest(uint32_t id, PendingRequest &out);
+    template <typename Predicate>
+    bool takeNextPendingRequest(size_t &index, Predicate expired, PendingRequest &out);
+    void finishRequest(const PendingRequest &pending, const ObsRequestResult &result);
+    void releaseBatchRequests(uint32_t batchId, bool notify);
+    uint32_t sendRequestMessage(const char *requestType, const char *payload, RequestCallback onComplete = nullptr, void *context = nullptr, uint32_t timeoutMs = 0, ObsResponseSink sink = nullptr);
+    using RequestDataWriter = void (*)(ObsJsonWriter &json, const void *data);
+    uint32_t sendRequestData(const char *requestType, RequestDataWriter writeData, const void *data, RequestCallback onComplete, void *context, uint32_t timeoutMs, ObsResponseSink sink = nullptr);
+    static void writeRawRequestData(ObsJsonWriter &json, const void *data);
+    template <typename Request>
+    static void writeRequestData(ObsJsonWriter &json, const void *data)
+    {
+        json.beginObject();
+        static_cast<const Request *>(data)->write(json);
+        json.endObject();
+    }
+    bool completePendingRequest(const ObsWsMessage &message, const ObsMsgPackSlice &rawResponseData);
+    void expirePendingRequests(unsigned long now);
+    void failPendingRequests(ObsWsError error);
     bool ensureTransportStopped();
     bool sendText(const char *text, size_t length);
+    bool ensureTxBuffer(size_t capacity);
+    template <typename Build>
+    bool formatMessage(Build &build, bool msgPack, uint8_t *out, size_t capacity, size_t &length);
+    template <typename Build>
+    bool sendJsonMessage(Build build);
+    template <typename Build>
+    bool queueJsonMessage(Build build);
     bool sendFrame(uint8_t opcode, const uint8_t *data, size_t length);
+    bool commitFrame(uint8_t opcode, size_t length);
+    bool flushTx();
     bool sendControlFrame(uint8_t opcode, const uint8_t *data, size_t length);
     bool sendHandshakeRequest();
+    bool ensureRxBuffer(size_t capacity);
+    void releaseRxBuffer();
+    void consumeRxBuffer(size_t length);
+    void compactRxBuffer();
     bool processHandshakeBuffer();
     void processRxBuffer();
-    void handleIncomingFrame(uint8_t opcode, const uint8_t *payload, size_t length);
+    bool decodeFrameHeader();
+    bool ensureMessageBuffer(size_t capacity);
+    bool appendMessageData(const uint8_t *data, size_t length, bool final);
+    bool bufferMessageData(const uint8_t *data, size_t length);
+    bool scanMessageData(const uint8_t *data, size_t length);
+    bool scanJsonByte(char c);
+    bool scanMsgPackData(const uint8_t *data, size_t length);
+    bool scanMsgPackHeader();
+    void endMsgPackValue();
+    bool awaitingInternalReply() const;
+    bool hasPendingSink();
+    bool findPendingSink(uint32_t id, ObsResponseSink &sink, void *&context);
+    void beginResponseStream(ObsResponseSink sink, void *context);
+    void feedResponseStream(const char *data, size_t length);
+    void finishResponseStream();
+    uint8_t deflateWindowBits() const;
+    bool ensureInflater();
+    void releaseInflater();
+    bool inflatePayload(const uint8_t *data, size_t length, bool final);
+    void releaseMessageBuffer();
+    void resetRxDecoder();
+    void failConnection(uint16_t closeCode, ObsWsError error, const char *message);
+    void handleIncomingFrame(uint8_t opcode, uint8_t *payload, size_t length);
     void handlePingFrame(const uint8_t *payload, size_t length);
     bool computeAcceptKey(char *out, size_t outSize);
     bool computeAuthentication(const char *password, const char *salt, const char *challenge, char *out, size_t outSize);
 
     Config config_{};
-    ObsWsStatus status_ = ObsWsStatus::Disconnected;
-    ObsWsError lastError_ = ObsWsError::None;
+    std::atomic<ObsWsStatus> status_{ObsWsStatus::Disconnected};
+    std::atomic<ObsWsError> lastError_{ObsWsError::None};
     unsigned long lastStateChangeMs_ = 0;
     unsigned long lastReconnectAttemptMs_ = 0;
     bool placeholderEventDispatched_ = false;
     unsigned long handshakeStartMs_ = 0;
-    HandshakeState handshakeState_ = HandshakeState::Idle;
+    std::atomic<HandshakeState> handshakeState_{HandshakeState::Idle};
+    // Identify/Reidentify bookkeeping: the mask to identify with, the last one sent, how many
+    // op 2 replies are outstanding and the acknowledged mask; guarded by subscriptionLock_.
+    uint64_t requestedSubscriptions_ = 0;
+    uint64_t sentSubscriptions_ = 0;
+    uint32_t identifyPending_ = 0;
+    uint64_t activeSubscriptions_ = 0;
+    mutable portMUX_TYPE subscriptionLock_ = portMUX_INITIALIZER_UNLOCKED;
     WiFiClient plainClient_;
     WiFiClientSecure secureClient_;
     Client *transport_ = nullptr;
-    QueueHandle_t eventQueue_ = nullptr;
-    uint32_t requestCounter_ = 1;
-    std::string handshakeBuffer_;
-    std::vector<uint8_t> rxBuffer_;
+    InternalEvent **eventRing_ = nullptr;
+    size_t eventRingCapacity_ = 0;
+    size_t eventRingHead_ = 0;
+    size_t eventRingCount_ = 0;
+    mutable portMUX_TYPE eventRingLock_ = portMUX_INITIALIZER_UNLOCKED;
+    QueueHandle_t eventPoolFree_ = nullptr;
+    uint8_t *eventPool_ = nullptr;
+    size_t eventPoolSlots_ = 0;
+    size_t eventPoolPayloadBytes_ = 0;
+    // Counters are updated and snapshotted under eventRingLock_ so stats() is consistent.
+    ObsWsStats stats_{};
+    EventRoute eventRoutes_[kObsEventTypeCount];
+    // One bit per ObsEventType with a handler; read by the network task when filtering.
+    std::atomic<uint32_t> eventRouteMask_[(kObsEventTypeCount + 31) / 32]{};
+    // Declared before state_, which holds references into it.
+    ObsNameTable names_;
+    ObsStateCache state_;
+    uint32_t stateGeneration_ = 0;
+    size_t stateSeedPending_ = 0;
+    // Meter levels are decoded into one buffer, published by swapping it with the pending
+    // one, and delivered from a third, so neither side copies or waits on the other.
+    ObsInputMeter *meterBuffer_ = nullptr;
+    size_t meterCapacity_ = 0;
+    ObsInputMeter *meterDecode_ = nullptr;
+    ObsInputMeter *meterPending_ = nullptr;
+    ObsInputMeter *meterDeliver_ = nullptr;
+    size_t meterPendingCount_ = 0;
+    bool meterPendingReady_ = false;
+    portMUX_TYPE meterLock_ = portMUX_INITIALIZER_UNLOCKED;
+    std::atomic<uint32_t> requestCounter_{1};
+    PendingRequest *pendingRequests_ = nullptr;
+    size_t pendingCapacity_ = 0;
+    std::atomic<size_t> pendingCount_{0};
+    portMUX_TYPE pendingLock_ = portMUX_INITIALIZER_UNLOCKED;
+    InternalEvent *completedHead_ = nullptr;
+    InternalEvent *completedTail_ = nullptr;
+    RxScan rxScan_;
+    RxPackScan rxPackScan_;
+    ResponseStream responseStream_;
+    std::atomic<TaskHandle_t> networkTask_{nullptr};
+    std::atomic<bool> networkTaskStop_{false};
+    std::atomic<bool> networkTaskRunning_{false};
+    std::atomic<OutboundFrame *> sendStack_{nullptr};
+    std::atomic<size_t> sendQueued_{0};
+    uint8_t *txBuffer_ = nullptr;
+    size_t txCapacity_ = 0;
+    size_t txStart_ = 0;
+    size_t txLength_ = 0;
+    // Set once obswebsocket.msgpack is negotiated; read by tasks formatting requests.
+    std::atomic<bool> msgPackActive_{false};
+    char *rxJson_ = nullptr;
+    size_t rxJsonCapacity_ = 0;
+    // The payload members of the binary message being handled, still encoded.
+    const ObsWsMsgPackData *rxPacked_ = nullptr;
+    uint8_t *rxBuffer_ = nullptr;
+    size_t rxCapacity_ = 0;
+    size_t rxReadPos_ = 0;
+    size_t rxWritePos_ = 0;
+    RxMode rxMode_ = RxMode::Header;
+    RxFrame rxFrame_{};
+    RxMessage rxMessage_{};
+    uint8_t *messageBuffer_ = nullptr;
+    size_t messageCapacity_ = 0;
+    bool compressionActive_ = false;
+    void *inflater_ = nullptr;
+    uint8_t *inflateWindow_ = nullptr;
+    size_t inflateWindowSize_ = 0;
+    size_t inflateWindowPos_ = 0;
     char secWebsocketKey_[32] = {0};
 };
@@ -0,0 +1,155 @@
+#include "ObsWsEventTypes.h"
+
+#include <cstring>
+
+namespace
+{
+    constexpr const char *kEventNames[kObsEventTypeCount] = {
+        // General
+        "ExitStarted",
+        "VendorEvent",
+        "CustomEvent",
+        // Config
+        "CurrentSceneCollectionChanging",
+        "CurrentSceneCollectionChanged",
+        "SceneCollectionListChanged",
+        "CurrentProfileChanging",
+        "CurrentProfileChanged",
+        "ProfileListChanged",
+        // Scenes
+        "SceneCreated",
+        "SceneRemoved",
+        "SceneNameChanged",
+        "CurrentProgramSceneChanged",
+        "CurrentPreviewSceneChanged",
+        "SceneListChanged",
+        // Inputs
+        "InputCreated",
+        "InputRemoved",
+        "InputNameChanged",
+        "InputSettingsChanged",
+        "InputActiveStateChanged",
+        "InputShowStateChanged",
+        "InputMuteStateChanged",
+        "InputVolumeChanged",
+        "InputAudioBalanceChanged",
+        "InputAudioSyncOffsetChanged",
+        "InputAudioTracksChanged",
+        "InputAudioMonitorTypeChanged",
+        "InputVolumeMeters",
+        // Transitions
+        "CurrentSceneTransitionChanged",
+        "CurrentSceneTransitionDurationChanged",
+        "SceneTransitionStarted",
+        "SceneTransitionEnded",
+        "SceneTransitionVideoEnded",
+        // Filters
+        "SourceFilterListReindexed",
+        "SourceFilterCreated",
+        "SourceFilterRemoved",
+        "SourceFilterNameChanged",
+        "SourceFilterSettingsChanged",
+        "SourceFilterEnableStateChanged",
+        // Scene items
+        "SceneItemCreated",
+        "SceneItemRemoved",
+        "SceneItemListReindexed",
+        "SceneItemEnableStateChanged",
+        "SceneItemLockStateChanged",
+        "SceneItemSelected",
+        "SceneItemTransformChanged",
+        // Outputs
+        "StreamStateChanged",
+        "RecordStateChanged",
+        "RecordFileChanged",
+        "ReplayBufferStateChanged",
+        "VirtualcamStateChanged",
+        "ReplayBufferSaved",
+        // Media inputs
+        "MediaInputPlaybackStarted",
+        "MediaInputPlaybackEnded",
+        "MediaInputActionTriggered",
+        // UI
+        "StudioModeStateChanged",
+        "ScreenshotSaved",
+    };
+
+    // FNV-1a with a seed chosen offline so the top byte of the hash is distinct for every
+    // name above; kEventSlots maps that byte to index + 1 (0 marks an empty slot).
+    constexpr uint32_t kEventHashSeed = 0x811ca291u;
+    constexpr uint32_t kEventHashPrime = 16777619u;
+
+    constexpr uint32_t eventHash(const char *name, size_t length, uint32_t hash)
+    {
+        return length == 0 ? hash >> 24 : eventHash(name + 1, length - 1, (hash ^ static_cast<uint8_t>(*name)) * kEventHashPrime);
+    }
+
+    constexpr size_t nameLength(const char *name)
+    {
+        return *name == '\0' ? 0 : 1 + nameLength(name + 1);
+    }
+
+    constexpr size_t longestName(size_t index, size_t longest)
+    {
+        return index == kObsEventTypeCount ? longest : longestName(index + 1, nameLength(kEventNames[index]) > longest ? nameLength(kEventNames[index]) : longest);
+    }
+
+    // Also bounds the recursion depth of eventHash() at run time.
+    constexpr size_t kMaxEventNameLength = longestName(0, 0);
+
+    constexpr uint8_t kEventSlots[256] = {
+        0, 0, 44, 0, 0, 0, 0, 37, 0, 43, 0, 0, 0, 0, 29, 0,
+        24, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 48, 0, 0,
+        31, 47, 0, 0, 0, 0, 27, 0, 0, 0, 0, 1, 0, 0, 0, 0,
+        53, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        22, 0, 10, 26, 0, 0, 0, 0, 0, 13, 0, 20, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 54, 0, 0, 0, 0, 38, 0, 0, 0, 0,
+        0, 0, 0, 0, 45, 0, 0, 0, 0, 0, 46, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        17, 8, 0, 14, 15, 0, 0, 49, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 3, 28, 0, 0, 0, 16, 0, 0, 0, 0,
+        9, 6, 0, 32, 0, 0, 0, 0, 0, 51, 0, 35, 0, 0, 52, 0,
+        56, 0, 0, 33, 0, 57, 11, 34, 0, 0, 0, 36, 7, 0, 0, 2,
+        0, 0, 0, 0, 0, 0, 42, 0, 4, 0, 0, 0, 0, 19, 0, 0,
+        0, 40, 0, 0, 0, 41, 0, 12, 21, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 25, 0, 0, 0, 0, 39, 50, 0, 18, 0, 0, 0, 0,
+        5, 0, 0, 0, 30, 0, 0, 0, 0, 0, 23, 0, 0, 55, 0, 0,
+    };
+
+    // Proves at compile time that the table above is a perfect hash of kEventNames.
+    constexpr bool slotsMatchNames(size_t index)
+    {
+        return index == kObsEventTypeCount ||
+               (kEventSlots[eventHash(kEventNames[index], nameLength(kEventNames[index]), kEventHashSeed)] == index + 1 && slotsMatchNames(index + 1));
+    }
+
+    static_assert(slotsMatchNames(0), "kEventSlots is out of date with kEventNames");
+}
+
+const char *obsEventTypeName(ObsEventType type)
+{
+    const size_t index = static_cast<size_t>(type);
+    return index < kObsEventTypeCount ? kEventNames[index] : nullptr;
+}
+
+ObsEventType findObsEventType(const char *name, size_t length)
+{
+    if (name == nullptr || length == 0 || length > kMaxEventNameLength)
+    {
+        return ObsEventType::Unknown;
+    }
+
+    const uint8_t slot = kEventSlots[eventHash(name, length, kEventHashSeed)];
+    if (slot == 0)
+    {
+        return ObsEventType::Unknown;
+    }
+
+    // One comparison rejects names that merely share a slot with a known one.
+    const char *candidate = kEventNames[slot - 1];
+    if (std::strncmp(candidate, name, length) != 0 || candidate[length] != '\0')
+    {
+        return ObsEventType::Unknown;
+    }
+    return static_cast<ObsEventType>(slot - 1);
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Event types defined by the obs-websocket 5.x protocol, in protocol.md order.
+enum class ObsEventType : uint8_t
+{
+    // General
+    ExitStarted,
+    VendorEvent,
+    CustomEvent,
+    // Config
+    CurrentSceneCollectionChanging,
+    CurrentSceneCollectionChanged,
+    SceneCollectionListChanged,
+    CurrentProfileChanging,
+    CurrentProfileChanged,
+    ProfileListChanged,
+    // Scenes
+    SceneCreated,
+    SceneRemoved,
+    SceneNameChanged,
+    CurrentProgramSceneChanged,
+    CurrentPreviewSceneChanged,
+    SceneListChanged,
+    // Inputs
+    InputCreated,
+    InputRemoved,
+    InputNameChanged,
+    InputSettingsChanged,
+    InputActiveStateChanged,
+    InputShowStateChanged,
+    InputMuteStateChanged,
+    InputVolumeChanged,
+    InputAudioBalanceChanged,
+    InputAudioSyncOffsetChanged,
+    InputAudioTracksChanged,
+    InputAudioMonitorTypeChanged,
+    InputVolumeMeters,
+    // Transitions
+    CurrentSceneTransitionChanged,
+    CurrentSceneTransitionDurationChanged,
+    SceneTransitionStarted,
+    SceneTransitionEnded,
+    SceneTransitionVideoEnded,
+    // Filters
+    SourceFilterListReindexed,
+    SourceFilterCreated,
+    SourceFilterRemoved,
+    SourceFilterNameChanged,
+    SourceFilterSettingsChanged,
+    SourceFilterEnableStateChanged,
+    // Scene items
+    SceneItemCreated,
+    SceneItemRemoved,
+    SceneItemListReindexed,
+    SceneItemEnableStateChanged,
+    SceneItemLockStateChanged,
+    SceneItemSelected,
+    SceneItemTransformChanged,
+    // Outputs
+    StreamStateChanged,
+    RecordStateChanged,
+    RecordFileChanged,
+    ReplayBufferStateChanged,
+    VirtualcamStateChanged,
+    ReplayBufferSaved,
+    // Media inputs
+    MediaInputPlaybackStarted,
+    MediaInputPlaybackEnded,
+    MediaInputActionTriggered,
+    // UI
+    StudioModeStateChanged,
+    ScreenshotSaved,
+    Unknown
+};
+
+constexpr size_t kObsEventTypeCount = static_cast<size_t>(ObsEventType::Unknown);
+
+// Bits of the eventSubscriptions mask sent in Identify (op 1) and Reidentify (op 3). The
+// high-volume events are not part of All and have to be requested individually.
+namespace ObsEventSubscription
+{
+    constexpr uint64_t None = 0;
+    constexpr uint64_t General = 1ULL << 0;
+    constexpr uint64_t Config = 1ULL << 1;
+    constexpr uint64_t Scenes = 1ULL << 2;
+    constexpr uint64_t Inputs = 1ULL << 3;
+    constexpr uint64_t Transitions = 1ULL << 4;
+    constexpr uint64_t Filters = 1ULL << 5;
+    constexpr uint64_t Outputs = 1ULL << 6;
+    constexpr uint64_t SceneItems = 1ULL << 7;
+    constexpr uint64_t MediaInputs = 1ULL << 8;
+    constexpr uint64_t Vendors = 1ULL << 9;
+    constexpr uint64_t Ui = 1ULL << 10;
+    constexpr uint64_t All = 0x7FF;
+    constexpr uint64_t InputVolumeMeters = 1ULL << 16;
+    constexpr uint64_t InputActiveStateChanged = 1ULL << 17;
+    constexpr uint64_t InputShowStateChanged = 1ULL << 18;
+    constexpr uint64_t SceneItemTransformChanged = 1ULL << 19;
+}
+
+// Returns the wire name of `type`, or nullptr for ObsEventType::Unknown.
+const char *obsEventTypeName(ObsEventType type);
+
+// Maps an eventType string (not necessarily NUL-terminated) to its ObsEventType in O(1).
+// Names this library does not know yield ObsEventType::Unknown.
+ObsEventType findObsEventType(const char *name, size_t length);
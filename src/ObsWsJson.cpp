@@ -0,0 +1,1178 @@
+#include "ObsWsJson.h"
+#include "ObsWsMsgPack.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    bool isWhitespace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    bool isDelimiter(char c)
+    {
+        return c == ',' || c == '}' || c == ']' || isWhitespace(c);
+    }
+
+    int hexDigit(char c)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f')
+        {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F')
+        {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    // Reads the four hex digits of a \u escape starting at `text`; -1 when malformed.
+    int32_t readHex4(const char *text, const char *end)
+    {
+        if (end - text < 4)
+        {
+            return -1;
+        }
+        int32_t value = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            const int digit = hexDigit(text[i]);
+            if (digit < 0)
+            {
+                return -1;
+            }
+            value = (value << 4) | digit;
+        }
+        return value;
+    }
+
+    size_t encodeUtf8(uint32_t codepoint, char *out)
+    {
+        if (codepoint < 0x80)
+        {
+            out[0] = static_cast<char>(codepoint);
+            return 1;
+        }
+        if (codepoint < 0x800)
+        {
+            out[0] = static_cast<char>(0xC0 | (codepoint >> 6));
+            out[1] = static_cast<char>(0x80 | (codepoint & 0x3F));
+            return 2;
+        }
+        if (codepoint < 0x10000)
+        {
+            out[0] = static_cast<char>(0xE0 | (codepoint >> 12));
+            out[1] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out[2] = static_cast<char>(0x80 | (codepoint & 0x3F));
+            return 3;
+        }
+        out[0] = static_cast<char>(0xF0 | (codepoint >> 18));
+        out[1] = static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        out[2] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out[3] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        return 4;
+    }
+
+    bool readOrSkipString(ObsJsonReader &reader, ObsJsonSlice &value)
+    {
+        return reader.readString(value) || reader.skipValue();
+    }
+
+    bool readOrSkipUnsigned(ObsJsonReader &reader, uint32_t &value)
+    {
+        int64_t number = 0;
+        if (reader.readInteger(number))
+        {
+            value = number < 0 ? 0 : static_cast<uint32_t>(number);
+            return true;
+        }
+        return reader.skipValue();
+    }
+
+    bool parseAuthentication(ObsJsonReader &reader, ObsWsMessage &message)
+    {
+        if (!reader.beginObject())
+        {
+            return reader.skipValue();
+        }
+
+        ObsJsonSlice key;
+        while (reader.nextMember(key))
+        {
+            const bool ok = key.equals("challenge") ? readOrSkipString(reader, message.challenge)
+                            : key.equals("salt")    ? readOrSkipString(reader, message.salt)
+                                                    : reader.skipValue();
+            if (!ok)
+            {
+                return false;
+            }
+        }
+        return !reader.failed();
+    }
+
+    bool parseRequestStatus(ObsJsonReader &reader, ObsWsMessage &message)
+    {
+        if (!reader.beginObject())
+        {
+            return reader.skipValue();
+        }
+
+        message.hasRequestStatus = true;
+        ObsJsonSlice key;
+        while (reader.nextMember(key))
+        {
+            bool ok = true;
+            if (key.equals("result"))
+            {
+                ok = reader.readBool(message.requestResult) || reader.skipValue();
+            }
+            else if (key.equals("code"))
+            {
+                int64_t code = 0;
+                ok = reader.readInteger(code) || reader.skipValue();
+                message.requestCode = static_cast<int32_t>(code);
+            }
+            else if (key.equals("comment"))
+            {
+                ok = readOrSkipString(reader, message.comment);
+            }
+            else
+            {
+                ok = reader.skipValue();
+            }
+
+            if (!ok)
+            {
+                return false;
+            }
+        }
+        return !reader.failed();
+    }
+
+    bool parseMessageData(ObsJsonReader &reader, ObsWsMessage &message)
+    {
+        const char peeked = reader.peek();
+        const char *begin = reader.cursor();
+        if (peeked != '{')
+        {
+            return reader.skipValue(&message.data);
+        }
+
+        reader.beginObject();
+        ObsJsonSlice key;
+        while (reader.nextMember(key))
+        {
+            bool ok = true;
+            if (key.equals("eventType"))
+            {
+                ok = readOrSkipString(reader, message.eventType);
+            }
+            else if (key.equals("eventData"))
+            {
+                ok = reader.skipValue(&message.eventData);
+            }
+            else if (key.equals("requestId"))
+            {
+                ok = readOrSkipString(reader, message.requestId);
+            }
+            else if (key.equals("requestType"))
+            {
+                ok = readOrSkipString(reader, message.requestType);
+            }
+            else if (key.equals("requestStatus"))
+            {
+                ok = parseRequestStatus(reader, message);
+            }
+            else if (key.equals("responseData"))
+            {
+                ok = reader.skipValue(&message.responseData);
+            }
+            else if (key.equals("results"))
+            {
+                ok = reader.skipValue(&message.results);
+            }
+            else if (key.equals("rpcVersion") || key.equals("negotiatedRpcVersion"))
+            {
+                ok = readOrSkipUnsigned(reader, message.rpcVersion);
+            }
+            else if (key.equals("authentication"))
+            {
+                ok = parseAuthentication(reader, message);
+            }
+            else
+            {
+                ok = reader.skipValue();
+            }
+
+            if (!ok)
+            {
+                return false;
+            }
+        }
+
+        if (reader.failed())
+        {
+            return false;
+        }
+
+        message.data.data = begin;
+        message.data.length = static_cast<size_t>(reader.cursor() - begin);
+        return true;
+    }
+
+    // Nesting isJsonObject() accepts; deeper payloads are rejected rather than recursed into.
+    constexpr int kMaxValidateDepth = 32;
+
+    // The body of a string slice: no raw control characters and only the escapes of RFC 8259.
+    bool isValidStringBody(const ObsJsonSlice &value)
+    {
+        const char *cur = value.data;
+        const char *end = value.data + value.length;
+        while (cur < end)
+        {
+            const unsigned char c = static_cast<unsigned char>(*cur++);
+            if (c < 0x20)
+            {
+                return false;
+            }
+            if (c != '\\')
+            {
+                continue;
+            }
+            if (cur == end)
+            {
+                return false;
+            }
+            const char escape = *cur++;
+            if (escape == 'u')
+            {
+                if (readHex4(cur, end) < 0)
+                {
+                    return false;
+                }
+                cur += 4;
+            }
+            else if (std::strchr("\"\\/bfnrt", escape) == nullptr || escape == '\0')
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns the end of the number starting at `cur` under the RFC 8259 grammar (no leading
+    // zeros, digits on both sides of the point, a complete exponent), or nullptr.
+    const char *scanNumber(const char *cur, const char *end)
+    {
+        const auto digitAt = [end](const char *p)
+        {
+            return p < end && *p >= '0' && *p <= '9';
+        };
+
+        if (cur < end && *cur == '-')
+        {
+            ++cur;
+        }
+        if (!digitAt(cur))
+        {
+            return nullptr;
+        }
+        if (*cur++ != '0')
+        {
+            while (digitAt(cur))
+            {
+                ++cur;
+            }
+        }
+        if (cur < end && *cur == '.')
+        {
+            if (!digitAt(++cur))
+            {
+                return nullptr;
+            }
+            while (digitAt(cur))
+            {
+                ++cur;
+            }
+        }
+        if (cur < end && (*cur == 'e' || *cur == 'E'))
+        {
+            ++cur;
+            if (cur < end && (*cur == '+' || *cur == '-'))
+            {
+                ++cur;
+            }
+            if (!digitAt(cur))
+            {
+                return nullptr;
+            }
+            while (digitAt(cur))
+            {
+                ++cur;
+            }
+        }
+        return cur;
+    }
+
+    bool validateValue(ObsJsonReader &reader, const char *end, int depth);
+
+    // Walks the members or elements after the opening bracket. The reader's nextMember() and
+    // nextElement() tolerate a missing or leading comma, so separators are checked here.
+    bool validateContainer(ObsJsonReader &reader, const char *end, int depth, bool object)
+    {
+        const char close = object ? '}' : ']';
+        for (bool first = true;; first = false)
+        {
+            const char c = reader.peek();
+            if (c == close)
+            {
+                // Only reached right after the opening bracket or a value: a comma is always
+                // followed by a member or element, so a trailing one fails there instead.
+                ObsJsonSlice key;
+                const bool more = object ? reader.nextMember(key) : reader.nextElement();
+                return !more && !reader.failed();
+            }
+            if (first ? c == ',' : c != ',')
+            {
+                return false;
+            }
+
+            if (object)
+            {
+                ObsJsonSlice key;
+                if (!reader.nextMember(key) || !isValidStringBody(key))
+                {
+                    return false;
+                }
+            }
+            else if (!reader.nextElement())
+            {
+                return false;
+            }
+
+            if (!validateValue(reader, end, depth + 1))
+            {
+                return false;
+            }
+        }
+    }
+
+    bool validateValue(ObsJsonReader &reader, const char *end, int depth)
+    {
+        if (depth > kMaxValidateDepth)
+        {
+            return false;
+        }
+
+        const char c = reader.peek();
+        if (reader.beginObject())
+        {
+            return validateContainer(reader, end, depth, true);
+        }
+        if (reader.beginArray())
+        {
+            return validateContainer(reader, end, depth, false);
+        }
+        if (c == '"')
+        {
+            ObsJsonSlice value;
+            return reader.readString(value) && isValidStringBody(value);
+        }
+
+        const char *begin = reader.cursor();
+        if (c == '-' || (c >= '0' && c <= '9'))
+        {
+            // readNumber() also takes leading zeros and a bare point or exponent, so the
+            // grammar is checked first and the reader must stop exactly where it ends.
+            const char *numberEnd = scanNumber(begin, end);
+            double value = 0;
+            return numberEnd != nullptr && reader.readNumber(value) && reader.cursor() == numberEnd;
+        }
+
+        bool flag = false;
+        if (reader.readBool(flag))
+        {
+            return reader.cursor() == end || isDelimiter(*reader.cursor());
+        }
+
+        ObsJsonSlice literal;
+        return c == 'n' && reader.skipValue(&literal) && literal.equals("null");
+    }
+}
+
+bool ObsJsonSlice::equals(const char *text) const
+{
+    if (text == nullptr)
+    {
+        return false;
+    }
+
+    const size_t textLength = std::strlen(text);
+    return textLength == length && (length == 0 || std::memcmp(data, text, length) == 0);
+}
+
+ObsJsonReader::ObsJsonReader(const char *data, size_t length)
+    : cur_(data), end_(data != nullptr ? data + length : data)
+{
+}
+
+ObsJsonReader::ObsJsonReader(const ObsJsonSlice &slice)
+    : ObsJsonReader(slice.data, slice.length)
+{
+}
+
+bool ObsJsonReader::fail()
+{
+    failed_ = true;
+    cur_ = end_;
+    return false;
+}
+
+void ObsJsonReader::skipWhitespace()
+{
+    while (cur_ < end_ && isWhitespace(*cur_))
+    {
+        ++cur_;
+    }
+}
+
+char ObsJsonReader::peek()
+{
+    skipWhitespace();
+    return cur_ < end_ ? *cur_ : '\0';
+}
+
+bool ObsJsonReader::beginObject()
+{
+    if (peek() != '{')
+    {
+        return false;
+    }
+    ++cur_;
+    return true;
+}
+
+bool ObsJsonReader::nextMember(ObsJsonSlice &key)
+{
+    char c = peek();
+    if (c == '}')
+    {
+        ++cur_;
+        return false;
+    }
+    if (c == ',')
+    {
+        ++cur_;
+        c = peek();
+    }
+    if (c != '"' || !readString(key))
+    {
+        return fail();
+    }
+    if (peek() != ':')
+    {
+        return fail();
+    }
+    ++cur_;
+    return true;
+}
+
+bool ObsJsonReader::beginArray()
+{
+    if (peek() != '[')
+    {
+        return false;
+    }
+    ++cur_;
+    return true;
+}
+
+bool ObsJsonReader::nextElement()
+{
+    char c = peek();
+    if (c == ']')
+    {
+        ++cur_;
+        return false;
+    }
+    if (c == ',')
+    {
+        ++cur_;
+        c = peek();
+    }
+    if (c == '\0')
+    {
+        return fail();
+    }
+    return true;
+}
+
+bool ObsJsonReader::skipString()
+{
+    // Assumes cur_ is on the opening quote; leaves it just past the closing one.
+    ++cur_;
+    while (cur_ < end_)
+    {
+        const char c = *cur_++;
+        if (c == '\\')
+        {
+            if (cur_ >= end_)
+            {
+                break;
+            }
+            ++cur_;
+        }
+        else if (c == '"')
+        {
+            return true;
+        }
+    }
+    return fail();
+}
+
+bool ObsJsonReader::readString(ObsJsonSlice &value)
+{
+    if (peek() != '"')
+    {
+        return false;
+    }
+
+    const char *begin = cur_ + 1;
+    if (!skipString())
+    {
+        return false;
+    }
+    value.data = begin;
+    value.length = static_cast<size_t>(cur_ - 1 - begin);
+    return true;
+}
+
+bool ObsJsonReader::readInteger(int64_t &value)
+{
+    double number = 0;
+    if (!readNumber(number))
+    {
+        return false;
+    }
+    value = static_cast<int64_t>(number);
+    return true;
+}
+
+bool ObsJsonReader::readNumber(double &value)
+{
+    const char c = peek();
+    if (c != '-' && (c < '0' || c > '9'))
+    {
+        return false;
+    }
+
+    bool negative = false;
+    if (*cur_ == '-')
+    {
+        negative = true;
+        ++cur_;
+    }
+
+    double mantissa = 0;
+    int exponent = 0;
+    bool digits = false;
+    while (cur_ < end_ && *cur_ >= '0' && *cur_ <= '9')
+    {
+        mantissa = mantissa * 10 + (*cur_++ - '0');
+        digits = true;
+    }
+    if (cur_ < end_ && *cur_ == '.')
+    {
+        ++cur_;
+        while (cur_ < end_ && *cur_ >= '0' && *cur_ <= '9')
+        {
+            mantissa = mantissa * 10 + (*cur_++ - '0');
+            --exponent;
+            digits = true;
+        }
+    }
+    if (cur_ < end_ && (*cur_ == 'e' || *cur_ == 'E'))
+    {
+        ++cur_;
+        bool negativeExponent = false;
+        if (cur_ < end_ && (*cur_ == '+' || *cur_ == '-'))
+        {
+            negativeExponent = *cur_++ == '-';
+        }
+        int explicitExponent = 0;
+        while (cur_ < end_ && *cur_ >= '0' && *cur_ <= '9')
+        {
+            explicitExponent = explicitExponent * 10 + (*cur_++ - '0');
+        }
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+
+    if (!digits || (cur_ < end_ && !isDelimiter(*cur_)))
+    {
+        return fail();
+    }
+
+    if (exponent != 0)
+    {
+        mantissa *= std::pow(10.0, exponent);
+    }
+    value = negative ? -mantissa : mantissa;
+    return true;
+}
+
+bool ObsJsonReader::readBool(bool &value)
+{
+    const char c = peek();
+    if (c == 't' && end_ - cur_ >= 4 && std::memcmp(cur_, "true", 4) == 0)
+    {
+        cur_ += 4;
+        value = true;
+        return true;
+    }
+    if (c == 'f' && end_ - cur_ >= 5 && std::memcmp(cur_, "false", 5) == 0)
+    {
+        cur_ += 5;
+        value = false;
+        return true;
+    }
+    return false;
+}
+
+bool ObsJsonReader::skipValue(ObsJsonSlice *raw)
+{
+    const char c = peek();
+    const char *begin = cur_;
+
+    if (c == '"')
+    {
+        if (!skipString())
+        {
+            return false;
+        }
+    }
+    else if (c == '{' || c == '[')
+    {
+        int depth = 0;
+        while (cur_ < end_)
+        {
+            const char current = *cur_;
+            if (current == '"')
+            {
+                if (!skipString())
+                {
+                    return false;
+                }
+                continue;
+            }
+            ++cur_;
+            if (current == '{' || current == '[')
+            {
+                ++depth;
+            }
+            else if ((current == '}' || current == ']') && --depth == 0)
+            {
+                break;
+            }
+        }
+        if (depth != 0)
+        {
+            return fail();
+        }
+    }
+    else if (c != '\0' && !isDelimiter(c))
+    {
+        while (cur_ < end_ && !isDelimiter(*cur_))
+        {
+            ++cur_;
+        }
+    }
+    else
+    {
+        return fail();
+    }
+
+    if (raw != nullptr)
+    {
+        raw->data = begin;
+        raw->length = static_cast<size_t>(cur_ - begin);
+    }
+    return true;
+}
+
+bool ObsJsonReader::findMember(const ObsJsonSlice &object, const char *key, ObsJsonSlice &value)
+{
+    ObsJsonReader reader(object);
+    if (!reader.beginObject())
+    {
+        return false;
+    }
+
+    ObsJsonSlice name;
+    while (reader.nextMember(name))
+    {
+        if (name.equals(key))
+        {
+            return reader.skipValue(&value);
+        }
+        if (!reader.skipValue())
+        {
+            return false;
+        }
+    }
+    return false;
+}
+
+bool parseObsWsMessage(const char *json, size_t length, ObsWsMessage &message)
+{
+    message = ObsWsMessage{};
+
+    ObsJsonReader reader(json, length);
+    if (!reader.beginObject())
+    {
+        return false;
+    }
+
+    // obs-websocket serialises keys in sorted order ("d" before "op"), so the envelope is
+    // read in one pass and routing waits until every field has been collected.
+    ObsJsonSlice key;
+    while (reader.nextMember(key))
+    {
+        bool ok = true;
+        if (key.equals("op"))
+        {
+            int64_t op = -1;
+            ok = reader.readInteger(op) || reader.skipValue();
+            message.op = static_cast<int>(op);
+        }
+        else if (key.equals("d"))
+        {
+            ok = parseMessageData(reader, message);
+        }
+        else
+        {
+            ok = reader.skipValue();
+        }
+
+        if (!ok)
+        {
+            return false;
+        }
+    }
+
+    return !reader.failed();
+}
+
+bool parseObsWsRequestResult(ObsJsonReader &reader, ObsWsMessage &result)
+{
+    result = ObsWsMessage{};
+    return parseMessageData(reader, result);
+}
+
+ObsJsonWriter::ObsJsonWriter(char *buffer, size_t capacity)
+    : buffer_(buffer), capacity_(buffer != nullptr ? capacity : 0)
+{
+    if (capacity_ > 0)
+    {
+        buffer_[0] = '\0';
+    }
+}
+
+ObsJsonWriter ObsJsonWriter::msgPack(uint8_t *buffer, size_t capacity)
+{
+    ObsJsonWriter writer(nullptr, 0);
+    writer.buffer_ = reinterpret_cast<char *>(buffer);
+    writer.capacity_ = buffer != nullptr ? capacity : 0;
+    writer.msgPack_ = true;
+    return writer;
+}
+
+// Appends one MessagePack value; past the end of the buffer it is only counted.
+template <typename Write>
+void ObsJsonWriter::pack(Write write)
+{
+    const bool fits = buffer_ != nullptr && length_ <= capacity_;
+    ObsMsgPackWriter out(fits ? reinterpret_cast<uint8_t *>(buffer_) + length_ : nullptr, fits ? capacity_ - length_ : 0);
+    write(out);
+    length_ += out.length();
+}
+
+void ObsJsonWriter::beginPacked(uint8_t tag)
+{
+    constexpr size_t kHeader = 5;
+    if (length_ + kHeader <= capacity_)
+    {
+        const uint32_t enclosing = open_ == SIZE_MAX ? UINT32_MAX : static_cast<uint32_t>(open_);
+        uint8_t *header = reinterpret_cast<uint8_t *>(buffer_ + length_);
+        header[0] = tag;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            header[1 + i] = static_cast<uint8_t>(enclosing >> (24 - 8 * i));
+        }
+    }
+    open_ = length_;
+    length_ += kHeader;
+}
+
+// Counts the values written since the container began. Once the buffer has overflowed nothing
+// is patched: the message is formatted again into a larger one.
+void ObsJsonWriter::endPacked(bool map)
+{
+    constexpr size_t kHeader = 5;
+    if (length_ > capacity_ || open_ == SIZE_MAX)
+    {
+        return;
+    }
+
+    uint8_t *header = reinterpret_cast<uint8_t *>(buffer_ + open_);
+    ObsMsgPackReader reader(header + kHeader, length_ - open_ - kHeader);
+    uint32_t count = 0;
+    while (reader.skipValue())
+    {
+        ++count;
+    }
+    count = map ? count / 2 : count;
+
+    uint32_t enclosing = 0;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        enclosing = (enclosing << 8) | header[1 + i];
+        header[1 + i] = static_cast<uint8_t>(count >> (24 - 8 * i));
+    }
+    open_ = enclosing == UINT32_MAX ? SIZE_MAX : enclosing;
+}
+
+void ObsJsonWriter::put(char c)
+{
+    if (length_ + 1 < capacity_)
+    {
+        buffer_[length_] = c;
+        buffer_[length_ + 1] = '\0';
+    }
+    ++length_;
+}
+
+void ObsJsonWriter::put(const char *text, size_t length)
+{
+    if (length_ + length < capacity_)
+    {
+        std::memcpy(buffer_ + length_, text, length);
+        buffer_[length_ + length] = '\0';
+    }
+    length_ += length;
+}
+
+void ObsJsonWriter::beginValue()
+{
+    if (afterKey_)
+    {
+        afterKey_ = false;
+    }
+    else if (!first_)
+    {
+        put(',');
+    }
+    first_ = false;
+}
+
+void ObsJsonWriter::beginObject()
+{
+    if (msgPack_)
+    {
+        beginPacked(0xDF);
+        return;
+    }
+    beginValue();
+    put('{');
+    first_ = true;
+}
+
+void ObsJsonWriter::endObject()
+{
+    if (msgPack_)
+    {
+        endPacked(true);
+        return;
+    }
+    put('}');
+    first_ = false;
+}
+
+void ObsJsonWriter::beginArray()
+{
+    if (msgPack_)
+    {
+        beginPacked(0xDD);
+        return;
+    }
+    beginValue();
+    put('[');
+    first_ = true;
+}
+
+void ObsJsonWriter::endArray()
+{
+    if (msgPack_)
+    {
+        endPacked(false);
+        return;
+    }
+    put(']');
+    first_ = false;
+}
+
+void ObsJsonWriter::key(const char *name)
+{
+    key(name, name != nullptr ? std::strlen(name) : 0);
+}
+
+void ObsJsonWriter::key(const char *name, size_t length)
+{
+    string(name, length);
+    if (msgPack_)
+    {
+        return;
+    }
+    put(':');
+    afterKey_ = true;
+}
+
+void ObsJsonWriter::string(const char *value)
+{
+    string(value, value != nullptr ? std::strlen(value) : 0);
+}
+
+void ObsJsonWriter::string(const char *value, size_t length)
+{
+    static const char kHex[] = "0123456789abcdef";
+
+    if (msgPack_)
+    {
+        pack([&](ObsMsgPackWriter &out)
+             { out.string(value, value != nullptr ? length : 0); });
+        return;
+    }
+    beginValue();
+    put('"');
+    const char *runStart = value;
+    const char *p = value;
+    const char *end = value != nullptr ? value + length : nullptr;
+    for (; p != end; ++p)
+    {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if (c >= 0x20 && c != '"' && c != '\\')
+        {
+            continue;
+        }
+
+        put(runStart, static_cast<size_t>(p - runStart));
+        runStart = p + 1;
+        switch (c)
+        {
+        case '"':
+            put("\\\"", 2);
+            break;
+        case '\\':
+            put("\\\\", 2);
+            break;
+        case '\n':
+            put("\\n", 2);
+            break;
+        case '\r':
+            put("\\r", 2);
+            break;
+        case '\t':
+            put("\\t", 2);
+            break;
+        default:
+        {
+            const char escaped[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0x0F]};
+            put(escaped, sizeof(escaped));
+            break;
+        }
+        }
+    }
+    if (p != nullptr)
+    {
+        put(runStart, static_cast<size_t>(p - runStart));
+    }
+    put('"');
+}
+
+void ObsJsonWriter::integer(int64_t value)
+{
+    if (msgPack_)
+    {
+        pack([&](ObsMsgPackWriter &out)
+             { out.integer(value); });
+        return;
+    }
+    char digits[24];
+    const int written = std::snprintf(digits, sizeof(digits), "%lld", static_cast<long long>(value));
+    beginValue();
+    put(digits, static_cast<size_t>(written));
+}
+
+void ObsJsonWriter::number(double value)
+{
+    if (msgPack_)
+    {
+        pack([&](ObsMsgPackWriter &out)
+             { out.number(std::isfinite(value) ? value : 0.0); });
+        return;
+    }
+    char digits[32];
+    const int written = std::snprintf(digits, sizeof(digits), "%.9g", std::isfinite(value) ? value : 0.0);
+    beginValue();
+    put(digits, static_cast<size_t>(written));
+}
+
+void ObsJsonWriter::boolean(bool value)
+{
+    if (msgPack_)
+    {
+        pack([&](ObsMsgPackWriter &out)
+             { out.boolean(value); });
+        return;
+    }
+    beginValue();
+    if (value)
+    {
+        put("true", 4);
+    }
+    else
+    {
+        put("false", 5);
+    }
+}
+
+void ObsJsonWriter::null()
+{
+    if (msgPack_)
+    {
+        pack([](ObsMsgPackWriter &out)
+             { out.nil(); });
+        return;
+    }
+    beginValue();
+    put("null", 4);
+}
+
+void ObsJsonWriter::raw(const char *json, size_t length)
+{
+    if (msgPack_)
+    {
+        pack([&](ObsMsgPackWriter &out)
+             { failed_ = !writeObsJsonAsMsgPack(json, length, out) || failed_; });
+        return;
+    }
+    beginValue();
+    put(json, length);
+}
+
+bool isJsonObject(const char *json, size_t length)
+{
+    if (json == nullptr)
+    {
+        return false;
+    }
+
+    ObsJsonReader reader(json, length);
+    const char *end = json + length;
+    return reader.peek() == '{' && validateValue(reader, end, 0) && reader.peek() == '\0' && reader.cursor() == end;
+}
+
+bool isJsonValue(const char *json, size_t length)
+{
+    if (json == nullptr)
+    {
+        return false;
+    }
+
+    ObsJsonReader reader(json, length);
+    const char *end = json + length;
+    return validateValue(reader, end, 0) && reader.peek() == '\0' && reader.cursor() == end;
+}
+
+size_t unescapeJsonString(const ObsJsonSlice &value, char *out, size_t capacity)
+{
+    const char *cur = value.data;
+    const char *end = value.data != nullptr ? value.data + value.length : nullptr;
+    size_t length = 0;
+    while (cur < end)
+    {
+        char decoded[4];
+        size_t count = 1;
+        const char c = *cur++;
+        decoded[0] = c;
+        if (c == '\\' && cur < end)
+        {
+            const char escape = *cur++;
+            switch (escape)
+            {
+            case 'b':
+                decoded[0] = '\b';
+                break;
+            case 'f':
+                decoded[0] = '\f';
+                break;
+            case 'n':
+                decoded[0] = '\n';
+                break;
+            case 'r':
+                decoded[0] = '\r';
+                break;
+            case 't':
+                decoded[0] = '\t';
+                break;
+            case 'u':
+            {
+                const int32_t unit = readHex4(cur, end);
+                if (unit < 0)
+                {
+                    decoded[0] = escape;
+                    break;
+                }
+                cur += 4;
+                uint32_t codepoint = static_cast<uint32_t>(unit);
+                // A high surrogate followed by an escaped low surrogate forms one codepoint;
+                // unpaired surrogates decode to U+FFFD.
+                if (codepoint >= 0xD800 && codepoint < 0xDC00 && end - cur >= 6 && cur[0] == '\\' && cur[1] == 'u')
+                {
+                    const int32_t low = readHex4(cur + 2, end);
+                    if (low >= 0xDC00 && low < 0xE000)
+                    {
+                        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + static_cast<uint32_t>(low - 0xDC00);
+                        cur += 6;
+                    }
+                }
+                if (codepoint >= 0xD800 && codepoint < 0xE000)
+                {
+                    codepoint = 0xFFFD;
+                }
+                count = encodeUtf8(codepoint, decoded);
+                break;
+            }
+            default:
+                decoded[0] = escape;
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i, ++length)
+        {
+            if (length < capacity)
+            {
+                out[length] = decoded[i];
+            }
+        }
+    }
+    return length;
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// A view into JSON text owned by someone else (usually the decoded frame). String slices
+// exclude the surrounding quotes and keep escape sequences as they appear on the wire.
+struct ObsJsonSlice
+{
+    const char *data = nullptr;
+    size_t length = 0;
+
+    bool empty() const { return data == nullptr || length == 0; }
+    bool equals(const char *text) const;
+};
+
+// Pull-style tokenizer that walks JSON text in place without allocating. Typed reads
+// return false without consuming anything when the next value has a different type, so
+// callers can fall back to skipValue(); malformed input sets failed() and stops the reader.
+class ObsJsonReader
+{
+public:
+    ObsJsonReader(const char *data, size_t length);
+    explicit ObsJsonReader(const ObsJsonSlice &slice);
+
+    bool beginObject();
+    bool nextMember(ObsJsonSlice &key);
+    bool beginArray();
+    bool nextElement();
+
+    bool readString(ObsJsonSlice &value);
+    bool readInteger(int64_t &value);
+    bool readNumber(double &value);
+    bool readBool(bool &value);
+    bool skipValue(ObsJsonSlice *raw = nullptr);
+
+    char peek();
+    const char *cursor() const { return cur_; }
+    bool failed() const { return failed_; }
+
+    // Finds `key` among the members of the object in `object` and returns its raw value.
+    static bool findMember(const ObsJsonSlice &object, const char *key, ObsJsonSlice &value);
+
+private:
+    void skipWhitespace();
+    bool skipString();
+    bool fail();
+
+    const char *cur_;
+    const char *end_;
+    bool failed_ = false;
+};
+
+// Formats JSON straight into a caller-owned buffer. Commas are inserted automatically; when
+// the text does not fit, writing continues to count so required() reports the size (including
+// the terminating NUL) to grow the buffer to before writing again.
+class ObsJsonWriter
+{
+public:
+    ObsJsonWriter(char *buffer, size_t capacity);
+    // A writer that formats MessagePack instead, for obswebsocket.msgpack sessions, so message
+    // builders serve both encodings. Objects and arrays take 32-bit counts that are filled in
+    // when they end, raw() encodes the JSON it is given, and required() counts no terminator.
+    static ObsJsonWriter msgPack(uint8_t *buffer, size_t capacity);
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+    void key(const char *name);
+    void key(const char *name, size_t length);
+
+    void string(const char *value);
+    void string(const char *value, size_t length);
+    void integer(int64_t value);
+    // Non-finite values are written as 0, since JSON has no representation for them.
+    void number(double value);
+    void boolean(bool value);
+    void null();
+    // Splices pre-validated JSON text in verbatim. In MessagePack mode the text is encoded
+    // instead, and text that does not parse marks the writer failed().
+    void raw(const char *json, size_t length);
+
+    const char *data() const { return buffer_; }
+    size_t length() const { return length_; }
+    size_t required() const { return msgPack_ ? length_ : length_ + 1; }
+    bool overflowed() const { return msgPack_ ? length_ > capacity_ : length_ >= capacity_; }
+    // The output is incomplete because raw() was given text it could not encode; growing the
+    // buffer does not help, so the message must not be sent.
+    bool failed() const { return failed_; }
+
+private:
+    void beginValue();
+    void put(char c);
+    void put(const char *text, size_t length);
+    template <typename Write>
+    void pack(Write write);
+    void beginPacked(uint8_t tag);
+    void endPacked(bool map);
+
+    char *buffer_;
+    size_t capacity_;
+    size_t length_ = 0;
+    bool first_ = true;
+    bool afterKey_ = false;
+    bool msgPack_ = false;
+    bool failed_ = false;
+    // Where the innermost open MessagePack container starts; its count field holds the
+    // enclosing one's offset until it ends.
+    size_t open_ = SIZE_MAX;
+};
+
+// Returns true when `json` holds exactly one well-formed JSON object (RFC 8259, surrounding
+// whitespace allowed, at most 32 levels deep). Caller payloads are checked with this before
+// they are spliced into a request, since OBS closes the session on malformed JSON.
+bool isJsonObject(const char *json, size_t length);
+// The same check for exactly one JSON value of any type, for fields typed Any or Array.
+bool isJsonValue(const char *json, size_t length);
+
+// Decodes the escapes of a string slice into `out` (\u escapes become UTF-8) and returns the
+// decoded length. Nothing is written past `capacity`, so a result larger than it means the
+// text did not fit. No terminating NUL is written.
+size_t unescapeJsonString(const ObsJsonSlice &value, char *out, size_t capacity);
+
+// Fields of an obs-websocket message envelope that the client routes on, gathered in a
+// single pass. Slices point into the frame the message was parsed from.
+struct ObsWsMessage
+{
+    int op = -1;
+    ObsJsonSlice data;
+    ObsJsonSlice eventType;
+    ObsJsonSlice eventData;
+    ObsJsonSlice requestId;
+    ObsJsonSlice requestType;
+    ObsJsonSlice responseData;
+    ObsJsonSlice results;
+    ObsJsonSlice challenge;
+    ObsJsonSlice salt;
+    ObsJsonSlice comment;
+    bool hasRequestStatus = false;
+    bool requestResult = false;
+    int32_t requestCode = 0;
+    uint32_t rpcVersion = 0;
+};
+
+bool parseObsWsMessage(const char *json, size_t length, ObsWsMessage &message);
+
+// Reads one entry of a RequestBatchResponse "results" array at the reader's position into the
+// request fields of `result` (requestId, requestType, requestStatus, responseData).
+bool parseObsWsRequestResult(ObsJsonReader &reader, ObsWsMessage &result);
@@ -0,0 +1,62 @@
+#include "ObsWsMask.h"
+
+#include <cstring>
+
+namespace
+{
+#if defined(__GNUC__)
+    typedef uint32_t MaskVector __attribute__((vector_size(16)));
+#endif
+
+    // Lets the compiler use aligned word loads and stores for the memcpy calls below.
+    inline void *assumeWordAligned(uint8_t *p)
+    {
+#if defined(__GNUC__)
+        return __builtin_assume_aligned(p, 4);
+#else
+        return p;
+#endif
+    }
+}
+
+// Bytes are handled singly only up to the first 4-byte boundary and after the last whole
+// word; the body runs 16 bytes per step where the compiler supports vector types and a word
+// at a time otherwise.
+void applyObsWsMask(uint8_t *data, size_t length, const uint8_t *maskKey, size_t offset)
+{
+    size_t i = 0;
+    size_t phase = offset & 3;
+    while (i < length && (reinterpret_cast<uintptr_t>(data + i) & 3) != 0)
+    {
+        data[i++] ^= maskKey[phase];
+        phase = (phase + 1) & 3;
+    }
+
+    // The key rotated so that byte 0 of every aligned word lines up with `phase`.
+    const uint8_t rotated[4] = {maskKey[phase], maskKey[(phase + 1) & 3], maskKey[(phase + 2) & 3], maskKey[(phase + 3) & 3]};
+    uint32_t maskWord;
+    std::memcpy(&maskWord, rotated, sizeof(maskWord));
+
+#if defined(__GNUC__)
+    const MaskVector maskVector = {maskWord, maskWord, maskWord, maskWord};
+    for (; i + sizeof(MaskVector) <= length; i += sizeof(MaskVector))
+    {
+        MaskVector block;
+        std::memcpy(&block, assumeWordAligned(data + i), sizeof(block));
+        block ^= maskVector;
+        std::memcpy(assumeWordAligned(data + i), &block, sizeof(block));
+    }
+#endif
+    for (; i + sizeof(maskWord) <= length; i += sizeof(maskWord))
+    {
+        uint32_t word;
+        std::memcpy(&word, assumeWordAligned(data + i), sizeof(word));
+        word ^= maskWord;
+        std::memcpy(assumeWordAligned(data + i), &word, sizeof(word));
+    }
+
+    for (size_t k = 0; i < length; ++i, ++k)
+    {
+        data[i] ^= rotated[k];
+    }
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// XORs `data` with the repeating 4-byte WebSocket mask, where `offset` is the position of
+// data[0] within the masked payload, so a payload can be unmasked in pieces. Used for both
+// the frames the client sends and masked frames it receives.
+void applyObsWsMask(uint8_t *data, size_t length, const uint8_t *maskKey, size_t offset);
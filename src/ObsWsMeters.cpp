@@ -0,0 +1,297 @@
+#include "ObsWsMeters.h"
+
+#include <cmath>
+
+namespace
+{
+    // Digits beyond this are dropped; single precision cannot hold them anyway.
+    constexpr uint32_t kMaxMantissa = 100000000u;
+
+    bool isDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    int16_t clampDb100(float db100)
+    {
+        if (db100 <= kObsMeterFloor)
+        {
+            return kObsMeterFloor;
+        }
+        if (db100 >= INT16_MAX)
+        {
+            return INT16_MAX;
+        }
+        return static_cast<int16_t>(std::lrint(db100));
+    }
+
+    // Reads a linear level (a JSON number) as mantissa * 10^exponent and converts it with one
+    // single-precision log10: 20 * log10(m * 10^e) = 20 * (log10(m) + e).
+    int16_t levelToDb100(const ObsJsonSlice &number)
+    {
+        const char *cur = number.data;
+        const char *end = number.data + number.length;
+        if (cur == end || *cur == '-')
+        {
+            return kObsMeterFloor;
+        }
+
+        uint32_t mantissa = 0;
+        int exponent = 0;
+        for (; cur < end && isDigit(*cur); ++cur)
+        {
+            if (mantissa < kMaxMantissa)
+            {
+                mantissa = mantissa * 10 + (*cur - '0');
+            }
+            else
+            {
+                ++exponent;
+            }
+        }
+        if (cur < end && *cur == '.')
+        {
+            for (++cur; cur < end && isDigit(*cur); ++cur)
+            {
+                if (mantissa < kMaxMantissa)
+                {
+                    mantissa = mantissa * 10 + (*cur - '0');
+                    --exponent;
+                }
+            }
+        }
+        if (cur < end && (*cur == 'e' || *cur == 'E'))
+        {
+            ++cur;
+            const bool negative = cur < end && *cur == '-';
+            if (cur < end && (*cur == '-' || *cur == '+'))
+            {
+                ++cur;
+            }
+            int value = 0;
+            for (; cur < end && isDigit(*cur); ++cur)
+            {
+                value = value < 1000 ? value * 10 + (*cur - '0') : value;
+            }
+            exponent += negative ? -value : value;
+        }
+
+        if (mantissa == 0)
+        {
+            return kObsMeterFloor;
+        }
+        return clampDb100(2000.0f * (std::log10(static_cast<float>(mantissa)) + static_cast<float>(exponent)));
+    }
+
+    // MessagePack sessions send the level as a float.
+    int16_t levelToDb100(double level)
+    {
+        return level > 0 ? clampDb100(2000.0f * std::log10(static_cast<float>(level))) : kObsMeterFloor;
+    }
+
+    // inputLevelsMul holds one [magnitude, peak, inputPeak] array per channel.
+    bool readLevels(ObsJsonReader &reader, ObsInputMeter &meter)
+    {
+        if (!reader.beginArray())
+        {
+            return reader.skipValue();
+        }
+
+        while (reader.nextElement())
+        {
+            if (meter.channels == kObsMeterChannels || !reader.beginArray())
+            {
+                if (!reader.skipValue())
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            const size_t channel = meter.channels++;
+            meter.magnitude[channel] = kObsMeterFloor;
+            meter.peak[channel] = kObsMeterFloor;
+            ObsJsonSlice raw;
+            for (size_t i = 0; reader.nextElement(); ++i)
+            {
+                if (!reader.skipValue(&raw))
+                {
+                    return false;
+                }
+                if (i == 0)
+                {
+                    meter.magnitude[channel] = levelToDb100(raw);
+                }
+                else if (i == 1)
+                {
+                    meter.peak[channel] = levelToDb100(raw);
+                }
+            }
+        }
+        return !reader.failed();
+    }
+
+    bool readLevels(ObsMsgPackReader &reader, ObsInputMeter &meter)
+    {
+        uint32_t channels = 0;
+        if (!reader.readArray(channels))
+        {
+            return reader.skipValue();
+        }
+
+        for (uint32_t c = 0; c < channels; ++c)
+        {
+            uint32_t values = 0;
+            if (meter.channels == kObsMeterChannels || !reader.readArray(values))
+            {
+                if (!reader.skipValue())
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            const size_t channel = meter.channels++;
+            meter.magnitude[channel] = kObsMeterFloor;
+            meter.peak[channel] = kObsMeterFloor;
+            for (uint32_t i = 0; i < values; ++i)
+            {
+                double level = 0;
+                if (i < 2 && reader.readNumber(level))
+                {
+                    (i == 0 ? meter.magnitude : meter.peak)[channel] = levelToDb100(level);
+                }
+                else if (!reader.skipValue())
+                {
+                    return false;
+                }
+            }
+        }
+        return !reader.failed();
+    }
+}
+
+size_t decodeObsVolumeMeters(const ObsJsonSlice &eventData, ObsNameTable &names, ObsInputMeter *meters, size_t capacity)
+{
+    ObsJsonSlice inputs;
+    if (meters == nullptr || capacity == 0 || !ObsJsonReader::findMember(eventData, "inputs", inputs))
+    {
+        return 0;
+    }
+
+    ObsJsonReader reader(inputs);
+    if (!reader.beginArray())
+    {
+        return 0;
+    }
+
+    size_t count = 0;
+    bool valid = true;
+    while (valid && count < capacity && reader.nextElement())
+    {
+        ObsInputMeter &meter = meters[count];
+        meter.input = kObsNoName;
+        meter.channels = 0;
+        valid = reader.beginObject();
+
+        ObsJsonSlice key;
+        ObsJsonSlice value;
+        while (valid && reader.nextMember(key))
+        {
+            if (key.equals("inputLevelsMul"))
+            {
+                valid = readLevels(reader, meter);
+            }
+            else if (key.equals("inputName") && meter.input == kObsNoName && reader.readString(value))
+            {
+                meter.input = names.internJson(value);
+            }
+            else
+            {
+                valid = reader.skipValue();
+            }
+        }
+        valid = valid && !reader.failed();
+        if (meter.input != kObsNoName)
+        {
+            // Counted even when malformed so the reference is dropped below.
+            ++count;
+        }
+    }
+
+    if (!valid || reader.failed())
+    {
+        releaseObsVolumeMeters(names, meters, count);
+        return 0;
+    }
+    return count;
+}
+
+size_t decodeObsVolumeMeters(const ObsMsgPackSlice &eventData, ObsNameTable &names, ObsInputMeter *meters, size_t capacity)
+{
+    ObsMsgPackSlice inputs;
+    if (meters == nullptr || capacity == 0 || !ObsMsgPackReader::findMember(eventData, "inputs", inputs))
+    {
+        return 0;
+    }
+
+    ObsMsgPackReader reader(inputs);
+    uint32_t total = 0;
+    if (!reader.readArray(total))
+    {
+        return 0;
+    }
+
+    size_t count = 0;
+    bool valid = true;
+    for (uint32_t n = 0; valid && count < capacity && n < total; ++n)
+    {
+        ObsInputMeter &meter = meters[count];
+        meter.input = kObsNoName;
+        meter.channels = 0;
+        uint32_t members = 0;
+        valid = reader.readMap(members);
+
+        ObsMsgPackSlice key;
+        ObsMsgPackSlice value;
+        for (uint32_t i = 0; valid && i < members; ++i)
+        {
+            if (!reader.readString(key))
+            {
+                valid = reader.skipValue() && reader.skipValue();
+            }
+            else if (key.equals("inputLevelsMul"))
+            {
+                valid = readLevels(reader, meter);
+            }
+            else if (key.equals("inputName") && meter.input == kObsNoName && reader.readString(value))
+            {
+                meter.input = names.internDecoded(reinterpret_cast<const char *>(value.data), value.length);
+            }
+            else
+            {
+                valid = reader.skipValue();
+            }
+        }
+        valid = valid && !reader.failed();
+        if (meter.input != kObsNoName)
+        {
+            ++count;
+        }
+    }
+
+    if (!valid || reader.failed())
+    {
+        releaseObsVolumeMeters(names, meters, count);
+        return 0;
+    }
+    return count;
+}
+
+void releaseObsVolumeMeters(ObsNameTable &names, const ObsInputMeter *meters, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        names.release(meters[i].input);
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "ObsWsJson.h"
+#include "ObsWsMsgPack.h"
+#include "ObsWsNames.h"
+
+// OBS mixes at most eight channels (MAX_AUDIO_CHANNELS); further channels are ignored.
+constexpr size_t kObsMeterChannels = 8;
+// Levels are dBFS times 100 (-12.5 dB reads as -1250). Silence and anything quieter than
+// -100 dB read as kObsMeterFloor.
+constexpr int16_t kObsMeterFloor = -10000;
+
+// One input of an InputVolumeMeters event.
+struct ObsInputMeter
+{
+    ObsNameHandle input = kObsNoName;
+    uint8_t channels = 0;
+    int16_t magnitude[kObsMeterChannels];
+    int16_t peak[kObsMeterChannels];
+};
+
+// Decodes the eventData of an InputVolumeMeters event straight from the frame into `meters`,
+// without intermediate JSON, doubles or allocations. Input names are interned in `names`, so
+// each meter written holds a reference to its input until releaseObsVolumeMeters(); inputs
+// that do not fit in the table are skipped. At most `capacity` meters are written. Returns
+// how many; 0 for malformed data, in which case no references are left behind.
+size_t decodeObsVolumeMeters(const ObsJsonSlice &eventData, ObsNameTable &names, ObsInputMeter *meters, size_t capacity);
+// The same for the MessagePack eventData of obswebsocket.msgpack sessions, whose levels arrive
+// as floats.
+size_t decodeObsVolumeMeters(const ObsMsgPackSlice &eventData, ObsNameTable &names, ObsInputMeter *meters, size_t capacity);
+// Drops the name references held by meters from decodeObsVolumeMeters().
+void releaseObsVolumeMeters(ObsNameTable &names, const ObsInputMeter *meters, size_t count);
@@ -0,0 +1,1011 @@
+#include "ObsWsMsgPack.h"
+
+#include <cstring>
+
+namespace
+{
+    using Type = ObsMsgPackReader::Type;
+
+    // Deeper values are rejected rather than recursed into.
+    constexpr size_t kMaxDepth = 32;
+
+    uint64_t readBigEndian(const uint8_t *data, size_t bytes)
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; ++i)
+        {
+            value = (value << 8) | data[i];
+        }
+        return value;
+    }
+
+    void writeJsonString(const ObsJsonSlice &value, ObsMsgPackWriter &out)
+    {
+        const size_t length = unescapeJsonString(value, nullptr, 0);
+        uint8_t *bytes = out.beginString(length);
+        if (bytes != nullptr)
+        {
+            unescapeJsonString(value, reinterpret_cast<char *>(bytes), length);
+        }
+    }
+
+    // Plain integers that fit in int64 keep their exact value; anything else goes through
+    // ObsJsonReader's double parser.
+    bool writeJsonNumber(const ObsJsonSlice &raw, ObsMsgPackWriter &out)
+    {
+        const char *cur = raw.data;
+        const char *end = raw.data + raw.length;
+        const bool negative = cur < end && *cur == '-';
+        if (negative)
+        {
+            ++cur;
+        }
+
+        // Nineteen digits cannot overflow uint64.
+        bool integral = cur < end && end - cur <= 19;
+        uint64_t value = 0;
+        for (; integral && cur < end; ++cur)
+        {
+            if (*cur < '0' || *cur > '9')
+            {
+                integral = false;
+                break;
+            }
+            value = value * 10 + static_cast<uint64_t>(*cur - '0');
+        }
+        const uint64_t limit = static_cast<uint64_t>(INT64_MAX) + (negative ? 1 : 0);
+        if (integral && value <= limit)
+        {
+            out.integer(negative ? static_cast<int64_t>(0 - value) : static_cast<int64_t>(value));
+            return true;
+        }
+
+        double number = 0;
+        ObsJsonReader reader(raw);
+        if (!reader.readNumber(number))
+        {
+            return false;
+        }
+        out.number(number);
+        return true;
+    }
+
+    bool writeJsonValue(ObsJsonReader &reader, ObsMsgPackWriter &out, size_t depth)
+    {
+        ObsJsonSlice text;
+        bool flag = false;
+        switch (reader.peek())
+        {
+        case '{':
+        case '[':
+        {
+            if (depth >= kMaxDepth)
+            {
+                return false;
+            }
+
+            // MessagePack needs the element count up front, so a copy of the reader counts
+            // the members before they are written.
+            const bool object = reader.peek() == '{';
+            ObsJsonReader counter = reader;
+            uint32_t count = 0;
+            if (object)
+            {
+                counter.beginObject();
+                while (counter.nextMember(text) && counter.skipValue())
+                {
+                    ++count;
+                }
+                out.beginMap(count);
+            }
+            else
+            {
+                counter.beginArray();
+                while (counter.nextElement() && counter.skipValue())
+                {
+                    ++count;
+                }
+                out.beginArray(count);
+            }
+            if (counter.failed())
+            {
+                return false;
+            }
+
+            if (object)
+            {
+                reader.beginObject();
+                while (reader.nextMember(text))
+                {
+                    writeJsonString(text, out);
+                    if (!writeJsonValue(reader, out, depth + 1))
+                    {
+                        return false;
+                    }
+                }
+            }
+            else
+            {
+                reader.beginArray();
+                while (reader.nextElement())
+                {
+                    if (!writeJsonValue(reader, out, depth + 1))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return !reader.failed();
+        }
+        case '"':
+            if (!reader.readString(text))
+            {
+                return false;
+            }
+            writeJsonString(text, out);
+            return true;
+        case 't':
+        case 'f':
+            if (!reader.readBool(flag))
+            {
+                return false;
+            }
+            out.boolean(flag);
+            return true;
+        case 'n':
+            if (!reader.skipValue())
+            {
+                return false;
+            }
+            out.nil();
+            return true;
+        default:
+            return reader.skipValue(&text) && writeJsonNumber(text, out);
+        }
+    }
+
+    // MessagePack strings carry no escapes, so their bytes serve as ObsWsMessage text slices.
+    bool readOrSkipString(ObsMsgPackReader &reader, ObsJsonSlice &value)
+    {
+        ObsMsgPackSlice text;
+        if (!reader.readString(text))
+        {
+            return reader.skipValue();
+        }
+        value.data = reinterpret_cast<const char *>(text.data);
+        value.length = text.length;
+        return true;
+    }
+
+    // Calls member(key) for each string key of the map at the reader; it consumes the value.
+    // A value that is not a map is skipped, like the JSON envelope parser does.
+    template <typename Member>
+    bool readMembers(ObsMsgPackReader &reader, Member member)
+    {
+        uint32_t count = 0;
+        if (!reader.readMap(count))
+        {
+            return reader.skipValue();
+        }
+
+        ObsMsgPackSlice key;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const bool ok = reader.readString(key) ? member(key) : reader.skipValue() && reader.skipValue();
+            if (!ok)
+            {
+                return false;
+            }
+        }
+        return !reader.failed();
+    }
+
+    bool parseRequestStatus(ObsMsgPackReader &reader, ObsWsMessage &message)
+    {
+        message.hasRequestStatus = reader.peek() == Type::Map;
+        return readMembers(reader, [&](const ObsMsgPackSlice &key)
+        {
+            if (key.equals("result"))
+            {
+                return reader.readBool(message.requestResult) || reader.skipValue();
+            }
+            if (key.equals("code"))
+            {
+                int64_t code = 0;
+                const bool ok = reader.readInteger(code) || reader.skipValue();
+                message.requestCode = static_cast<int32_t>(code);
+                return ok;
+            }
+            if (key.equals("comment"))
+            {
+                return readOrSkipString(reader, message.comment);
+            }
+            return reader.skipValue();
+        });
+    }
+
+    bool parseAuthentication(ObsMsgPackReader &reader, ObsWsMessage &message)
+    {
+        return readMembers(reader, [&](const ObsMsgPackSlice &key)
+        {
+            if (key.equals("challenge"))
+            {
+                return readOrSkipString(reader, message.challenge);
+            }
+            if (key.equals("salt"))
+            {
+                return readOrSkipString(reader, message.salt);
+            }
+            return reader.skipValue();
+        });
+    }
+
+    bool parseMessageData(ObsMsgPackReader &reader, ObsWsMessage &message, ObsWsMsgPackData &packed)
+    {
+        const uint8_t *begin = reader.cursor();
+        if (reader.peek() != Type::Map)
+        {
+            return reader.skipValue(&packed.data);
+        }
+
+        const bool ok = readMembers(reader, [&](const ObsMsgPackSlice &key)
+        {
+            if (key.equals("eventType"))
+            {
+                return readOrSkipString(reader, message.eventType);
+            }
+            if (key.equals("eventData"))
+            {
+                return reader.skipValue(&packed.eventData);
+            }
+            if (key.equals("requestId"))
+            {
+                return readOrSkipString(reader, message.requestId);
+            }
+            if (key.equals("requestType"))
+            {
+                return readOrSkipString(reader, message.requestType);
+            }
+            if (key.equals("requestStatus"))
+            {
+                return parseRequestStatus(reader, message);
+            }
+            if (key.equals("responseData"))
+            {
+                return reader.skipValue(&packed.responseData);
+            }
+            if (key.equals("results"))
+            {
+                return reader.skipValue(&packed.results);
+            }
+            if (key.equals("rpcVersion") || key.equals("negotiatedRpcVersion"))
+            {
+                int64_t version = 0;
+                if (!reader.readInteger(version))
+                {
+                    return reader.skipValue();
+                }
+                message.rpcVersion = version < 0 ? 0 : static_cast<uint32_t>(version);
+                return true;
+            }
+            if (key.equals("authentication"))
+            {
+                return parseAuthentication(reader, message);
+            }
+            return reader.skipValue();
+        });
+        if (!ok)
+        {
+            return false;
+        }
+
+        packed.data.data = begin;
+        packed.data.length = static_cast<size_t>(reader.cursor() - begin);
+        return true;
+    }
+
+    bool writeMsgPackValue(ObsMsgPackReader &reader, ObsJsonWriter &json, size_t depth)
+    {
+        ObsMsgPackSlice text;
+        uint32_t count = 0;
+        int64_t integer = 0;
+        double number = 0;
+        bool flag = false;
+        switch (reader.peek())
+        {
+        case Type::Nil:
+            reader.readNil();
+            json.null();
+            return true;
+        case Type::Bool:
+            reader.readBool(flag);
+            json.boolean(flag);
+            return true;
+        case Type::Integer:
+            if (reader.readInteger(integer))
+            {
+                json.integer(integer);
+                return true;
+            }
+            // Only unsigned values above INT64_MAX get here.
+            reader.readNumber(number);
+            json.number(number);
+            return true;
+        case Type::Float:
+            reader.readNumber(number);
+            json.number(number);
+            return true;
+        case Type::String:
+            reader.readString(text);
+            json.string(reinterpret_cast<const char *>(text.data), text.length);
+            return true;
+        case Type::Array:
+            if (depth >= kMaxDepth || !reader.readArray(count))
+            {
+                return false;
+            }
+            json.beginArray();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (!writeMsgPackValue(reader, json, depth + 1))
+                {
+                    return false;
+                }
+            }
+            json.endArray();
+            return true;
+        case Type::Map:
+            if (depth >= kMaxDepth || !reader.readMap(count))
+            {
+                return false;
+            }
+            json.beginObject();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (!reader.readString(text))
+                {
+                    return false;
+                }
+                json.key(reinterpret_cast<const char *>(text.data), text.length);
+                if (!writeMsgPackValue(reader, json, depth + 1))
+                {
+                    return false;
+                }
+            }
+            json.endObject();
+            return true;
+        case Type::Binary:
+        case Type::Extension:
+            if (!reader.skipValue())
+            {
+                return false;
+            }
+            json.null();
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
+// One decoded header. Integers and floats carry their value in `value`; containers carry
+// their element count there. `payload` is the length of string, binary and extension data
+// (the latter including its type byte).
+struct ObsMsgPackReader::Token
+{
+    Type type = Type::Invalid;
+    size_t header = 1;
+    size_t payload = 0;
+    uint64_t value = 0;
+};
+
+bool ObsMsgPackSlice::equals(const char *text) const
+{
+    const size_t textLength = text != nullptr ? std::strlen(text) : 0;
+    return length == textLength && (length == 0 || std::memcmp(data, text, length) == 0);
+}
+
+ObsMsgPackReader::ObsMsgPackReader(const uint8_t *data, size_t length)
+    : cur_(data), end_(data != nullptr ? data + length : nullptr)
+{
+}
+
+ObsMsgPackReader::ObsMsgPackReader(const ObsMsgPackSlice &slice)
+    : ObsMsgPackReader(slice.data, slice.length)
+{
+}
+
+bool ObsMsgPackReader::decode(const uint8_t *cur, const uint8_t *end, Token &token)
+{
+    if (cur >= end)
+    {
+        return false;
+    }
+
+    const uint8_t tag = *cur;
+    token = Token{};
+    size_t fieldBytes = 0;
+    bool isSigned = false;
+    if (tag <= 0x7F)
+    {
+        token.type = Type::Integer;
+        token.value = tag;
+    }
+    else if (tag >= 0xE0)
+    {
+        token.type = Type::Integer;
+        token.value = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int8_t>(tag)));
+    }
+    else if (tag <= 0x8F)
+    {
+        token.type = Type::Map;
+        token.value = tag & 0x0F;
+    }
+    else if (tag <= 0x9F)
+    {
+        token.type = Type::Array;
+        token.value = tag & 0x0F;
+    }
+    else if (tag <= 0xBF)
+    {
+        token.type = Type::String;
+        token.payload = tag & 0x1F;
+    }
+    else
+    {
+        switch (tag)
+        {
+        case 0xC0:
+            token.type = Type::Nil;
+            break;
+        case 0xC2:
+        case 0xC3:
+            token.type = Type::Bool;
+            token.value = tag & 0x01;
+            break;
+        case 0xC4:
+        case 0xC5:
+        case 0xC6:
+            token.type = Type::Binary;
+            fieldBytes = static_cast<size_t>(1) << (tag - 0xC4);
+            break;
+        case 0xC7:
+        case 0xC8:
+        case 0xC9:
+            token.type = Type::Extension;
+            fieldBytes = static_cast<size_t>(1) << (tag - 0xC7);
+            break;
+        case 0xCA:
+        case 0xCB:
+            token.type = Type::Float;
+            fieldBytes = tag == 0xCA ? 4 : 8;
+            break;
+        case 0xCC:
+        case 0xCD:
+        case 0xCE:
+        case 0xCF:
+            token.type = Type::Integer;
+            fieldBytes = static_cast<size_t>(1) << (tag - 0xCC);
+            break;
+        case 0xD0:
+        case 0xD1:
+        case 0xD2:
+        case 0xD3:
+            token.type = Type::Integer;
+            fieldBytes = static_cast<size_t>(1) << (tag - 0xD0);
+            isSigned = true;
+            break;
+        case 0xD4:
+        case 0xD5:
+        case 0xD6:
+        case 0xD7:
+        case 0xD8:
+            token.type = Type::Extension;
+            token.payload = 1 + (static_cast<size_t>(1) << (tag - 0xD4));
+            break;
+        case 0xD9:
+        case 0xDA:
+        case 0xDB:
+            token.type = Type::String;
+            fieldBytes = static_cast<size_t>(1) << (tag - 0xD9);
+            break;
+        case 0xDC:
+        case 0xDD:
+            token.type = Type::Array;
+            fieldBytes = tag == 0xDC ? 2 : 4;
+            break;
+        case 0xDE:
+        case 0xDF:
+            token.type = Type::Map;
+            fieldBytes = tag == 0xDE ? 2 : 4;
+            break;
+        default:
+            return false;
+        }
+    }
+
+    const size_t available = static_cast<size_t>(end - cur);
+    if (available < 1 + fieldBytes)
+    {
+        return false;
+    }
+    token.header = 1 + fieldBytes;
+    if (fieldBytes > 0)
+    {
+        const uint64_t field = readBigEndian(cur + 1, fieldBytes);
+        switch (token.type)
+        {
+        case Type::String:
+        case Type::Binary:
+        case Type::Extension:
+            if (field >= available)
+            {
+                return false;
+            }
+            token.payload = static_cast<size_t>(field) + (token.type == Type::Extension ? 1 : 0);
+            break;
+        case Type::Integer:
+            if (isSigned && fieldBytes < 8)
+            {
+                const unsigned shift = static_cast<unsigned>(64 - 8 * fieldBytes);
+                token.value = static_cast<uint64_t>(static_cast<int64_t>(field << shift) >> shift);
+            }
+            else
+            {
+                token.value = field;
+            }
+            break;
+        default:
+            token.value = field;
+            break;
+        }
+    }
+    return token.payload <= available - token.header;
+}
+
+bool ObsMsgPackReader::fail()
+{
+    failed_ = true;
+    return false;
+}
+
+bool ObsMsgPackReader::look(Type type, Token &token)
+{
+    if (failed_ || cur_ >= end_)
+    {
+        return false;
+    }
+    if (!decode(cur_, end_, token))
+    {
+        return fail();
+    }
+    return token.type == type;
+}
+
+void ObsMsgPackReader::consume(const Token &token)
+{
+    cur_ += token.header + token.payload;
+}
+
+ObsMsgPackReader::Type ObsMsgPackReader::peek() const
+{
+    if (failed_)
+    {
+        return Type::Invalid;
+    }
+    if (cur_ >= end_)
+    {
+        return Type::End;
+    }
+    Token token;
+    return decode(cur_, end_, token) ? token.type : Type::Invalid;
+}
+
+bool ObsMsgPackReader::readMap(uint32_t &count)
+{
+    Token token;
+    if (!look(Type::Map, token))
+    {
+        return false;
+    }
+    consume(token);
+    count = static_cast<uint32_t>(token.value);
+    return true;
+}
+
+bool ObsMsgPackReader::readArray(uint32_t &count)
+{
+    Token token;
+    if (!look(Type::Array, token))
+    {
+        return false;
+    }
+    consume(token);
+    count = static_cast<uint32_t>(token.value);
+    return true;
+}
+
+bool ObsMsgPackReader::readString(ObsMsgPackSlice &value)
+{
+    Token token;
+    if (!look(Type::String, token))
+    {
+        return false;
+    }
+    value.data = cur_ + token.header;
+    value.length = token.payload;
+    consume(token);
+    return true;
+}
+
+bool ObsMsgPackReader::readBinary(ObsMsgPackSlice &value)
+{
+    Token token;
+    if (!look(Type::Binary, token))
+    {
+        return false;
+    }
+    value.data = cur_ + token.header;
+    value.length = token.payload;
+    consume(token);
+    return true;
+}
+
+bool ObsMsgPackReader::readInteger(int64_t &value)
+{
+    Token token;
+    if (!look(Type::Integer, token))
+    {
+        return false;
+    }
+    // Only uint64 (0xCF) can hold a value whose top bit is not a sign bit.
+    if (*cur_ == 0xCF && token.value > static_cast<uint64_t>(INT64_MAX))
+    {
+        return false;
+    }
+    consume(token);
+    value = static_cast<int64_t>(token.value);
+    return true;
+}
+
+bool ObsMsgPackReader::readNumber(double &value)
+{
+    Token token;
+    if (look(Type::Integer, token))
+    {
+        const bool isUnsigned = *cur_ <= 0x7F || (*cur_ >= 0xCC && *cur_ <= 0xCF);
+        value = isUnsigned ? static_cast<double>(token.value) : static_cast<double>(static_cast<int64_t>(token.value));
+        consume(token);
+        return true;
+    }
+    if (token.type != Type::Float)
+    {
+        return false;
+    }
+
+    if (token.header == 5)
+    {
+        const uint32_t bits = static_cast<uint32_t>(token.value);
+        float single = 0;
+        std::memcpy(&single, &bits, sizeof(single));
+        value = single;
+    }
+    else
+    {
+        std::memcpy(&value, &token.value, sizeof(value));
+    }
+    consume(token);
+    return true;
+}
+
+bool ObsMsgPackReader::readBool(bool &value)
+{
+    Token token;
+    if (!look(Type::Bool, token))
+    {
+        return false;
+    }
+    consume(token);
+    value = token.value != 0;
+    return true;
+}
+
+bool ObsMsgPackReader::readNil()
+{
+    Token token;
+    if (!look(Type::Nil, token))
+    {
+        return false;
+    }
+    consume(token);
+    return true;
+}
+
+// Iterative, so nesting depth costs nothing: containers just add their elements to the count
+// of values still to skip.
+bool ObsMsgPackReader::skipValue(ObsMsgPackSlice *raw)
+{
+    if (failed_ || cur_ >= end_)
+    {
+        return false;
+    }
+
+    const uint8_t *start = cur_;
+    uint64_t remaining = 1;
+    while (remaining > 0)
+    {
+        Token token;
+        if (!decode(cur_, end_, token))
+        {
+            return fail();
+        }
+        consume(token);
+        --remaining;
+        if (token.type == Type::Map || token.type == Type::Array)
+        {
+            const uint64_t elements = token.type == Type::Map ? token.value * 2 : token.value;
+            // Every element takes at least one byte, which bounds counts in hostile input.
+            if (elements > static_cast<uint64_t>(end_ - cur_))
+            {
+                return fail();
+            }
+            remaining += elements;
+        }
+    }
+
+    if (raw != nullptr)
+    {
+        raw->data = start;
+        raw->length = static_cast<size_t>(cur_ - start);
+    }
+    return true;
+}
+
+bool ObsMsgPackReader::findMember(const ObsMsgPackSlice &map, const char *key, ObsMsgPackSlice &value)
+{
+    ObsMsgPackReader reader(map);
+    uint32_t count = 0;
+    if (!reader.readMap(count))
+    {
+        return false;
+    }
+
+    ObsMsgPackSlice name;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        // Keys that are not strings are skipped like any other value.
+        bool match = false;
+        if (reader.readString(name))
+        {
+            match = name.equals(key);
+        }
+        else if (!reader.skipValue())
+        {
+            return false;
+        }
+        if (match)
+        {
+            return reader.skipValue(&value);
+        }
+        if (!reader.skipValue())
+        {
+            return false;
+        }
+    }
+    return false;
+}
+
+ObsMsgPackWriter::ObsMsgPackWriter(uint8_t *buffer, size_t capacity)
+    : buffer_(buffer), capacity_(buffer != nullptr ? capacity : 0)
+{
+}
+
+uint8_t *ObsMsgPackWriter::reserve(size_t length)
+{
+    uint8_t *out = length_ + length <= capacity_ ? buffer_ + length_ : nullptr;
+    length_ += length;
+    return out;
+}
+
+void ObsMsgPackWriter::put(uint8_t tag, uint64_t value, size_t bytes)
+{
+    uint8_t *out = reserve(1 + bytes);
+    if (out == nullptr)
+    {
+        return;
+    }
+    out[0] = tag;
+    for (size_t i = bytes; i > 0; --i)
+    {
+        out[i] = static_cast<uint8_t>(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+void ObsMsgPackWriter::beginMap(uint32_t count)
+{
+    if (count < 16)
+    {
+        put(static_cast<uint8_t>(0x80 | count), 0, 0);
+    }
+    else if (count <= 0xFFFF)
+    {
+        put(0xDE, count, 2);
+    }
+    else
+    {
+        put(0xDF, count, 4);
+    }
+}
+
+void ObsMsgPackWriter::beginArray(uint32_t count)
+{
+    if (count < 16)
+    {
+        put(static_cast<uint8_t>(0x90 | count), 0, 0);
+    }
+    else if (count <= 0xFFFF)
+    {
+        put(0xDC, count, 2);
+    }
+    else
+    {
+        put(0xDD, count, 4);
+    }
+}
+
+uint8_t *ObsMsgPackWriter::beginString(size_t length)
+{
+    if (length < 32)
+    {
+        put(static_cast<uint8_t>(0xA0 | length), 0, 0);
+    }
+    else if (length <= 0xFF)
+    {
+        put(0xD9, length, 1);
+    }
+    else if (length <= 0xFFFF)
+    {
+        put(0xDA, length, 2);
+    }
+    else
+    {
+        put(0xDB, length, 4);
+    }
+    return reserve(length);
+}
+
+void ObsMsgPackWriter::string(const char *value, size_t length)
+{
+    uint8_t *out = beginString(length);
+    if (out != nullptr && length > 0)
+    {
+        std::memcpy(out, value, length);
+    }
+}
+
+void ObsMsgPackWriter::string(const char *value)
+{
+    string(value, value != nullptr ? std::strlen(value) : 0);
+}
+
+void ObsMsgPackWriter::integer(int64_t value)
+{
+    const uint64_t bits = static_cast<uint64_t>(value);
+    if (value >= 0)
+    {
+        if (value < 0x80)
+        {
+            put(static_cast<uint8_t>(value), 0, 0);
+        }
+        else if (value <= 0xFF)
+        {
+            put(0xCC, bits, 1);
+        }
+        else if (value <= 0xFFFF)
+        {
+            put(0xCD, bits, 2);
+        }
+        else if (value <= 0xFFFFFFFFLL)
+        {
+            put(0xCE, bits, 4);
+        }
+        else
+        {
+            put(0xCF, bits, 8);
+        }
+    }
+    else if (value >= -32)
+    {
+        put(static_cast<uint8_t>(value), 0, 0);
+    }
+    else if (value >= INT8_MIN)
+    {
+        put(0xD0, bits, 1);
+    }
+    else if (value >= INT16_MIN)
+    {
+        put(0xD1, bits, 2);
+    }
+    else if (value >= INT32_MIN)
+    {
+        put(0xD2, bits, 4);
+    }
+    else
+    {
+        put(0xD3, bits, 8);
+    }
+}
+
+void ObsMsgPackWriter::number(double value)
+{
+    const float single = static_cast<float>(value);
+    if (static_cast<double>(single) == value)
+    {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &single, sizeof(bits));
+        put(0xCA, bits, 4);
+        return;
+    }
+
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put(0xCB, bits, 8);
+}
+
+void ObsMsgPackWriter::boolean(bool value)
+{
+    put(value ? 0xC3 : 0xC2, 0, 0);
+}
+
+void ObsMsgPackWriter::nil()
+{
+    put(0xC0, 0, 0);
+}
+
+bool writeObsMsgPackAsJson(const ObsMsgPackSlice &value, ObsJsonWriter &json)
+{
+    ObsMsgPackReader reader(value);
+    return writeMsgPackValue(reader, json, 0) && !reader.failed();
+}
+
+bool writeObsJsonAsMsgPack(const char *json, size_t length, ObsMsgPackWriter &out)
+{
+    ObsJsonReader reader(json, length);
+    return writeJsonValue(reader, out, 0) && !reader.failed();
+}
+
+bool parseObsWsMsgPackMessage(const uint8_t *data, size_t length, ObsWsMessage &message, ObsWsMsgPackData &packed)
+{
+    message = ObsWsMessage{};
+    packed = ObsWsMsgPackData{};
+
+    ObsMsgPackReader reader(data, length);
+    if (reader.peek() != Type::Map)
+    {
+        return false;
+    }
+
+    return readMembers(reader, [&](const ObsMsgPackSlice &key)
+    {
+        if (key.equals("op"))
+        {
+            int64_t op = -1;
+            const bool ok = reader.readInteger(op) || reader.skipValue();
+            message.op = static_cast<int>(op);
+            return ok;
+        }
+        if (key.equals("d"))
+        {
+            return parseMessageData(reader, message, packed);
+        }
+        return reader.skipValue();
+    });
+}
+
+bool parseObsWsMsgPackRequestResult(ObsMsgPackReader &reader, ObsWsMessage &result, ObsWsMsgPackData &packed)
+{
+    result = ObsWsMessage{};
+    packed = ObsWsMsgPackData{};
+    return parseMessageData(reader, result, packed);
+}
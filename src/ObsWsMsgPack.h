@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "ObsWsJson.h"
+
+// A view into MessagePack bytes owned by someone else (usually the decoded frame). String
+// slices cover the string's bytes without its header.
+struct ObsMsgPackSlice
+{
+    const uint8_t *data = nullptr;
+    size_t length = 0;
+
+    bool empty() const { return data == nullptr || length == 0; }
+    bool equals(const char *text) const;
+};
+
+// Pull-style reader for MessagePack, the binary counterpart of ObsJsonReader: it walks the
+// bytes in place without allocating, typed reads return false without consuming anything when
+// the next value has a different type, and malformed or truncated input sets failed(). Maps
+// and arrays announce their size up front, so callers loop over the count they were given.
+class ObsMsgPackReader
+{
+public:
+    enum class Type
+    {
+        Nil,
+        Bool,
+        Integer,
+        Float,
+        String,
+        Binary,
+        Array,
+        Map,
+        Extension,
+        End,
+        Invalid
+    };
+
+    ObsMsgPackReader(const uint8_t *data, size_t length);
+    explicit ObsMsgPackReader(const ObsMsgPackSlice &slice);
+
+    Type peek() const;
+    // `count` is the number of key/value pairs that follow.
+    bool readMap(uint32_t &count);
+    bool readArray(uint32_t &count);
+
+    bool readString(ObsMsgPackSlice &value);
+    bool readBinary(ObsMsgPackSlice &value);
+    // Fails for unsigned values above INT64_MAX; readNumber() accepts those.
+    bool readInteger(int64_t &value);
+    bool readNumber(double &value);
+    bool readBool(bool &value);
+    bool readNil();
+    bool skipValue(ObsMsgPackSlice *raw = nullptr);
+
+    const uint8_t *cursor() const { return cur_; }
+    bool failed() const { return failed_; }
+
+    // Finds the string key `key` in the map in `map` and returns its encoded value.
+    static bool findMember(const ObsMsgPackSlice &map, const char *key, ObsMsgPackSlice &value);
+
+private:
+    struct Token;
+
+    static bool decode(const uint8_t *cur, const uint8_t *end, Token &token);
+    bool look(Type type, Token &token);
+    void consume(const Token &token);
+    bool fail();
+
+    const uint8_t *cur_;
+    const uint8_t *end_;
+    bool failed_ = false;
+};
+
+// Formats MessagePack straight into a caller-owned buffer. Like ObsJsonWriter it keeps
+// counting once the buffer is full, so required() reports the size to retry with; containers
+// take their element count up front.
+class ObsMsgPackWriter
+{
+public:
+    ObsMsgPackWriter(uint8_t *buffer, size_t capacity);
+
+    void beginMap(uint32_t count);
+    void beginArray(uint32_t count);
+    // Writes the header of a string of `length` bytes and returns where its bytes go, or
+    // nullptr once the buffer is full.
+    uint8_t *beginString(size_t length);
+    void string(const char *value, size_t length);
+    void string(const char *value);
+    // Integers use the smallest encoding that holds them; numbers are written as float32 when
+    // that is exact and as float64 otherwise.
+    void integer(int64_t value);
+    void number(double value);
+    void boolean(bool value);
+    void nil();
+
+    const uint8_t *data() const { return buffer_; }
+    size_t length() const { return length_; }
+    size_t required() const { return length_; }
+    bool overflowed() const { return length_ > capacity_; }
+
+private:
+    uint8_t *reserve(size_t length);
+    void put(uint8_t tag, uint64_t value, size_t bytes);
+
+    uint8_t *buffer_;
+    size_t capacity_;
+    size_t length_ = 0;
+};
+
+// Renders one MessagePack value as JSON. False for malformed input, map keys that are not
+// strings and nesting deeper than 32 levels. Binary and extension values, which obs-websocket
+// does not send, are written as null.
+bool writeObsMsgPackAsJson(const ObsMsgPackSlice &value, ObsJsonWriter &json);
+
+// Encodes one JSON value as MessagePack. Strings are unescaped, integers keep their exact
+// value and every other number becomes a float.
+bool writeObsJsonAsMsgPack(const char *json, size_t length, ObsMsgPackWriter &out);
+
+// The payload members of a MessagePack obs-websocket message, left encoded.
+struct ObsWsMsgPackData
+{
+    ObsMsgPackSlice data;
+    ObsMsgPackSlice eventData;
+    ObsMsgPackSlice responseData;
+    ObsMsgPackSlice results;
+};
+
+// parseObsWsMessage() for obswebsocket.msgpack sessions, also in one pass. The envelope fields
+// go into `message`; its string slices cover the decoded text in the frame, since MessagePack
+// strings carry no escapes. The payload members go into `packed`, and message's JSON slices
+// for them stay empty.
+bool parseObsWsMsgPackMessage(const uint8_t *data, size_t length, ObsWsMessage &message, ObsWsMsgPackData &packed);
+
+// parseObsWsRequestResult() for one entry of a MessagePack "results" array.
+bool parseObsWsMsgPackRequestResult(ObsMsgPackReader &reader, ObsWsMessage &result, ObsWsMsgPackData &packed);
@@ -0,0 +1,515 @@
+#include "ObsWsNames.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    constexpr uint32_t kFnvOffsetBasis = 2166136261u;
+    constexpr uint32_t kFnvPrime = 16777619u;
+    // Leaves kObsNoName free to mark empty slots.
+    constexpr size_t kMaxNames = 0xFFFE;
+
+    // Escaped names up to this size are decoded on the stack.
+    constexpr size_t kInlineNameBytes = 96;
+
+    uint32_t hashName(const char *data, size_t length)
+    {
+        uint32_t hash = kFnvOffsetBasis;
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash = (hash ^ static_cast<uint8_t>(data[i])) * kFnvPrime;
+        }
+        return hash;
+    }
+
+    // A name as it appears in a frame, unescaped before the table lock is taken. Names without
+    // escapes are used where they lie; decoding never makes a name longer.
+    class DecodedName
+    {
+    public:
+        explicit DecodedName(const ObsJsonSlice &raw)
+            : data_(raw.data), length_(raw.length)
+        {
+            if (raw.length == 0 || std::memchr(raw.data, '\\', raw.length) == nullptr)
+            {
+                return;
+            }
+
+            char *out = inline_;
+            if (raw.length > sizeof(inline_))
+            {
+                heap_ = static_cast<char *>(std::malloc(raw.length));
+                out = heap_;
+            }
+            data_ = out;
+            length_ = out != nullptr ? unescapeJsonString(raw, out, raw.length) : 0;
+        }
+
+        ~DecodedName()
+        {
+            std::free(heap_);
+        }
+
+        DecodedName(const DecodedName &) = delete;
+        DecodedName &operator=(const DecodedName &) = delete;
+
+        bool valid() const { return data_ != nullptr; }
+        const char *data() const { return data_; }
+        size_t length() const { return length_; }
+
+    private:
+        char inline_[kInlineNameBytes];
+        char *heap_ = nullptr;
+        const char *data_;
+        size_t length_;
+    };
+}
+
+bool ObsHashIndex::allocate(size_t records)
+{
+    size_t slots = 4;
+    while (slots < records * 2)
+    {
+        slots <<= 1;
+    }
+
+    slots_ = static_cast<Slot *>(std::malloc(slots * sizeof(Slot)));
+    if (slots_ == nullptr)
+    {
+        return false;
+    }
+    mask_ = slots - 1;
+    clear();
+    return true;
+}
+
+void ObsHashIndex::release()
+{
+    std::free(slots_);
+    slots_ = nullptr;
+    mask_ = 0;
+}
+
+void ObsHashIndex::clear()
+{
+    for (size_t i = 0; slots_ != nullptr && i <= mask_; ++i)
+    {
+        slots_[i].record = kObsNoName;
+    }
+}
+
+void ObsHashIndex::insert(uint32_t hash, uint16_t record)
+{
+    size_t i = hash & mask_;
+    while (slots_[i].record != kObsNoName)
+    {
+        i = (i + 1) & mask_;
+    }
+    slots_[i].hash = hash;
+    slots_[i].record = record;
+}
+
+void ObsHashIndex::erase(uint32_t hash, uint16_t record)
+{
+    size_t hole = hash & mask_;
+    while (slots_[hole].record != record)
+    {
+        if (slots_[hole].record == kObsNoName)
+        {
+            return;
+        }
+        hole = (hole + 1) & mask_;
+    }
+
+    // Pull later entries of the probe run back into the hole unless that would move them in
+    // front of their home slot.
+    for (size_t i = (hole + 1) & mask_; slots_[i].record != kObsNoName; i = (i + 1) & mask_)
+    {
+        const size_t home = slots_[i].hash & mask_;
+        if (((i - home) & mask_) >= ((i - hole) & mask_))
+        {
+            slots_[hole] = slots_[i];
+            hole = i;
+        }
+    }
+    slots_[hole].record = kObsNoName;
+}
+
+ObsNameTable::~ObsNameTable()
+{
+    deallocate();
+}
+
+// Handles survive reconnects: begin() only rebuilds the table when its size changes.
+bool ObsNameTable::allocate(size_t maxNames, size_t poolBytes)
+{
+    maxNames = std::min(maxNames, kMaxNames);
+    if (entries_ != nullptr && capacity_ == maxNames && poolCapacity_ == poolBytes)
+    {
+        return true;
+    }
+    deallocate();
+    if (maxNames == 0)
+    {
+        return true;
+    }
+
+    Entry *entries = static_cast<Entry *>(std::malloc(maxNames * sizeof(Entry)));
+    char *pool = static_cast<char *>(std::malloc(std::max<size_t>(poolBytes, 1)));
+    ObsHashIndex index;
+    if (entries == nullptr || pool == nullptr || !index.allocate(maxNames))
+    {
+        std::free(entries);
+        std::free(pool);
+        index.release();
+        return false;
+    }
+
+    // Every slot starts on the free list in order.
+    for (size_t i = 0; i < maxNames; ++i)
+    {
+        entries[i] = Entry();
+        entries[i].nextFree = i + 1 < maxNames ? static_cast<uint16_t>(i + 1) : kObsNoName;
+    }
+
+    portENTER_CRITICAL(&lock_);
+    entries_ = entries;
+    capacity_ = maxNames;
+    count_ = 0;
+    freeHead_ = 0;
+    freeTail_ = static_cast<uint16_t>(maxNames - 1);
+    pool_ = pool;
+    poolCapacity_ = poolBytes;
+    poolUsed_ = 0;
+    poolLive_ = 0;
+    poolHead_ = kObsNoName;
+    poolTail_ = kObsNoName;
+    compacting_ = false;
+    compactNext_ = kObsNoName;
+    compactTo_ = 0;
+    index_ = index;
+    portEXIT_CRITICAL(&lock_);
+    return true;
+}
+
+void ObsNameTable::deallocate()
+{
+    portENTER_CRITICAL(&lock_);
+    Entry *entries = entries_;
+    char *pool = pool_;
+    ObsHashIndex index = index_;
+    entries_ = nullptr;
+    capacity_ = 0;
+    count_ = 0;
+    freeHead_ = kObsNoName;
+    freeTail_ = kObsNoName;
+    pool_ = nullptr;
+    poolCapacity_ = 0;
+    poolUsed_ = 0;
+    poolLive_ = 0;
+    poolHead_ = kObsNoName;
+    poolTail_ = kObsNoName;
+    compacting_ = false;
+    compactNext_ = kObsNoName;
+    compactTo_ = 0;
+    index_ = ObsHashIndex();
+    portEXIT_CRITICAL(&lock_);
+
+    std::free(entries);
+    std::free(pool);
+    index.release();
+}
+
+ObsNameHandle ObsNameTable::intern(const char *name)
+{
+    return name != nullptr ? internDecoded(name, std::strlen(name)) : kObsNoName;
+}
+
+ObsNameHandle ObsNameTable::find(const char *name) const
+{
+    return name != nullptr ? findDecoded(name, std::strlen(name)) : kObsNoName;
+}
+
+void ObsNameTable::release(ObsNameHandle handle)
+{
+    portENTER_CRITICAL(&lock_);
+    if (handle < capacity_ && entries_[handle].refs > 0 && --entries_[handle].refs == 0)
+    {
+        // The pool bytes are reclaimed by the next compaction.
+        index_.erase(entries_[handle].hash, handle);
+        unlinkLocked(handle);
+        poolLive_ -= entries_[handle].length + 1;
+        entries_[handle].nextFree = kObsNoName;
+        if (freeTail_ != kObsNoName)
+        {
+            entries_[freeTail_].nextFree = handle;
+        }
+        else
+        {
+            freeHead_ = handle;
+        }
+        freeTail_ = handle;
+        --count_;
+    }
+    portEXIT_CRITICAL(&lock_);
+}
+
+bool ObsNameTable::retain(ObsNameHandle handle)
+{
+    portENTER_CRITICAL(&lock_);
+    const bool live = handle < capacity_ && entries_[handle].refs > 0 && entries_[handle].refs < UINT16_MAX;
+    if (live)
+    {
+        ++entries_[handle].refs;
+    }
+    portEXIT_CRITICAL(&lock_);
+    return live;
+}
+
+bool ObsNameTable::copy(ObsNameHandle handle, char *out, size_t size) const
+{
+    if (out == nullptr)
+    {
+        return false;
+    }
+
+    portENTER_CRITICAL(&lock_);
+    const bool fits = handle < capacity_ && entries_[handle].refs > 0 && entries_[handle].length < size;
+    if (fits)
+    {
+        std::memcpy(out, pool_ + entries_[handle].offset, entries_[handle].length + 1);
+    }
+    portEXIT_CRITICAL(&lock_);
+    return fits;
+}
+
+uint32_t ObsNameTable::hash(ObsNameHandle handle) const
+{
+    portENTER_CRITICAL(&lock_);
+    const uint32_t value = handle < capacity_ && entries_[handle].refs > 0 ? entries_[handle].hash : 0;
+    portEXIT_CRITICAL(&lock_);
+    return value;
+}
+
+size_t ObsNameTable::size() const
+{
+    portENTER_CRITICAL(&lock_);
+    const size_t count = count_;
+    portEXIT_CRITICAL(&lock_);
+    return count;
+}
+
+ObsNameHandle ObsNameTable::internJson(const ObsJsonSlice &raw)
+{
+    const DecodedName name(raw);
+    return name.valid() ? internDecoded(name.data(), name.length()) : kObsNoName;
+}
+
+ObsNameHandle ObsNameTable::findJson(const ObsJsonSlice &raw) const
+{
+    if (size() == 0)
+    {
+        return kObsNoName;
+    }
+    const DecodedName name(raw);
+    return name.valid() ? findDecoded(name.data(), name.length()) : kObsNoName;
+}
+
+bool ObsNameTable::writeJson(ObsNameHandle handle, ObsJsonWriter &json) const
+{
+    char name[kInlineNameBytes];
+    char *heap = nullptr;
+    size_t length = 0;
+    bool known = false;
+
+    // Longer names are measured first and copied once the buffer is allocated; a name that
+    // changed in between was released, so it is reported as unknown.
+    for (int attempt = 0; attempt < 2 && !known; ++attempt)
+    {
+        char *out = heap != nullptr ? heap : name;
+        const size_t room = heap != nullptr ? length + 1 : sizeof(name);
+        portENTER_CRITICAL(&lock_);
+        const bool live = handle < capacity_ && entries_[handle].refs > 0 && (heap == nullptr || entries_[handle].length == length);
+        length = live ? entries_[handle].length : 0;
+        known = live && length < room;
+        if (known)
+        {
+            std::memcpy(out, pool_ + entries_[handle].offset, length);
+        }
+        portEXIT_CRITICAL(&lock_);
+
+        if (!live || known || heap != nullptr)
+        {
+            break;
+        }
+        heap = static_cast<char *>(std::malloc(length + 1));
+        if (heap == nullptr)
+        {
+            break;
+        }
+    }
+
+    if (known)
+    {
+        json.string(heap != nullptr ? heap : name, length);
+    }
+    std::free(heap);
+    return known;
+}
+
+ObsNameHandle ObsNameTable::findDecoded(const char *name, size_t length) const
+{
+    const uint32_t hash = hashName(name, length);
+    portENTER_CRITICAL(&lock_);
+    const ObsNameHandle handle = count_ > 0 ? findLocked(name, length, hash) : kObsNoName;
+    portEXIT_CRITICAL(&lock_);
+    return handle;
+}
+
+ObsNameHandle ObsNameTable::findLocked(const char *name, size_t length, uint32_t hash) const
+{
+    return index_.find(hash, [&](uint16_t handle)
+    {
+        const Entry &entry = entries_[handle];
+        return entry.length == length && std::memcmp(pool_ + entry.offset, name, length) == 0;
+    });
+}
+
+// When the pool is full, the lock is dropped after every compaction step so other tasks and
+// interrupts get in between; the loop ends once the name fits or nothing is left to reclaim.
+ObsNameHandle ObsNameTable::internDecoded(const char *name, size_t length)
+{
+    const uint32_t hash = hashName(name, length);
+    for (;;)
+    {
+        portENTER_CRITICAL(&lock_);
+        ObsNameHandle handle = findLocked(name, length, hash);
+        if (handle != kObsNoName)
+        {
+            if (entries_[handle].refs == UINT16_MAX)
+            {
+                handle = kObsNoName;
+            }
+            else
+            {
+                ++entries_[handle].refs;
+            }
+            portEXIT_CRITICAL(&lock_);
+            return handle;
+        }
+
+        if (freeHead_ == kObsNoName)
+        {
+            portEXIT_CRITICAL(&lock_);
+            return kObsNoName;
+        }
+
+        if (poolCapacity_ - poolUsed_ > length)
+        {
+            handle = freeHead_;
+            Entry &entry = entries_[handle];
+            freeHead_ = entry.nextFree;
+            if (freeHead_ == kObsNoName)
+            {
+                freeTail_ = kObsNoName;
+            }
+
+            std::memcpy(pool_ + poolUsed_, name, length);
+            pool_[poolUsed_ + length] = '\0';
+            entry.hash = hash;
+            entry.offset = static_cast<uint32_t>(poolUsed_);
+            entry.length = static_cast<uint32_t>(length);
+            entry.refs = 1;
+            entry.nextFree = kObsNoName;
+            entry.prevInPool = poolTail_;
+            entry.nextInPool = kObsNoName;
+            if (poolTail_ != kObsNoName)
+            {
+                entries_[poolTail_].nextInPool = handle;
+            }
+            else
+            {
+                poolHead_ = handle;
+            }
+            poolTail_ = handle;
+            poolUsed_ += length + 1;
+            poolLive_ += length + 1;
+            index_.insert(hash, handle);
+            ++count_;
+            portEXIT_CRITICAL(&lock_);
+            return handle;
+        }
+
+        const bool progressed = compactStepLocked();
+        portEXIT_CRITICAL(&lock_);
+        if (!progressed)
+        {
+            return kObsNoName;
+        }
+    }
+}
+
+// Names that lost their last reference stay in the pool until it fills up; live names are
+// then slid down one per step, walking them in pool order. Returns false when no bytes can
+// be reclaimed.
+bool ObsNameTable::compactStepLocked()
+{
+    if (!compacting_)
+    {
+        if (poolLive_ == poolUsed_)
+        {
+            return false;
+        }
+        compacting_ = true;
+        compactNext_ = poolHead_;
+        compactTo_ = 0;
+    }
+
+    if (compactNext_ != kObsNoName)
+    {
+        Entry &entry = entries_[compactNext_];
+        if (entry.offset != compactTo_)
+        {
+            std::memmove(pool_ + compactTo_, pool_ + entry.offset, entry.length + 1);
+            entry.offset = static_cast<uint32_t>(compactTo_);
+        }
+        compactTo_ += entry.length + 1;
+        compactNext_ = entry.nextInPool;
+    }
+
+    if (compactNext_ == kObsNoName)
+    {
+        poolUsed_ = compactTo_;
+        compacting_ = false;
+    }
+    return true;
+}
+
+void ObsNameTable::unlinkLocked(ObsNameHandle handle)
+{
+    Entry &entry = entries_[handle];
+    if (compactNext_ == handle)
+    {
+        compactNext_ = entry.nextInPool;
+    }
+    if (entry.prevInPool != kObsNoName)
+    {
+        entries_[entry.prevInPool].nextInPool = entry.nextInPool;
+    }
+    else
+    {
+        poolHead_ = entry.nextInPool;
+    }
+    if (entry.nextInPool != kObsNoName)
+    {
+        entries_[entry.nextInPool].prevInPool = entry.prevInPool;
+    }
+    else
+    {
+        poolTail_ = entry.prevInPool;
+    }
+    entry.prevInPool = kObsNoName;
+    entry.nextInPool = kObsNoName;
+}
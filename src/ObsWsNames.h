@@ -0,0 +1,134 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+#include <cstddef>
+#include <cstdint>
+#include "ObsWsJson.h"
+
+struct ObsInputMeter;
+struct ObsMsgPackSlice;
+
+// Small integer standing for an interned scene, input or source name. Two handles from the
+// same table are equal exactly when the names are.
+using ObsNameHandle = uint16_t;
+constexpr ObsNameHandle kObsNoName = 0xFFFF;
+
+// Linear-probing table of 16-bit record numbers keyed by a caller-computed hash, shared by the
+// name table and the state cache. It has at least twice as many slots as records, and erase
+// shifts entries back instead of leaving tombstones, so probes stay short under churn.
+class ObsHashIndex
+{
+public:
+    bool allocate(size_t records);
+    void release();
+    void clear();
+    void insert(uint32_t hash, uint16_t record);
+    void erase(uint32_t hash, uint16_t record);
+
+    template <typename Match>
+    uint16_t find(uint32_t hash, Match match) const
+    {
+        if (slots_ == nullptr)
+        {
+            return kObsNoName;
+        }
+        for (size_t i = hash & mask_; slots_[i].record != kObsNoName; i = (i + 1) & mask_)
+        {
+            if (slots_[i].hash == hash && match(slots_[i].record))
+            {
+                return slots_[i].record;
+            }
+        }
+        return kObsNoName;
+    }
+
+private:
+    struct Slot
+    {
+        uint32_t hash;
+        uint16_t record;
+    };
+
+    Slot *slots_ = nullptr;
+    size_t mask_ = 0;
+};
+
+// Fixed-capacity intern table for OBS object names (ObsWsClient::names()). Each name is stored
+// once, decoded, in a shared pool along with its FNV-1a hash, and is reference counted:
+// intern() adds a reference and release() drops it, and the name is forgotten with its last
+// reference. Freed handles are reused oldest first. Safe to call from any task; hashing and
+// unescaping happen before the lock is taken, and each critical section touches at most one
+// name, so interrupts are never held off for longer than a short memcpy.
+class ObsNameTable
+{
+public:
+    ObsNameTable() = default;
+    ~ObsNameTable();
+    ObsNameTable(const ObsNameTable &) = delete;
+    ObsNameTable &operator=(const ObsNameTable &) = delete;
+
+    // kObsNoName when the table or the pool is full.
+    ObsNameHandle intern(const char *name);
+    // Looks `name` up without storing it or taking a reference.
+    ObsNameHandle find(const char *name) const;
+    void release(ObsNameHandle handle);
+    // Copies the name into `out`; false for unknown handles or when `size` is too small.
+    bool copy(ObsNameHandle handle, char *out, size_t size) const;
+    uint32_t hash(ObsNameHandle handle) const;
+    size_t size() const;
+    size_t capacity() const { return capacity_; }
+
+private:
+    friend class ObsWsClient;
+    friend class ObsStateCache;
+    friend size_t decodeObsVolumeMeters(const ObsJsonSlice &, ObsNameTable &, ObsInputMeter *, size_t);
+    friend size_t decodeObsVolumeMeters(const ObsMsgPackSlice &, ObsNameTable &, ObsInputMeter *, size_t);
+
+    struct Entry
+    {
+        uint32_t hash = 0;
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        uint16_t refs = 0;
+        uint16_t nextFree = kObsNoName;
+        // Live names in pool order, so compaction needs no sort.
+        uint16_t prevInPool = kObsNoName;
+        uint16_t nextInPool = kObsNoName;
+    };
+
+    bool allocate(size_t maxNames, size_t poolBytes);
+    void deallocate();
+    // The same for names still JSON-escaped, as they appear in a frame.
+    ObsNameHandle internJson(const ObsJsonSlice &raw);
+    ObsNameHandle findJson(const ObsJsonSlice &raw) const;
+    // Writes the name as a JSON string; false for unknown handles. The name is copied out
+    // under the lock and escaped after it is dropped.
+    bool writeJson(ObsNameHandle handle, ObsJsonWriter &json) const;
+
+    // Adds a reference to a live handle; false when it is unknown or saturated.
+    bool retain(ObsNameHandle handle);
+    ObsNameHandle internDecoded(const char *name, size_t length);
+    ObsNameHandle findDecoded(const char *name, size_t length) const;
+    ObsNameHandle findLocked(const char *name, size_t length, uint32_t hash) const;
+    bool compactStepLocked();
+    void unlinkLocked(ObsNameHandle handle);
+
+    Entry *entries_ = nullptr;
+    size_t capacity_ = 0;
+    size_t count_ = 0;
+    uint16_t freeHead_ = kObsNoName;
+    uint16_t freeTail_ = kObsNoName;
+    char *pool_ = nullptr;
+    size_t poolCapacity_ = 0;
+    size_t poolUsed_ = 0;
+    size_t poolLive_ = 0; // Bytes of poolUsed_ still referenced.
+    uint16_t poolHead_ = kObsNoName;
+    uint16_t poolTail_ = kObsNoName;
+    // A compaction in progress slides one name per step from compactNext_ down to compactTo_,
+    // dropping the lock in between; names appended meanwhile join the end of the walk.
+    bool compacting_ = false;
+    uint16_t compactNext_ = kObsNoName;
+    size_t compactTo_ = 0;
+    ObsHashIndex index_;
+    mutable portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+};
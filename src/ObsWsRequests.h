@@ -0,0 +1,1524 @@
+// Generated by tools/generate_requests.py from tools/protocol-requests.json. Do not edit by hand.
+#pragma once
+
+#include <cstring>
+#include "ObsWsJson.h"
+
+// A request field that is only sent when assigned.
+template <typename T>
+struct ObsOptional
+{
+    bool set = false;
+    T value{};
+
+    ObsOptional &operator=(T next)
+    {
+        set = true;
+        value = next;
+        return *this;
+    }
+};
+
+// Typed builders for ObsWsClient::send(). String fields left as nullptr are omitted, so OBS
+// reports a missing required field instead of receiving an empty one. Response views parse
+// the responseData of an ObsRequestResult; their string slices point into that buffer and
+// keep JSON escapes as sent.
+namespace ObsRequests
+{
+    namespace detail
+    {
+        inline void readField(ObsJsonReader &reader, ObsJsonSlice &value)
+        {
+            if (!reader.readString(value))
+            {
+                reader.skipValue();
+            }
+        }
+
+        inline void readField(ObsJsonReader &reader, bool &value)
+        {
+            if (!reader.readBool(value))
+            {
+                reader.skipValue();
+            }
+        }
+
+        inline void readField(ObsJsonReader &reader, int64_t &value)
+        {
+            if (!reader.readInteger(value))
+            {
+                reader.skipValue();
+            }
+        }
+
+        inline void readField(ObsJsonReader &reader, double &value)
+        {
+            if (!reader.readNumber(value))
+            {
+                reader.skipValue();
+            }
+        }
+
+        inline void readRaw(ObsJsonReader &reader, ObsJsonSlice &value)
+        {
+            reader.skipValue(&value);
+        }
+    }
+
+    // Broadcasts a CustomEvent to all WebSocket clients.
+    struct BroadcastCustomEvent
+    {
+        static constexpr const char *kRequestType = "BroadcastCustomEvent";
+        static constexpr bool kHasData = true;
+
+        const char *eventData = nullptr; // JSON text, written verbatim
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (eventData != nullptr)
+            {
+                json.key("eventData");
+                json.raw(eventData, std::strlen(eventData));
+            }
+        }
+
+        // JSON text fields are spliced in verbatim, so send() refuses them when malformed.
+        bool valid() const
+        {
+            return (eventData == nullptr || isJsonObject(eventData, std::strlen(eventData)));
+        }
+    };
+
+    // Gets the current preview scene. Only available when studio mode is enabled.
+    struct GetCurrentPreviewScene
+    {
+        static constexpr const char *kRequestType = "GetCurrentPreviewScene";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            ObsJsonSlice sceneName;
+            ObsJsonSlice sceneUuid;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("sceneName"))
+                    {
+                        detail::readField(reader, sceneName);
+                    }
+                    else if (key.equals("sceneUuid"))
+                    {
+                        detail::readField(reader, sceneUuid);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Gets the current program scene.
+    struct GetCurrentProgramScene
+    {
+        static constexpr const char *kRequestType = "GetCurrentProgramScene";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            ObsJsonSlice sceneName;
+            ObsJsonSlice sceneUuid;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("sceneName"))
+                    {
+                        detail::readField(reader, sceneName);
+                    }
+                    else if (key.equals("sceneUuid"))
+                    {
+                        detail::readField(reader, sceneUuid);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Gets the audio mute state of an input.
+    struct GetInputMute
+    {
+        static constexpr const char *kRequestType = "GetInputMute";
+        static constexpr bool kHasData = true;
+
+        const char *inputName = nullptr;
+        const char *inputUuid = nullptr;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (inputName != nullptr)
+            {
+                json.key("inputName");
+                json.string(inputName);
+            }
+            if (inputUuid != nullptr)
+            {
+                json.key("inputUuid");
+                json.string(inputUuid);
+            }
+        }
+
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            bool inputMuted = false;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("inputMuted"))
+                    {
+                        detail::readField(reader, inputMuted);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Gets the current volume setting of an input.
+    struct GetInputVolume
+    {
+        static constexpr const char *kRequestType = "GetInputVolume";
+        static constexpr bool kHasData = true;
+
+        const char *inputName = nullptr;
+        const char *inputUuid = nullptr;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (inputName != nullptr)
+            {
+                json.key("inputName");
+                json.string(inputName);
+            }
+            if (inputUuid != nullptr)
+            {
+                json.key("inputUuid");
+                json.string(inputUuid);
+            }
+        }
+
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            double inputVolumeMul = 0;
+            double inputVolumeDb = 0;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("inputVolumeMul"))
+                    {
+                        detail::readField(reader, inputVolumeMul);
+                    }
+                    else if (key.equals("inputVolumeDb"))
+                    {
+                        detail::readField(reader, inputVolumeDb);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Gets an array of all profiles.
+    struct GetProfileList
+    {
+        static constexpr const char *kRequestType = "GetProfileList";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            ObsJsonSlice currentProfileName;
+            ObsJsonSlice profiles;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("currentProfileName"))
+                    {
+                        detail::readField(reader, currentProfileName);
+                    }
+                    else if (key.equals("profiles"))
+                    {
+                        detail::readRaw(reader, profiles);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Gets the status of the record output.
+    struct GetRecordStatus
+    {
+        static constexpr const char *kRequestType = "GetRecordStatus";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            bool outputActive = false;
+            bool outputPaused = false;
+            ObsJsonSlice outputTimecode;
+            int64_t outputDuration = 0;
+            int64_t outputBytes = 0;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("outputActive"))
+                    {
+                        detail::readField(reader, outputActive);
+                    }
+                    else if (key.equals("outputPaused"))
+                    {
+                        detail::readField(reader, outputPaused);
+                    }
+                    else if (key.equals("outputTimecode"))
+                    {
+                        detail::readField(reader, outputTimecode);
+                    }
+                    else if (key.equals("outputDuration"))
+                    {
+                        detail::readField(reader, outputDuration);
+                    }
+                    else if (key.equals("outputBytes"))
+                    {
+                        detail::readField(reader, outputBytes);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Gets an array of all scene collections.
+    struct GetSceneCollectionList
+    {
+        static constexpr const char *kRequestType = "GetSceneCollectionList";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            ObsJsonSlice currentSceneCollectionName;
+            ObsJsonSlice sceneCollections;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("currentSceneCollectionName"))
+                    {
+                        detail::readField(reader, currentSceneCollectionName);
+                    }
+                    else if (key.equals("sceneCollections"))
+                    {
+                        detail::readRaw(reader, sceneCollections);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Gets the enable state of a scene item.
+    struct GetSceneItemEnabled
+    {
+        static constexpr const char *kRequestType = "GetSceneItemEnabled";
+        static constexpr bool kHasData = true;
+
+        const char *sceneName = nullptr;
+        const char *sceneUuid = nullptr;
+        int64_t sceneItemId = 0;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (sceneName != nullptr)
+            {
+                json.key("sceneName");
+                json.string(sceneName);
+            }
+            if (sceneUuid != nullptr)
+            {
+                json.key("sceneUuid");
+                json.string(sceneUuid);
+            }
+            json.key("sceneItemId");
+            json.integer(sceneItemId);
+        }
+
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            bool sceneItemEnabled = false;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("sceneItemEnabled"))
+                    {
+                        detail::readField(reader, sceneItemEnabled);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Searches a scene for a source, and returns its id.
+    struct GetSceneItemId
+    {
+        static constexpr const char *kRequestType = "GetSceneItemId";
+        static constexpr bool kHasData = true;
+
+        const char *sceneName = nullptr;
+        const char *sceneUuid = nullptr;
+        const char *sourceName = nullptr;
+        ObsOptional<int64_t> searchOffset;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (sceneName != nullptr)
+            {
+                json.key("sceneName");
+                json.string(sceneName);
+            }
+            if (sceneUuid != nullptr)
+            {
+                json.key("sceneUuid");
+                json.string(sceneUuid);
+            }
+            if (sourceName != nullptr)
+            {
+                json.key("sourceName");
+                json.string(sourceName);
+            }
+            if (searchOffset.set)
+            {
+                json.key("searchOffset");
+                json.integer(searchOffset.value);
+            }
+        }
+
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            int64_t sceneItemId = 0;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("sceneItemId"))
+                    {
+                        detail::readField(reader, sceneItemId);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Gets an array of all scenes in OBS.
+    struct GetSceneList
+    {
+        static constexpr const char *kRequestType = "GetSceneList";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            ObsJsonSlice currentProgramSceneName;
+            ObsJsonSlice currentProgramSceneUuid;
+            ObsJsonSlice currentPreviewSceneName;
+            ObsJsonSlice currentPreviewSceneUuid;
+            ObsJsonSlice scenes;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("currentProgramSceneName"))
+                    {
+                        detail::readField(reader, currentProgramSceneName);
+                    }
+                    else if (key.equals("currentProgramSceneUuid"))
+                    {
+                        detail::readField(reader, currentProgramSceneUuid);
+                    }
+                    else if (key.equals("currentPreviewSceneName"))
+                    {
+                        detail::readField(reader, currentPreviewSceneName);
+                    }
+                    else if (key.equals("currentPreviewSceneUuid"))
+                    {
+                        detail::readField(reader, currentPreviewSceneUuid);
+                    }
+                    else if (key.equals("scenes"))
+                    {
+                        detail::readRaw(reader, scenes);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Gets statistics about OBS, obs-websocket, and the current session.
+    struct GetStats
+    {
+        static constexpr const char *kRequestType = "GetStats";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            double cpuUsage = 0;
+            double memoryUsage = 0;
+            double availableDiskSpace = 0;
+            double activeFps = 0;
+            double averageFrameRenderTime = 0;
+            int64_t renderSkippedFrames = 0;
+            int64_t renderTotalFrames = 0;
+            int64_t outputSkippedFrames = 0;
+            int64_t outputTotalFrames = 0;
+            int64_t webSocketSessionIncomingMessages = 0;
+            int64_t webSocketSessionOutgoingMessages = 0;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("cpuUsage"))
+                    {
+                        detail::readField(reader, cpuUsage);
+                    }
+                    else if (key.equals("memoryUsage"))
+                    {
+                        detail::readField(reader, memoryUsage);
+                    }
+                    else if (key.equals("availableDiskSpace"))
+                    {
+                        detail::readField(reader, availableDiskSpace);
+                    }
+                    else if (key.equals("activeFps"))
+                    {
+                        detail::readField(reader, activeFps);
+                    }
+                    else if (key.equals("averageFrameRenderTime"))
+                    {
+                        detail::readField(reader, averageFrameRenderTime);
+                    }
+                    else if (key.equals("renderSkippedFrames"))
+                    {
+                        detail::readField(reader, renderSkippedFrames);
+                    }
+                    else if (key.equals("renderTotalFrames"))
+                    {
+                        detail::readField(reader, renderTotalFrames);
+                    }
+                    else if (key.equals("outputSkippedFrames"))
+                    {
+                        detail::readField(reader, outputSkippedFrames);
+                    }
+                    else if (key.equals("outputTotalFrames"))
+                    {
+                        detail::readField(reader, outputTotalFrames);
+                    }
+                    else if (key.equals("webSocketSessionIncomingMessages"))
+                    {
+                        detail::readField(reader, webSocketSessionIncomingMessages);
+                    }
+                    else if (key.equals("webSocketSessionOutgoingMessages"))
+                    {
+                        detail::readField(reader, webSocketSessionOutgoingMessages);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Gets the status of the stream output.
+    struct GetStreamStatus
+    {
+        static constexpr const char *kRequestType = "GetStreamStatus";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            bool outputActive = false;
+            bool outputReconnecting = false;
+            ObsJsonSlice outputTimecode;
+            int64_t outputDuration = 0;
+            double outputCongestion = 0;
+            int64_t outputBytes = 0;
+            int64_t outputSkippedFrames = 0;
+            int64_t outputTotalFrames = 0;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("outputActive"))
+                    {
+                        detail::readField(reader, outputActive);
+                    }
+                    else if (key.equals("outputReconnecting"))
+                    {
+                        detail::readField(reader, outputReconnecting);
+                    }
+                    else if (key.equals("outputTimecode"))
+                    {
+                        detail::readField(reader, outputTimecode);
+                    }
+                    else if (key.equals("outputDuration"))
+                    {
+                        detail::readField(reader, outputDuration);
+                    }
+                    else if (key.equals("outputCongestion"))
+                    {
+                        detail::readField(reader, outputCongestion);
+                    }
+                    else if (key.equals("outputBytes"))
+                    {
+                        detail::readField(reader, outputBytes);
+                    }
+                    else if (key.equals("outputSkippedFrames"))
+                    {
+                        detail::readField(reader, outputSkippedFrames);
+                    }
+                    else if (key.equals("outputTotalFrames"))
+                    {
+                        detail::readField(reader, outputTotalFrames);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Gets whether studio is enabled.
+    struct GetStudioModeEnabled
+    {
+        static constexpr const char *kRequestType = "GetStudioModeEnabled";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            bool studioModeEnabled = false;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("studioModeEnabled"))
+                    {
+                        detail::readField(reader, studioModeEnabled);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Gets data about the current plugin and RPC version.
+    struct GetVersion
+    {
+        static constexpr const char *kRequestType = "GetVersion";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            ObsJsonSlice obsVersion;
+            ObsJsonSlice obsWebSocketVersion;
+            int64_t rpcVersion = 0;
+            ObsJsonSlice availableRequests;
+            ObsJsonSlice supportedImageFormats;
+            ObsJsonSlice platform;
+            ObsJsonSlice platformDescription;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("obsVersion"))
+                    {
+                        detail::readField(reader, obsVersion);
+                    }
+                    else if (key.equals("obsWebSocketVersion"))
+                    {
+                        detail::readField(reader, obsWebSocketVersion);
+                    }
+                    else if (key.equals("rpcVersion"))
+                    {
+                        detail::readField(reader, rpcVersion);
+                    }
+                    else if (key.equals("availableRequests"))
+                    {
+                        detail::readRaw(reader, availableRequests);
+                    }
+                    else if (key.equals("supportedImageFormats"))
+                    {
+                        detail::readRaw(reader, supportedImageFormats);
+                    }
+                    else if (key.equals("platform"))
+                    {
+                        detail::readField(reader, platform);
+                    }
+                    else if (key.equals("platformDescription"))
+                    {
+                        detail::readField(reader, platformDescription);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Pauses the record output.
+    struct PauseRecord
+    {
+        static constexpr const char *kRequestType = "PauseRecord";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+    };
+
+    // Resumes the record output.
+    struct ResumeRecord
+    {
+        static constexpr const char *kRequestType = "ResumeRecord";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+    };
+
+    // Saves the contents of the replay buffer output.
+    struct SaveReplayBuffer
+    {
+        static constexpr const char *kRequestType = "SaveReplayBuffer";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+    };
+
+    // Sets the current preview scene. Only available when studio mode is enabled.
+    struct SetCurrentPreviewScene
+    {
+        static constexpr const char *kRequestType = "SetCurrentPreviewScene";
+        static constexpr bool kHasData = true;
+
+        const char *sceneName = nullptr;
+        const char *sceneUuid = nullptr;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (sceneName != nullptr)
+            {
+                json.key("sceneName");
+                json.string(sceneName);
+            }
+            if (sceneUuid != nullptr)
+            {
+                json.key("sceneUuid");
+                json.string(sceneUuid);
+            }
+        }
+
+        bool valid() const { return true; }
+    };
+
+    // Switches to a profile.
+    struct SetCurrentProfile
+    {
+        static constexpr const char *kRequestType = "SetCurrentProfile";
+        static constexpr bool kHasData = true;
+
+        const char *profileName = nullptr;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (profileName != nullptr)
+            {
+                json.key("profileName");
+                json.string(profileName);
+            }
+        }
+
+        bool valid() const { return true; }
+    };
+
+    // Sets the current program scene.
+    struct SetCurrentProgramScene
+    {
+        static constexpr const char *kRequestType = "SetCurrentProgramScene";
+        static constexpr bool kHasData = true;
+
+        const char *sceneName = nullptr;
+        const char *sceneUuid = nullptr;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (sceneName != nullptr)
+            {
+                json.key("sceneName");
+                json.string(sceneName);
+            }
+            if (sceneUuid != nullptr)
+            {
+                json.key("sceneUuid");
+                json.string(sceneUuid);
+            }
+        }
+
+        bool valid() const { return true; }
+    };
+
+    // Switches to a scene collection.
+    struct SetCurrentSceneCollection
+    {
+        static constexpr const char *kRequestType = "SetCurrentSceneCollection";
+        static constexpr bool kHasData = true;
+
+        const char *sceneCollectionName = nullptr;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (sceneCollectionName != nullptr)
+            {
+                json.key("sceneCollectionName");
+                json.string(sceneCollectionName);
+            }
+        }
+
+        bool valid() const { return true; }
+    };
+
+    // Sets the current scene transition.
+    struct SetCurrentSceneTransition
+    {
+        static constexpr const char *kRequestType = "SetCurrentSceneTransition";
+        static constexpr bool kHasData = true;
+
+        const char *transitionName = nullptr;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (transitionName != nullptr)
+            {
+                json.key("transitionName");
+                json.string(transitionName);
+            }
+        }
+
+        bool valid() const { return true; }
+    };
+
+    // Sets the duration of the current scene transition, if it is not fixed.
+    struct SetCurrentSceneTransitionDuration
+    {
+        static constexpr const char *kRequestType = "SetCurrentSceneTransitionDuration";
+        static constexpr bool kHasData = true;
+
+        int64_t transitionDuration = 0;
+
+        void write(ObsJsonWriter &json) const
+        {
+            json.key("transitionDuration");
+            json.integer(transitionDuration);
+        }
+
+        bool valid() const { return true; }
+    };
+
+    // Sets the audio mute state of an input.
+    struct SetInputMute
+    {
+        static constexpr const char *kRequestType = "SetInputMute";
+        static constexpr bool kHasData = true;
+
+        const char *inputName = nullptr;
+        const char *inputUuid = nullptr;
+        bool inputMuted = false;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (inputName != nullptr)
+            {
+                json.key("inputName");
+                json.string(inputName);
+            }
+            if (inputUuid != nullptr)
+            {
+                json.key("inputUuid");
+                json.string(inputUuid);
+            }
+            json.key("inputMuted");
+            json.boolean(inputMuted);
+        }
+
+        bool valid() const { return true; }
+    };
+
+    // Sets the volume setting of an input.
+    struct SetInputVolume
+    {
+        static constexpr const char *kRequestType = "SetInputVolume";
+        static constexpr bool kHasData = true;
+
+        const char *inputName = nullptr;
+        const char *inputUuid = nullptr;
+        ObsOptional<double> inputVolumeMul;
+        ObsOptional<double> inputVolumeDb;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (inputName != nullptr)
+            {
+                json.key("inputName");
+                json.string(inputName);
+            }
+            if (inputUuid != nullptr)
+            {
+                json.key("inputUuid");
+                json.string(inputUuid);
+            }
+            if (inputVolumeMul.set)
+            {
+                json.key("inputVolumeMul");
+                json.number(inputVolumeMul.value);
+            }
+            if (inputVolumeDb.set)
+            {
+                json.key("inputVolumeDb");
+                json.number(inputVolumeDb.value);
+            }
+        }
+
+        bool valid() const { return true; }
+    };
+
+    // Sets the enable state of a scene item.
+    struct SetSceneItemEnabled
+    {
+        static constexpr const char *kRequestType = "SetSceneItemEnabled";
+        static constexpr bool kHasData = true;
+
+        const char *sceneName = nullptr;
+        const char *sceneUuid = nullptr;
+        int64_t sceneItemId = 0;
+        bool sceneItemEnabled = false;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (sceneName != nullptr)
+            {
+                json.key("sceneName");
+                json.string(sceneName);
+            }
+            if (sceneUuid != nullptr)
+            {
+                json.key("sceneUuid");
+                json.string(sceneUuid);
+            }
+            json.key("sceneItemId");
+            json.integer(sceneItemId);
+            json.key("sceneItemEnabled");
+            json.boolean(sceneItemEnabled);
+        }
+
+        bool valid() const { return true; }
+    };
+
+    // Sets the enable state of a source filter.
+    struct SetSourceFilterEnabled
+    {
+        static constexpr const char *kRequestType = "SetSourceFilterEnabled";
+        static constexpr bool kHasData = true;
+
+        const char *sourceName = nullptr;
+        const char *sourceUuid = nullptr;
+        const char *filterName = nullptr;
+        bool filterEnabled = false;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (sourceName != nullptr)
+            {
+                json.key("sourceName");
+                json.string(sourceName);
+            }
+            if (sourceUuid != nullptr)
+            {
+                json.key("sourceUuid");
+                json.string(sourceUuid);
+            }
+            if (filterName != nullptr)
+            {
+                json.key("filterName");
+                json.string(filterName);
+            }
+            json.key("filterEnabled");
+            json.boolean(filterEnabled);
+        }
+
+        bool valid() const { return true; }
+    };
+
+    // Enables or disables studio mode.
+    struct SetStudioModeEnabled
+    {
+        static constexpr const char *kRequestType = "SetStudioModeEnabled";
+        static constexpr bool kHasData = true;
+
+        bool studioModeEnabled = false;
+
+        void write(ObsJsonWriter &json) const
+        {
+            json.key("studioModeEnabled");
+            json.boolean(studioModeEnabled);
+        }
+
+        bool valid() const { return true; }
+    };
+
+    // Starts the record output.
+    struct StartRecord
+    {
+        static constexpr const char *kRequestType = "StartRecord";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+    };
+
+    // Starts the stream output.
+    struct StartStream
+    {
+        static constexpr const char *kRequestType = "StartStream";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+    };
+
+    // Stops the record output.
+    struct StopRecord
+    {
+        static constexpr const char *kRequestType = "StopRecord";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            ObsJsonSlice outputPath;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("outputPath"))
+                    {
+                        detail::readField(reader, outputPath);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Stops the stream output.
+    struct StopStream
+    {
+        static constexpr const char *kRequestType = "StopStream";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+    };
+
+    // Toggles the audio mute state of an input.
+    struct ToggleInputMute
+    {
+        static constexpr const char *kRequestType = "ToggleInputMute";
+        static constexpr bool kHasData = true;
+
+        const char *inputName = nullptr;
+        const char *inputUuid = nullptr;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (inputName != nullptr)
+            {
+                json.key("inputName");
+                json.string(inputName);
+            }
+            if (inputUuid != nullptr)
+            {
+                json.key("inputUuid");
+                json.string(inputUuid);
+            }
+        }
+
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            bool inputMuted = false;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("inputMuted"))
+                    {
+                        detail::readField(reader, inputMuted);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Toggles the status of the record output.
+    struct ToggleRecord
+    {
+        static constexpr const char *kRequestType = "ToggleRecord";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            bool outputActive = false;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("outputActive"))
+                    {
+                        detail::readField(reader, outputActive);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Toggles pause on the record output.
+    struct ToggleRecordPause
+    {
+        static constexpr const char *kRequestType = "ToggleRecordPause";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+    };
+
+    // Toggles the state of the replay buffer output.
+    struct ToggleReplayBuffer
+    {
+        static constexpr const char *kRequestType = "ToggleReplayBuffer";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            bool outputActive = false;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("outputActive"))
+                    {
+                        detail::readField(reader, outputActive);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Toggles the status of the stream output.
+    struct ToggleStream
+    {
+        static constexpr const char *kRequestType = "ToggleStream";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            bool outputActive = false;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("outputActive"))
+                    {
+                        detail::readField(reader, outputActive);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Toggles the state of the virtualcam output.
+    struct ToggleVirtualCam
+    {
+        static constexpr const char *kRequestType = "ToggleVirtualCam";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+
+        struct Response
+        {
+            bool outputActive = false;
+
+            bool parse(const char *json, size_t length)
+            {
+                ObsJsonReader reader(json, length);
+                ObsJsonSlice key;
+                if (!reader.beginObject())
+                {
+                    return false;
+                }
+                while (reader.nextMember(key))
+                {
+                    if (key.equals("outputActive"))
+                    {
+                        detail::readField(reader, outputActive);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+                return !reader.failed();
+            }
+        };
+    };
+
+    // Triggers a hotkey using its name.
+    struct TriggerHotkeyByName
+    {
+        static constexpr const char *kRequestType = "TriggerHotkeyByName";
+        static constexpr bool kHasData = true;
+
+        const char *hotkeyName = nullptr;
+        const char *contextName = nullptr;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (hotkeyName != nullptr)
+            {
+                json.key("hotkeyName");
+                json.string(hotkeyName);
+            }
+            if (contextName != nullptr)
+            {
+                json.key("contextName");
+                json.string(contextName);
+            }
+        }
+
+        bool valid() const { return true; }
+    };
+
+    // Triggers an action on a media input.
+    struct TriggerMediaInputAction
+    {
+        static constexpr const char *kRequestType = "TriggerMediaInputAction";
+        static constexpr bool kHasData = true;
+
+        const char *inputName = nullptr;
+        const char *inputUuid = nullptr;
+        const char *mediaAction = nullptr;
+
+        void write(ObsJsonWriter &json) const
+        {
+            if (inputName != nullptr)
+            {
+                json.key("inputName");
+                json.string(inputName);
+            }
+            if (inputUuid != nullptr)
+            {
+                json.key("inputUuid");
+                json.string(inputUuid);
+            }
+            if (mediaAction != nullptr)
+            {
+                json.key("mediaAction");
+                json.string(mediaAction);
+            }
+        }
+
+        bool valid() const { return true; }
+    };
+
+    // Triggers the current scene transition. Same functionality as the Transition button in studio mode.
+    struct TriggerStudioModeTransition
+    {
+        static constexpr const char *kRequestType = "TriggerStudioModeTransition";
+        static constexpr bool kHasData = false;
+
+        void write(ObsJsonWriter &) const {}
+        bool valid() const { return true; }
+    };
+}
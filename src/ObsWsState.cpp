@@ -0,0 +1,775 @@
+#include "ObsWsState.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+    // Leaves kObsNoName free to mark empty slots.
+    constexpr size_t kMaxRecords = 0xFFFE;
+
+    // MurmurHash3 finalizer; spreads small integer keys over the index mask.
+    uint32_t mixHash(uint32_t hash)
+    {
+        hash ^= hash >> 16;
+        hash *= 0x85EBCA6Bu;
+        hash ^= hash >> 13;
+        hash *= 0xC2B2AE35u;
+        hash ^= hash >> 16;
+        return hash;
+    }
+
+    uint32_t hashItem(uint16_t scene, int64_t id)
+    {
+        const uint64_t key = static_cast<uint64_t>(id);
+        return mixHash(scene * 0x9E3779B1u ^ static_cast<uint32_t>(key) ^ static_cast<uint32_t>(key >> 32) * 0x27D4EB2Fu);
+    }
+
+    uint32_t hashItemSource(uint16_t scene, uint16_t source)
+    {
+        return mixHash((static_cast<uint32_t>(scene) << 16 | source) ^ 0x5BD1E995u);
+    }
+
+    bool memberString(const ObsJsonSlice &object, const char *key, ObsJsonSlice &value)
+    {
+        ObsJsonSlice raw;
+        if (!ObsJsonReader::findMember(object, key, raw))
+        {
+            return false;
+        }
+        ObsJsonReader reader(raw);
+        return reader.readString(value);
+    }
+
+    bool memberBool(const ObsJsonSlice &object, const char *key, bool &value)
+    {
+        ObsJsonSlice raw;
+        if (!ObsJsonReader::findMember(object, key, raw))
+        {
+            return false;
+        }
+        ObsJsonReader reader(raw);
+        return reader.readBool(value);
+    }
+
+    bool memberInteger(const ObsJsonSlice &object, const char *key, int64_t &value)
+    {
+        ObsJsonSlice raw;
+        if (!ObsJsonReader::findMember(object, key, raw))
+        {
+            return false;
+        }
+        ObsJsonReader reader(raw);
+        return reader.readInteger(value);
+    }
+}
+
+ObsStateCache::~ObsStateCache()
+{
+    release();
+}
+
+// Readers on other tasks only ever see fully built tables: buffers are allocated outside the
+// lock and swapped in under it. There is one source record per name handle.
+bool ObsStateCache::allocate(ObsNameTable *names, size_t maxSceneItems)
+{
+    const size_t maxSources = names != nullptr ? names->capacity() : 0;
+    maxSceneItems = std::min(std::max<size_t>(maxSceneItems, 1), kMaxRecords);
+    if (sources_ != nullptr && names_ == names && sourceCapacity_ == maxSources && itemCapacity_ == maxSceneItems)
+    {
+        clear();
+        return true;
+    }
+    release();
+    if (maxSources == 0)
+    {
+        return false;
+    }
+
+    Source *sources = static_cast<Source *>(std::malloc(maxSources * sizeof(Source)));
+    SceneItem *items = static_cast<SceneItem *>(std::malloc(maxSceneItems * sizeof(SceneItem)));
+    ObsHashIndex itemIndex;
+    ObsHashIndex itemSourceIndex;
+    const bool allocated = sources != nullptr && items != nullptr && itemIndex.allocate(maxSceneItems) &&
+                           itemSourceIndex.allocate(maxSceneItems);
+    if (!allocated)
+    {
+        std::free(sources);
+        std::free(items);
+        itemIndex.release();
+        itemSourceIndex.release();
+        return false;
+    }
+    for (size_t i = 0; i < maxSources; ++i)
+    {
+        sources[i] = Source();
+    }
+
+    portENTER_CRITICAL(&lock_);
+    names_ = names;
+    sources_ = sources;
+    sourceCapacity_ = maxSources;
+    items_ = items;
+    itemCapacity_ = maxSceneItems;
+    itemIndex_ = itemIndex;
+    itemSourceIndex_ = itemSourceIndex;
+    portEXIT_CRITICAL(&lock_);
+
+    clear();
+    return true;
+}
+
+void ObsStateCache::release()
+{
+    clear();
+
+    portENTER_CRITICAL(&lock_);
+    Source *sources = sources_;
+    SceneItem *items = items_;
+    ObsHashIndex itemIndex = itemIndex_;
+    ObsHashIndex itemSourceIndex = itemSourceIndex_;
+    sources_ = nullptr;
+    sourceCapacity_ = 0;
+    items_ = nullptr;
+    itemCapacity_ = 0;
+    itemIndex_ = ObsHashIndex();
+    itemSourceIndex_ = ObsHashIndex();
+    portEXIT_CRITICAL(&lock_);
+
+    std::free(sources);
+    std::free(items);
+    itemIndex.release();
+    itemSourceIndex.release();
+}
+
+// Drops the cache's references, so names nobody else interned leave the table.
+void ObsStateCache::clear()
+{
+    portENTER_CRITICAL(&lock_);
+    for (size_t i = 0; i < sourceCapacity_; ++i)
+    {
+        if (sources_[i].kind != SourceKind::Free)
+        {
+            names_->release(static_cast<ObsNameHandle>(i));
+        }
+        sources_[i] = Source();
+    }
+    itemCount_ = 0;
+    itemIndex_.clear();
+    itemSourceIndex_.clear();
+    programScene_ = kObsNoName;
+    previewScene_ = kObsNoName;
+    ready_ = false;
+    overflowed_ = false;
+    overflowReported_ = false;
+    portEXIT_CRITICAL(&lock_);
+}
+
+void ObsStateCache::setReady(bool ready)
+{
+    portENTER_CRITICAL(&lock_);
+    ready_ = ready && sources_ != nullptr;
+    portEXIT_CRITICAL(&lock_);
+}
+
+bool ObsStateCache::takeOverflow()
+{
+    portENTER_CRITICAL(&lock_);
+    const bool report = overflowed_ && !overflowReported_;
+    overflowReported_ = overflowed_;
+    portEXIT_CRITICAL(&lock_);
+    return report;
+}
+
+bool ObsStateCache::ready() const
+{
+    portENTER_CRITICAL(&lock_);
+    const bool ready = ready_;
+    portEXIT_CRITICAL(&lock_);
+    return ready;
+}
+
+ObsNameHandle ObsStateCache::programScene() const
+{
+    portENTER_CRITICAL(&lock_);
+    const ObsNameHandle scene = ready_ ? programScene_ : kObsNoName;
+    portEXIT_CRITICAL(&lock_);
+    return scene;
+}
+
+ObsNameHandle ObsStateCache::previewScene() const
+{
+    portENTER_CRITICAL(&lock_);
+    const ObsNameHandle scene = ready_ ? previewScene_ : kObsNoName;
+    portEXIT_CRITICAL(&lock_);
+    return scene;
+}
+
+bool ObsStateCache::programScene(char *name, size_t size) const
+{
+    portENTER_CRITICAL(&lock_);
+    const bool found = ready_ && programScene_ != kObsNoName && names_->copy(programScene_, name, size);
+    portEXIT_CRITICAL(&lock_);
+    return found;
+}
+
+bool ObsStateCache::previewScene(char *name, size_t size) const
+{
+    portENTER_CRITICAL(&lock_);
+    const bool found = ready_ && previewScene_ != kObsNoName && names_->copy(previewScene_, name, size);
+    portEXIT_CRITICAL(&lock_);
+    return found;
+}
+
+bool ObsStateCache::inputMuted(ObsNameHandle input, bool &muted) const
+{
+    portENTER_CRITICAL(&lock_);
+    const bool found = ready_ && isSource(input, SourceKind::Input) && sources_[input].muteKnown;
+    if (found)
+    {
+        muted = sources_[input].muted;
+    }
+    portEXIT_CRITICAL(&lock_);
+    return found;
+}
+
+bool ObsStateCache::inputMuted(const char *inputName, bool &muted) const
+{
+    return names_ != nullptr && inputMuted(names_->find(inputName), muted);
+}
+
+bool ObsStateCache::sceneItemEnabled(ObsNameHandle scene, int64_t sceneItemId, bool &enabled) const
+{
+    portENTER_CRITICAL(&lock_);
+    const uint16_t item = ready_ && isSource(scene, SourceKind::Scene) ? findSceneItem(scene, sceneItemId) : kObsNoName;
+    if (item != kObsNoName)
+    {
+        enabled = items_[item].enabled;
+    }
+    portEXIT_CRITICAL(&lock_);
+    return item != kObsNoName;
+}
+
+bool ObsStateCache::sceneItemEnabled(const char *sceneName, int64_t sceneItemId, bool &enabled) const
+{
+    return names_ != nullptr && sceneItemEnabled(names_->find(sceneName), sceneItemId, enabled);
+}
+
+bool ObsStateCache::sceneItemEnabledBySource(ObsNameHandle scene, ObsNameHandle source, bool &enabled) const
+{
+    portENTER_CRITICAL(&lock_);
+    const uint16_t item = ready_ && isSource(scene, SourceKind::Scene) ? findSceneItemBySource(scene, source) : kObsNoName;
+    if (item != kObsNoName)
+    {
+        enabled = items_[item].enabled;
+    }
+    portEXIT_CRITICAL(&lock_);
+    return item != kObsNoName;
+}
+
+bool ObsStateCache::sceneItemEnabled(const char *sceneName, const char *sourceName, bool &enabled) const
+{
+    return names_ != nullptr && sceneItemEnabledBySource(names_->find(sceneName), names_->find(sourceName), enabled);
+}
+
+// Lists are applied one entry per critical section so readers on other tasks are never held
+// off for the whole response.
+void ObsStateCache::applySceneList(const ObsJsonSlice &responseData)
+{
+    ObsJsonSlice scenes;
+    if (ObsJsonReader::findMember(responseData, "scenes", scenes))
+    {
+        ObsJsonReader reader(scenes);
+        ObsJsonSlice scene;
+        if (reader.beginArray())
+        {
+            while (reader.nextElement() && reader.skipValue(&scene))
+            {
+                portENTER_CRITICAL(&lock_);
+                addSource(scene, "sceneName", SourceKind::Scene);
+                portEXIT_CRITICAL(&lock_);
+            }
+        }
+    }
+
+    portENTER_CRITICAL(&lock_);
+    programScene_ = findSourceMember(responseData, "currentProgramSceneName");
+    previewScene_ = findSourceMember(responseData, "currentPreviewSceneName");
+    portEXIT_CRITICAL(&lock_);
+}
+
+void ObsStateCache::applyInputList(const ObsJsonSlice &responseData)
+{
+    ObsJsonSlice inputs;
+    if (!ObsJsonReader::findMember(responseData, "inputs", inputs))
+    {
+        return;
+    }
+
+    ObsJsonReader reader(inputs);
+    ObsJsonSlice input;
+    if (reader.beginArray())
+    {
+        while (reader.nextElement() && reader.skipValue(&input))
+        {
+            portENTER_CRITICAL(&lock_);
+            addSource(input, "inputName", SourceKind::Input);
+            portEXIT_CRITICAL(&lock_);
+        }
+    }
+}
+
+void ObsStateCache::applyInputMute(SourceRef input, const ObsJsonSlice &responseData)
+{
+    bool muted = false;
+    if (!memberBool(responseData, "inputMuted", muted))
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&lock_);
+    const ObsNameHandle slot = resolve(input);
+    if (isSource(slot, SourceKind::Input))
+    {
+        sources_[slot].muteKnown = true;
+        sources_[slot].muted = muted;
+    }
+    portEXIT_CRITICAL(&lock_);
+}
+
+// Replaces every item of the scene, so it also serves as the refresh after SceneItemCreated.
+void ObsStateCache::applySceneItemList(SourceRef scene, const ObsJsonSlice &responseData)
+{
+    portENTER_CRITICAL(&lock_);
+    const ObsNameHandle slot = resolve(scene);
+    if (slot != kObsNoName)
+    {
+        removeSceneItems(slot, kObsNoName);
+    }
+    portEXIT_CRITICAL(&lock_);
+
+    ObsJsonSlice list;
+    if (slot == kObsNoName || !ObsJsonReader::findMember(responseData, "sceneItems", list))
+    {
+        return;
+    }
+
+    ObsJsonReader reader(list);
+    ObsJsonSlice item;
+    if (reader.beginArray())
+    {
+        while (reader.nextElement() && reader.skipValue(&item))
+        {
+            int64_t id = 0;
+            bool enabled = false;
+            if (!memberInteger(item, "sceneItemId", id) || !memberBool(item, "sceneItemEnabled", enabled))
+            {
+                continue;
+            }
+            portENTER_CRITICAL(&lock_);
+            if (resolve(scene) == slot)
+            {
+                addSceneItem(slot, findSourceMember(item, "sourceName"), id, enabled);
+            }
+            portEXIT_CRITICAL(&lock_);
+        }
+    }
+}
+
+ObsStateCache::FollowUp ObsStateCache::applyEvent(ObsEventType type, const ObsJsonSlice &eventData, SourceRef &subject)
+{
+    FollowUp followUp = FollowUp::None;
+    ObsNameHandle slot = kObsNoName;
+    bool flag = false;
+    int64_t id = 0;
+
+    portENTER_CRITICAL(&lock_);
+    if (sources_ == nullptr)
+    {
+        portEXIT_CRITICAL(&lock_);
+        return followUp;
+    }
+
+    switch (type)
+    {
+    case ObsEventType::CurrentSceneCollectionChanging:
+        ready_ = false;
+        break;
+    case ObsEventType::CurrentSceneCollectionChanged:
+        followUp = FollowUp::Reseed;
+        break;
+    case ObsEventType::SceneCreated:
+        // Groups are scenes internally but GetSceneList leaves them out; so does the cache.
+        if (!memberBool(eventData, "isGroup", flag) || !flag)
+        {
+            addSource(eventData, "sceneName", SourceKind::Scene);
+        }
+        break;
+    case ObsEventType::SceneRemoved:
+    case ObsEventType::InputRemoved:
+        slot = findSourceMember(eventData, type == ObsEventType::SceneRemoved ? "sceneName" : "inputName");
+        if (slot != kObsNoName)
+        {
+            removeSource(slot);
+        }
+        break;
+    case ObsEventType::SceneNameChanged:
+        renameSource(eventData, "oldSceneName", "sceneName");
+        break;
+    case ObsEventType::CurrentProgramSceneChanged:
+        programScene_ = findSourceMember(eventData, "sceneName");
+        break;
+    case ObsEventType::CurrentPreviewSceneChanged:
+        previewScene_ = findSourceMember(eventData, "sceneName");
+        break;
+    case ObsEventType::StudioModeStateChanged:
+        if (memberBool(eventData, "studioModeEnabled", flag) && !flag)
+        {
+            previewScene_ = kObsNoName;
+        }
+        break;
+    case ObsEventType::InputCreated:
+        slot = addSource(eventData, "inputName", SourceKind::Input);
+        if (slot != kObsNoName)
+        {
+            followUp = FollowUp::InputMute;
+        }
+        break;
+    case ObsEventType::InputNameChanged:
+        renameSource(eventData, "oldInputName", "inputName");
+        break;
+    case ObsEventType::InputMuteStateChanged:
+        slot = findSourceMember(eventData, "inputName");
+        if (isSource(slot, SourceKind::Input) && memberBool(eventData, "inputMuted", flag))
+        {
+            sources_[slot].muteKnown = true;
+            sources_[slot].muted = flag;
+        }
+        break;
+    case ObsEventType::SceneItemCreated:
+        // The event leaves out the enabled state, so the scene's item list is fetched again.
+        slot = findSourceMember(eventData, "sceneName");
+        if (slot != kObsNoName)
+        {
+            followUp = FollowUp::SceneItems;
+        }
+        break;
+    case ObsEventType::SceneItemRemoved:
+    case ObsEventType::SceneItemEnableStateChanged:
+    {
+        const ObsNameHandle scene = findSourceMember(eventData, "sceneName");
+        const uint16_t item = scene != kObsNoName && memberInteger(eventData, "sceneItemId", id) ? findSceneItem(scene, id) : kObsNoName;
+        if (item == kObsNoName)
+        {
+            break;
+        }
+        if (type == ObsEventType::SceneItemRemoved)
+        {
+            removeSceneItem(item);
+        }
+        else if (memberBool(eventData, "sceneItemEnabled", flag))
+        {
+            items_[item].enabled = flag;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    if (followUp == FollowUp::InputMute || followUp == FollowUp::SceneItems)
+    {
+        subject.slot = slot;
+        subject.serial = sources_[slot].serial;
+    }
+    portEXIT_CRITICAL(&lock_);
+    return followUp;
+}
+
+bool ObsStateCache::tracks(ObsEventType type)
+{
+    switch (type)
+    {
+    case ObsEventType::CurrentSceneCollectionChanging:
+    case ObsEventType::CurrentSceneCollectionChanged:
+    case ObsEventType::SceneCreated:
+    case ObsEventType::SceneRemoved:
+    case ObsEventType::InputRemoved:
+    case ObsEventType::SceneNameChanged:
+    case ObsEventType::CurrentProgramSceneChanged:
+    case ObsEventType::CurrentPreviewSceneChanged:
+    case ObsEventType::StudioModeStateChanged:
+    case ObsEventType::InputCreated:
+    case ObsEventType::InputNameChanged:
+    case ObsEventType::InputMuteStateChanged:
+    case ObsEventType::SceneItemCreated:
+    case ObsEventType::SceneItemRemoved:
+    case ObsEventType::SceneItemEnableStateChanged:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool ObsStateCache::nextSource(SourceKind kind, size_t &slot, SourceRef &ref) const
+{
+    portENTER_CRITICAL(&lock_);
+    for (; slot < sourceCapacity_; ++slot)
+    {
+        const Source &source = sources_[slot];
+        if (source.kind == kind)
+        {
+            ref.slot = static_cast<ObsNameHandle>(slot);
+            ref.serial = source.serial;
+            ++slot;
+            portEXIT_CRITICAL(&lock_);
+            return true;
+        }
+    }
+    portEXIT_CRITICAL(&lock_);
+    return false;
+}
+
+bool ObsStateCache::hasSource(SourceRef ref) const
+{
+    portENTER_CRITICAL(&lock_);
+    const bool live = resolve(ref) != kObsNoName;
+    portEXIT_CRITICAL(&lock_);
+    return live;
+}
+
+// The reference taken under the lock keeps the name from being reused while it is written.
+bool ObsStateCache::writeSourceName(SourceRef ref, ObsJsonWriter &json) const
+{
+    portENTER_CRITICAL(&lock_);
+    const ObsNameHandle slot = resolve(ref);
+    const bool retained = slot != kObsNoName && names_->retain(slot);
+    portEXIT_CRITICAL(&lock_);
+
+    if (!retained)
+    {
+        return false;
+    }
+    const bool written = names_->writeJson(slot, json);
+    names_->release(slot);
+    return written;
+}
+
+ObsNameHandle ObsStateCache::findSourceMember(const ObsJsonSlice &object, const char *key) const
+{
+    ObsJsonSlice raw;
+    if (!memberString(object, key, raw))
+    {
+        return kObsNoName;
+    }
+    const ObsNameHandle slot = names_->findJson(raw);
+    return slot < sourceCapacity_ && sources_[slot].kind != SourceKind::Free ? slot : kObsNoName;
+}
+
+ObsNameHandle ObsStateCache::addSource(const ObsJsonSlice &object, const char *key, SourceKind kind)
+{
+    ObsJsonSlice raw;
+    if (!memberString(object, key, raw))
+    {
+        return kObsNoName;
+    }
+
+    const ObsNameHandle slot = names_->internJson(raw);
+    if (slot == kObsNoName)
+    {
+        overflowed_ = true;
+        return kObsNoName;
+    }
+
+    // A source the cache already tracks keeps the single reference it holds.
+    Source &source = sources_[slot];
+    if (source.kind != SourceKind::Free)
+    {
+        names_->release(slot);
+        source.kind = kind;
+        return slot;
+    }
+    source = Source();
+    source.serial = ++nextSerial_;
+    source.kind = kind;
+    return slot;
+}
+
+// The record moves to the handle of the new name; items and the current scenes follow it.
+void ObsStateCache::renameSource(const ObsJsonSlice &object, const char *oldKey, const char *newKey)
+{
+    const ObsNameHandle from = findSourceMember(object, oldKey);
+    ObsJsonSlice raw;
+    if (from == kObsNoName || !memberString(object, newKey, raw))
+    {
+        return;
+    }
+
+    const ObsNameHandle to = names_->internJson(raw);
+    if (to == kObsNoName)
+    {
+        overflowed_ = true;
+        removeSource(from);
+        return;
+    }
+    if (to == from)
+    {
+        names_->release(to);
+        return;
+    }
+    if (sources_[to].kind != SourceKind::Free)
+    {
+        removeSource(to);
+    }
+
+    sources_[to] = sources_[from];
+    sources_[from] = Source();
+    retargetSceneItems(from, to);
+    if (programScene_ == from)
+    {
+        programScene_ = to;
+    }
+    if (previewScene_ == from)
+    {
+        previewScene_ = to;
+    }
+    names_->release(from);
+}
+
+void ObsStateCache::removeSource(ObsNameHandle slot)
+{
+    removeSceneItems(slot, slot);
+    if (programScene_ == slot)
+    {
+        programScene_ = kObsNoName;
+    }
+    if (previewScene_ == slot)
+    {
+        previewScene_ = kObsNoName;
+    }
+    sources_[slot] = Source();
+    names_->release(slot);
+}
+
+uint16_t ObsStateCache::findSceneItem(ObsNameHandle scene, int64_t id) const
+{
+    return itemIndex_.find(hashItem(scene, id), [&](uint16_t item)
+    {
+        return items_[item].scene == scene && items_[item].id == id;
+    });
+}
+
+uint16_t ObsStateCache::findSceneItemBySource(ObsNameHandle scene, ObsNameHandle source) const
+{
+    if (scene == kObsNoName || source == kObsNoName)
+    {
+        return kObsNoName;
+    }
+    return itemSourceIndex_.find(hashItemSource(scene, source), [&](uint16_t item)
+    {
+        return items_[item].scene == scene && items_[item].source == source;
+    });
+}
+
+void ObsStateCache::addSceneItem(ObsNameHandle scene, ObsNameHandle source, int64_t id, bool enabled)
+{
+    const uint16_t existing = findSceneItem(scene, id);
+    if (existing != kObsNoName)
+    {
+        removeSceneItem(existing);
+    }
+    if (itemCount_ == itemCapacity_)
+    {
+        overflowed_ = true;
+        return;
+    }
+
+    const uint16_t item = static_cast<uint16_t>(itemCount_++);
+    items_[item].id = id;
+    items_[item].scene = scene;
+    items_[item].source = source;
+    items_[item].enabled = enabled;
+    itemIndex_.insert(hashItem(scene, id), item);
+    if (source != kObsNoName)
+    {
+        itemSourceIndex_.insert(hashItemSource(scene, source), item);
+    }
+}
+
+// Items are kept dense; the last one moves into the gap and is re-indexed under its new slot.
+void ObsStateCache::removeSceneItem(uint16_t item)
+{
+    const uint16_t last = static_cast<uint16_t>(itemCount_ - 1);
+    const SceneItem removed = items_[item];
+    itemIndex_.erase(hashItem(removed.scene, removed.id), item);
+    if (removed.source != kObsNoName)
+    {
+        itemSourceIndex_.erase(hashItemSource(removed.scene, removed.source), item);
+    }
+
+    if (item != last)
+    {
+        const SceneItem moved = items_[last];
+        itemIndex_.erase(hashItem(moved.scene, moved.id), last);
+        itemIndex_.insert(hashItem(moved.scene, moved.id), item);
+        if (moved.source != kObsNoName)
+        {
+            itemSourceIndex_.erase(hashItemSource(moved.scene, moved.source), last);
+            itemSourceIndex_.insert(hashItemSource(moved.scene, moved.source), item);
+        }
+        items_[item] = moved;
+    }
+    --itemCount_;
+}
+
+// Removes the items of `scene` and the items showing `source`; kObsNoName matches nothing.
+void ObsStateCache::removeSceneItems(ObsNameHandle scene, ObsNameHandle source)
+{
+    for (size_t i = itemCount_; i-- > 0;)
+    {
+        if ((scene != kObsNoName && items_[i].scene == scene) || (source != kObsNoName && items_[i].source == source))
+        {
+            removeSceneItem(static_cast<uint16_t>(i));
+        }
+    }
+}
+
+// Item keys include the scene and source handles, so touched items are re-indexed.
+void ObsStateCache::retargetSceneItems(ObsNameHandle from, ObsNameHandle to)
+{
+    for (size_t i = 0; i < itemCount_; ++i)
+    {
+        SceneItem &item = items_[i];
+        if (item.scene != from && item.source != from)
+        {
+            continue;
+        }
+        const uint16_t record = static_cast<uint16_t>(i);
+        itemIndex_.erase(hashItem(item.scene, item.id), record);
+        if (item.source != kObsNoName)
+        {
+            itemSourceIndex_.erase(hashItemSource(item.scene, item.source), record);
+        }
+        item.scene = item.scene == from ? to : item.scene;
+        item.source = item.source == from ? to : item.source;
+        itemIndex_.insert(hashItem(item.scene, item.id), record);
+        if (item.source != kObsNoName)
+        {
+            itemSourceIndex_.insert(hashItemSource(item.scene, item.source), record);
+        }
+    }
+}
+
+bool ObsStateCache::isSource(ObsNameHandle slot, SourceKind kind) const
+{
+    return slot < sourceCapacity_ && sources_[slot].kind == kind;
+}
+
+ObsNameHandle ObsStateCache::resolve(SourceRef ref) const
+{
+    if (ref.slot >= sourceCapacity_ || sources_[ref.slot].kind == SourceKind::Free || sources_[ref.slot].serial != ref.serial)
+    {
+        return kObsNoName;
+    }
+    return ref.slot;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+#include <cstddef>
+#include <cstdint>
+#include "ObsWsEventTypes.h"
+#include "ObsWsJson.h"
+#include "ObsWsNames.h"
+
+// Local mirror of the scenes, inputs and scene items of the connected OBS instance, seeded by
+// ObsWsClient after Identified and kept current from events (Config::enableStateCache).
+// Scenes and inputs are keyed by their handle in ObsWsClient::names(), so lookups by handle
+// are array reads and lookups by name cost one hash probe; neither touches the network.
+// Lookups may be called from any task and return false (or kObsNoName) while the state is
+// unknown.
+class ObsStateCache
+{
+public:
+    ObsStateCache() = default;
+    ~ObsStateCache();
+    ObsStateCache(const ObsStateCache &) = delete;
+    ObsStateCache &operator=(const ObsStateCache &) = delete;
+
+    // True once the initial snapshot has been received.
+    bool ready() const;
+    // The preview scene is only known in studio mode.
+    ObsNameHandle programScene() const;
+    ObsNameHandle previewScene() const;
+    // Copy the scene name into `name`; false when unknown or when it does not fit in `size`
+    // (including the terminating NUL).
+    bool programScene(char *name, size_t size) const;
+    bool previewScene(char *name, size_t size) const;
+    bool inputMuted(ObsNameHandle input, bool &muted) const;
+    bool inputMuted(const char *inputName, bool &muted) const;
+    bool sceneItemEnabled(ObsNameHandle scene, int64_t sceneItemId, bool &enabled) const;
+    bool sceneItemEnabled(const char *sceneName, int64_t sceneItemId, bool &enabled) const;
+    // Match an item of the scene that shows the source (any one of them when the source
+    // appears in the scene more than once).
+    bool sceneItemEnabledBySource(ObsNameHandle scene, ObsNameHandle source, bool &enabled) const;
+    bool sceneItemEnabled(const char *sceneName, const char *sourceName, bool &enabled) const;
+
+private:
+    friend class ObsWsClient;
+
+    enum class SourceKind : uint8_t
+    {
+        Free,
+        Scene,
+        Input
+    };
+
+    // Identifies a source across renames; `serial` changes when the slot is reused.
+    struct SourceRef
+    {
+        ObsNameHandle slot = kObsNoName;
+        uint16_t serial = 0;
+    };
+
+    // What the client has to fetch after an event the event data alone cannot describe.
+    enum class FollowUp
+    {
+        None,
+        InputMute,
+        SceneItems,
+        Reseed
+    };
+
+    // Indexed by name handle; the cache holds one reference on the name of each live source.
+    struct Source
+    {
+        uint16_t serial = 0;
+        SourceKind kind = SourceKind::Free;
+        bool muteKnown = false;
+        bool muted = false;
+    };
+
+    struct SceneItem
+    {
+        int64_t id = 0;
+        ObsNameHandle scene = kObsNoName;
+        ObsNameHandle source = kObsNoName;
+        bool enabled = false;
+    };
+
+    bool allocate(ObsNameTable *names, size_t maxSceneItems);
+    void release();
+    void clear();
+    void setReady(bool ready);
+    // True the first time it is asked after a table or the name pool ran full and something
+    // went untracked; reset by clear().
+    bool takeOverflow();
+    void applySceneList(const ObsJsonSlice &responseData);
+    void applyInputList(const ObsJsonSlice &responseData);
+    void applyInputMute(SourceRef input, const ObsJsonSlice &responseData);
+    void applySceneItemList(SourceRef scene, const ObsJsonSlice &responseData);
+    // `subject` names the input or scene an InputMute or SceneItems follow-up is about.
+    FollowUp applyEvent(ObsEventType type, const ObsJsonSlice &eventData, SourceRef &subject);
+    // The event types applyEvent() acts on; MessagePack sessions render only their data as JSON.
+    static bool tracks(ObsEventType type);
+    // Scenes and inputs in slot order, for fetching their details after the lists arrive.
+    bool nextSource(SourceKind kind, size_t &slot, SourceRef &ref) const;
+    bool hasSource(SourceRef ref) const;
+    bool writeSourceName(SourceRef ref, ObsJsonWriter &json) const;
+
+    ObsNameHandle findSourceMember(const ObsJsonSlice &object, const char *key) const;
+    ObsNameHandle addSource(const ObsJsonSlice &object, const char *key, SourceKind kind);
+    void renameSource(const ObsJsonSlice &object, const char *oldKey, const char *newKey);
+    void removeSource(ObsNameHandle slot);
+    uint16_t findSceneItem(ObsNameHandle scene, int64_t id) const;
+    uint16_t findSceneItemBySource(ObsNameHandle scene, ObsNameHandle source) const;
+    void addSceneItem(ObsNameHandle scene, ObsNameHandle source, int64_t id, bool enabled);
+    void removeSceneItem(uint16_t item);
+    void removeSceneItems(ObsNameHandle scene, ObsNameHandle source);
+    void retargetSceneItems(ObsNameHandle from, ObsNameHandle to);
+    bool isSource(ObsNameHandle slot, SourceKind kind) const;
+    ObsNameHandle resolve(SourceRef ref) const;
+
+    ObsNameTable *names_ = nullptr;
+    Source *sources_ = nullptr;
+    size_t sourceCapacity_ = 0;
+    SceneItem *items_ = nullptr;
+    size_t itemCapacity_ = 0;
+    size_t itemCount_ = 0;
+    ObsHashIndex itemIndex_;
+    ObsHashIndex itemSourceIndex_;
+    ObsNameHandle programScene_ = kObsNoName;
+    ObsNameHandle previewScene_ = kObsNoName;
+    uint16_t nextSerial_ = 0;
+    bool ready_ = false;
+    bool overflowed_ = false;
+    bool overflowReported_ = false;
+    mutable portMUX_TYPE lock_ = portMUX_INITIALIZER_UNLOCKED;
+};
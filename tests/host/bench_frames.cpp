@@ -0,0 +1,244 @@
+// Splitting a burst of server frames out of the receive buffer: the per-frame erase the
+// decoder used to do against the read/write cursors it uses now, both filling the buffer in
+// TCP-segment reads the way poll() does, and the client's decoder end to end for reference.
+// The stream is mostly small InputVolumeMeters frames with some 16-bit lengths and masked
+// frames. Build with OBSWS_SANITIZE=OFF for meaningful timings.
+
+#include "HostTest.h"
+#include "ObsWsMask.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+    // Parses one frame header at `frame`. Returns the header length, or 0 when more bytes are
+    // needed.
+    size_t frameHeader(const uint8_t *frame, size_t buffered, uint64_t &payloadLength, bool &masked, uint8_t maskKey[4])
+    {
+        if (buffered < 2)
+        {
+            return 0;
+        }
+        masked = (frame[1] & 0x80U) != 0;
+        payloadLength = frame[1] & 0x7FU;
+        size_t index = 2;
+        if (payloadLength == 126)
+        {
+            if (buffered < index + 2)
+            {
+                return 0;
+            }
+            payloadLength = (static_cast<uint64_t>(frame[2]) << 8) | frame[3];
+            index += 2;
+        }
+        else if (payloadLength == 127)
+        {
+            if (buffered < index + 8)
+            {
+                return 0;
+            }
+            payloadLength = 0;
+            for (int i = 0; i < 8; ++i)
+            {
+                payloadLength = (payloadLength << 8) | frame[index + i];
+            }
+            index += 8;
+        }
+        if (masked)
+        {
+            if (buffered < index + 4)
+            {
+                return 0;
+            }
+            std::memcpy(maskKey, frame + index, 4);
+            index += 4;
+        }
+        return index;
+    }
+
+    struct Splitter
+    {
+        std::vector<uint8_t> buffer;
+        size_t readPos = 0;
+        size_t writePos = 0;
+        size_t frames = 0;
+        size_t payloadBytes = 0;
+
+        explicit Splitter(size_t capacity) : buffer(capacity) {}
+
+        // Returns the length of the complete frame at the read cursor after unmasking it, or 0.
+        size_t nextFrame()
+        {
+            uint8_t *frame = buffer.data() + readPos;
+            uint64_t payloadLength = 0;
+            bool masked = false;
+            uint8_t maskKey[4];
+            const size_t header = frameHeader(frame, writePos - readPos, payloadLength, masked, maskKey);
+            if (header == 0 || writePos - readPos < header + payloadLength)
+            {
+                return 0;
+            }
+            if (masked)
+            {
+                applyObsWsMask(frame + header, static_cast<size_t>(payloadLength), maskKey, 0);
+            }
+            ++frames;
+            payloadBytes += static_cast<size_t>(payloadLength);
+            return header + static_cast<size_t>(payloadLength);
+        }
+    };
+
+    // The old path: every frame is erased from the front, shifting whatever follows it.
+    void splitByErase(Splitter &rx, const std::string &stream, size_t segment)
+    {
+        size_t offset = 0;
+        while (offset < stream.size() || rx.writePos > 0)
+        {
+            const size_t count = std::min(std::min(segment, stream.size() - offset), rx.buffer.size() - rx.writePos);
+            std::memcpy(rx.buffer.data() + rx.writePos, stream.data() + offset, count);
+            rx.writePos += count;
+            offset += count;
+            for (size_t length = rx.nextFrame(); length > 0; length = rx.nextFrame())
+            {
+                std::memmove(rx.buffer.data(), rx.buffer.data() + length, rx.writePos - length);
+                rx.writePos -= length;
+            }
+            if (count == 0 && rx.writePos > 0)
+            {
+                return;
+            }
+        }
+    }
+
+    // The current path: the read cursor advances over decoded frames; pending bytes are only
+    // moved to the front when the buffer is full or the next frame would run past its end.
+    void splitByCursor(Splitter &rx, const std::string &stream, size_t segment)
+    {
+        size_t offset = 0;
+        while (offset < stream.size() || rx.writePos > rx.readPos)
+        {
+            if (rx.writePos == rx.buffer.size() && rx.readPos > 0)
+            {
+                std::memmove(rx.buffer.data(), rx.buffer.data() + rx.readPos, rx.writePos - rx.readPos);
+                rx.writePos -= rx.readPos;
+                rx.readPos = 0;
+            }
+            const size_t count = std::min(std::min(segment, stream.size() - offset), rx.buffer.size() - rx.writePos);
+            std::memcpy(rx.buffer.data() + rx.writePos, stream.data() + offset, count);
+            rx.writePos += count;
+            offset += count;
+            for (size_t length = rx.nextFrame(); length > 0; length = rx.nextFrame())
+            {
+                rx.readPos += length;
+                if (rx.readPos == rx.writePos)
+                {
+                    rx.readPos = 0;
+                    rx.writePos = 0;
+                }
+            }
+            if (count == 0 && rx.writePos > rx.readPos)
+            {
+                return;
+            }
+        }
+    }
+
+    std::string burst(size_t &frames)
+    {
+        std::string meters = "{\"inputs\":[";
+        for (int i = 0; i < 2; ++i)
+        {
+            meters += std::string(i > 0 ? "," : "") + "{\"inputLevelsMul\":[[0.0123,0.0234,0.0234],[0.0111,0.0222,0.0222]],\"inputName\":\"Input " + std::to_string(i) + "\"}";
+        }
+        meters += "]}";
+
+        std::string stream;
+        frames = 0;
+        for (int i = 0; i < 400; ++i, ++frames)
+        {
+            if (i % 50 == 49)
+            {
+                stream += serverFrame(0x1, responseMessage(static_cast<uint32_t>(i), "GetSceneItemList", true, "{\"sceneItems\":[" + std::string(600, ' ') + "]}"));
+            }
+            else
+            {
+                stream += serverFrame(0x1, eventMessage("InputVolumeMeters", meters), true, i % 10 == 0);
+            }
+        }
+        return stream;
+    }
+
+    template <typename Split>
+    double microsecondsPerBurst(Split split, const std::string &stream, size_t capacity, size_t segment, size_t frames, int rounds)
+    {
+        Splitter rx(capacity);
+        const auto begin = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r)
+        {
+            split(rx, stream, segment);
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        return rx.frames == frames * rounds ? seconds * 1e6 / rounds : -1.0;
+    }
+
+    size_t routed = 0;
+
+    void countEvent(const ObsEvent &)
+    {
+        ++routed;
+    }
+}
+
+int main()
+{
+    size_t frames = 0;
+    const std::string stream = burst(frames);
+    const int rounds = 2000;
+    std::printf("%zu frames, %zu bytes per burst\n", frames, stream.size());
+    std::printf("%10s %10s %16s %17s\n", "buffer", "segment", "erase us/burst", "cursor us/burst");
+
+    const size_t capacities[] = {4096, 16384};
+    const size_t segments[] = {536, 1460, 16384};
+    for (size_t capacity : capacities)
+    {
+        for (size_t segment : segments)
+        {
+            const double erase = microsecondsPerBurst(&splitByErase, stream, capacity, segment, frames, rounds);
+            const double cursor = microsecondsPerBurst(&splitByCursor, stream, capacity, segment, frames, rounds);
+            if (erase < 0 || cursor < 0)
+            {
+                std::printf("frames lost\n");
+                return 1;
+            }
+            std::printf("%10zu %10zu %16.1f %17.1f\n", capacity, segment, erase, cursor);
+        }
+    }
+
+    // The same burst through poll(), with everything it does past splitting.
+    ObsWsClient client;
+    ObsWsClient::Config config;
+    config.onEvent = &countEvent;
+    config.deliverEventsInline = true;
+    if (connectClient(client, config) == 0)
+    {
+        return 1;
+    }
+    {
+        std::lock_guard<std::mutex> guard(hostConnection.lock);
+        hostConnection.maxRead = 1460;
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+    {
+        hostConnection.feed(stream);
+        pollUntilDrained(client);
+        std::lock_guard<std::mutex> guard(hostConnection.lock);
+        hostConnection.input.erase(0, hostConnection.readPos);
+        hostConnection.readPos = 0;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::printf("client, %zu-byte buffer, 1460-byte reads: %.1f us per burst\n", config.rxBufferSize, seconds * 1e6 / rounds);
+    client.close();
+    return routed == frames * rounds ? 0 : 1;
+}
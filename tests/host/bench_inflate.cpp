@@ -0,0 +1,157 @@
+// permessage-deflate on the receive path: a session shaped like an OBS capture (volume meters,
+// scene and input events, a scene item list) compressed with one server context per window
+// size, as OBS does, and routed by poll(). Reports the compression ratio and the time per
+// frame against the same messages uncompressed. Build with OBSWS_SANITIZE=OFF for meaningful
+// timings.
+
+#include "HostTest.h"
+
+#include <chrono>
+#include <zlib.h>
+
+namespace
+{
+    size_t routed = 0;
+
+    void countEvent(const ObsEvent &)
+    {
+        ++routed;
+    }
+
+    std::vector<std::string> capture()
+    {
+        std::string meters = "{\"inputs\":[";
+        for (int i = 0; i < 6; ++i)
+        {
+            meters += std::string(i > 0 ? "," : "") + "{\"inputLevelsMul\":[[0.0123456789,0.0234567891,0.0234567891],[0.0111111111,0.0222222222,0.0222222222]],\"inputName\":\"Input " + std::to_string(i) + "\"}";
+        }
+        meters += "]}";
+
+        std::string items = "{\"sceneItems\":[";
+        for (int i = 0; i < 12; ++i)
+        {
+            items += std::string(i > 0 ? "," : "") + "{\"inputKind\":\"ffmpeg_source\",\"isGroup\":null,\"sceneItemBlendMode\":\"OBS_BLEND_NORMAL\",\"sceneItemEnabled\":true,\"sceneItemId\":" + std::to_string(i + 1) + ",\"sceneItemIndex\":" + std::to_string(i) + ",\"sceneItemLocked\":false,\"sourceName\":\"Clip " + std::to_string(i) + "\",\"sourceType\":\"OBS_SOURCE_TYPE_INPUT\"}";
+        }
+        items += "]}";
+
+        std::vector<std::string> messages;
+        for (int i = 0; i < 20; ++i)
+        {
+            messages.push_back(eventMessage("InputVolumeMeters", meters));
+        }
+        messages.push_back(eventMessage("CurrentProgramSceneChanged", "{\"sceneName\":\"Live Camera\"}"));
+        messages.push_back(eventMessage("InputMuteStateChanged", "{\"inputMuted\":false,\"inputName\":\"Mic/Aux\"}"));
+        messages.push_back(responseMessage(101, "GetSceneItemList", true, items));
+        return messages;
+    }
+
+    // RFC 7692 framing of one message from a context kept across messages.
+    std::string compress(z_stream &stream, const std::string &message)
+    {
+        std::string out(message.size() + 1024, '\0');
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(message.data()));
+        stream.avail_in = static_cast<uInt>(message.size());
+        stream.next_out = reinterpret_cast<Bytef *>(&out[0]);
+        stream.avail_out = static_cast<uInt>(out.size());
+        deflate(&stream, Z_SYNC_FLUSH);
+        out.resize(out.size() - stream.avail_out - 4);
+        return out;
+    }
+
+    // Feeds `rounds` captures one at a time and returns the seconds poll() took.
+    double secondsFor(ObsWsClient &client, const std::vector<std::string> &rounds)
+    {
+        double seconds = 0;
+        for (const std::string &stream : rounds)
+        {
+            hostConnection.feed(stream);
+            const auto begin = std::chrono::steady_clock::now();
+            pollUntilDrained(client);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            std::lock_guard<std::mutex> guard(hostConnection.lock);
+            hostConnection.input.erase(0, hostConnection.readPos);
+            hostConnection.readPos = 0;
+        }
+        return seconds;
+    }
+
+    bool connect(ObsWsClient &client, uint8_t windowBits)
+    {
+        ObsWsClient::Config config;
+        config.onEvent = &countEvent;
+        config.eventQueueLength = 32;
+        config.eventPoolSlots = 32;
+        config.eventPoolPayloadBytes = 2048;
+        config.enableCompression = windowBits != 0;
+        config.compressionWindowBits = windowBits != 0 ? windowBits : config.compressionWindowBits;
+        hostConnection.reset();
+        const std::string extension = windowBits != 0 ? "Sec-WebSocket-Extensions: permessage-deflate; server_max_window_bits=" + std::to_string(windowBits) + "\r\n" : "";
+        return connectClient(client, config, extension) != 0;
+    }
+}
+
+int main()
+{
+    const std::vector<std::string> messages = capture();
+    const int rounds = 2000;
+    const size_t frames = messages.size() * rounds;
+
+    size_t plainBytes = 0;
+    std::string plain;
+    for (const std::string &message : messages)
+    {
+        plain += serverFrame(0x1, message);
+        plainBytes += message.size();
+    }
+
+    ObsWsClient reference;
+    if (!connect(reference, 0))
+    {
+        return 1;
+    }
+    routed = 0;
+    const double plainSeconds = secondsFor(reference, std::vector<std::string>(rounds, plain));
+    reference.close();
+    if (routed != frames)
+    {
+        return 1;
+    }
+    std::printf("%zu messages, %zu bytes per capture; uncompressed: %.2f us per frame\n", messages.size(), plainBytes, plainSeconds * 1e6 / frames);
+    std::printf("%12s %8s %14s %16s\n", "window bits", "ratio", "us per frame", "inflate us/frame");
+
+    for (uint8_t windowBits : {uint8_t(9), uint8_t(12), uint8_t(15)})
+    {
+        z_stream stream{};
+        deflateInit2(&stream, 6, Z_DEFLATED, -static_cast<int>(windowBits), 8, Z_DEFAULT_STRATEGY);
+        size_t compressedBytes = 0;
+        std::vector<std::string> compressed;
+        for (int r = 0; r < rounds; ++r)
+        {
+            std::string batch;
+            for (const std::string &message : messages)
+            {
+                const std::string payload = compress(stream, message);
+                compressedBytes += payload.size();
+                batch += serverFrame(0x1, payload, true, false, 0x40);
+            }
+            compressed.push_back(batch);
+        }
+        deflateEnd(&stream);
+
+        ObsWsClient client;
+        if (!connect(client, windowBits))
+        {
+            return 1;
+        }
+        routed = 0;
+        const double seconds = secondsFor(client, compressed);
+        client.close();
+        if (routed != frames)
+        {
+            std::printf("routed %zu of %zu frames\n", routed, frames);
+            return 1;
+        }
+        std::printf("%12u %8.2f %14.2f %16.2f\n", windowBits, static_cast<double>(plainBytes) * rounds / compressedBytes, seconds * 1e6 / frames, (seconds - plainSeconds) * 1e6 / frames);
+    }
+    return 0;
+}
@@ -0,0 +1,346 @@
+// Routing obs-websocket messages: parseObsWsMessage() against the cJSON path it replaced,
+// on Hello, Event and RequestResponse payloads shaped like OBS sends them. cJSON is not part
+// of the host build, so the old path is reproduced here the way cJSON works: a heap node per
+// value with decoded strings, member lookups by name, and the payload handed on printed back
+// out with cJSON_PrintUnformatted(). Build with OBSWS_SANITIZE=OFF for meaningful timings.
+
+#include "HostTest.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    // cJSON_Parse(): one allocation per node and per decoded string.
+    struct Node
+    {
+        enum Type
+        {
+            Null,
+            False,
+            True,
+            Number,
+            String,
+            Array,
+            Object
+        } type = Null;
+        Node *next = nullptr;
+        Node *child = nullptr;
+        char *name = nullptr;
+        char *string = nullptr;
+        double number = 0;
+    };
+
+    void deleteNode(Node *node)
+    {
+        while (node != nullptr)
+        {
+            Node *next = node->next;
+            deleteNode(node->child);
+            std::free(node->name);
+            std::free(node->string);
+            std::free(node);
+            node = next;
+        }
+    }
+
+    struct Parser
+    {
+        const char *cur;
+        const char *end;
+
+        void skipWhitespace()
+        {
+            while (cur < end && (*cur == ' ' || *cur == '\t' || *cur == '\n' || *cur == '\r'))
+            {
+                ++cur;
+            }
+        }
+
+        char *parseString()
+        {
+            const char *begin = ++cur;
+            while (cur < end && *cur != '"')
+            {
+                cur += *cur == '\\' ? 2 : 1;
+            }
+            if (cur >= end)
+            {
+                return nullptr;
+            }
+            const ObsJsonSlice escaped{begin, static_cast<size_t>(cur - begin)};
+            ++cur;
+            char *out = static_cast<char *>(std::malloc(escaped.length + 1));
+            out[unescapeJsonString(escaped, out, escaped.length)] = '\0';
+            return out;
+        }
+
+        Node *parseValue()
+        {
+            skipWhitespace();
+            if (cur >= end)
+            {
+                return nullptr;
+            }
+            Node *node = static_cast<Node *>(std::calloc(1, sizeof(Node)));
+            if (*cur == '{' || *cur == '[')
+            {
+                const bool object = *cur == '{';
+                node->type = object ? Node::Object : Node::Array;
+                ++cur;
+                skipWhitespace();
+                Node *last = nullptr;
+                while (cur < end && *cur != (object ? '}' : ']'))
+                {
+                    char *name = nullptr;
+                    if (object)
+                    {
+                        skipWhitespace();
+                        name = *cur == '"' ? parseString() : nullptr;
+                        skipWhitespace();
+                        if (name == nullptr || cur >= end || *cur++ != ':')
+                        {
+                            std::free(name);
+                            deleteNode(node);
+                            return nullptr;
+                        }
+                    }
+                    Node *item = parseValue();
+                    if (item == nullptr)
+                    {
+                        std::free(name);
+                        deleteNode(node);
+                        return nullptr;
+                    }
+                    item->name = name;
+                    (last != nullptr ? last->next : node->child) = item;
+                    last = item;
+                    skipWhitespace();
+                    if (cur < end && *cur == ',')
+                    {
+                        ++cur;
+                    }
+                }
+                ++cur;
+            }
+            else if (*cur == '"')
+            {
+                node->type = Node::String;
+                node->string = parseString();
+            }
+            else if (*cur == 't' || *cur == 'f' || *cur == 'n')
+            {
+                node->type = *cur == 't' ? Node::True : (*cur == 'f' ? Node::False : Node::Null);
+                cur += *cur == 'f' ? 5 : 4;
+            }
+            else
+            {
+                char *numberEnd = nullptr;
+                node->type = Node::Number;
+                node->number = std::strtod(cur, &numberEnd);
+                cur = numberEnd;
+            }
+            return node;
+        }
+    };
+
+    Node *parse(const std::string &json)
+    {
+        Parser parser{json.data(), json.data() + json.size()};
+        return parser.parseValue();
+    }
+
+    Node *member(const Node *object, const char *name)
+    {
+        for (Node *child = object != nullptr ? object->child : nullptr; child != nullptr; child = child->next)
+        {
+            if (std::strcmp(child->name, name) == 0)
+            {
+                return child;
+            }
+        }
+        return nullptr;
+    }
+
+    // cJSON_PrintUnformatted(): a buffer grown with realloc as the text is written.
+    struct Printer
+    {
+        char *buffer = static_cast<char *>(std::malloc(256));
+        size_t length = 0;
+        size_t capacity = 256;
+
+        void append(const char *text, size_t count)
+        {
+            if (length + count + 1 > capacity)
+            {
+                capacity = (length + count + 1) * 2;
+                buffer = static_cast<char *>(std::realloc(buffer, capacity));
+            }
+            std::memcpy(buffer + length, text, count);
+            length += count;
+            buffer[length] = '\0';
+        }
+
+        void appendString(const char *text)
+        {
+            append("\"", 1);
+            for (const char *c = text; *c != '\0'; ++c)
+            {
+                char escaped[8];
+                if (*c == '"' || *c == '\\')
+                {
+                    escaped[0] = '\\';
+                    escaped[1] = *c;
+                    append(escaped, 2);
+                }
+                else if (static_cast<unsigned char>(*c) < 0x20)
+                {
+                    append(escaped, static_cast<size_t>(std::snprintf(escaped, sizeof(escaped), "\\u%04x", *c)));
+                }
+                else
+                {
+                    append(c, 1);
+                }
+            }
+            append("\"", 1);
+        }
+
+        void print(const Node *node)
+        {
+            char number[32];
+            switch (node->type)
+            {
+            case Node::Null:
+                append("null", 4);
+                break;
+            case Node::False:
+                append("false", 5);
+                break;
+            case Node::True:
+                append("true", 4);
+                break;
+            case Node::Number:
+            {
+                int count = std::snprintf(number, sizeof(number), "%.15g", node->number);
+                if (std::strtod(number, nullptr) != node->number)
+                {
+                    count = std::snprintf(number, sizeof(number), "%.17g", node->number);
+                }
+                append(number, static_cast<size_t>(count));
+                break;
+            }
+            case Node::String:
+                appendString(node->string);
+                break;
+            case Node::Array:
+            case Node::Object:
+                append(node->type == Node::Object ? "{" : "[", 1);
+                for (const Node *child = node->child; child != nullptr; child = child->next)
+                {
+                    if (child != node->child)
+                    {
+                        append(",", 1);
+                    }
+                    if (node->type == Node::Object)
+                    {
+                        appendString(child->name);
+                        append(":", 1);
+                    }
+                    print(child);
+                }
+                append(node->type == Node::Object ? "}" : "]", 1);
+                break;
+            }
+        }
+    };
+
+    // What the old handlers pulled out of each message; returns a checksum so none of it is
+    // optimised away.
+    size_t routeWithDom(const std::string &json)
+    {
+        Node *root = parse(json);
+        const Node *op = member(root, "op");
+        const Node *d = member(root, "d");
+        size_t routed = 0;
+        if (op != nullptr && d != nullptr)
+        {
+            if (op->number == 0)
+            {
+                const Node *authentication = member(d, "authentication");
+                const Node *challenge = member(authentication, "challenge");
+                const Node *salt = member(authentication, "salt");
+                routed = static_cast<size_t>(member(d, "rpcVersion")->number) + std::strlen(challenge->string) + std::strlen(salt->string);
+            }
+            else
+            {
+                const Node *type = member(d, op->number == 5 ? "eventType" : "requestId");
+                const Node *payload = op->number == 5 ? member(d, "eventData") : d;
+                Printer printer;
+                printer.print(payload);
+                routed = std::strlen(type->string) + printer.length;
+                std::free(printer.buffer);
+            }
+        }
+        deleteNode(root);
+        return routed;
+    }
+
+    size_t routeWithReader(const std::string &json)
+    {
+        ObsWsMessage message;
+        if (!parseObsWsMessage(json.data(), json.size(), message))
+        {
+            return 0;
+        }
+        if (message.op == 0)
+        {
+            return message.rpcVersion + message.challenge.length + message.salt.length;
+        }
+        return message.op == 5 ? message.eventType.length + message.eventData.length : message.requestId.length + message.data.length;
+    }
+
+    template <typename Route>
+    double nanosecondsPerMessage(Route route, const std::string &json, size_t &checksum)
+    {
+        const int rounds = 20000;
+        const auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i)
+        {
+            checksum += route(json);
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() * 1e9 / rounds;
+    }
+}
+
+int main()
+{
+    std::string meters = "{\"inputs\":[";
+    for (int i = 0; i < 6; ++i)
+    {
+        meters += std::string(i > 0 ? "," : "") + "{\"inputLevelsMul\":[[0.0123456789,0.0234567891,0.0234567891],[0.0111111111,0.0222222222,0.0222222222]],\"inputName\":\"Input " + std::to_string(i) + "\"}";
+    }
+    meters += "]}";
+
+    struct Payload
+    {
+        const char *name;
+        std::string json;
+    };
+    const Payload payloads[] = {
+        {"Hello", "{\"d\":{\"authentication\":{\"challenge\":\"+IxH4CnCiqpX1rM9scsNynZzbOe4KhDeYcTNS3PDaeY=\",\"salt\":\"lM1GncleQOaCu9lT1yeUZhFYnqhsLLP1G5lAGo3ixaI=\"},\"obsWebSocketVersion\":\"5.5.2\",\"rpcVersion\":1},\"op\":0}"},
+        {"Event", eventMessage("SceneItemEnableStateChanged", "{\"sceneItemEnabled\":true,\"sceneItemId\":7,\"sceneName\":\"Live Camera\",\"sceneUuid\":\"0b7c4d2e-1111-4000-8000-000000000001\"}")},
+        {"Meters", eventMessage("InputVolumeMeters", meters)},
+        {"Response", responseMessage(101, "GetStats", true, "{\"activeFps\":60.0000024,\"availableDiskSpace\":201844.7265625,\"averageFrameRenderTime\":0.842108,\"cpuUsage\":3.417094017094017,\"memoryUsage\":412.80859375,\"outputSkippedFrames\":0,\"outputTotalFrames\":86211,\"renderSkippedFrames\":3,\"renderTotalFrames\":86214,\"webSocketSessionIncomingMessages\":42,\"webSocketSessionOutgoingMessages\":1732}")},
+    };
+
+    std::printf("%10s %8s %14s %14s\n", "message", "bytes", "cJSON ns/msg", "reader ns/msg");
+    size_t checksum = 0;
+    for (const Payload &payload : payloads)
+    {
+        const double dom = nanosecondsPerMessage(&routeWithDom, payload.json, checksum);
+        const double reader = nanosecondsPerMessage(&routeWithReader, payload.json, checksum);
+        std::printf("%10s %8zu %14.0f %14.0f\n", payload.name, payload.json.size(), dom, reader);
+    }
+    return checksum != 0 ? 0 : 1;
+}
@@ -0,0 +1,41 @@
+// Time per InputVolumeMeters event through decodeObsVolumeMeters() for a typical scene of six
+// stereo inputs. Build with OBSWS_SANITIZE=OFF for meaningful timings.
+
+#include "HostTest.h"
+#include "ObsWsMeters.h"
+
+#include <chrono>
+
+int main()
+{
+    std::string data = "{\"inputs\":[";
+    for (int i = 0; i < 6; ++i)
+    {
+        data += std::string(i > 0 ? "," : "") + "{\"inputLevelsMul\":[[0.0123456789,0.0234567891,0.0234567891],[0.0111111111,0.0222222222,0.0222222222]],\"inputName\":\"Input " + std::to_string(i) + "\"}";
+    }
+    data += "]}";
+
+    // The client allocates the name table the decoder interns into.
+    ObsWsClient client;
+    ObsWsClient::Config config;
+    if (connectClient(client, config) == 0)
+    {
+        return 1;
+    }
+
+    const ObsJsonSlice eventData{data.c_str(), data.size()};
+    ObsInputMeter meters[8];
+    const int rounds = 200000;
+    size_t decoded = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i)
+    {
+        const size_t count = decodeObsVolumeMeters(eventData, client.names(), meters, 8);
+        releaseObsVolumeMeters(client.names(), meters, count);
+        decoded += count;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::printf("%zu bytes, %zu inputs: %.0f ns per event\n", data.size(), decoded / rounds, seconds * 1e9 / rounds);
+    client.close();
+    return decoded == 6u * rounds ? 0 : 1;
+}
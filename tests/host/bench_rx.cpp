@@ -0,0 +1,107 @@
+// Receive throughput of ObsWsClient: a stream of frames shaped like an OBS capture (volume
+// meters, scene and input events, request responses) fed through the WiFiClient stub and
+// routed by poll(). Reported per message and in MB/s for whole-buffer reads and for reads
+// of one TCP segment. Build with OBSWS_SANITIZE=OFF for meaningful timings.
+
+#include "HostTest.h"
+
+#include <chrono>
+
+namespace
+{
+    size_t routed = 0;
+
+    void countEvent(const ObsEvent &)
+    {
+        ++routed;
+    }
+
+    std::string meters()
+    {
+        std::string data = "{\"inputs\":[";
+        for (int i = 0; i < 6; ++i)
+        {
+            data += std::string(i > 0 ? "," : "") + "{\"inputLevelsMul\":[[0.0123456789,0.0234567891,0.0234567891],[0.0111111111,0.0222222222,0.0222222222]],\"inputName\":\"Input " + std::to_string(i) + "\",\"inputUuid\":\"5f1c2a3e-0000-4000-8000-00000000000" + std::to_string(i) + "\"}";
+        }
+        return data + "]}";
+    }
+
+    // One second of a busy session: twenty meter updates, a scene switch, item and input
+    // changes, and the responses to a few requests.
+    std::string capture(size_t &messages)
+    {
+        std::vector<std::string> payloads;
+        for (int i = 0; i < 20; ++i)
+        {
+            payloads.push_back(eventMessage("InputVolumeMeters", meters()));
+        }
+        payloads.push_back(eventMessage("CurrentProgramSceneChanged", "{\"sceneName\":\"Live Camera\",\"sceneUuid\":\"0b7c4d2e-1111-4000-8000-000000000001\"}"));
+        payloads.push_back(eventMessage("SceneItemEnableStateChanged", "{\"sceneItemEnabled\":true,\"sceneItemId\":7,\"sceneName\":\"Live Camera\",\"sceneUuid\":\"0b7c4d2e-1111-4000-8000-000000000001\"}"));
+        payloads.push_back(eventMessage("InputMuteStateChanged", "{\"inputMuted\":false,\"inputName\":\"Mic/Aux\",\"inputUuid\":\"5f1c2a3e-0000-4000-8000-000000000000\"}"));
+        payloads.push_back(eventMessage("InputVolumeChanged", "{\"inputName\":\"Desktop Audio\",\"inputUuid\":\"5f1c2a3e-0000-4000-8000-000000000001\",\"inputVolumeDb\":-6.020599913279624,\"inputVolumeMul\":0.5}"));
+        payloads.push_back(responseMessage(101, "GetStats", true, "{\"activeFps\":60.0000024,\"availableDiskSpace\":201844.7265625,\"averageFrameRenderTime\":0.842108,\"cpuUsage\":3.417094017094017,\"memoryUsage\":412.80859375,\"outputSkippedFrames\":0,\"outputTotalFrames\":86211,\"renderSkippedFrames\":3,\"renderTotalFrames\":86214,\"webSocketSessionIncomingMessages\":42,\"webSocketSessionOutgoingMessages\":1732}"));
+        payloads.push_back(responseMessage(102, "SetInputMute", true));
+
+        std::string stream;
+        for (const std::string &payload : payloads)
+        {
+            stream += serverFrame(0x1, payload);
+        }
+        messages = payloads.size();
+        return stream;
+    }
+
+    double secondsFor(ObsWsClient &client, const std::string &stream, size_t maxRead, int rounds)
+    {
+        {
+            std::lock_guard<std::mutex> guard(hostConnection.lock);
+            hostConnection.maxRead = maxRead;
+        }
+        const auto begin = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r)
+        {
+            hostConnection.feed(stream);
+            pollUntilDrained(client);
+            std::lock_guard<std::mutex> guard(hostConnection.lock);
+            hostConnection.input.erase(0, hostConnection.readPos);
+            hostConnection.readPos = 0;
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+}
+
+int main()
+{
+    ObsWsClient client;
+    ObsWsClient::Config config;
+    config.onEvent = &countEvent;
+    // Room to queue a whole capture, so every message is routed and none is dropped.
+    config.eventQueueLength = 32;
+    config.eventPoolSlots = 32;
+    config.eventPoolPayloadBytes = 2048;
+    if (connectClient(client, config) == 0)
+    {
+        return 1;
+    }
+
+    size_t messages = 0;
+    const std::string stream = capture(messages);
+    const int rounds = 5000;
+
+    std::printf("%zu messages, %zu bytes per capture\n", messages, stream.size());
+    std::printf("%12s %14s %10s\n", "read size", "us per message", "MB/s");
+    const size_t readSizes[] = {static_cast<size_t>(-1), 1460};
+    for (size_t maxRead : readSizes)
+    {
+        routed = 0;
+        const double seconds = secondsFor(client, stream, maxRead, rounds);
+        if (routed != messages * rounds)
+        {
+            std::printf("routed %zu of %zu messages\n", routed, messages * rounds);
+            return 1;
+        }
+        std::printf("%12s %14.2f %10.1f\n", maxRead == 1460 ? "1460" : "whole", seconds * 1e6 / (messages * rounds), stream.size() * rounds / seconds / 1e6);
+    }
+    client.close();
+    return 0;
+}
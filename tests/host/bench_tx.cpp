@@ -0,0 +1,129 @@
+// Formatting outgoing requests: heap allocations and time per request for ObsJsonWriter on
+// its own and for sendRequest() and send() through the WiFiClient stub. The library's malloc,
+// calloc and realloc calls are counted by wrapping them at link time (see CMakeLists.txt).
+// Build with OBSWS_SANITIZE=OFF for meaningful timings.
+
+#include "HostTest.h"
+#include "ObsWsRequests.h"
+
+#include <atomic>
+#include <chrono>
+
+extern "C"
+{
+    void *__real_malloc(size_t size);
+    void *__real_calloc(size_t count, size_t size);
+    void *__real_realloc(void *pointer, size_t size);
+
+    std::atomic<size_t> allocations{0};
+
+    void *__wrap_malloc(size_t size)
+    {
+        ++allocations;
+        return __real_malloc(size);
+    }
+
+    void *__wrap_calloc(size_t count, size_t size)
+    {
+        ++allocations;
+        return __real_calloc(count, size);
+    }
+
+    void *__wrap_realloc(void *pointer, size_t size)
+    {
+        ++allocations;
+        return __real_realloc(pointer, size);
+    }
+}
+
+namespace
+{
+    const char kPayload[] = "{\"inputName\":\"Mic/Aux\",\"inputMuted\":true}";
+
+    void ignoreResult(const ObsRequestResult &, void *)
+    {
+    }
+
+    template <typename Send>
+    void measure(const char *name, Send send)
+    {
+        const int rounds = 100000;
+        // Warm up so buffers that are grown once and kept are not counted against each request.
+        send();
+        hostConnection.output.clear();
+        const size_t before = allocations.load();
+        const auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i)
+        {
+            if (!send())
+            {
+                std::printf("%s failed\n", name);
+                return;
+            }
+            if (hostConnection.output.size() > (1u << 20))
+            {
+                hostConnection.output.clear();
+            }
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::printf("%-32s %12.2f %12.3f\n", name, static_cast<double>(allocations.load() - before) / rounds, seconds * 1e6 / rounds);
+    }
+}
+
+int main()
+{
+    ObsWsClient client;
+    ObsWsClient::Config config;
+    config.maxPendingRequests = 4;
+    if (connectClient(client, config) == 0)
+    {
+        return 1;
+    }
+
+    std::printf("%-32s %12s %12s\n", "request", "allocations", "us");
+
+    char buffer[256];
+    measure("ObsJsonWriter op 6 envelope", [&]()
+    {
+        ObsJsonWriter json(buffer, sizeof(buffer));
+        json.beginObject();
+        json.key("op");
+        json.integer(6);
+        json.key("d");
+        json.beginObject();
+        json.key("requestType");
+        json.string("SetInputMute");
+        json.key("requestId");
+        json.string("12345");
+        json.key("requestData");
+        json.raw(kPayload, sizeof(kPayload) - 1);
+        json.endObject();
+        json.endObject();
+        return !json.overflowed();
+    });
+
+    measure("sendRequest(type, payload)", [&]()
+    {
+        return client.sendRequest("SetInputMute", kPayload);
+    });
+
+    // Completed by the timeout sweep in poll() so the table never fills.
+    measure("sendRequest with a callback", [&]()
+    {
+        const uint32_t id = client.sendRequest("SetInputMute", kPayload, &ignoreResult, nullptr, 1);
+        advanceHostMillis(1);
+        client.poll();
+        return id != 0;
+    });
+
+    ObsRequests::SetInputMute request;
+    request.inputName = "Mic/Aux";
+    request.inputMuted = true;
+    measure("send(ObsRequests::SetInputMute)", [&]()
+    {
+        return client.send(request) != 0;
+    });
+
+    client.close();
+    return 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// Host stand-in for the parts of the Arduino core the library uses.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+unsigned long millis();
+void delay(unsigned long ms);
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t b) { return write(&b, 1); }
+    virtual size_t write(const uint8_t *buffer, size_t size) = 0;
+    size_t print(const char *text) { return write(reinterpret_cast<const uint8_t *>(text), std::strlen(text)); }
+    size_t print(unsigned long value)
+    {
+        char digits[24];
+        std::snprintf(digits, sizeof(digits), "%lu", value);
+        return print(digits);
+    }
+    size_t print(long value)
+    {
+        char digits[24];
+        std::snprintf(digits, sizeof(digits), "%ld", value);
+        return print(digits);
+    }
+    size_t print(unsigned int value) { return print(static_cast<unsigned long>(value)); }
+    size_t print(int value) { return print(static_cast<long>(value)); }
+    virtual void flush() {}
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Arduino.h>
+
+class Client : public Print
+{
+public:
+    virtual int connect(const char *host, uint16_t port) = 0;
+    using Print::write;
+    virtual size_t write(const uint8_t *buffer, size_t size) = 0;
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int read(uint8_t *buffer, size_t size) = 0;
+    virtual int peek() = 0;
+    virtual void flush() = 0;
+    virtual void stop() = 0;
+    virtual uint8_t connected() = 0;
+};
+
+// Backed by the scripted connection in support/HostTest.h.
+class WiFiClient : public Client
+{
+public:
+    int connect(const char *host, uint16_t port) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buffer, size_t size) override;
+    int peek() override { return -1; }
+    void flush() override;
+    void stop() override;
+    uint8_t connected() override;
+};
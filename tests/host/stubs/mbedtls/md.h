@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+// Only SHA-1 (the handshake accept key) is implemented; setting up SHA-256 fails.
+typedef enum
+{
+    MBEDTLS_MD_SHA1,
+    MBEDTLS_MD_SHA256
+} mbedtls_md_type_t;
+
+typedef struct mbedtls_md_info_t mbedtls_md_info_t;
+
+typedef struct
+{
+    void *state;
+} mbedtls_md_context_t;
+
+const mbedtls_md_info_t *mbedtls_md_info_from_type(mbedtls_md_type_t type);
+void mbedtls_md_init(mbedtls_md_context_t *ctx);
+int mbedtls_md_setup(mbedtls_md_context_t *ctx, const mbedtls_md_info_t *info, int hmac);
+int mbedtls_md_starts(mbedtls_md_context_t *ctx);
+int mbedtls_md_update(mbedtls_md_context_t *ctx, const unsigned char *input, size_t length);
+int mbedtls_md_finish(mbedtls_md_context_t *ctx, unsigned char *output);
+void mbedtls_md_free(mbedtls_md_context_t *ctx);
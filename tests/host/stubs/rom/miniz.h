@@ -0,0 +1,102 @@
+#pragma once
+
+// Host stand-in for the ESP32 ROM tinfl API, backed by zlib raw inflate. zlib keeps its own
+// history, so the output window passed in is only written to, never read back. zlib's state
+// lives in an arena inside the decompressor, so freeing the decompressor frees everything.
+
+#include <zlib.h>
+#include <cstddef>
+#include <cstdint>
+
+typedef unsigned char mz_uint8;
+typedef uint32_t mz_uint32;
+
+typedef enum
+{
+    TINFL_STATUS_BAD_PARAM = -3,
+    TINFL_STATUS_ADLER32_MISMATCH = -2,
+    TINFL_STATUS_FAILED = -1,
+    TINFL_STATUS_DONE = 0,
+    TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+    TINFL_STATUS_HAS_MORE_OUTPUT = 2
+} tinfl_status;
+
+enum
+{
+    TINFL_FLAG_PARSE_ZLIB_HEADER = 1,
+    TINFL_FLAG_HAS_MORE_INPUT = 2,
+    TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF = 4
+};
+
+typedef struct tinfl_decompressor_tag
+{
+    uint32_t m_state;
+    uint32_t ready;
+    z_stream stream;
+    size_t arenaUsed;
+    alignas(16) unsigned char arena[48 * 1024];
+} tinfl_decompressor;
+
+// tinfl restarts its block decoder per message but keeps the history in the window; zlib
+// keeps both, so starting a message needs no work here.
+#define tinfl_init(r)       \
+    do                      \
+    {                       \
+        (r)->m_state = 0;   \
+    } while (0)
+
+inline voidpf tinflHostAlloc(voidpf opaque, uInt items, uInt size)
+{
+    tinfl_decompressor *r = static_cast<tinfl_decompressor *>(opaque);
+    const size_t bytes = (static_cast<size_t>(items) * size + 15) & ~static_cast<size_t>(15);
+    if (r->arenaUsed + bytes > sizeof(r->arena))
+    {
+        return Z_NULL;
+    }
+    voidpf p = r->arena + r->arenaUsed;
+    r->arenaUsed += bytes;
+    return p;
+}
+
+inline void tinflHostFree(voidpf, voidpf)
+{
+}
+
+inline tinfl_status tinfl_decompress(tinfl_decompressor *r, const mz_uint8 *in, size_t *inSize, mz_uint8 *outStart, mz_uint8 *outNext, size_t *outSize, const mz_uint32 flags)
+{
+    constexpr uint32_t kReady = 0x5A5A5A5A;
+    (void)outStart;
+    (void)flags;
+    if (r->ready != kReady)
+    {
+        r->stream = z_stream{};
+        r->stream.zalloc = &tinflHostAlloc;
+        r->stream.zfree = &tinflHostFree;
+        r->stream.opaque = r;
+        r->arenaUsed = 0;
+        if (inflateInit2(&r->stream, -15) != Z_OK)
+        {
+            return TINFL_STATUS_FAILED;
+        }
+        r->ready = kReady;
+    }
+
+    r->stream.next_in = const_cast<mz_uint8 *>(in);
+    r->stream.avail_in = static_cast<uInt>(*inSize);
+    r->stream.next_out = outNext;
+    r->stream.avail_out = static_cast<uInt>(*outSize);
+    const int rc = inflate(&r->stream, Z_SYNC_FLUSH);
+    *inSize -= r->stream.avail_in;
+    *outSize -= r->stream.avail_out;
+
+    if (rc == Z_STREAM_END)
+    {
+        inflateReset(&r->stream);
+        return TINFL_STATUS_DONE;
+    }
+    if (rc != Z_OK && rc != Z_BUF_ERROR)
+    {
+        return TINFL_STATUS_FAILED;
+    }
+    return r->stream.avail_out == 0 ? TINFL_STATUS_HAS_MORE_OUTPUT : TINFL_STATUS_NEEDS_MORE_INPUT;
+}
@@ -0,0 +1,650 @@
+// Host implementations of the Arduino, FreeRTOS, ESP-IDF and mbedTLS calls the library makes,
+// plus the helpers declared in HostTest.h.
+
+#include "HostTest.h"
+
+#include <esp_system.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <mbedtls/base64.h>
+#include <mbedtls/md.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <thread>
+
+HostConnection hostConnection;
+
+namespace
+{
+    std::atomic<unsigned long> hostMillis{1000};
+    std::recursive_mutex criticalSection;
+    std::atomic<int> checksRun{0};
+    std::atomic<int> checksFailed{0};
+
+    uint32_t rotateLeft(uint32_t value, int bits)
+    {
+        return (value << bits) | (value >> (32 - bits));
+    }
+}
+
+void HostConnection::reset()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    input.clear();
+    readPos = 0;
+    output.clear();
+    connected = false;
+    maxRead = static_cast<size_t>(-1);
+    writes = 0;
+}
+
+void HostConnection::feed(const std::string &bytes)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    input += bytes;
+}
+
+bool HostConnection::drained()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return readPos >= input.size();
+}
+
+std::string HostConnection::written()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return output;
+}
+
+void setHostMillis(unsigned long now)
+{
+    hostMillis = now;
+}
+
+void advanceHostMillis(unsigned long ms)
+{
+    hostMillis += ms;
+}
+
+unsigned long millis()
+{
+    return hostMillis;
+}
+
+void delay(unsigned long)
+{
+}
+
+uint32_t esp_random()
+{
+    return static_cast<uint32_t>(std::rand());
+}
+
+// FreeRTOS --------------------------------------------------------------------------------
+
+void hostEnterCritical(portMUX_TYPE *)
+{
+    criticalSection.lock();
+}
+
+void hostExitCritical(portMUX_TYPE *)
+{
+    criticalSection.unlock();
+}
+
+struct QueueDefinition
+{
+    std::mutex lock;
+    std::deque<std::vector<uint8_t>> items;
+    size_t length = 0;
+    size_t itemSize = 0;
+    std::recursive_timed_mutex mutex; // Used when created by xSemaphoreCreateMutex().
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+    QueueDefinition *queue = new QueueDefinition;
+    queue->length = length;
+    queue->itemSize = itemSize;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t)
+{
+    std::lock_guard<std::mutex> guard(queue->lock);
+    if (queue->items.size() >= queue->length)
+    {
+        return pdFALSE;
+    }
+    const uint8_t *bytes = static_cast<const uint8_t *>(item);
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait)
+{
+    for (;;)
+    {
+        {
+            std::lock_guard<std::mutex> guard(queue->lock);
+            if (!queue->items.empty())
+            {
+                std::memcpy(item, queue->items.front().data(), queue->itemSize);
+                queue->items.pop_front();
+                return pdTRUE;
+            }
+        }
+        if (wait == 0)
+        {
+            return pdFALSE;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (wait != portMAX_DELAY)
+        {
+            --wait;
+        }
+    }
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    std::lock_guard<std::mutex> guard(queue->lock);
+    return static_cast<UBaseType_t>(queue->items.size());
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    delete queue;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    return new QueueDefinition;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t wait)
+{
+    if (wait == portMAX_DELAY)
+    {
+        semaphore->mutex.lock();
+        return pdTRUE;
+    }
+    return semaphore->mutex.try_lock_for(std::chrono::milliseconds(wait)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    semaphore->mutex.unlock();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    delete semaphore;
+}
+
+struct TaskDefinition
+{
+    TaskFunction_t function = nullptr;
+    void *parameters = nullptr;
+};
+
+namespace
+{
+    thread_local TaskDefinition *currentTask = nullptr;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *, uint32_t, void *parameters, UBaseType_t, TaskHandle_t *created, BaseType_t)
+{
+    TaskDefinition *task = new TaskDefinition;
+    task->function = function;
+    task->parameters = parameters;
+    if (created != nullptr)
+    {
+        *created = task;
+    }
+    std::thread([task]()
+                {
+                    currentTask = task;
+                    task->function(task->parameters); })
+        .detach();
+    return pdPASS;
+}
+
+// Tasks only ever delete themselves, as the last thing they do.
+void vTaskDelete(TaskHandle_t task)
+{
+    delete (task != nullptr ? task : currentTask);
+    currentTask = nullptr;
+}
+
+void vTaskDelay(TickType_t)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    return currentTask;
+}
+
+void xTaskNotifyGive(TaskHandle_t)
+{
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t, TickType_t)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    return 0;
+}
+
+// mbedTLS ---------------------------------------------------------------------------------
+
+std::string base64Encode(const std::string &data)
+{
+    static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < data.size(); i += 3)
+    {
+        uint32_t bits = static_cast<uint8_t>(data[i]) << 16;
+        if (i + 1 < data.size())
+        {
+            bits |= static_cast<uint8_t>(data[i + 1]) << 8;
+        }
+        if (i + 2 < data.size())
+        {
+            bits |= static_cast<uint8_t>(data[i + 2]);
+        }
+        out += kAlphabet[(bits >> 18) & 63];
+        out += kAlphabet[(bits >> 12) & 63];
+        out += i + 1 < data.size() ? kAlphabet[(bits >> 6) & 63] : '=';
+        out += i + 2 < data.size() ? kAlphabet[bits & 63] : '=';
+    }
+    return out;
+}
+
+int mbedtls_base64_encode(unsigned char *dst, size_t dlen, size_t *olen, const unsigned char *src, size_t slen)
+{
+    const std::string encoded = base64Encode(std::string(reinterpret_cast<const char *>(src), slen));
+    *olen = encoded.size() + 1;
+    if (encoded.size() + 1 > dlen)
+    {
+        return -1;
+    }
+    std::memcpy(dst, encoded.c_str(), encoded.size() + 1);
+    *olen = encoded.size();
+    return 0;
+}
+
+int mbedtls_base64_decode(unsigned char *, size_t, size_t *, const unsigned char *, size_t)
+{
+    return -1;
+}
+
+std::string sha1Digest(const std::string &data)
+{
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    std::string message = data;
+    const uint64_t bitLength = static_cast<uint64_t>(data.size()) * 8;
+    message += static_cast<char>(0x80);
+    while (message.size() % 64 != 56)
+    {
+        message += '\0';
+    }
+    for (int i = 7; i >= 0; --i)
+    {
+        message += static_cast<char>((bitLength >> (8 * i)) & 0xFF);
+    }
+
+    for (size_t block = 0; block < message.size(); block += 64)
+    {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i)
+        {
+            const unsigned char *p = reinterpret_cast<const unsigned char *>(message.data() + block + 4 * i);
+            w[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+        }
+        for (int i = 16; i < 80; ++i)
+        {
+            w[i] = rotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i)
+        {
+            uint32_t f;
+            uint32_t k;
+            if (i < 20)
+            {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            }
+            else if (i < 40)
+            {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            }
+            else if (i < 60)
+            {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            }
+            else
+            {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            const uint32_t t = rotateLeft(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotateLeft(b, 30);
+            b = a;
+            a = t;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+
+    std::string digest;
+    for (uint32_t word : h)
+    {
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            digest += static_cast<char>((word >> shift) & 0xFF);
+        }
+    }
+    return digest;
+}
+
+struct mbedtls_md_info_t
+{
+    mbedtls_md_type_t type;
+};
+
+const mbedtls_md_info_t *mbedtls_md_info_from_type(mbedtls_md_type_t type)
+{
+    static const mbedtls_md_info_t sha1{MBEDTLS_MD_SHA1};
+    static const mbedtls_md_info_t sha256{MBEDTLS_MD_SHA256};
+    return type == MBEDTLS_MD_SHA1 ? &sha1 : &sha256;
+}
+
+void mbedtls_md_init(mbedtls_md_context_t *ctx)
+{
+    ctx->state = nullptr;
+}
+
+int mbedtls_md_setup(mbedtls_md_context_t *ctx, const mbedtls_md_info_t *info, int)
+{
+    if (info == nullptr || info->type != MBEDTLS_MD_SHA1)
+    {
+        return -1;
+    }
+    ctx->state = new std::string;
+    return 0;
+}
+
+int mbedtls_md_starts(mbedtls_md_context_t *ctx)
+{
+    static_cast<std::string *>(ctx->state)->clear();
+    return 0;
+}
+
+int mbedtls_md_update(mbedtls_md_context_t *ctx, const unsigned char *input, size_t length)
+{
+    static_cast<std::string *>(ctx->state)->append(reinterpret_cast<const char *>(input), length);
+    return 0;
+}
+
+int mbedtls_md_finish(mbedtls_md_context_t *ctx, unsigned char *output)
+{
+    const std::string digest = sha1Digest(*static_cast<std::string *>(ctx->state));
+    std::memcpy(output, digest.data(), digest.size());
+    return 0;
+}
+
+void mbedtls_md_free(mbedtls_md_context_t *ctx)
+{
+    delete static_cast<std::string *>(ctx->state);
+    ctx->state = nullptr;
+}
+
+// WiFiClient ------------------------------------------------------------------------------
+
+int WiFiClient::connect(const char *, uint16_t)
+{
+    std::lock_guard<std::mutex> guard(hostConnection.lock);
+    hostConnection.connected = true;
+    return 1;
+}
+
+size_t WiFiClient::write(const uint8_t *buffer, size_t size)
+{
+    std::lock_guard<std::mutex> guard(hostConnection.lock);
+    if (!hostConnection.connected)
+    {
+        return 0;
+    }
+    hostConnection.output.append(reinterpret_cast<const char *>(buffer), size);
+    ++hostConnection.writes;
+    return size;
+}
+
+int WiFiClient::available()
+{
+    std::lock_guard<std::mutex> guard(hostConnection.lock);
+    return static_cast<int>(std::min(hostConnection.input.size() - hostConnection.readPos, hostConnection.maxRead));
+}
+
+int WiFiClient::read()
+{
+    uint8_t byte = 0;
+    return read(&byte, 1) == 1 ? byte : -1;
+}
+
+int WiFiClient::read(uint8_t *buffer, size_t size)
+{
+    std::lock_guard<std::mutex> guard(hostConnection.lock);
+    const size_t count = std::min(std::min(size, hostConnection.input.size() - hostConnection.readPos), hostConnection.maxRead);
+    std::memcpy(buffer, hostConnection.input.data() + hostConnection.readPos, count);
+    hostConnection.readPos += count;
+    return static_cast<int>(count);
+}
+
+void WiFiClient::flush()
+{
+}
+
+void WiFiClient::stop()
+{
+    std::lock_guard<std::mutex> guard(hostConnection.lock);
+    hostConnection.connected = false;
+}
+
+uint8_t WiFiClient::connected()
+{
+    std::lock_guard<std::mutex> guard(hostConnection.lock);
+    return hostConnection.connected;
+}
+
+// Test helpers ----------------------------------------------------------------------------
+
+std::string serverFrame(uint8_t opcode, const std::string &payload, bool fin, bool masked, uint8_t rsv)
+{
+    std::string frame;
+    frame += static_cast<char>((fin ? 0x80 : 0) | rsv | opcode);
+    const uint8_t maskBit = masked ? 0x80 : 0;
+    if (payload.size() < 126)
+    {
+        frame += static_cast<char>(maskBit | payload.size());
+    }
+    else if (payload.size() <= 0xFFFF)
+    {
+        frame += static_cast<char>(maskBit | 126);
+        frame += static_cast<char>(payload.size() >> 8);
+        frame += static_cast<char>(payload.size() & 0xFF);
+    }
+    else
+    {
+        frame += static_cast<char>(maskBit | 127);
+        for (int i = 7; i >= 0; --i)
+        {
+            frame += static_cast<char>((static_cast<uint64_t>(payload.size()) >> (8 * i)) & 0xFF);
+        }
+    }
+
+    if (!masked)
+    {
+        return frame + payload;
+    }
+    static const char kKey[4] = {0x12, 0x34, 0x56, 0x78};
+    frame.append(kKey, sizeof(kKey));
+    for (size_t i = 0; i < payload.size(); ++i)
+    {
+        frame += static_cast<char>(payload[i] ^ kKey[i % 4]);
+    }
+    return frame;
+}
+
+std::vector<ClientFrame> clientFrames(size_t from)
+{
+    const std::string out = hostConnection.written();
+    std::vector<ClientFrame> frames;
+    size_t pos = from;
+    while (pos + 2 <= out.size())
+    {
+        ClientFrame frame;
+        frame.first = static_cast<uint8_t>(out[pos]);
+        uint64_t length = static_cast<uint8_t>(out[pos + 1]) & 0x7F;
+        size_t header = 2;
+        if (length == 126)
+        {
+            length = (static_cast<uint8_t>(out[pos + 2]) << 8) | static_cast<uint8_t>(out[pos + 3]);
+            header = 4;
+        }
+        else if (length == 127)
+        {
+            length = 0;
+            for (int i = 0; i < 8; ++i)
+            {
+                length = (length << 8) | static_cast<uint8_t>(out[pos + 2 + i]);
+            }
+            header = 10;
+        }
+        if (pos + header + 4 + length > out.size())
+        {
+            break;
+        }
+        const char *key = out.data() + pos + header;
+        for (uint64_t i = 0; i < length; ++i)
+        {
+            frame.payload += static_cast<char>(out[pos + header + 4 + i] ^ key[i % 4]);
+        }
+        frames.push_back(frame);
+        pos += header + 4 + length;
+    }
+    return frames;
+}
+
+size_t acceptUpgrade(ObsWsClient &client, const std::string &extraHeaders)
+{
+    client.poll();
+    const std::string out = hostConnection.written();
+    const size_t keyPos = out.find("Sec-WebSocket-Key: ");
+    if (keyPos == std::string::npos)
+    {
+        return 0;
+    }
+    const size_t keyEnd = out.find("\r\n", keyPos);
+    const std::string key = out.substr(keyPos + 19, keyEnd - keyPos - 19);
+    const std::string accept = base64Encode(sha1Digest(key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"));
+    hostConnection.feed("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n" + extraHeaders + "Sec-WebSocket-Accept: " + accept + "\r\n\r\n");
+    return out.size();
+}
+
+size_t connectClient(ObsWsClient &client, ObsWsClient::Config &config, const std::string &extraHeaders)
+{
+    if (config.host == nullptr)
+    {
+        config.host = "obs.local";
+    }
+    if (!client.begin(config))
+    {
+        return 0;
+    }
+    acceptUpgrade(client, extraHeaders);
+    hostConnection.feed(serverFrame(0x1, "{\"op\":0,\"d\":{\"obsWebSocketVersion\":\"5.5.0\",\"rpcVersion\":1}}"));
+    pollUntilDrained(client);
+    hostConnection.feed(serverFrame(0x1, "{\"op\":2,\"d\":{\"negotiatedRpcVersion\":1}}"));
+    pollUntilDrained(client);
+    return client.status() == ObsWsStatus::Connected ? hostConnection.written().size() : 0;
+}
+
+void pollUntilDrained(ObsWsClient &client, int maxPolls)
+{
+    for (int i = 0; i < maxPolls && !hostConnection.drained(); ++i)
+    {
+        client.poll();
+    }
+    client.poll();
+}
+
+std::string eventMessage(const std::string &eventType, const std::string &eventData)
+{
+    return "{\"d\":{\"eventData\":" + eventData + ",\"eventIntent\":1,\"eventType\":\"" + eventType + "\"},\"op\":5}";
+}
+
+std::string responseMessage(uint32_t requestId, const std::string &requestType, bool success, const std::string &responseData)
+{
+    std::string message = "{\"d\":{\"requestId\":\"" + std::to_string(requestId) + "\",\"requestStatus\":{\"code\":" + (success ? "100" : "600") + ",\"result\":" + (success ? "true" : "false") + "},\"requestType\":\"" + requestType + "\"";
+    if (!responseData.empty())
+    {
+        message += ",\"responseData\":" + responseData;
+    }
+    return message + "},\"op\":7}";
+}
+
+bool hostCheck(bool ok, const char *expression, const char *file, int line)
+{
+    ++checksRun;
+    if (!ok)
+    {
+        ++checksFailed;
+        std::printf("%s:%d: check failed: %s\n", file, line, expression);
+    }
+    return ok;
+}
+
+bool hostCheckEqual(const std::string &actual, const std::string &expected, const char *expression, const char *file, int line)
+{
+    const bool ok = hostCheck(actual == expected, expression, file, line);
+    if (!ok)
+    {
+        std::printf("  actual:   \"%s\"\n  expected: \"%s\"\n", actual.c_str(), expected.c_str());
+    }
+    return ok;
+}
+
+bool hostCheckEqual(long long actual, long long expected, const char *expression, const char *file, int line)
+{
+    const bool ok = hostCheck(actual == expected, expression, file, line);
+    if (!ok)
+    {
+        std::printf("  actual:   %lld\n  expected: %lld\n", actual, expected);
+    }
+    return ok;
+}
+
+int hostTestResult(const char *name)
+{
+    std::printf("%s: %d checks, %d failed\n", name, checksRun.load(), checksFailed.load());
+    return checksFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+// Shared helpers for the host tests: a scripted connection behind the WiFiClient stub, a
+// controllable millis(), WebSocket frame builders and a minimal check/report harness.
+
+#include <ObsWsEsp32.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// What the client reads from and writes to through WiFiClient. `input` is consumed from
+// `readPos`; each read returns at most `maxRead` bytes so tests can split data anywhere.
+struct HostConnection
+{
+    std::mutex lock;
+    std::string input;
+    size_t readPos = 0;
+    std::string output;
+    bool connected = false;
+    size_t maxRead = static_cast<size_t>(-1);
+    int writes = 0;
+
+    void reset();
+    void feed(const std::string &bytes);
+    bool drained();
+    std::string written();
+};
+
+extern HostConnection hostConnection;
+void setHostMillis(unsigned long now);
+void advanceHostMillis(unsigned long ms);
+
+std::string sha1Digest(const std::string &data);
+std::string base64Encode(const std::string &data);
+
+// A server-to-client frame. Servers do not mask, but the decoder accepts masked frames too.
+std::string serverFrame(uint8_t opcode, const std::string &payload, bool fin = true, bool masked = false, uint8_t rsv = 0);
+
+struct ClientFrame
+{
+    uint8_t first = 0; // FIN, RSV and opcode bits.
+    std::string payload;
+};
+
+// Decodes the masked frames the client wrote, starting at byte `from` of its output.
+std::vector<ClientFrame> clientFrames(size_t from = 0);
+
+// Answers the HTTP upgrade the client sent; returns where its WebSocket output starts.
+size_t acceptUpgrade(ObsWsClient &client, const std::string &extraHeaders = "");
+
+// Runs begin(), the upgrade, Hello and Identified so requests can be sent. Returns where the
+// client's frames after Identify start, or 0 when the session did not come up.
+size_t connectClient(ObsWsClient &client, ObsWsClient::Config &config, const std::string &extraHeaders = "");
+
+// Polls until every scripted byte has been read (bounded, so a stuck decoder fails).
+void pollUntilDrained(ObsWsClient &client, int maxPolls = 100000);
+
+std::string eventMessage(const std::string &eventType, const std::string &eventData);
+std::string responseMessage(uint32_t requestId, const std::string &requestType, bool success, const std::string &responseData = "");
+
+bool hostCheck(bool ok, const char *expression, const char *file, int line);
+bool hostCheckEqual(const std::string &actual, const std::string &expected, const char *expression, const char *file, int line);
+bool hostCheckEqual(long long actual, long long expected, const char *expression, const char *file, int line);
+// Prints a summary and returns the process exit code.
+int hostTestResult(const char *name);
+
+#define CHECK(cond) hostCheck((cond), #cond, __FILE__, __LINE__)
+#define CHECK_EQ(actual, expected) hostCheckEqual((actual), (expected), #actual " == " #expected, __FILE__, __LINE__)
@@ -0,0 +1,321 @@
+// Request batches (op 8): the frame sendRequestBatch() writes, results fanned out to each
+// request's callback, haltOnFailure completing the skipped requests with RequestNotExecuted,
+// and batch entries released when the connection drops.
+
+#include "HostTest.h"
+
+#include <map>
+
+namespace
+{
+    struct Completion
+    {
+        uintptr_t context = 0;
+        ObsWsError error = ObsWsError::None;
+        bool success = false;
+        int32_t code = 0;
+        std::string comment;
+        std::string responseData;
+    };
+
+    std::map<uint32_t, std::vector<Completion>> completions;
+    std::vector<std::string> unclaimed;
+
+    void recordCompletion(const ObsRequestResult &result, void *context)
+    {
+        Completion completion;
+        completion.context = reinterpret_cast<uintptr_t>(context);
+        completion.error = result.error;
+        completion.success = result.success;
+        completion.code = result.code;
+        completion.comment = result.comment != nullptr ? result.comment : "";
+        if (result.responseData != nullptr)
+        {
+            completion.responseData.assign(result.responseData, result.responseDataLength);
+        }
+        completions[result.requestId].push_back(completion);
+    }
+
+    void recordEvent(const ObsEvent &event)
+    {
+        unclaimed.push_back(std::string(event.id) + "=" + std::string(event.payload, event.payloadLength));
+    }
+
+    void *context(uintptr_t value)
+    {
+        return reinterpret_cast<void *>(value);
+    }
+
+    std::string text(const ObsJsonSlice &slice)
+    {
+        return slice.data != nullptr ? std::string(slice.data, slice.length) : std::string();
+    }
+
+    struct SentBatch
+    {
+        std::string batchId;
+        std::string haltOnFailure;
+        std::vector<std::string> requestIds;
+        std::vector<std::string> requests;
+    };
+
+    // The op 8 frame the client wrote after `start`; requests are listed without requestId.
+    SentBatch sentBatch(size_t start)
+    {
+        SentBatch sent;
+        const std::vector<ClientFrame> frames = clientFrames(start);
+        ObsJsonSlice op;
+        ObsJsonSlice d;
+        ObsJsonSlice value;
+        if (!CHECK_EQ(frames.size(), 1) || !ObsJsonReader::findMember(ObsJsonSlice{frames[0].payload.data(), frames[0].payload.size()}, "op", op) ||
+            !CHECK_EQ(text(op), "8") || !ObsJsonReader::findMember(ObsJsonSlice{frames[0].payload.data(), frames[0].payload.size()}, "d", d))
+        {
+            return sent;
+        }
+        if (ObsJsonReader::findMember(d, "requestId", value))
+        {
+            sent.batchId = text(value).substr(1, value.length - 2);
+        }
+        if (ObsJsonReader::findMember(d, "haltOnFailure", value))
+        {
+            sent.haltOnFailure = text(value);
+        }
+        ObsJsonSlice requests;
+        if (!ObsJsonReader::findMember(d, "requests", requests))
+        {
+            return sent;
+        }
+        ObsJsonReader reader(requests);
+        if (!reader.beginArray())
+        {
+            return sent;
+        }
+        while (reader.nextElement())
+        {
+            ObsJsonSlice request;
+            reader.skipValue(&request);
+            std::string listed = "{";
+            ObsJsonReader members(request);
+            ObsJsonSlice key;
+            members.beginObject();
+            while (members.nextMember(key))
+            {
+                members.skipValue(&value);
+                if (key.equals("requestId"))
+                {
+                    sent.requestIds.push_back(text(value).substr(1, value.length - 2));
+                }
+                else
+                {
+                    listed += std::string(listed.size() > 1 ? "," : "") + "\"" + text(key) + "\":" + text(value);
+                }
+            }
+            sent.requests.push_back(listed + "}");
+        }
+        return sent;
+    }
+
+    std::string result(const std::string &requestId, bool success, int code, const std::string &status = "", const std::string &extra = "")
+    {
+        return "{\"requestType\":\"X\",\"requestId\":\"" + requestId + "\",\"requestStatus\":{\"result\":" + (success ? "true" : "false") + ",\"code\":" + std::to_string(code) + status + "}" + extra + "}";
+    }
+
+    std::string batchResponse(const std::string &batchId, const std::vector<std::string> &results)
+    {
+        std::string joined;
+        for (const std::string &entry : results)
+        {
+            joined += (joined.empty() ? "" : ",") + entry;
+        }
+        return "{\"op\":9,\"d\":{\"requestId\":\"" + batchId + "\",\"results\":[" + joined + "]}}";
+    }
+
+    uint32_t id(const std::string &text)
+    {
+        return static_cast<uint32_t>(std::stoul(text));
+    }
+
+    size_t connect(ObsWsClient &client, ObsWsClient::Config &config)
+    {
+        hostConnection.reset();
+        completions.clear();
+        unclaimed.clear();
+        config.autoReconnect = false;
+        config.onEvent = &recordEvent;
+        return connectClient(client, config);
+    }
+
+    // Results reach the callback of the request they name, whatever their order; results for
+    // requests sent without a callback are forwarded to onEvent with the whole batch response.
+    void testFanOut()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        const size_t start = connect(client, config);
+        if (!CHECK(start != 0))
+        {
+            return;
+        }
+
+        ObsRequestBatch batch;
+        batch.executionType = ObsBatchExecution::SerialFrame;
+        CHECK(batch.add("GetVersion", nullptr, &recordCompletion, context(1)));
+        CHECK(batch.add("SetInputMute", "{\"inputName\":\"Mic\",\"inputMuted\":true}"));
+        CHECK(batch.add("GetInputMute", "{\"inputName\":\"Nope\"}", &recordCompletion, context(3)));
+        const uint32_t batchId = client.sendRequestBatch(batch);
+        CHECK(batchId != 0);
+
+        const SentBatch sent = sentBatch(start);
+        CHECK_EQ(sent.batchId, std::to_string(batchId));
+        CHECK_EQ(sent.haltOnFailure, "false");
+        CHECK(sent.requests == std::vector<std::string>({"{\"requestType\":\"GetVersion\"}", "{\"requestType\":\"SetInputMute\",\"requestData\":{\"inputName\":\"Mic\",\"inputMuted\":true}}",
+                                                         "{\"requestType\":\"GetInputMute\",\"requestData\":{\"inputName\":\"Nope\"}}"}));
+        if (!CHECK_EQ(sent.requestIds.size(), 3))
+        {
+            return;
+        }
+        CHECK(sent.requestIds[0] != sent.requestIds[1] && sent.requestIds[1] != sent.requestIds[2] && sent.requestIds[0] != sent.batchId);
+
+        hostConnection.feed(serverFrame(0x1, batchResponse(sent.batchId, {result(sent.requestIds[2], false, 600, ",\"comment\":\"No source was found.\""), result(sent.requestIds[1], true, 100),
+                                                                           result(sent.requestIds[0], true, 100, "", ",\"responseData\":{\"obsVersion\":\"30.0\"}")})));
+        pollUntilDrained(client);
+
+        const uint32_t first = id(sent.requestIds[0]);
+        const uint32_t third = id(sent.requestIds[2]);
+        CHECK_EQ(completions.size(), 2);
+        if (CHECK_EQ(completions[first].size(), 1))
+        {
+            CHECK_EQ(completions[first][0].context, 1);
+            CHECK(completions[first][0].success);
+            CHECK_EQ(completions[first][0].code, 100);
+            CHECK_EQ(completions[first][0].responseData, "{\"obsVersion\":\"30.0\"}");
+        }
+        if (CHECK_EQ(completions[third].size(), 1))
+        {
+            CHECK_EQ(completions[third][0].context, 3);
+            CHECK(completions[third][0].error == ObsWsError::None);
+            CHECK(!completions[third][0].success);
+            CHECK_EQ(completions[third][0].code, 600);
+            CHECK_EQ(completions[third][0].comment, "No source was found.");
+        }
+        CHECK_EQ(unclaimed.size(), 1);
+        CHECK_EQ(unclaimed.empty() ? std::string() : unclaimed[0].substr(0, sent.batchId.size() + 1), sent.batchId + "=");
+    }
+
+    // OBS stops at the first failure and leaves the rest out of the results; their callbacks
+    // still run, once, with RequestNotExecuted.
+    void testHaltOnFailure()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        const size_t start = connect(client, config);
+        if (!CHECK(start != 0))
+        {
+            return;
+        }
+
+        ObsRequestBatch batch;
+        batch.haltOnFailure = true;
+        for (uintptr_t i = 1; i <= 4; ++i)
+        {
+            CHECK(batch.add("SetCurrentProgramScene", "{\"sceneName\":\"Live\"}", &recordCompletion, context(i)));
+        }
+        CHECK(client.sendRequestBatch(batch) != 0);
+        const SentBatch sent = sentBatch(start);
+        CHECK_EQ(sent.haltOnFailure, "true");
+        if (!CHECK_EQ(sent.requestIds.size(), 4))
+        {
+            return;
+        }
+
+        hostConnection.feed(serverFrame(0x1, batchResponse(sent.batchId, {result(sent.requestIds[0], true, 100), result(sent.requestIds[1], false, 600)})));
+        pollUntilDrained(client);
+        advanceHostMillis(60000);
+        client.poll();
+
+        CHECK_EQ(completions.size(), 4);
+        const ObsWsError expected[] = {ObsWsError::None, ObsWsError::None, ObsWsError::RequestNotExecuted, ObsWsError::RequestNotExecuted};
+        for (size_t i = 0; i < 4; ++i)
+        {
+            const std::vector<Completion> &done = completions[id(sent.requestIds[i])];
+            if (CHECK_EQ(done.size(), 1))
+            {
+                CHECK_EQ(done[0].context, i + 1);
+                CHECK(done[0].error == expected[i]);
+                CHECK_EQ(done[0].success, i == 0);
+            }
+        }
+        CHECK(unclaimed.empty());
+    }
+
+    // A dropped connection fails the batch's requests once and frees their slots; a response
+    // to the old batch arriving on the next session completes nothing.
+    void testDisconnect()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.maxPendingRequests = 3;
+        const size_t start = connect(client, config);
+        if (!CHECK(start != 0))
+        {
+            return;
+        }
+
+        ObsRequestBatch batch;
+        for (uintptr_t i = 1; i <= 3; ++i)
+        {
+            CHECK(batch.add("GetVersion", nullptr, &recordCompletion, context(i)));
+        }
+        CHECK(client.sendRequestBatch(batch) != 0);
+        const SentBatch sent = sentBatch(start);
+        CHECK_EQ(client.sendRequestBatch(batch), 0);
+
+        {
+            std::lock_guard<std::mutex> guard(hostConnection.lock);
+            hostConnection.connected = false;
+        }
+        for (int i = 0; i < 5; ++i)
+        {
+            client.poll();
+        }
+        CHECK(client.status() == ObsWsStatus::Disconnected);
+        CHECK_EQ(completions.size(), 3);
+        for (const std::string &requestId : sent.requestIds)
+        {
+            const std::vector<Completion> &done = completions[id(requestId)];
+            CHECK(done.size() == 1 && done[0].error == ObsWsError::TransportUnavailable);
+        }
+
+        const size_t restart = connect(client, config);
+        if (!CHECK(restart != 0))
+        {
+            return;
+        }
+        const uint32_t next = client.sendRequestBatch(batch);
+        CHECK(next != 0);
+        const SentBatch resent = sentBatch(restart);
+
+        hostConnection.feed(serverFrame(0x1, batchResponse(sent.batchId, {result(sent.requestIds[0], true, 100), result(sent.requestIds[1], true, 100), result(sent.requestIds[2], true, 100)})));
+        pollUntilDrained(client);
+        CHECK(completions.empty());
+        CHECK_EQ(unclaimed.size(), 1);
+
+        std::vector<std::string> results;
+        for (const std::string &requestId : resent.requestIds)
+        {
+            results.push_back(result(requestId, true, 100));
+        }
+        hostConnection.feed(serverFrame(0x1, batchResponse(resent.batchId, results)));
+        pollUntilDrained(client);
+        CHECK_EQ(completions.size(), 3);
+        CHECK_EQ(unclaimed.size(), 1);
+    }
+}
+
+int main()
+{
+    testFanOut();
+    testHaltOnFailure();
+    testDisconnect();
+    return hostTestResult("batch");
+}
@@ -0,0 +1,167 @@
+// Continuation frames: reassembly with control frames in between, fragments streamed to
+// onMessageChunk, the size cap and the protocol errors of RFC 6455 section 5.4.
+
+#include "HostTest.h"
+
+namespace
+{
+    std::vector<std::string> events;
+    std::string streamed;
+    std::vector<std::string> streamedMessages;
+    std::vector<ObsWsError> errors;
+
+    void recordEvent(const ObsEvent &event)
+    {
+        events.push_back(std::string(event.id) + "=" + std::string(event.payload, event.payloadLength));
+    }
+
+    void recordChunk(const ObsMessageChunk &chunk)
+    {
+        CHECK_EQ(chunk.offset, streamed.size());
+        CHECK_EQ(chunk.totalLength, 0);
+        streamed.append(reinterpret_cast<const char *>(chunk.data), chunk.length);
+        if (chunk.final)
+        {
+            streamedMessages.push_back(streamed);
+            streamed.clear();
+        }
+    }
+
+    void recordError(ObsWsError error)
+    {
+        errors.push_back(error);
+    }
+
+    void resetRecorders()
+    {
+        events.clear();
+        streamed.clear();
+        streamedMessages.clear();
+        errors.clear();
+    }
+
+    ObsWsClient::Config baseConfig()
+    {
+        ObsWsClient::Config config;
+        config.onEvent = &recordEvent;
+        config.onError = &recordError;
+        config.rxBufferSize = 1024;
+        return config;
+    }
+
+    // The message cut into three fragments at `first` and `second`, with a ping after the
+    // first fragment, followed by an unfragmented event.
+    std::string fragmentedWire(const std::string &message, size_t first, size_t second)
+    {
+        return serverFrame(0x1, message.substr(0, first), false, first % 2 == 1) +
+               serverFrame(0x9, "p") +
+               serverFrame(0x0, message.substr(first, second - first), false, second % 2 == 1) +
+               serverFrame(0x0, message.substr(second), true) +
+               serverFrame(0x1, eventMessage("After", "{}"));
+    }
+
+    void testReassemblyAtEveryBoundary()
+    {
+        std::string text;
+        for (int i = 0; i < 300; ++i)
+        {
+            text += static_cast<char>('A' + i % 26);
+        }
+        const std::string data = "{\"s\":\"" + text + "\"}";
+        const std::string message = eventMessage("Fragmented", data);
+
+        for (size_t split = 0; split <= message.size(); ++split)
+        {
+            hostConnection.reset();
+            resetRecorders();
+            ObsWsClient client;
+            ObsWsClient::Config config = baseConfig();
+            const size_t start = connectClient(client, config);
+
+            hostConnection.maxRead = 1 + split % 17;
+            hostConnection.feed(fragmentedWire(message, split, split + (message.size() - split) / 2));
+            pollUntilDrained(client);
+
+            if (!CHECK(events.size() == 2 && events[0] == "Fragmented=" + data && events[1] == "After={}"))
+            {
+                std::printf("  split at %zu\n", split);
+                return;
+            }
+            const std::vector<ClientFrame> frames = clientFrames(start);
+            CHECK(frames.size() == 1 && frames[0].first == 0x8A && frames[0].payload == "p");
+        }
+    }
+
+    void testStreamedFragments()
+    {
+        const std::string message = eventMessage("Fragmented", "{\"s\":\"" + std::string(200, 'x') + "\"}");
+        for (size_t split = 0; split <= message.size(); split += 7)
+        {
+            hostConnection.reset();
+            resetRecorders();
+            ObsWsClient client;
+            ObsWsClient::Config config = baseConfig();
+            config.onMessageChunk = &recordChunk;
+            config.streamFragments = true;
+            CHECK(connectClient(client, config) > 0);
+
+            hostConnection.feed(fragmentedWire(message, split, split + (message.size() - split) / 2));
+            pollUntilDrained(client);
+
+            CHECK(streamedMessages.size() == 1 && streamedMessages[0] == message);
+            CHECK(events.size() == 1 && events[0] == "After={}");
+        }
+    }
+
+    void testProtocolErrors()
+    {
+        const std::vector<std::string> violations = {
+            serverFrame(0x0, "orphan continuation"),
+            serverFrame(0x1, "x", false) + serverFrame(0x1, "new message before the last ended"),
+            serverFrame(0x9, "fragmented ping", false),
+        };
+        for (const std::string &wire : violations)
+        {
+            hostConnection.reset();
+            resetRecorders();
+            ObsWsClient client;
+            ObsWsClient::Config config = baseConfig();
+            const size_t start = connectClient(client, config);
+
+            hostConnection.feed(wire);
+            pollUntilDrained(client);
+
+            CHECK(errors.size() == 1 && errors[0] == ObsWsError::ProtocolError);
+            const std::vector<ClientFrame> frames = clientFrames(start);
+            CHECK(!frames.empty() && frames.back().first == 0x88 && frames.back().payload.substr(0, 2) == std::string("\x03\xea"));
+        }
+    }
+
+    void testReassemblyCap()
+    {
+        hostConnection.reset();
+        resetRecorders();
+        ObsWsClient client;
+        ObsWsClient::Config config = baseConfig();
+        config.maxMessageSize = 2000;
+        CHECK(connectClient(client, config) > 0);
+
+        for (int i = 0; i < 5; ++i)
+        {
+            hostConnection.feed(serverFrame(i == 0 ? 0x1 : 0x0, std::string(500, 'x'), false));
+        }
+        pollUntilDrained(client);
+
+        CHECK(errors.size() == 1 && errors[0] == ObsWsError::MessageTooLarge);
+        CHECK(events.empty());
+    }
+}
+
+int main()
+{
+    testReassemblyAtEveryBoundary();
+    testStreamedFragments();
+    testProtocolErrors();
+    testReassemblyCap();
+    return hostTestResult("fragments");
+}
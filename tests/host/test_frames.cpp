@@ -0,0 +1,269 @@
+// Receive path: block reads into the receive buffer, the read/write cursor decoder and the
+// incremental frame state machine, fed with frames split at every byte boundary.
+
+#include "HostTest.h"
+
+namespace
+{
+    std::vector<std::string> events;
+    std::string streamed;
+    std::vector<std::string> streamedMessages;
+    std::vector<ObsWsError> errors;
+
+    void recordEvent(const ObsEvent &event)
+    {
+        events.push_back(std::string(event.id) + "=" + std::string(event.payload, event.payloadLength));
+    }
+
+    void recordChunk(const ObsMessageChunk &chunk)
+    {
+        CHECK_EQ(chunk.offset, streamed.size());
+        streamed.append(reinterpret_cast<const char *>(chunk.data), chunk.length);
+        if (chunk.final)
+        {
+            CHECK_EQ(chunk.totalLength, streamed.size());
+            streamedMessages.push_back(streamed);
+            streamed.clear();
+        }
+    }
+
+    void recordError(ObsWsError error)
+    {
+        errors.push_back(error);
+    }
+
+    std::string filler(size_t length)
+    {
+        std::string text;
+        for (size_t i = 0; i < length; ++i)
+        {
+            text += static_cast<char>('a' + i % 26);
+        }
+        return text;
+    }
+
+    std::string eventData(size_t length)
+    {
+        return "{\"s\":\"" + filler(length) + "\"}";
+    }
+
+    void resetRecorders()
+    {
+        events.clear();
+        streamed.clear();
+        streamedMessages.clear();
+        errors.clear();
+    }
+
+    ObsWsClient::Config baseConfig()
+    {
+        ObsWsClient::Config config;
+        config.onEvent = &recordEvent;
+        config.onError = &recordError;
+        config.rxBufferSize = 1024;
+        config.maxMessageSize = 256 * 1024;
+        config.eventQueueLength = 16;
+        return config;
+    }
+
+    // Feeds `wire` in two parts split at `split`, polling in between.
+    void feedSplit(ObsWsClient &client, const std::string &wire, size_t split)
+    {
+        hostConnection.feed(wire.substr(0, split));
+        pollUntilDrained(client);
+        hostConnection.feed(wire.substr(split));
+        pollUntilDrained(client);
+    }
+
+    void testEverySplitOfSmallFrames()
+    {
+        // 7-bit and 16-bit lengths, a masked frame and a ping between data frames.
+        const std::vector<size_t> sizes = {1, 100, 140, 3};
+        std::string wire;
+        std::vector<std::string> expected;
+        for (size_t i = 0; i < sizes.size(); ++i)
+        {
+            const std::string data = eventData(sizes[i]);
+            wire += serverFrame(0x1, eventMessage("E" + std::to_string(i), data), true, i == 2);
+            expected.push_back("E" + std::to_string(i) + "=" + data);
+            if (i == 1)
+            {
+                wire += serverFrame(0x9, "ping");
+            }
+        }
+
+        for (size_t split = 0; split <= wire.size(); ++split)
+        {
+            hostConnection.reset();
+            resetRecorders();
+            ObsWsClient client;
+            ObsWsClient::Config config = baseConfig();
+            const size_t start = connectClient(client, config);
+            CHECK(start > 0);
+
+            feedSplit(client, wire, split);
+            if (!CHECK(events == expected))
+            {
+                std::printf("  split at %zu\n", split);
+                return;
+            }
+            const std::vector<ClientFrame> frames = clientFrames(start);
+            CHECK(frames.size() == 1 && frames[0].first == 0x8A && frames[0].payload == "ping");
+        }
+    }
+
+    void testSplitsAroundLargeFrames()
+    {
+        // A 64-bit length and a message that does not fit in the receive buffer; split at
+        // every byte of the headers and the ends of the payload, and every 997 bytes between.
+        const std::string large = eventData(70000);
+        const std::string wire = serverFrame(0x1, eventMessage("Large", large)) + serverFrame(0x1, eventMessage("After", "{}"));
+        const std::string firstFrame = serverFrame(0x1, eventMessage("Large", large));
+
+        std::vector<size_t> splits;
+        for (size_t i = 0; i < 32; ++i)
+        {
+            splits.push_back(i);
+            splits.push_back(firstFrame.size() - 16 + i);
+        }
+        for (size_t i = 32; i < firstFrame.size(); i += 997)
+        {
+            splits.push_back(i);
+        }
+
+        for (size_t split : splits)
+        {
+            hostConnection.reset();
+            resetRecorders();
+            ObsWsClient client;
+            ObsWsClient::Config config = baseConfig();
+            CHECK(connectClient(client, config) > 0);
+
+            feedSplit(client, wire, split);
+            if (!CHECK(events.size() == 2 && events[0] == "Large=" + large && events[1] == "After={}"))
+            {
+                std::printf("  split at %zu\n", split);
+                return;
+            }
+        }
+    }
+
+    void testReadSizes()
+    {
+        // The transport returning a few bytes per read must give the same messages as one
+        // read of everything.
+        for (size_t maxRead : {size_t(1), size_t(7), size_t(100), size_t(1023), size_t(5000), static_cast<size_t>(-1)})
+        {
+            hostConnection.reset();
+            resetRecorders();
+            ObsWsClient client;
+            ObsWsClient::Config config = baseConfig();
+            CHECK(connectClient(client, config) > 0);
+
+            hostConnection.maxRead = maxRead;
+            std::vector<std::string> expected;
+            for (size_t size : {0, 5, 125, 126, 1000, 1024, 3000, 66000})
+            {
+                const std::string data = eventData(size);
+                hostConnection.feed(serverFrame(0x1, eventMessage("Sized", data), true, size % 2 == 1));
+                expected.push_back("Sized=" + data);
+            }
+            pollUntilDrained(client);
+            if (!CHECK(events == expected))
+            {
+                std::printf("  maxRead %zu\n", maxRead);
+            }
+        }
+    }
+
+    void testMessageTooLarge()
+    {
+        hostConnection.reset();
+        resetRecorders();
+        ObsWsClient client;
+        ObsWsClient::Config config = baseConfig();
+        config.maxMessageSize = 5000;
+        const size_t start = connectClient(client, config);
+
+        hostConnection.feed(serverFrame(0x1, eventMessage("Big", eventData(6000))));
+        pollUntilDrained(client);
+
+        CHECK(events.empty());
+        CHECK(errors.size() == 1 && errors[0] == ObsWsError::MessageTooLarge);
+        const std::vector<ClientFrame> frames = clientFrames(start);
+        CHECK(!frames.empty() && frames.back().first == 0x88 && frames.back().payload == std::string("\x03\xf1"));
+        CHECK(client.status() == ObsWsStatus::Error);
+    }
+
+    void testStreamedMessage()
+    {
+        // Nothing waits for a reply, so a message larger than the receive buffer goes to
+        // onMessageChunk as it arrives; smaller ones are still parsed.
+        hostConnection.reset();
+        resetRecorders();
+        ObsWsClient client;
+        ObsWsClient::Config config = baseConfig();
+        config.onMessageChunk = &recordChunk;
+        config.maxMessageSize = 1000;
+        CHECK(connectClient(client, config) > 0);
+
+        const std::string big = eventMessage("Big", eventData(300000));
+        hostConnection.maxRead = 333;
+        hostConnection.feed(serverFrame(0x1, big, true, true));
+        hostConnection.feed(serverFrame(0x1, eventMessage("Small", "{}")));
+        pollUntilDrained(client);
+
+        CHECK(streamedMessages.size() == 1 && streamedMessages[0] == big);
+        CHECK(events.size() == 1 && events[0] == "Small={}");
+        CHECK(errors.empty());
+    }
+
+    std::string completedData;
+
+    void recordCompletion(const ObsRequestResult &result, void *)
+    {
+        completedData.assign(result.responseData != nullptr ? result.responseData : "", result.responseDataLength);
+    }
+
+    void testStreamingWaitsForPendingReplies()
+    {
+        // A large response to a request with a callback is assembled so the callback gets it;
+        // once nothing is pending, large messages are streamed again.
+        hostConnection.reset();
+        resetRecorders();
+        completedData.clear();
+        ObsWsClient client;
+        ObsWsClient::Config config = baseConfig();
+        config.onMessageChunk = &recordChunk;
+        config.maxMessageSize = 16 * 1024;
+        CHECK(connectClient(client, config) > 0);
+
+        const uint32_t id = client.sendRequest("GetInputList", nullptr, &recordCompletion, nullptr);
+        CHECK(id != 0);
+        const std::string data = eventData(5000);
+        hostConnection.maxRead = 100;
+        hostConnection.feed(serverFrame(0x1, responseMessage(id, "GetInputList", true, data)));
+        pollUntilDrained(client);
+
+        CHECK_EQ(completedData, data);
+        CHECK(streamedMessages.empty());
+
+        const std::string big = eventMessage("Big", eventData(5000));
+        hostConnection.feed(serverFrame(0x1, big));
+        pollUntilDrained(client);
+
+        CHECK(streamedMessages.size() == 1 && streamedMessages[0] == big);
+        CHECK(errors.empty());
+    }
+}
+
+int main()
+{
+    testEverySplitOfSmallFrames();
+    testSplitsAroundLargeFrames();
+    testReadSizes();
+    testMessageTooLarge();
+    testStreamedMessage();
+    testStreamingWaitsForPendingReplies();
+    return hostTestResult("frames");
+}
@@ -0,0 +1,194 @@
+// permessage-deflate: negotiation, messages compressed with a shared context, compressed
+// messages split at every byte boundary or fragmented, and corrupt input.
+
+#include "HostTest.h"
+
+#include <zlib.h>
+
+namespace
+{
+    const char kExtension[] = "Sec-WebSocket-Extensions: permessage-deflate; server_max_window_bits=12\r\n";
+
+    std::vector<std::string> events;
+    std::vector<ObsWsError> errors;
+
+    void recordEvent(const ObsEvent &event)
+    {
+        events.push_back(std::string(event.id) + "=" + std::string(event.payload, event.payloadLength));
+    }
+
+    void recordError(ObsWsError error)
+    {
+        errors.push_back(error);
+    }
+
+    // A server-side compressor that keeps its context across messages, as OBS does.
+    class Deflater
+    {
+    public:
+        Deflater()
+        {
+            deflateInit2(&stream_, 6, Z_DEFLATED, -12, 8, Z_DEFAULT_STRATEGY);
+        }
+
+        ~Deflater()
+        {
+            deflateEnd(&stream_);
+        }
+
+        // RFC 7692: compress with a sync flush and drop the trailing 00 00 FF FF.
+        std::string compress(const std::string &message)
+        {
+            std::string out(message.size() + 1024, '\0');
+            stream_.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(message.data()));
+            stream_.avail_in = static_cast<uInt>(message.size());
+            stream_.next_out = reinterpret_cast<Bytef *>(&out[0]);
+            stream_.avail_out = static_cast<uInt>(out.size());
+            deflate(&stream_, Z_SYNC_FLUSH);
+            out.resize(out.size() - stream_.avail_out);
+            CHECK(out.size() >= 4 && out.substr(out.size() - 4) == std::string("\0\0\xff\xff", 4));
+            out.resize(out.size() - 4);
+            return out;
+        }
+
+    private:
+        z_stream stream_{};
+    };
+
+    ObsWsClient::Config baseConfig()
+    {
+        ObsWsClient::Config config;
+        config.onEvent = &recordEvent;
+        config.onError = &recordError;
+        config.rxBufferSize = 1024;
+        config.maxMessageSize = 1 << 20;
+        config.eventQueueLength = 16;
+        config.enableCompression = true;
+        return config;
+    }
+
+    void reset()
+    {
+        hostConnection.reset();
+        events.clear();
+        errors.clear();
+    }
+
+    void testOffer()
+    {
+        reset();
+        ObsWsClient client;
+        ObsWsClient::Config config = baseConfig();
+        config.host = "obs.local";
+        CHECK(client.begin(config));
+        client.poll();
+        CHECK(hostConnection.written().find(kExtension) != std::string::npos);
+        client.close();
+
+        // Not offered, so an accepted extension fails the handshake.
+        reset();
+        ObsWsClient plain;
+        config.enableCompression = false;
+        CHECK(plain.begin(config));
+        acceptUpgrade(plain, kExtension);
+        pollUntilDrained(plain);
+        CHECK(errors.size() == 1 && errors[0] == ObsWsError::HandshakeRejected);
+    }
+
+    void testSharedContext()
+    {
+        for (size_t maxRead : {size_t(1), size_t(13), static_cast<size_t>(-1)})
+        {
+            reset();
+            ObsWsClient client;
+            ObsWsClient::Config config = baseConfig();
+            CHECK(connectClient(client, config, kExtension) > 0);
+            hostConnection.maxRead = maxRead;
+
+            Deflater deflater;
+            std::vector<std::string> expected;
+            for (int i = 0; i < 6; ++i)
+            {
+                const std::string data = "{\"inputName\":\"Mic\",\"n\":" + std::to_string(i) + "}";
+                hostConnection.feed(serverFrame(0x1, deflater.compress(eventMessage("Sample", data)), true, i % 2 == 1, 0x40));
+                expected.push_back("Sample=" + data);
+            }
+
+            // Larger than the receive buffer once inflated, and fragmented with a ping inside.
+            std::string list = "[";
+            for (int i = 0; i < 5000; ++i)
+            {
+                list += (i > 0 ? ",\"Scene " : "\"Scene ") + std::to_string(i % 50) + "\"";
+            }
+            list += "]";
+            const std::string large = "{\"scenes\":" + list + "}";
+            const std::string compressed = deflater.compress(eventMessage("Large", large));
+            const size_t half = compressed.size() / 2;
+            hostConnection.feed(serverFrame(0x1, compressed.substr(0, half), false, false, 0x40));
+            hostConnection.feed(serverFrame(0x9, "x"));
+            hostConnection.feed(serverFrame(0x0, compressed.substr(half), true, true));
+            expected.push_back("Large=" + large);
+
+            hostConnection.feed(serverFrame(0x1, eventMessage("Plain", "{}")));
+            expected.push_back("Plain={}");
+            pollUntilDrained(client);
+
+            if (!CHECK(events == expected))
+            {
+                std::printf("  maxRead %zu, %zu events\n", maxRead, events.size());
+            }
+            CHECK(errors.empty());
+        }
+    }
+
+    void testEverySplit()
+    {
+        Deflater reference;
+        const std::string message = eventMessage("Sample", "{\"inputName\":\"Microphone\",\"inputVolumeMul\":0.5}");
+        const std::string wire = serverFrame(0x1, reference.compress(message), true, false, 0x40);
+
+        for (size_t split = 0; split <= wire.size(); ++split)
+        {
+            reset();
+            ObsWsClient client;
+            ObsWsClient::Config config = baseConfig();
+            CHECK(connectClient(client, config, kExtension) > 0);
+
+            hostConnection.feed(wire.substr(0, split));
+            pollUntilDrained(client);
+            hostConnection.feed(wire.substr(split));
+            pollUntilDrained(client);
+
+            if (!CHECK(events.size() == 1 && events[0] == "Sample={\"inputName\":\"Microphone\",\"inputVolumeMul\":0.5}"))
+            {
+                std::printf("  split at %zu\n", split);
+                return;
+            }
+        }
+    }
+
+    void testCorruptInput()
+    {
+        reset();
+        ObsWsClient client;
+        ObsWsClient::Config config = baseConfig();
+        const size_t start = connectClient(client, config, kExtension);
+
+        // Block type 3 does not exist.
+        hostConnection.feed(serverFrame(0x1, std::string("\x07\xff\xff\xff", 4), true, false, 0x40));
+        pollUntilDrained(client);
+
+        CHECK(errors.size() == 1 && errors[0] == ObsWsError::ProtocolError);
+        const std::vector<ClientFrame> frames = clientFrames(start);
+        CHECK(!frames.empty() && frames.back().first == 0x88 && frames.back().payload.substr(0, 2) == std::string("\x03\xef"));
+    }
+}
+
+int main()
+{
+    testOffer();
+    testSharedContext();
+    testEverySplit();
+    testCorruptInput();
+    return hostTestResult("inflate");
+}
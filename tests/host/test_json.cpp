@@ -0,0 +1,409 @@
+// ObsJsonReader, parseObsWsMessage(), unescapeJsonString(), ObsJsonWriter, isJsonObject() and
+// isJsonValue(), including malformed input.
+
+#include "HostTest.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    std::string text(const ObsJsonSlice &slice)
+    {
+        return slice.data != nullptr ? std::string(slice.data, slice.length) : std::string();
+    }
+
+    std::string unescaped(const std::string &escaped)
+    {
+        ObsJsonSlice slice{escaped.data(), escaped.size()};
+        char out[64];
+        const size_t length = unescapeJsonString(slice, out, sizeof(out));
+        return std::string(out, std::min(length, sizeof(out)));
+    }
+
+    void testTypedReads()
+    {
+        const std::string json = " { \"s\" : \"a\\\"b\" , \"n\" : -12.5e1 , \"i\" : 42 , \"t\" : true , \"f\" : false , \"z\" : null , \"o\" : {\"x\":[1,{\"y\":\"]\"}]} } ";
+        ObsJsonReader reader(json.data(), json.size());
+        CHECK(reader.beginObject());
+
+        ObsJsonSlice key;
+        ObsJsonSlice value;
+        CHECK(reader.nextMember(key) && text(key) == "s");
+        CHECK(!reader.beginObject()); // Type mismatch consumes nothing.
+        CHECK(reader.readString(value));
+        CHECK_EQ(text(value), "a\\\"b");
+
+        double number = 0;
+        CHECK(reader.nextMember(key) && text(key) == "n");
+        CHECK(reader.readNumber(number) && number == -125.0);
+
+        int64_t integer = 0;
+        CHECK(reader.nextMember(key) && text(key) == "i");
+        CHECK(reader.readInteger(integer) && integer == 42);
+
+        bool flag = false;
+        CHECK(reader.nextMember(key) && text(key) == "t");
+        CHECK(reader.readBool(flag) && flag);
+        CHECK(reader.nextMember(key) && text(key) == "f");
+        CHECK(reader.readBool(flag) && !flag);
+
+        CHECK(reader.nextMember(key) && text(key) == "z");
+        CHECK(!reader.readBool(flag));
+        CHECK(reader.skipValue(&value) && text(value) == "null");
+
+        CHECK(reader.nextMember(key) && text(key) == "o");
+        CHECK(reader.skipValue(&value));
+        CHECK_EQ(text(value), "{\"x\":[1,{\"y\":\"]\"}]}");
+
+        CHECK(!reader.nextMember(key));
+        CHECK(!reader.failed());
+        CHECK(reader.peek() == '\0');
+    }
+
+    void testArrays()
+    {
+        const std::string json = "[1, \"two\", [3], {\"four\": 4}]";
+        ObsJsonReader reader(json.data(), json.size());
+        CHECK(reader.beginArray());
+        std::vector<std::string> elements;
+        ObsJsonSlice element;
+        while (reader.nextElement() && reader.skipValue(&element))
+        {
+            elements.push_back(text(element));
+        }
+        CHECK(!reader.failed());
+        CHECK(elements == std::vector<std::string>({"1", "\"two\"", "[3]", "{\"four\": 4}"}));
+    }
+
+    void testFindMember()
+    {
+        const std::string json = "{\"a\":{\"b\":1},\"b\":[2,3],\"c\":\"x\"}";
+        const ObsJsonSlice object{json.data(), json.size()};
+        ObsJsonSlice value;
+        CHECK(ObsJsonReader::findMember(object, "b", value) && text(value) == "[2,3]");
+        CHECK(ObsJsonReader::findMember(object, "c", value) && text(value) == "\"x\"");
+        CHECK(!ObsJsonReader::findMember(object, "d", value));
+
+        const std::string array = "[1]";
+        CHECK(!ObsJsonReader::findMember(ObsJsonSlice{array.data(), array.size()}, "a", value));
+    }
+
+    // Structural errors; skipValue() passes over scalars without checking them, which is
+    // left to the typed reads and to isJsonObject().
+    void testMalformed()
+    {
+        const std::vector<std::string> inputs = {
+            "{\"a\":\"unterminated",
+            "{\"a\":[1,2",
+            "{\"a\" 1}",
+            "{1:2}",
+            "",
+        };
+        for (const std::string &json : inputs)
+        {
+            ObsJsonReader reader(json.data(), json.size());
+            bool ok = reader.beginObject();
+            ObsJsonSlice key;
+            while (ok && reader.nextMember(key))
+            {
+                ok = reader.skipValue();
+            }
+            if (!CHECK(!ok || reader.failed()))
+            {
+                std::printf("  accepted: %s\n", json.c_str());
+            }
+
+            ObsWsMessage message;
+            CHECK(!parseObsWsMessage(json.data(), json.size(), message));
+        }
+
+        for (const char *number : {"1x", "-", "--1", "1.2.3"})
+        {
+            ObsJsonReader reader(number, std::strlen(number));
+            double value = 0;
+            CHECK(!reader.readNumber(value) && reader.failed());
+        }
+    }
+
+    void testHello()
+    {
+        const std::string json = "{\"d\":{\"authentication\":{\"challenge\":\"+IxH4CnCiqpX1rM9scsNynZzbOe4KhDeYcTNS3PDaeY=\",\"salt\":\"lM1GncleQOaCu9lT1yeUZhFYnqhsLLP1G5lAGo3ixaI=\"},\"obsWebSocketVersion\":\"5.1.0\",\"rpcVersion\":1},\"op\":0}";
+        ObsWsMessage message;
+        CHECK(parseObsWsMessage(json.data(), json.size(), message));
+        CHECK_EQ(message.op, 0);
+        CHECK_EQ(message.rpcVersion, 1);
+        CHECK_EQ(text(message.challenge), "+IxH4CnCiqpX1rM9scsNynZzbOe4KhDeYcTNS3PDaeY=");
+        CHECK_EQ(text(message.salt), "lM1GncleQOaCu9lT1yeUZhFYnqhsLLP1G5lAGo3ixaI=");
+    }
+
+    void testEvent()
+    {
+        const std::string json = eventMessage("CurrentProgramSceneChanged", "{\"sceneName\":\"Main\",\"sceneUuid\":\"1\"}");
+        ObsWsMessage message;
+        CHECK(parseObsWsMessage(json.data(), json.size(), message));
+        CHECK_EQ(message.op, 5);
+        CHECK_EQ(text(message.eventType), "CurrentProgramSceneChanged");
+        CHECK_EQ(text(message.eventData), "{\"sceneName\":\"Main\",\"sceneUuid\":\"1\"}");
+        CHECK(text(message.data).find("\"eventIntent\":1") != std::string::npos);
+    }
+
+    void testResponse()
+    {
+        const std::string json = "{\"op\":7,\"d\":{\"requestType\":\"GetVersion\",\"requestId\":\"17\",\"requestStatus\":{\"result\":false,\"code\":604,\"comment\":\"No \\\"scene\\\"\"},\"responseData\":{\"v\":[1,2]}}}";
+        ObsWsMessage message;
+        CHECK(parseObsWsMessage(json.data(), json.size(), message));
+        CHECK_EQ(message.op, 7);
+        CHECK_EQ(text(message.requestType), "GetVersion");
+        CHECK_EQ(text(message.requestId), "17");
+        CHECK(message.hasRequestStatus && !message.requestResult);
+        CHECK_EQ(message.requestCode, 604);
+        CHECK_EQ(text(message.comment), "No \\\"scene\\\"");
+        CHECK_EQ(text(message.responseData), "{\"v\":[1,2]}");
+    }
+
+    void testBatchResults()
+    {
+        const std::string json = "{\"d\":{\"requestId\":\"9\",\"results\":[{\"requestId\":\"10\",\"requestStatus\":{\"code\":100,\"result\":true},\"requestType\":\"A\",\"responseData\":{\"x\":1}},{\"requestId\":\"11\",\"requestStatus\":{\"code\":600,\"result\":false},\"requestType\":\"B\"}]},\"op\":9}";
+        ObsWsMessage message;
+        CHECK(parseObsWsMessage(json.data(), json.size(), message));
+        CHECK_EQ(message.op, 9);
+        CHECK_EQ(text(message.requestId), "9");
+
+        ObsJsonReader reader(message.results);
+        CHECK(reader.beginArray());
+        std::vector<std::string> seen;
+        while (reader.nextElement())
+        {
+            ObsWsMessage result;
+            CHECK(parseObsWsRequestResult(reader, result));
+            seen.push_back(text(result.requestId) + ":" + text(result.requestType) + ":" + (result.requestResult ? "ok" : "fail") + ":" + std::to_string(result.requestCode) + ":" + text(result.responseData));
+        }
+        CHECK(!reader.failed());
+        CHECK(seen == std::vector<std::string>({"10:A:ok:100:{\"x\":1}", "11:B:fail:600:"}));
+    }
+
+    void testNumbers()
+    {
+        const std::vector<std::pair<std::string, double>> cases = {
+            {"0", 0}, {"-0", 0}, {"7", 7}, {"1.5", 1.5}, {"-2.25", -2.25}, {"1e3", 1000}, {"1E-2", 0.01}, {"2.5e+2", 250}, {"123456789", 123456789}};
+        for (const auto &entry : cases)
+        {
+            ObsJsonReader reader(entry.first.data(), entry.first.size());
+            double value = -1;
+            if (!CHECK(reader.readNumber(value) && std::fabs(value - entry.second) < 1e-9))
+            {
+                std::printf("  number %s\n", entry.first.c_str());
+            }
+        }
+    }
+
+    void testUnescape()
+    {
+        CHECK_EQ(unescaped("plain"), "plain");
+        CHECK_EQ(unescaped("a\\\"b\\\\c\\/d"), "a\"b\\c/d");
+        CHECK_EQ(unescaped("\\b\\f\\n\\r\\t"), "\b\f\n\r\t");
+        CHECK_EQ(unescaped("\\u00e9\\u20ac"), "\xc3\xa9\xe2\x82\xac");
+        CHECK_EQ(unescaped("\\ud83c\\udfa5"), "\xf0\x9f\x8e\xa5");
+        CHECK_EQ(unescaped("\\ud83c!"), "\xef\xbf\xbd!");
+
+        // The decoded length is reported even when it does not fit.
+        const std::string repeated = "\\u00e9\\u00e9\\u00e9";
+        char out[3];
+        CHECK_EQ(unescapeJsonString(ObsJsonSlice{repeated.data(), repeated.size()}, out, sizeof(out)), 6);
+        CHECK(std::string(out, 2) == "\xc3\xa9");
+    }
+
+    void testWriter()
+    {
+        char buffer[256];
+        ObsJsonWriter json(buffer, sizeof(buffer));
+        json.beginObject();
+        json.key("s");
+        json.string("q\"b\\n\n\r\t\x01");
+        json.key("i");
+        json.integer(-9007199254740993LL);
+        json.key("n");
+        json.number(0.25);
+        json.key("inf");
+        json.number(HUGE_VAL);
+        json.key("a");
+        json.beginArray();
+        json.boolean(true);
+        json.boolean(false);
+        json.null();
+        json.beginObject();
+        json.endObject();
+        json.raw("{\"r\":1}", 7);
+        json.endArray();
+        json.key("k", 1);
+        json.string("abc", 2);
+        json.endObject();
+
+        CHECK(!json.overflowed());
+        CHECK_EQ(std::string(json.data(), json.length()), "{\"s\":\"q\\\"b\\\\n\\n\\r\\t\\u0001\",\"i\":-9007199254740993,\"n\":0.25,\"inf\":0,\"a\":[true,false,null,{},{\"r\":1}],\"k\":\"ab\"}");
+        CHECK(isJsonObject(json.data(), json.length()));
+    }
+
+    void testWriterOverflow()
+    {
+        char small[8];
+        ObsJsonWriter json(small, sizeof(small));
+        json.beginObject();
+        json.key("requestType");
+        json.string("GetVersion");
+        json.endObject();
+        CHECK(json.overflowed());
+        CHECK_EQ(json.required(), std::strlen("{\"requestType\":\"GetVersion\"}") + 1);
+        CHECK(std::strlen(small) < sizeof(small));
+
+        std::vector<char> retry(json.required());
+        ObsJsonWriter again(retry.data(), retry.size());
+        again.beginObject();
+        again.key("requestType");
+        again.string("GetVersion");
+        again.endObject();
+        CHECK(!again.overflowed());
+        CHECK_EQ(std::string(again.data()), "{\"requestType\":\"GetVersion\"}");
+    }
+
+    void testIsJsonObject()
+    {
+        const std::vector<std::string> accepted = {
+            "{}",
+            " { } ",
+            "{\"a\":1}",
+            "{\"a\":-0.5e-3,\"b\":0,\"c\":10E+2}",
+            "{\"a\":\"\\\"\\\\\\/\\b\\f\\n\\r\\t\\u00e9\"}",
+            "{\"a\":[],\"b\":[1,[2,{}]],\"c\":{\"d\":null}}",
+            "{\"a\":true,\"b\":false,\"c\":null}",
+            "\n{\"inputName\" : \"Mic/Aux\" ,\r\n \"inputMuted\" : true}\t",
+            "{\"\u00e9\":\"\xc3\xa9\"}",
+        };
+        for (const std::string &json : accepted)
+        {
+            if (!CHECK(isJsonObject(json.data(), json.size())))
+            {
+                std::printf("  rejected: %s\n", json.c_str());
+            }
+        }
+
+        const std::vector<std::string> rejected = {
+            "",
+            "   ",
+            "[]",
+            "\"a\"",
+            "1",
+            "{",
+            "{}}",
+            "{}{}",
+            "{} x",
+            "{\"a\":}",
+            "{\"a\":1,}",
+            "{,\"a\":1}",
+            "{\"a\":1 \"b\":2}",
+            "{\"a\":1,,\"b\":2}",
+            "{\"a\" 1}",
+            "{\"a\"}",
+            "{a:1}",
+            "{1:1}",
+            "{\"a\":tru}",
+            "{\"a\":truex}",
+            "{\"a\":nul}",
+            "{\"a\":nulls}",
+            "{\"a\":01}",
+            "{\"a\":-01}",
+            "{\"a\":1.}",
+            "{\"a\":.5}",
+            "{\"a\":1e}",
+            "{\"a\":1e+}",
+            "{\"a\":+1}",
+            "{\"a\":-}",
+            "{\"a\":0x10}",
+            "{\"a\":\"\\x\"}",
+            "{\"a\":\"\\u12\"}",
+            "{\"a\":\"\\u12g4\"}",
+            "{\"a\":\"tab\there\"}",
+            "{\"a\":\"unterminated}",
+            "{\"a\":[1,]}",
+            "{\"a\":[,1]}",
+            "{\"a\":[1 2]}",
+            "{\"a\":[1}",
+            "{\"a\":{]}",
+            "{\"a\":[}]}",
+        };
+        for (const std::string &json : rejected)
+        {
+            if (!CHECK(!isJsonObject(json.data(), json.size())))
+            {
+                std::printf("  accepted: %s\n", json.c_str());
+            }
+        }
+
+        // A NUL inside the text is not whitespace.
+        const std::string embedded("{}\0", 3);
+        CHECK(!isJsonObject(embedded.data(), embedded.size()));
+        CHECK(!isJsonObject(nullptr, 0));
+
+        std::string deep;
+        for (int i = 0; i < 40; ++i)
+        {
+            deep += "{\"a\":";
+        }
+        deep += "1" + std::string(40, '}');
+        CHECK(!isJsonObject(deep.data(), deep.size()));
+
+        // isJsonValue() applies the same grammar to a value of any type.
+        for (const std::string json : {"{}", "[]", " [1,{\"a\":null}] ", "\"a\"", "-0.5", "true", "null"})
+        {
+            CHECK(isJsonValue(json.data(), json.size()));
+        }
+        for (const std::string json : {"", " ", "1 2", "[1,]", "\"a", "tru", "{\"a\":}", "[]]"})
+        {
+            CHECK(!isJsonValue(json.data(), json.size()));
+        }
+        CHECK(!isJsonValue(deep.data(), deep.size()));
+        CHECK(!isJsonValue(nullptr, 0));
+    }
+
+    // Malformed payloads are refused before anything reaches OBS.
+    void testRequestPayloads()
+    {
+        hostConnection.reset();
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        const size_t start = connectClient(client, config);
+        CHECK(start > 0);
+
+        CHECK(!client.sendRequest("SetInputMute", "{\"inputName\":\"Mic\",\"inputMuted\":tru}"));
+        ObsRequestBatch batch;
+        batch.add("GetVersion");
+        batch.add("SetInputMute", "{\"inputName\":\"Mic\",}");
+        CHECK_EQ(client.sendRequestBatch(batch), 0);
+        CHECK(clientFrames(start).empty());
+
+        CHECK(client.sendRequest("SetInputMute", "{\"inputName\":\"Mic\",\"inputMuted\":true}"));
+        const std::vector<ClientFrame> frames = clientFrames(start);
+        CHECK(frames.size() == 1 && frames[0].payload.find("\"requestData\":{\"inputName\":\"Mic\",\"inputMuted\":true}") != std::string::npos);
+        client.close();
+    }
+}
+
+int main()
+{
+    testTypedReads();
+    testArrays();
+    testFindMember();
+    testMalformed();
+    testHello();
+    testEvent();
+    testResponse();
+    testBatchResults();
+    testNumbers();
+    testUnescape();
+    testWriter();
+    testWriterOverflow();
+    testIsJsonObject();
+    testRequestPayloads();
+    return hostTestResult("json");
+}
@@ -0,0 +1,127 @@
+// applyObsWsMask() against a byte-at-a-time reference for every start alignment, mask phase
+// and tail length, plus masking through the client's send and receive paths.
+
+#include "HostTest.h"
+#include "ObsWsMask.h"
+
+#include <random>
+
+namespace
+{
+    void referenceMask(uint8_t *data, size_t length, const uint8_t *maskKey, size_t offset)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            data[i] ^= maskKey[(offset + i) % 4];
+        }
+    }
+
+    bool matchesReference(std::mt19937 &random, std::vector<uint8_t> &buffer, size_t start, size_t length, size_t offset)
+    {
+        const uint8_t key[4] = {0xA5, 0x3C, 0x0F, 0xF0};
+        // Guard bytes around the payload catch writes outside it.
+        for (size_t i = 0; i < start + length + 32; ++i)
+        {
+            buffer[i] = static_cast<uint8_t>(random());
+        }
+        std::vector<uint8_t> expected(buffer.begin(), buffer.begin() + start + length + 32);
+        referenceMask(expected.data() + start, length, key, offset);
+        applyObsWsMask(buffer.data() + start, length, key, offset);
+        return std::equal(expected.begin(), expected.end(), buffer.begin());
+    }
+
+    void testAgainstReference()
+    {
+        std::mt19937 random(1);
+        std::vector<uint8_t> buffer(300 * 1024);
+        for (size_t start = 0; start < 16; ++start)
+        {
+            for (size_t offset = 0; offset < 8; ++offset)
+            {
+                for (size_t length = 0; length <= 80; ++length)
+                {
+                    if (!CHECK(matchesReference(random, buffer, start, length, offset)))
+                    {
+                        std::printf("  start %zu offset %zu length %zu\n", start, offset, length);
+                        return;
+                    }
+                }
+            }
+        }
+
+        for (size_t length : {size_t(255), size_t(4096), size_t(65537), size_t(256 * 1024)})
+        {
+            for (size_t start = 0; start < 4; ++start)
+            {
+                CHECK(matchesReference(random, buffer, start, length, start + 1));
+            }
+        }
+    }
+
+    // Unmasking a payload piece by piece with running offsets equals unmasking it at once.
+    void testPieces()
+    {
+        const uint8_t key[4] = {1, 2, 3, 4};
+        std::vector<uint8_t> whole(1000);
+        for (size_t i = 0; i < whole.size(); ++i)
+        {
+            whole[i] = static_cast<uint8_t>(i * 7);
+        }
+        std::vector<uint8_t> pieces = whole;
+        applyObsWsMask(whole.data(), whole.size(), key, 0);
+        for (size_t pos = 0, step = 1; pos < pieces.size(); pos += step, step = step * 2 + 1)
+        {
+            const size_t length = std::min(step, pieces.size() - pos);
+            applyObsWsMask(pieces.data() + pos, length, key, pos);
+        }
+        CHECK(whole == pieces);
+    }
+
+    std::vector<std::string> events;
+
+    void recordEvent(const ObsEvent &event)
+    {
+        events.push_back(std::string(event.payload, event.payloadLength));
+    }
+
+    // Payloads of every length up to 70 bytes round-trip through the client's masking: masked
+    // server frames are unmasked on receipt, and requests leave with a mask the test removes.
+    void testThroughClient()
+    {
+        hostConnection.reset();
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.onEvent = &recordEvent;
+        config.eventQueueLength = 128;
+        config.deferFlush = true;
+        const size_t start = connectClient(client, config);
+        CHECK(start > 0);
+
+        std::vector<std::string> expected;
+        for (size_t length = 0; length <= 70; ++length)
+        {
+            const std::string data = "{\"s\":\"" + std::string(length, static_cast<char>('a' + length % 26)) + "\"}";
+            hostConnection.feed(serverFrame(0x1, eventMessage("Masked", data), true, true));
+            expected.push_back(data);
+            CHECK(client.sendRequest(("Request" + std::string(length, 'x')).c_str(), nullptr));
+        }
+        pollUntilDrained(client);
+        CHECK(events == expected);
+
+        const std::vector<ClientFrame> frames = clientFrames(start);
+        CHECK_EQ(frames.size(), 71);
+        for (size_t i = 0; i < frames.size(); ++i)
+        {
+            CHECK(frames[i].payload.find("\"requestType\":\"Request" + std::string(i, 'x') + "\"") != std::string::npos);
+        }
+        client.close();
+    }
+}
+
+int main()
+{
+    testAgainstReference();
+    testPieces();
+    testThroughClient();
+    return hostTestResult("mask");
+}
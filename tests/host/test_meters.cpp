@@ -0,0 +1,174 @@
+// InputVolumeMeters: fixed-point levels, inputs interned on first sight and released with
+// their levels, capacity and malformed data, and delivery through onVolumeMeters.
+
+#include "HostTest.h"
+#include "ObsWsMeters.h"
+
+namespace
+{
+    std::string input(const std::string &name, const std::string &levels)
+    {
+        return "{\"inputLevelsMul\":" + levels + ",\"inputName\":\"" + name + "\"}";
+    }
+
+    std::string meters(const std::vector<std::string> &inputs)
+    {
+        std::string data = "{\"inputs\":[";
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            data += (i > 0 ? "," : "") + inputs[i];
+        }
+        return data + "]}";
+    }
+
+    ObsJsonSlice slice(const std::string &text)
+    {
+        return ObsJsonSlice{text.c_str(), text.size()};
+    }
+
+    std::string nameOf(ObsNameTable &names, ObsNameHandle handle)
+    {
+        char name[64];
+        return names.copy(handle, name, sizeof(name)) ? std::string(name) : std::string();
+    }
+
+    void testLevels(ObsNameTable &names)
+    {
+        const std::string data = meters({input("Mic", "[[1.0,0.5,1],[0.1,0.01,0],[0,0,0],[1e-6,2.5e-1,0],[\"x\",-1,0]]")});
+        ObsInputMeter out[2];
+        CHECK_EQ(decodeObsVolumeMeters(slice(data), names, out, 2), 1);
+        CHECK_EQ(out[0].channels, 5);
+        CHECK_EQ(out[0].magnitude[0], 0);
+        CHECK_EQ(out[0].peak[0], -602);
+        CHECK_EQ(out[0].magnitude[1], -2000);
+        CHECK_EQ(out[0].peak[1], -4000);
+        CHECK_EQ(out[0].magnitude[2], kObsMeterFloor);
+        CHECK_EQ(out[0].magnitude[3], kObsMeterFloor);
+        CHECK_EQ(out[0].peak[3], -1204);
+        CHECK_EQ(out[0].magnitude[4], kObsMeterFloor);
+        CHECK_EQ(out[0].peak[4], kObsMeterFloor);
+        releaseObsVolumeMeters(names, out, 1);
+
+        // Channels past kObsMeterChannels are ignored.
+        std::string many = "[";
+        for (size_t i = 0; i < kObsMeterChannels + 3; ++i)
+        {
+            many += (i > 0 ? ",[1,1,1]" : "[1,1,1]");
+        }
+        const std::string wide = meters({input("Wide", many + "]")});
+        CHECK_EQ(decodeObsVolumeMeters(slice(wide), names, out, 2), 1);
+        CHECK_EQ(out[0].channels, kObsMeterChannels);
+        releaseObsVolumeMeters(names, out, 1);
+        CHECK_EQ(names.size(), 0);
+    }
+
+    // Inputs nobody interned are reported; each meter holds a reference until released.
+    void testInterning(ObsNameTable &names)
+    {
+        const ObsNameHandle mic = names.intern("Mic");
+        const std::string data = meters({input("Desktop Audio", "[[1,1,1]]"), input("Mic", "[[0.5,0.5,0.5]]"), input("Aux\\/Line \\u00e9", "[]")});
+        ObsInputMeter out[4];
+        CHECK_EQ(decodeObsVolumeMeters(slice(data), names, out, 4), 3);
+        CHECK_EQ(nameOf(names, out[0].input), "Desktop Audio");
+        CHECK(out[1].input == mic);
+        CHECK_EQ(nameOf(names, out[2].input), "Aux/Line \xc3\xa9");
+        CHECK(names.find("Desktop Audio") == out[0].input);
+        CHECK_EQ(names.size(), 3);
+
+        releaseObsVolumeMeters(names, out, 3);
+        CHECK_EQ(names.size(), 1);
+        CHECK(names.find("Desktop Audio") == kObsNoName);
+        CHECK(names.find("Mic") == mic);
+        names.release(mic);
+        CHECK_EQ(names.size(), 0);
+    }
+
+    void testCapacity(ObsNameTable &names)
+    {
+        const std::string data = meters({input("A", "[[1,1,1]]"), input("B", "[[1,1,1]]"), input("C", "[[1,1,1]]")});
+        ObsInputMeter out[2];
+        CHECK_EQ(decodeObsVolumeMeters(slice(data), names, out, 2), 2);
+        CHECK_EQ(nameOf(names, out[1].input), "B");
+        CHECK_EQ(names.size(), 2);
+        releaseObsVolumeMeters(names, out, 2);
+
+        // An input without a name is skipped.
+        const std::string unnamed = meters({"{\"inputLevelsMul\":[[1,1,1]]}", input("A", "[[1,1,1]]")});
+        CHECK_EQ(decodeObsVolumeMeters(slice(unnamed), names, out, 2), 1);
+        CHECK_EQ(nameOf(names, out[0].input), "A");
+        releaseObsVolumeMeters(names, out, 1);
+        CHECK_EQ(names.size(), 0);
+    }
+
+    // Malformed data decodes to nothing and leaves no references behind.
+    void testMalformed(ObsNameTable &names)
+    {
+        const std::vector<std::string> cases = {
+            "{}",
+            "{\"inputs\":{}}",
+            "{\"inputs\":[1]}",
+            meters({input("A", "[[1,1,1]]"), "{\"inputName\":\"B\",\"inputLevelsMul\":[[1,1,"}),
+            meters({input("A", "[[1,1,1]]"), input("B", "[[1,1,1]]")}).substr(0, 60),
+        };
+        ObsInputMeter out[4];
+        for (const std::string &data : cases)
+        {
+            if (!CHECK_EQ(decodeObsVolumeMeters(slice(data), names, out, 4), 0))
+            {
+                std::printf("  %s\n", data.c_str());
+            }
+            CHECK_EQ(names.size(), 0);
+        }
+        CHECK_EQ(decodeObsVolumeMeters(slice(meters({})), names, nullptr, 4), 0);
+    }
+
+    std::vector<std::string> delivered;
+
+    void recordMeters(const ObsInputMeter *levels, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            delivered.push_back(std::to_string(levels[i].input) + ":" + std::to_string(levels[i].magnitude[0]));
+        }
+    }
+
+    void testThroughClient()
+    {
+        hostConnection.reset();
+        delivered.clear();
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.onVolumeMeters = &recordMeters;
+        config.maxMeterInputs = 4;
+        config.eventSubscriptions = ObsEventSubscription::All | ObsEventSubscription::InputVolumeMeters;
+        CHECK(connectClient(client, config) > 0);
+
+        const ObsNameHandle mic = client.names().intern("Mic");
+        hostConnection.feed(serverFrame(0x1, eventMessage("InputVolumeMeters", meters({input("Mic", "[[1,1,1]]"), input("Desktop", "[[0.1,0.1,0.1]]")}))));
+        pollUntilDrained(client);
+
+        CHECK(delivered.size() == 2 && delivered[0] == std::to_string(mic) + ":0");
+        CHECK(delivered.size() == 2 && delivered[1].substr(delivered[1].find(':')) == ":-2000");
+        // The levels were delivered, so only the application's reference is left.
+        CHECK_EQ(client.names().size(), 1);
+        client.names().release(mic);
+        client.close();
+    }
+}
+
+int main()
+{
+    // The client allocates the table; the decoder tests borrow it.
+    hostConnection.reset();
+    ObsWsClient client;
+    ObsWsClient::Config config;
+    CHECK(connectClient(client, config) > 0);
+    testLevels(client.names());
+    testInterning(client.names());
+    testCapacity(client.names());
+    testMalformed(client.names());
+    client.close();
+
+    testThroughClient();
+    return hostTestResult("meters");
+}
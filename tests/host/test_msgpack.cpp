@@ -0,0 +1,379 @@
+// MessagePack: JSON round trips through writeObsJsonAsMsgPack() and writeObsMsgPackAsJson(),
+// the writer's MessagePack mode, the message parser, and a client session on the
+// obswebsocket.msgpack subprotocol routing events, responses, meters and streamed images.
+
+#include "HostTest.h"
+#include "ObsWsMsgPack.h"
+
+namespace
+{
+    std::string packed(const std::string &json)
+    {
+        std::vector<uint8_t> buffer(json.size() * 2 + 16);
+        ObsMsgPackWriter out(buffer.data(), buffer.size());
+        if (!writeObsJsonAsMsgPack(json.c_str(), json.size(), out) || out.overflowed())
+        {
+            return std::string();
+        }
+        return std::string(reinterpret_cast<const char *>(out.data()), out.length());
+    }
+
+    ObsMsgPackSlice slice(const std::string &bytes)
+    {
+        return ObsMsgPackSlice{reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size()};
+    }
+
+    std::string rendered(const ObsMsgPackSlice &value)
+    {
+        char buffer[1024];
+        ObsJsonWriter json(buffer, sizeof(buffer));
+        if (!writeObsMsgPackAsJson(value, json) || json.overflowed())
+        {
+            return "<invalid>";
+        }
+        return std::string(json.data(), json.length());
+    }
+
+    // JSON in the writer's own form comes back unchanged, and MessagePack in the smallest
+    // encodings comes back byte for byte.
+    void testRoundTrips()
+    {
+        const std::vector<std::string> documents = {
+            "{}",
+            "[]",
+            "{\"a\":1,\"b\":[true,false,null],\"c\":\"x\\\"y\\\\z\",\"d\":-5,\"e\":1.5}",
+            "{\"nested\":{\"deeper\":{\"list\":[[],{},[0,-1,127,128,-32,-33,65535,65536]]}}}",
+            "{\"big\":4294967296,\"negative\":-2147483649,\"text\":\"caf\xc3\xa9\"}",
+            "[\"" + std::string(40, 'x') + "\",\"" + std::string(300, 'y') + "\"]",
+            "0.25",
+            "\"plain\"",
+        };
+        for (const std::string &document : documents)
+        {
+            const std::string bytes = packed(document);
+            if (!CHECK_EQ(rendered(slice(bytes)), document))
+            {
+                continue;
+            }
+            const std::string json = rendered(slice(bytes));
+            CHECK(packed(json) == bytes);
+        }
+
+        // Escapes are decoded on the way in and written back in the writer's form.
+        CHECK_EQ(rendered(slice(packed("{\"s\":\"a\\/b\\u00e9\\n\"}"))), "{\"s\":\"a/b\xc3\xa9\\n\"}");
+
+        const std::string message = packed(eventMessage("SceneNameChanged", "{\"sceneName\":\"Live\"}"));
+        for (size_t length = 0; length < message.size(); ++length)
+        {
+            if (!CHECK_EQ(rendered(ObsMsgPackSlice{slice(message).data, length}), "<invalid>"))
+            {
+                std::printf("  truncated to %zu bytes\n", length);
+                break;
+            }
+        }
+        CHECK(packed("{\"a\":").empty());
+        CHECK(packed("[1,]").empty());
+    }
+
+    // ObsJsonWriter::msgPack() formats the same calls as MessagePack, counts past the end of
+    // a small buffer, and encodes raw() JSON in place.
+    void testWriter()
+    {
+        const auto build = [](ObsJsonWriter &json)
+        {
+            json.beginObject();
+            json.key("requestType");
+            json.string("SetInputMute");
+            json.key("requestData");
+            json.beginObject();
+            json.key("inputName");
+            json.string("Mic/Aux");
+            json.key("inputMuted");
+            json.boolean(true);
+            json.key("levels");
+            json.beginArray();
+            json.integer(-3);
+            json.number(0.5);
+            json.null();
+            json.endArray();
+            json.key("raw");
+            json.raw("{\"k\":[1,\"v\"]}", 13);
+            json.endObject();
+            json.endObject();
+        };
+        const std::string expected = "{\"requestType\":\"SetInputMute\",\"requestData\":{\"inputName\":\"Mic/Aux\",\"inputMuted\":true,\"levels\":[-3,0.5,null],\"raw\":{\"k\":[1,\"v\"]}}}";
+
+        uint8_t small[16];
+        ObsJsonWriter tooSmall = ObsJsonWriter::msgPack(small, sizeof(small));
+        build(tooSmall);
+        CHECK(tooSmall.overflowed());
+
+        std::vector<uint8_t> buffer(tooSmall.required());
+        ObsJsonWriter json = ObsJsonWriter::msgPack(buffer.data(), buffer.size());
+        build(json);
+        CHECK(!json.overflowed());
+        CHECK_EQ(json.length(), buffer.size());
+        CHECK_EQ(rendered(ObsMsgPackSlice{buffer.data(), json.length()}), expected);
+        CHECK(!json.failed());
+
+        // raw() text that does not parse cannot be encoded; the writer reports it instead of
+        // leaving a value out.
+        ObsJsonWriter broken = ObsJsonWriter::msgPack(buffer.data(), buffer.size());
+        broken.beginObject();
+        broken.key("raw");
+        broken.raw("{\"k\":", 5);
+        broken.endObject();
+        CHECK(broken.failed());
+    }
+
+    void testParse()
+    {
+        const std::string response = packed(responseMessage(42, "GetVersion", true, "{\"obsVersion\":\"30.0\"}"));
+        ObsWsMessage message;
+        ObsWsMsgPackData data;
+        CHECK(parseObsWsMsgPackMessage(slice(response).data, response.size(), message, data));
+        CHECK_EQ(message.op, 7);
+        CHECK(message.requestId.equals("42"));
+        CHECK(message.requestType.equals("GetVersion"));
+        CHECK(message.hasRequestStatus && message.requestResult);
+        CHECK_EQ(message.requestCode, 100);
+        CHECK(message.responseData.empty());
+        CHECK_EQ(rendered(data.responseData), "{\"obsVersion\":\"30.0\"}");
+        CHECK_EQ(rendered(data.data).substr(0, 18), "{\"requestId\":\"42\",");
+
+        const std::string event = packed(eventMessage("InputMuteStateChanged", "{\"inputMuted\":false,\"inputName\":\"Mic\"}"));
+        CHECK(parseObsWsMsgPackMessage(slice(event).data, event.size(), message, data));
+        CHECK_EQ(message.op, 5);
+        CHECK(message.eventType.equals("InputMuteStateChanged"));
+        CHECK_EQ(rendered(data.eventData), "{\"inputMuted\":false,\"inputName\":\"Mic\"}");
+
+        const std::string batch = packed("{\"d\":{\"requestId\":\"b\",\"results\":[{\"requestId\":\"1\",\"requestStatus\":{\"code\":100,\"result\":true},\"requestType\":\"A\",\"responseData\":{\"x\":1}}]},\"op\":9}");
+        CHECK(parseObsWsMsgPackMessage(slice(batch).data, batch.size(), message, data));
+        CHECK_EQ(message.op, 9);
+        ObsMsgPackReader reader(data.results);
+        uint32_t count = 0;
+        ObsWsMessage result;
+        ObsWsMsgPackData resultData;
+        CHECK(reader.readArray(count) && count == 1);
+        CHECK(parseObsWsMsgPackRequestResult(reader, result, resultData));
+        CHECK(result.requestId.equals("1") && result.requestResult);
+        CHECK_EQ(rendered(resultData.responseData), "{\"x\":1}");
+
+        CHECK(!parseObsWsMsgPackMessage(slice(event).data, event.size() - 1, message, data));
+        const std::string notMap = packed("[1]");
+        CHECK(!parseObsWsMsgPackMessage(slice(notMap).data, notMap.size(), message, data));
+    }
+
+    struct Session
+    {
+        std::vector<std::string> events;
+        std::vector<std::string> responses;
+        std::string image;
+        std::vector<std::string> meters;
+        bool rawSeen = true;
+    };
+
+    Session *session = nullptr;
+
+    void recordEvent(const ObsEvent &event)
+    {
+        session->events.push_back(std::string(event.id) + " " + std::string(event.payload, event.payloadLength));
+        session->rawSeen = session->rawSeen && !event.raw.empty();
+    }
+
+    void recordResponse(const ObsRequestResult &result, void *)
+    {
+        session->responses.push_back(std::string(result.responseData != nullptr ? result.responseData : "", result.responseDataLength) + " " + rendered(result.rawResponseData));
+    }
+
+    void recordImage(const uint8_t *data, size_t length, void *)
+    {
+        session->image.append(reinterpret_cast<const char *>(data), length);
+    }
+
+    void recordMeters(const ObsInputMeter *levels, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            session->meters.push_back(std::to_string(levels[i].channels) + ":" + std::to_string(levels[i].magnitude[0]) + ":" + std::to_string(levels[i].peak[0]));
+        }
+    }
+
+    // The handshake in binary frames; returns where the client's frames start, or 0 when the
+    // session did not come up.
+    size_t connectMsgPack(ObsWsClient &client, ObsWsClient::Config &config)
+    {
+        hostConnection.reset();
+        config.host = "obs.local";
+        config.useMsgPack = true;
+        config.onEvent = &recordEvent;
+        if (!client.begin(config))
+        {
+            return 0;
+        }
+        const size_t upgrade = acceptUpgrade(client, "Sec-WebSocket-Protocol: obswebsocket.msgpack\r\n");
+        hostConnection.feed(serverFrame(0x2, packed("{\"d\":{\"obsWebSocketVersion\":\"5.5.0\",\"rpcVersion\":1},\"op\":0}")));
+        pollUntilDrained(client);
+        hostConnection.feed(serverFrame(0x2, packed("{\"d\":{\"negotiatedRpcVersion\":1},\"op\":2}")));
+        pollUntilDrained(client);
+        return client.status() == ObsWsStatus::Connected ? upgrade : 0;
+    }
+
+    std::vector<std::string> requestIds(const std::string &json)
+    {
+        std::vector<std::string> ids;
+        const std::string marker = "\"requestId\":\"";
+        for (size_t pos = json.find(marker); pos != std::string::npos; pos = json.find(marker, pos + 1))
+        {
+            const size_t begin = pos + marker.size();
+            ids.push_back(json.substr(begin, json.find('"', begin) - begin));
+        }
+        return ids;
+    }
+
+    std::string result(const std::string &requestId, const std::string &requestType, const std::string &responseData)
+    {
+        return "{\"requestId\":\"" + requestId + "\",\"requestStatus\":{\"code\":100,\"result\":true},\"requestType\":\"" + requestType + "\",\"responseData\":" + responseData + "}";
+    }
+
+    // Requests leave as binary frames; events, responses and meters arrive as binary frames
+    // and are routed without rendering whole messages.
+    void testSession()
+    {
+        Session recorded;
+        session = &recorded;
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.onVolumeMeters = &recordMeters;
+        config.eventSubscriptions = ObsEventSubscription::All | ObsEventSubscription::InputVolumeMeters;
+        config.enableStateCache = true;
+        const size_t start = connectMsgPack(client, config);
+        if (!CHECK(start > 0))
+        {
+            client.close();
+            return;
+        }
+
+        // Identify and the state cache seed batch go out as MessagePack too; the seed is
+        // answered in a batch response read straight from the frame.
+        std::vector<ClientFrame> frames = clientFrames(start);
+        if (!CHECK_EQ(frames.size(), 2))
+        {
+            client.close();
+            return;
+        }
+        CHECK_EQ(frames[0].first, 0x82);
+        CHECK(rendered(slice(frames[0].payload)).find("\"op\":1") != std::string::npos);
+        const std::string seed = rendered(slice(frames[1].payload));
+        const std::vector<std::string> seedIds = requestIds(seed);
+        if (!CHECK_EQ(seedIds.size(), 3))
+        {
+            client.close();
+            return;
+        }
+        hostConnection.feed(serverFrame(0x2, packed("{\"d\":{\"requestId\":\"" + seedIds[0] + "\",\"results\":[" +
+                                                    result(seedIds[1], "GetSceneList", "{\"currentPreviewSceneName\":null,\"currentProgramSceneName\":null,\"scenes\":[]}") + "," +
+                                                    result(seedIds[2], "GetInputList", "{\"inputs\":[]}") + "]},\"op\":9}")));
+        pollUntilDrained(client);
+
+        const uint32_t id = client.sendRequest("GetInputVolume", "{\"inputName\":\"Mic\"}", &recordResponse, nullptr);
+        CHECK(id != 0);
+        client.poll();
+        frames = clientFrames(start);
+        if (CHECK_EQ(frames.size(), 3))
+        {
+            CHECK_EQ(frames[2].first, 0x82);
+            const std::string request = rendered(slice(frames[2].payload));
+            CHECK(request.find("\"requestType\":\"GetInputVolume\"") != std::string::npos);
+            CHECK(request.find("\"requestData\":{\"inputName\":\"Mic\"}") != std::string::npos);
+            CHECK(request.find("\"requestId\":\"" + std::to_string(id) + "\"") != std::string::npos);
+            CHECK(request.find("\"op\":6") != std::string::npos);
+        }
+
+        hostConnection.feed(serverFrame(0x2, packed(eventMessage("SceneCreated", "{\"isGroup\":false,\"sceneName\":\"Live\",\"sceneUuid\":\"u1\"}"))));
+        hostConnection.feed(serverFrame(0x2, packed(eventMessage("CurrentProgramSceneChanged", "{\"sceneName\":\"Live\",\"sceneUuid\":\"u1\"}"))));
+        hostConnection.feed(serverFrame(0x2, packed(responseMessage(id, "GetInputVolume", true, "{\"inputVolumeDb\":-6.5,\"inputVolumeMul\":0.5}"))));
+        hostConnection.feed(serverFrame(0x2, packed(eventMessage("InputVolumeMeters", "{\"inputs\":[{\"inputLevelsMul\":[[0.1,1.0,0.5]],\"inputName\":\"Mic\"}]}"))));
+        pollUntilDrained(client);
+
+        CHECK(recorded.events.size() == 2 && recorded.events[1] == "CurrentProgramSceneChanged {\"sceneName\":\"Live\",\"sceneUuid\":\"u1\"}");
+        CHECK(recorded.rawSeen);
+        CHECK(recorded.responses.size() == 1 && recorded.responses[0] == "{\"inputVolumeDb\":-6.5,\"inputVolumeMul\":0.5} {\"inputVolumeDb\":-6.5,\"inputVolumeMul\":0.5}");
+        CHECK(recorded.meters.size() == 1 && recorded.meters[0] == "1:-2000:0");
+        char scene[16];
+        CHECK(client.state().programScene(scene, sizeof(scene)) && std::string(scene) == "Live");
+        client.close();
+        session = nullptr;
+    }
+
+    // A screenshot response larger than the receive buffer reaches the sink while it arrives,
+    // split across reads anywhere, and the callback sees imageData empty.
+    void testStreamedImage()
+    {
+        Session recorded;
+        session = &recorded;
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.rxBufferSize = 512;
+        config.maxMessageSize = 1024;
+        const size_t start = connectMsgPack(client, config);
+        if (!CHECK(start > 0))
+        {
+            client.close();
+            return;
+        }
+
+        std::string image;
+        for (int i = 0; i < 6000; ++i)
+        {
+            image += static_cast<char>(i * 31 + i / 7);
+        }
+        const uint32_t id = client.sendStreamingRequest("GetSourceScreenshot", "{\"sourceName\":\"Cam\"}", &recordImage, &recordResponse, nullptr);
+        CHECK(id != 0);
+        client.poll();
+
+        const std::string response = responseMessage(id, "GetSourceScreenshot", true, "{\"imageData\":\"data:image/png;base64," + base64Encode(image) + "\"}");
+        hostConnection.maxRead = 37;
+        hostConnection.feed(serverFrame(0x2, packed(response)));
+        pollUntilDrained(client);
+        hostConnection.maxRead = static_cast<size_t>(-1);
+
+        CHECK(recorded.image == image);
+        CHECK(recorded.responses.size() == 1 && recorded.responses[0] == "{\"imageData\":\"\"} {\"imageData\":\"\"}");
+        CHECK(client.status() == ObsWsStatus::Connected);
+        client.close();
+        session = nullptr;
+    }
+
+    // With msgPackJsonPayloads off, callbacks only get the MessagePack bytes.
+    void testRawPayloads()
+    {
+        Session recorded;
+        session = &recorded;
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.msgPackJsonPayloads = false;
+        config.deliverEventsInline = true;
+        CHECK(connectMsgPack(client, config) > 0);
+
+        hostConnection.feed(serverFrame(0x2, packed(eventMessage("CustomEvent", "{\"eventData\":{\"n\":1}}"))));
+        hostConnection.feed(serverFrame(0x2, packed(responseMessage(777, "Unclaimed", true, "{\"x\":true}"))));
+        pollUntilDrained(client);
+
+        CHECK(recorded.events.size() == 2 && recorded.events[0] == "CustomEvent " && recorded.events[1] == "777 ");
+        CHECK(recorded.rawSeen);
+        client.close();
+        session = nullptr;
+    }
+}
+
+int main()
+{
+    testRoundTrips();
+    testWriter();
+    testParse();
+    testSession();
+    testStreamedImage();
+    testRawPayloads();
+    return hostTestResult("msgpack");
+}
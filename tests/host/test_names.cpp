@@ -0,0 +1,182 @@
+// The name table under churn: interning and releasing against a model with a pool small
+// enough to compact constantly, and the same from several threads at once.
+
+#include "HostTest.h"
+
+#include <map>
+#include <random>
+#include <thread>
+
+namespace
+{
+    std::string nameFor(std::mt19937 &random, int id)
+    {
+        // Lengths from 1 to 40 bytes so compaction moves names of every size.
+        return "n" + std::to_string(id) + std::string(random() % 40, static_cast<char>('a' + id % 26));
+    }
+
+    std::string copied(ObsNameTable &names, ObsNameHandle handle)
+    {
+        char name[128];
+        return names.copy(handle, name, sizeof(name)) ? std::string(name) : std::string("<unknown>");
+    }
+
+    void testChurn(ObsNameTable &names)
+    {
+        std::mt19937 random(7);
+        std::map<std::string, std::pair<ObsNameHandle, int>> model; // name -> handle, refs
+        std::vector<std::string> pool;
+        for (int i = 0; i < 60; ++i)
+        {
+            pool.push_back(nameFor(random, i));
+        }
+
+        for (int step = 0; step < 20000; ++step)
+        {
+            const std::string &name = pool[random() % pool.size()];
+            auto it = model.find(name);
+            if (it != model.end() && random() % 2 == 0)
+            {
+                names.release(it->second.first);
+                if (--it->second.second == 0)
+                {
+                    model.erase(it);
+                }
+            }
+            else
+            {
+                const ObsNameHandle handle = names.intern(name.c_str());
+                if (it != model.end())
+                {
+                    CHECK(handle == it->second.first);
+                    ++it->second.second;
+                }
+                else if (handle != kObsNoName)
+                {
+                    model[name] = std::make_pair(handle, 1);
+                }
+            }
+
+            if (step % 97 == 0)
+            {
+                CHECK_EQ(names.size(), model.size());
+                for (const auto &entry : model)
+                {
+                    if (!CHECK_EQ(copied(names, entry.second.first), entry.first) || !CHECK(names.find(entry.first.c_str()) == entry.second.first))
+                    {
+                        std::printf("  step %d\n", step);
+                        return;
+                    }
+                }
+            }
+        }
+
+        for (const auto &entry : model)
+        {
+            for (int i = 0; i < entry.second.second; ++i)
+            {
+                names.release(entry.second.first);
+            }
+        }
+        CHECK_EQ(names.size(), 0);
+    }
+
+    // A pool full of live names refuses the next one; releasing a name makes room through
+    // compaction, and the names it moved read back intact.
+    void testFullPool(ObsNameTable &names)
+    {
+        std::vector<ObsNameHandle> held;
+        for (int i = 0;; ++i)
+        {
+            const ObsNameHandle handle = names.intern(("live " + std::to_string(i) + std::string(30, 'x')).c_str());
+            if (handle == kObsNoName)
+            {
+                break;
+            }
+            held.push_back(handle);
+        }
+        if (!CHECK(held.size() > 2))
+        {
+            return;
+        }
+        CHECK(names.intern("one more name that does not fit anywhere") == kObsNoName);
+
+        names.release(held[0]);
+        const ObsNameHandle reused = names.intern("short");
+        CHECK(reused != kObsNoName);
+        for (size_t i = 1; i < held.size(); ++i)
+        {
+            CHECK_EQ(copied(names, held[i]), "live " + std::to_string(i) + std::string(30, 'x'));
+        }
+        names.release(reused);
+        for (size_t i = 1; i < held.size(); ++i)
+        {
+            names.release(held[i]);
+        }
+        CHECK_EQ(names.size(), 0);
+    }
+
+    // Each thread churns its own names; none may see another's moves corrupt them.
+    void testConcurrentChurn(ObsNameTable &names)
+    {
+        std::atomic<int> corrupted{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&names, &corrupted, t]()
+            {
+                std::mt19937 random(t);
+                std::vector<std::pair<ObsNameHandle, std::string>> held;
+                for (int step = 0; step < 5000; ++step)
+                {
+                    if (!held.empty() && (held.size() > 4 || random() % 2 == 0))
+                    {
+                        const size_t index = random() % held.size();
+                        if (copied(names, held[index].first) != held[index].second || names.find(held[index].second.c_str()) != held[index].first)
+                        {
+                            ++corrupted;
+                        }
+                        names.release(held[index].first);
+                        held.erase(held.begin() + index);
+                    }
+                    else
+                    {
+                        const std::string name = "t" + std::to_string(t) + "-" + std::to_string(step) + std::string(random() % 24, 'z');
+                        const ObsNameHandle handle = names.intern(name.c_str());
+                        if (handle != kObsNoName)
+                        {
+                            held.emplace_back(handle, name);
+                        }
+                    }
+                }
+                for (const auto &entry : held)
+                {
+                    names.release(entry.first);
+                }
+            });
+        }
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        CHECK_EQ(corrupted.load(), 0);
+        CHECK_EQ(names.size(), 0);
+    }
+}
+
+int main()
+{
+    // The client allocates the table: 32 names in 512 bytes keeps the pool compacting.
+    hostConnection.reset();
+    ObsWsClient client;
+    ObsWsClient::Config config;
+    config.maxNames = 32;
+    config.namePoolBytes = 512;
+    CHECK(connectClient(client, config) > 0);
+
+    testChurn(client.names());
+    testFullPool(client.names());
+    testConcurrentChurn(client.names());
+    client.close();
+    return hostTestResult("names");
+}
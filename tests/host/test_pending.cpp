@@ -0,0 +1,235 @@
+// Pending request table: replies matched by requestId, timeouts and late replies, ids that
+// collide modulo the table capacity, and disconnects failing every in-flight request once.
+
+#include "HostTest.h"
+
+#include <map>
+
+namespace
+{
+    struct Completion
+    {
+        ObsWsError error = ObsWsError::None;
+        bool success = false;
+        std::string responseData;
+    };
+
+    std::map<uint32_t, std::vector<Completion>> completions;
+    std::vector<std::string> unclaimed;
+
+    void recordCompletion(const ObsRequestResult &result, void *)
+    {
+        Completion completion;
+        completion.error = result.error;
+        completion.success = result.success;
+        if (result.responseData != nullptr)
+        {
+            completion.responseData.assign(result.responseData, result.responseDataLength);
+        }
+        completions[result.requestId].push_back(completion);
+    }
+
+    void recordEvent(const ObsEvent &event)
+    {
+        unclaimed.push_back(event.id);
+    }
+
+    size_t connect(ObsWsClient &client, ObsWsClient::Config &config)
+    {
+        hostConnection.reset();
+        setHostMillis(1000);
+        completions.clear();
+        unclaimed.clear();
+        config.autoReconnect = false;
+        config.onEvent = &recordEvent;
+        return connectClient(client, config);
+    }
+
+    void reply(ObsWsClient &client, uint32_t id, const std::string &responseData = "")
+    {
+        hostConnection.feed(serverFrame(0x1, responseMessage(id, "GetVersion", true, responseData)));
+        pollUntilDrained(client);
+    }
+
+    // A reply completes the request whose id it carries, once, and nothing else.
+    void testReplyMatchesId()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        if (!CHECK(connect(client, config) != 0))
+        {
+            return;
+        }
+
+        const uint32_t first = client.sendRequest("GetVersion", nullptr, &recordCompletion, nullptr);
+        const uint32_t second = client.sendRequest("GetVersion", nullptr, &recordCompletion, nullptr);
+        CHECK(first != 0 && second != 0 && first != second);
+
+        reply(client, second, "{\"obsVersion\":\"30.0\"}");
+        CHECK_EQ(completions[second].size(), 1);
+        CHECK(completions[second][0].error == ObsWsError::None);
+        CHECK(completions[second][0].success);
+        CHECK_EQ(completions[second][0].responseData, "{\"obsVersion\":\"30.0\"}");
+        CHECK_EQ(completions.count(first), 0);
+
+        reply(client, first);
+        CHECK_EQ(completions[first].size(), 1);
+        CHECK(completions[first][0].success);
+
+        // A second reply for an id already completed is not delivered to its callback again.
+        reply(client, first);
+        CHECK_EQ(completions[first].size(), 1);
+        CHECK_EQ(unclaimed.size(), 1);
+        CHECK_EQ(completions[second].size(), 1);
+    }
+
+    // Requests expire after their own timeout or requestTimeoutMs; a reply arriving after that
+    // is forwarded to onEvent as an unclaimed response instead of completing them twice.
+    void testReplyAfterTimeout()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.requestTimeoutMs = 2000;
+        if (!CHECK(connect(client, config) != 0))
+        {
+            return;
+        }
+
+        const uint32_t shortTimeout = client.sendRequest("GetVersion", nullptr, &recordCompletion, nullptr, 500);
+        const uint32_t defaultTimeout = client.sendRequest("GetVersion", nullptr, &recordCompletion, nullptr);
+
+        advanceHostMillis(499);
+        client.poll();
+        CHECK(completions.empty());
+
+        advanceHostMillis(1);
+        client.poll();
+        CHECK_EQ(completions[shortTimeout].size(), 1);
+        CHECK(completions[shortTimeout][0].error == ObsWsError::RequestTimeout);
+        CHECK(!completions[shortTimeout][0].success);
+        CHECK_EQ(completions.count(defaultTimeout), 0);
+
+        reply(client, shortTimeout);
+        CHECK_EQ(completions[shortTimeout].size(), 1);
+        CHECK_EQ(unclaimed.size(), 1);
+        CHECK_EQ(unclaimed.empty() ? std::string() : unclaimed[0], std::to_string(shortTimeout));
+
+        advanceHostMillis(1500);
+        client.poll();
+        CHECK_EQ(completions[defaultTimeout].size(), 1);
+        CHECK(completions[defaultTimeout][0].error == ObsWsError::RequestTimeout);
+
+        advanceHostMillis(60000);
+        client.poll();
+        CHECK_EQ(completions.size(), 2);
+        CHECK_EQ(completions[shortTimeout].size(), 1);
+        CHECK_EQ(completions[defaultTimeout].size(), 1);
+    }
+
+    // Ids index the table modulo its capacity: an id whose slot is occupied is skipped, a reply
+    // for an id that only shares a slot does not complete the request in it, and a full table
+    // refuses new requests.
+    void testIdCollision()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.maxPendingRequests = 4;
+        if (!CHECK(connect(client, config) != 0))
+        {
+            return;
+        }
+
+        const uint32_t held = client.sendRequest("GetVersion", nullptr, &recordCompletion, nullptr);
+        CHECK(held != 0);
+
+        // Cycle the other slots until the next id would land on the held one.
+        uint32_t id = held;
+        while (id != 0 && (id + 1) % config.maxPendingRequests != held % config.maxPendingRequests)
+        {
+            id = client.sendRequest("GetVersion", nullptr, &recordCompletion, nullptr);
+            reply(client, id);
+        }
+        const uint32_t skipped = client.sendRequest("GetVersion", nullptr, &recordCompletion, nullptr);
+        CHECK(skipped != 0);
+        CHECK(skipped % config.maxPendingRequests != held % config.maxPendingRequests);
+
+        const uint32_t collision = held + static_cast<uint32_t>(config.maxPendingRequests);
+        reply(client, collision);
+        CHECK_EQ(completions.count(held), 0);
+        CHECK_EQ(completions.count(collision), 0);
+        CHECK_EQ(unclaimed.size(), 1);
+
+        const uint32_t third = client.sendRequest("GetVersion", nullptr, &recordCompletion, nullptr);
+        const uint32_t fourth = client.sendRequest("GetVersion", nullptr, &recordCompletion, nullptr);
+        CHECK(third != 0 && fourth != 0);
+        CHECK_EQ(client.sendRequest("GetVersion", nullptr, &recordCompletion, nullptr), 0);
+
+        const std::vector<uint32_t> inFlight = {held, skipped, third, fourth};
+        for (uint32_t pending : inFlight)
+        {
+            CHECK_EQ(completions.count(pending), 0);
+            reply(client, pending);
+            CHECK_EQ(completions[pending].size(), 1);
+            CHECK(completions[pending][0].success);
+        }
+        CHECK(client.sendRequest("GetVersion", nullptr, &recordCompletion, nullptr) != 0);
+    }
+
+    // Closing the client, or losing the connection, fails each in-flight request exactly once
+    // with TransportUnavailable.
+    void testDisconnectFailsInFlight()
+    {
+        for (int dropped = 0; dropped < 2; ++dropped)
+        {
+            ObsWsClient client;
+            ObsWsClient::Config config;
+            if (!CHECK(connect(client, config) != 0))
+            {
+                return;
+            }
+
+            std::vector<uint32_t> ids;
+            for (int i = 0; i < 5; ++i)
+            {
+                ids.push_back(client.sendRequest("GetVersion", nullptr, &recordCompletion, nullptr));
+            }
+            reply(client, ids[2]);
+
+            if (dropped != 0)
+            {
+                std::lock_guard<std::mutex> guard(hostConnection.lock);
+                hostConnection.connected = false;
+            }
+            else
+            {
+                client.close();
+            }
+            for (int i = 0; i < 10; ++i)
+            {
+                client.poll();
+            }
+            advanceHostMillis(60000);
+            client.poll();
+
+            CHECK(client.status() == ObsWsStatus::Disconnected);
+            CHECK_EQ(completions.size(), ids.size());
+            for (size_t i = 0; i < ids.size(); ++i)
+            {
+                if (!CHECK_EQ(completions[ids[i]].size(), 1))
+                {
+                    continue;
+                }
+                CHECK(completions[ids[i]][0].error == (i == 2 ? ObsWsError::None : ObsWsError::TransportUnavailable));
+            }
+        }
+    }
+}
+
+int main()
+{
+    testReplyMatchesId();
+    testReplyAfterTimeout();
+    testIdCollision();
+    testDisconnectFailsInFlight();
+    return hostTestResult("pending");
+}
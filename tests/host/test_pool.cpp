@@ -0,0 +1,174 @@
+// The event slot pool behind the queue: what each ObsWsPoolOverflow mode does once the slots
+// run out, heap containers sized for events too large for a slot, and the eventPool* counters
+// in ObsWsStats.
+
+#include "HostTest.h"
+
+namespace
+{
+    std::vector<std::string> delivered;
+    std::vector<uint32_t> inUseAtDelivery;
+    const ObsWsClient *observed = nullptr;
+
+    void recordEvent(const ObsEvent &event)
+    {
+        delivered.push_back(std::string(event.id) + "=" + std::string(event.payload, event.payloadLength));
+        inUseAtDelivery.push_back(observed != nullptr ? observed->stats().eventPoolInUse : 0);
+    }
+
+    bool connect(ObsWsClient &client, ObsWsClient::Config &config, size_t slots = 3)
+    {
+        hostConnection.reset();
+        delivered.clear();
+        inUseAtDelivery.clear();
+        observed = &client;
+        config.onEvent = &recordEvent;
+        config.eventQueueLength = 6;
+        config.eventPoolSlots = slots;
+        config.eventPoolPayloadBytes = 64;
+        return CHECK(connectClient(client, config) != 0);
+    }
+
+    // Everything in `messages` arrives before the queue is drained.
+    void burst(ObsWsClient &client, const std::vector<std::string> &messages)
+    {
+        std::string frames;
+        for (const std::string &message : messages)
+        {
+            frames += serverFrame(0x1, message);
+        }
+        hostConnection.feed(frames);
+        client.poll();
+        CHECK(hostConnection.drained());
+    }
+
+    std::vector<std::string> events(int count)
+    {
+        std::vector<std::string> messages;
+        for (int n = 1; n <= count; ++n)
+        {
+            messages.push_back(eventMessage("SceneNameChanged", "{\"n\":" + std::to_string(n) + "}"));
+        }
+        return messages;
+    }
+
+    std::vector<std::string> named(std::initializer_list<int> ns)
+    {
+        std::vector<std::string> names;
+        for (const int n : ns)
+        {
+            names.push_back("SceneNameChanged={\"n\":" + std::to_string(n) + "}");
+        }
+        return names;
+    }
+
+    void checkPool(const ObsWsStats &stats, uint32_t highWater, uint32_t heapFallbacks, uint32_t drops)
+    {
+        CHECK_EQ(stats.eventPoolSlots, 3);
+        CHECK_EQ(stats.eventPoolInUse, 0);
+        CHECK_EQ(stats.eventPoolHighWater, highWater);
+        CHECK_EQ(stats.eventPoolHeapFallbacks, heapFallbacks);
+        CHECK_EQ(stats.eventPoolDrops, drops);
+        CHECK_EQ(stats.eventsDroppedNewest, 0);
+    }
+
+    // Past the last free slot, events go to the heap; slots are handed back as each event is
+    // delivered.
+    void testHeapFallback()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.eventPoolOverflow = ObsWsPoolOverflow::HeapFallback;
+        if (!connect(client, config))
+        {
+            return;
+        }
+
+        burst(client, events(5));
+        CHECK(delivered == named({1, 2, 3, 4, 5}));
+        CHECK(inUseAtDelivery == std::vector<uint32_t>({3, 2, 1, 0, 0}));
+        checkPool(client.stats(), 3, 2, 0);
+    }
+
+    // Past the last free slot, events are dropped and counted apart from queue overflow; the
+    // slots are free again for the next burst.
+    void testDrop()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.eventPoolOverflow = ObsWsPoolOverflow::Drop;
+        if (!connect(client, config))
+        {
+            return;
+        }
+
+        burst(client, events(5));
+        CHECK(delivered == named({1, 2, 3}));
+        checkPool(client.stats(), 3, 0, 2);
+
+        delivered.clear();
+        burst(client, events(2));
+        CHECK(delivered == named({1, 2}));
+        checkPool(client.stats(), 3, 0, 2);
+    }
+
+    // Events too large for a slot, or with a name too long for its id field, get a heap
+    // container of their own size with the pool idle; under Drop they are dropped instead.
+    void testOversized()
+    {
+        const std::string fits = "{\"s\":\"" + std::string(56, 'a') + "\"}";
+        const std::string over = "{\"s\":\"" + std::string(57, 'b') + "\"}";
+        const std::string large = "{\"s\":\"" + std::string(4000, 'c') + "\"}";
+        const std::string vendor = "Vendor" + std::string(58, 'V');
+
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        if (!connect(client, config))
+        {
+            return;
+        }
+        burst(client, {eventMessage("SceneNameChanged", fits), eventMessage("SceneNameChanged", over), eventMessage("SceneNameChanged", large), eventMessage(vendor.c_str(), "{}")});
+        CHECK(delivered == std::vector<std::string>({"SceneNameChanged=" + fits, "SceneNameChanged=" + over, "SceneNameChanged=" + large, vendor + "={}"}));
+        CHECK(inUseAtDelivery == std::vector<uint32_t>({1, 0, 0, 0}));
+        checkPool(client.stats(), 1, 3, 0);
+
+        ObsWsClient dropping;
+        config.eventPoolOverflow = ObsWsPoolOverflow::Drop;
+        if (!connect(dropping, config))
+        {
+            return;
+        }
+        burst(dropping, {eventMessage("SceneNameChanged", fits), eventMessage("SceneNameChanged", large), eventMessage(vendor.c_str(), "{}")});
+        CHECK(delivered == std::vector<std::string>({"SceneNameChanged=" + fits}));
+        checkPool(dropping.stats(), 1, 0, 2);
+    }
+
+    // With no pool every event takes the heap, and Drop has nothing to apply to.
+    void testNoPool()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.eventPoolOverflow = ObsWsPoolOverflow::Drop;
+        if (!connect(client, config, 0))
+        {
+            return;
+        }
+
+        burst(client, events(4));
+        CHECK(delivered == named({1, 2, 3, 4}));
+        const ObsWsStats stats = client.stats();
+        CHECK_EQ(stats.eventPoolSlots, 0);
+        CHECK_EQ(stats.eventPoolHighWater, 0);
+        CHECK_EQ(stats.eventPoolHeapFallbacks, 4);
+        CHECK_EQ(stats.eventPoolDrops, 0);
+    }
+}
+
+int main()
+{
+    testHeapFallback();
+    testDrop();
+    testOversized();
+    testNoPool();
+    return hostTestResult("pool");
+}
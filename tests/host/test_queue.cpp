@@ -0,0 +1,190 @@
+// The event queue drained by poll(): what each ObsWsQueuePolicy keeps when a burst overflows
+// it, neverDropResponses, coalescing by key, and the ObsWsStats counters each outcome is
+// reported in.
+
+#include "HostTest.h"
+
+namespace
+{
+    std::vector<std::string> delivered;
+
+    void recordEvent(const ObsEvent &event)
+    {
+        delivered.push_back(std::string(event.id) + "=" + std::string(event.payload, event.payloadLength));
+    }
+
+    bool connect(ObsWsClient &client, ObsWsClient::Config &config)
+    {
+        hostConnection.reset();
+        delivered.clear();
+        config.onEvent = &recordEvent;
+        config.eventQueueLength = 3;
+        return CHECK(connectClient(client, config) != 0);
+    }
+
+    // Everything in `messages` arrives before the queue is drained.
+    void burst(ObsWsClient &client, const std::vector<std::string> &messages)
+    {
+        std::string frames;
+        for (const std::string &message : messages)
+        {
+            frames += serverFrame(0x1, message);
+        }
+        hostConnection.feed(frames);
+        client.poll();
+        CHECK(hostConnection.drained());
+    }
+
+    std::string event(const char *type, int n)
+    {
+        return eventMessage(type, "{\"n\":" + std::to_string(n) + "}");
+    }
+
+    std::string named(const char *type, int n)
+    {
+        return std::string(type) + "={\"n\":" + std::to_string(n) + "}";
+    }
+
+    void checkCounters(const ObsWsStats &stats, uint32_t droppedNewest, uint32_t droppedOldest, uint32_t evicted, uint32_t responsesDropped)
+    {
+        CHECK_EQ(stats.eventsDroppedNewest, droppedNewest);
+        CHECK_EQ(stats.eventsDroppedOldest, droppedOldest);
+        CHECK_EQ(stats.eventsEvicted, evicted);
+        CHECK_EQ(stats.responsesDropped, responsesDropped);
+        CHECK_EQ(stats.eventsCoalesced, 0);
+        CHECK_EQ(stats.eventQueueLength, 3);
+        CHECK_EQ(stats.eventQueueDepth, 0);
+        CHECK_EQ(stats.eventQueueHighWater, 3);
+    }
+
+    void testDropNewest()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.eventQueuePolicy = ObsWsQueuePolicy::DropNewest;
+        if (!connect(client, config))
+        {
+            return;
+        }
+
+        burst(client, {event("SceneNameChanged", 1), event("InputMuteStateChanged", 2), event("SceneNameChanged", 3), event("InputMuteStateChanged", 4), event("StudioModeStateChanged", 5)});
+        CHECK(delivered == std::vector<std::string>({named("SceneNameChanged", 1), named("InputMuteStateChanged", 2), named("SceneNameChanged", 3)}));
+        checkCounters(client.stats(), 2, 0, 0, 0);
+    }
+
+    void testDropOldest()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.eventQueuePolicy = ObsWsQueuePolicy::DropOldest;
+        if (!connect(client, config))
+        {
+            return;
+        }
+
+        burst(client, {event("SceneNameChanged", 1), event("InputMuteStateChanged", 2), event("SceneNameChanged", 3), event("InputMuteStateChanged", 4), event("StudioModeStateChanged", 5)});
+        CHECK(delivered == std::vector<std::string>({named("SceneNameChanged", 3), named("InputMuteStateChanged", 4), named("StudioModeStateChanged", 5)}));
+        checkCounters(client.stats(), 0, 2, 0, 0);
+    }
+
+    // An overflowing event evicts the oldest queued one of its type, counted apart from the
+    // key-based coalescing of Config::coalesceEvents; one with no queued counterpart is dropped.
+    void testCoalesceByType()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.eventQueuePolicy = ObsWsQueuePolicy::CoalesceByType;
+        if (!connect(client, config))
+        {
+            return;
+        }
+
+        burst(client, {event("SceneNameChanged", 1), event("InputMuteStateChanged", 2), event("SceneNameChanged", 3), event("InputMuteStateChanged", 4), event("StudioModeStateChanged", 5), event("SceneNameChanged", 6)});
+        CHECK(delivered == std::vector<std::string>({named("SceneNameChanged", 3), named("InputMuteStateChanged", 4), named("SceneNameChanged", 6)}));
+        checkCounters(client.stats(), 1, 0, 2, 0);
+
+        // Unknown event types are matched by name.
+        delivered.clear();
+        burst(client, {event("VendorA", 1), event("VendorB", 2), event("VendorA", 3), event("VendorB", 4)});
+        CHECK(delivered == std::vector<std::string>({named("VendorA", 1), named("VendorA", 3), named("VendorB", 4)}));
+        checkCounters(client.stats(), 1, 0, 3, 0);
+    }
+
+    // Responses displace the oldest queued event under every policy and are only dropped when
+    // the queue holds nothing but responses, or when neverDropResponses is off.
+    void testResponses()
+    {
+        for (const ObsWsQueuePolicy policy : {ObsWsQueuePolicy::DropNewest, ObsWsQueuePolicy::DropOldest, ObsWsQueuePolicy::CoalesceByType})
+        {
+            ObsWsClient client;
+            ObsWsClient::Config config;
+            config.eventQueuePolicy = policy;
+            if (!connect(client, config))
+            {
+                return;
+            }
+
+            burst(client, {event("SceneNameChanged", 1), event("InputMuteStateChanged", 2), event("SceneNameChanged", 3), responseMessage(7, "GetVersion", true)});
+            CHECK_EQ(delivered.size(), 3);
+            CHECK_EQ(delivered.empty() ? std::string() : delivered.back().substr(0, 2), "7=");
+            checkCounters(client.stats(), 0, 1, 0, 0);
+
+            burst(client, {responseMessage(8, "GetVersion", true), responseMessage(9, "GetVersion", true), responseMessage(10, "GetVersion", true), responseMessage(11, "GetVersion", true)});
+            CHECK_EQ(delivered.size(), 6);
+            checkCounters(client.stats(), 0, 1, 0, 1);
+        }
+
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.neverDropResponses = false;
+        if (!connect(client, config))
+        {
+            return;
+        }
+        burst(client, {event("SceneNameChanged", 1), event("InputMuteStateChanged", 2), event("SceneNameChanged", 3), responseMessage(7, "GetVersion", true)});
+        CHECK(delivered == std::vector<std::string>({named("SceneNameChanged", 1), named("InputMuteStateChanged", 2), named("SceneNameChanged", 3)}));
+        checkCounters(client.stats(), 0, 0, 0, 1);
+    }
+
+    std::string volume(const char *inputName, int n)
+    {
+        return "{\"inputName\":\"" + std::string(inputName) + "\",\"inputVolumeMul\":" + std::to_string(n) + "}";
+    }
+
+    // Repeated events for one input coalesce in place; another input stays separate even when
+    // its key hashes the same (these two names collide under the 32-bit FNV-1a key).
+    void testCoalesceByKey()
+    {
+        const char *first = "Input 229599";
+        const char *second = "Input 432382";
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.coalesceEvents = true;
+        if (!connect(client, config))
+        {
+            return;
+        }
+
+        burst(client, {eventMessage("InputVolumeChanged", volume(first, 1)), eventMessage("InputVolumeChanged", volume(second, 2)), eventMessage("InputVolumeChanged", volume(first, 3)),
+                       eventMessage("InputMuteStateChanged", volume(first, 4)), eventMessage("InputVolumeChanged", volume(second, 5)), eventMessage("InputVolumeChanged", volume(first, 6))});
+        CHECK(delivered == std::vector<std::string>({"InputVolumeChanged=" + volume(first, 6), "InputVolumeChanged=" + volume(second, 5), "InputMuteStateChanged=" + volume(first, 4)}));
+        CHECK_EQ(client.stats().eventsCoalesced, 3);
+        CHECK_EQ(client.stats().eventsDroppedNewest, 0);
+
+        // Events without any key member share one key per type.
+        delivered.clear();
+        burst(client, {eventMessage("InputVolumeMeters", "{\"inputs\":[1]}"), eventMessage("InputVolumeMeters", "{\"inputs\":[2]}"), eventMessage("InputVolumeChanged", volume(first, 7))});
+        CHECK(delivered == std::vector<std::string>({"InputVolumeMeters={\"inputs\":[2]}", "InputVolumeChanged=" + volume(first, 7)}));
+        CHECK_EQ(client.stats().eventsCoalesced, 4);
+    }
+}
+
+int main()
+{
+    testDropNewest();
+    testDropOldest();
+    testCoalesceByType();
+    testResponses();
+    testCoalesceByKey();
+    return hostTestResult("queue");
+}
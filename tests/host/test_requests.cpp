@@ -0,0 +1,846 @@
+// Generated by tools/generate_requests.py from tools/protocol-requests.json. Do not edit by hand.
+// Every typed request in ObsWsRequests.h: the requestData its builder writes with no field and
+// with every field assigned and sent through client.send(), and its response view reading each
+// field back, skipping members of the wrong type and rejecting data that is not an object.
+
+#include "HostTest.h"
+#include "ObsWsRequests.h"
+
+namespace
+{
+    template <typename Request>
+    std::string written(const Request &request)
+    {
+        char buffer[4096];
+        ObsJsonWriter json(buffer, sizeof(buffer));
+        json.beginObject();
+        request.write(json);
+        json.endObject();
+        return json.overflowed() ? std::string("<overflow>") : std::string(json.data(), json.length());
+    }
+
+    std::string text(const ObsJsonSlice &slice)
+    {
+        return slice.data != nullptr ? std::string(slice.data, slice.length) : std::string();
+    }
+
+    ObsWsClient client;
+
+    // The requestData member of the op 6 frame client.send() writes for `request`.
+    template <typename Request>
+    std::string sent(const Request &request)
+    {
+        const size_t start = hostConnection.written().size();
+        if (client.send(request) == 0)
+        {
+            return "<not sent>";
+        }
+        const std::vector<ClientFrame> frames = clientFrames(start);
+        ObsJsonSlice d;
+        ObsJsonSlice data;
+        if (frames.size() != 1 || !ObsJsonReader::findMember(ObsJsonSlice{frames[0].payload.data(), frames[0].payload.size()}, "d", d))
+        {
+            return "<no frame>";
+        }
+        return ObsJsonReader::findMember(d, "requestData", data) ? text(data) : std::string("<none>");
+    }
+
+    void testBroadcastCustomEvent()
+    {
+        ObsRequests::BroadcastCustomEvent request;
+        CHECK_EQ(std::string(request.kRequestType), "BroadcastCustomEvent");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{}");
+        request.eventData = "{\"eventData\":[0,true]}";
+        CHECK_EQ(written(request), "{\"eventData\":{\"eventData\":[0,true]}}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+        request.eventData = "{\"eventData\":";
+        CHECK(!request.valid());
+        CHECK_EQ(sent(request), "<not sent>");
+    }
+
+    void testGetCurrentPreviewScene()
+    {
+        ObsRequests::GetCurrentPreviewScene request;
+        CHECK_EQ(std::string(request.kRequestType), "GetCurrentPreviewScene");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"sceneUuid\":\"sceneUuid \\\"1\\\"\",\"sceneName\":\"sceneName \\\"0\\\"\"}";
+        ObsRequests::GetCurrentPreviewScene::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK_EQ(text(response.sceneName), "sceneName \\\"0\\\"");
+        CHECK_EQ(text(response.sceneUuid), "sceneUuid \\\"1\\\"");
+
+        const std::string mismatched = "{\"sceneName\":1,\"sceneUuid\":1}";
+        ObsRequests::GetCurrentPreviewScene::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.sceneName.empty());
+        CHECK(skipped.sceneUuid.empty());
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testGetCurrentProgramScene()
+    {
+        ObsRequests::GetCurrentProgramScene request;
+        CHECK_EQ(std::string(request.kRequestType), "GetCurrentProgramScene");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"sceneUuid\":\"sceneUuid \\\"1\\\"\",\"sceneName\":\"sceneName \\\"0\\\"\"}";
+        ObsRequests::GetCurrentProgramScene::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK_EQ(text(response.sceneName), "sceneName \\\"0\\\"");
+        CHECK_EQ(text(response.sceneUuid), "sceneUuid \\\"1\\\"");
+
+        const std::string mismatched = "{\"sceneName\":1,\"sceneUuid\":1}";
+        ObsRequests::GetCurrentProgramScene::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.sceneName.empty());
+        CHECK(skipped.sceneUuid.empty());
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testGetInputMute()
+    {
+        ObsRequests::GetInputMute request;
+        CHECK_EQ(std::string(request.kRequestType), "GetInputMute");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{}");
+        request.inputName = "inputName \"0\"";
+        request.inputUuid = "inputUuid \"1\"";
+        CHECK_EQ(written(request), "{\"inputName\":\"inputName \\\"0\\\"\",\"inputUuid\":\"inputUuid \\\"1\\\"\"}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"inputMuted\":true}";
+        ObsRequests::GetInputMute::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK(response.inputMuted == true);
+
+        const std::string mismatched = "{\"inputMuted\":\"true\"}";
+        ObsRequests::GetInputMute::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.inputMuted == false);
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testGetInputVolume()
+    {
+        ObsRequests::GetInputVolume request;
+        CHECK_EQ(std::string(request.kRequestType), "GetInputVolume");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{}");
+        request.inputName = "inputName \"0\"";
+        request.inputUuid = "inputUuid \"1\"";
+        CHECK_EQ(written(request), "{\"inputName\":\"inputName \\\"0\\\"\",\"inputUuid\":\"inputUuid \\\"1\\\"\"}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"inputVolumeDb\":1.25,\"inputVolumeMul\":0.25}";
+        ObsRequests::GetInputVolume::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK(response.inputVolumeMul == 0.25);
+        CHECK(response.inputVolumeDb == 1.25);
+
+        const std::string mismatched = "{\"inputVolumeMul\":false,\"inputVolumeDb\":false}";
+        ObsRequests::GetInputVolume::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.inputVolumeMul == 0);
+        CHECK(skipped.inputVolumeDb == 0);
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testGetProfileList()
+    {
+        ObsRequests::GetProfileList request;
+        CHECK_EQ(std::string(request.kRequestType), "GetProfileList");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"profiles\":{\"profiles\":[1,true]},\"currentProfileName\":\"currentProfileName \\\"0\\\"\"}";
+        ObsRequests::GetProfileList::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK_EQ(text(response.currentProfileName), "currentProfileName \\\"0\\\"");
+        CHECK_EQ(text(response.profiles), "{\"profiles\":[1,true]}");
+
+        const std::string mismatched = "{\"currentProfileName\":1}";
+        ObsRequests::GetProfileList::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.currentProfileName.empty());
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testGetRecordStatus()
+    {
+        ObsRequests::GetRecordStatus request;
+        CHECK_EQ(std::string(request.kRequestType), "GetRecordStatus");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"outputBytes\":10000000004,\"outputDuration\":10000000003,\"outputTimecode\":\"outputTimecode \\\"2\\\"\",\"outputPaused\":true,\"outputActive\":true}";
+        ObsRequests::GetRecordStatus::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK(response.outputActive == true);
+        CHECK(response.outputPaused == true);
+        CHECK_EQ(text(response.outputTimecode), "outputTimecode \\\"2\\\"");
+        CHECK(response.outputDuration == 10000000003LL);
+        CHECK(response.outputBytes == 10000000004LL);
+
+        const std::string mismatched = "{\"outputActive\":\"true\",\"outputPaused\":\"true\",\"outputTimecode\":1,\"outputDuration\":\"1\",\"outputBytes\":\"1\"}";
+        ObsRequests::GetRecordStatus::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.outputActive == false);
+        CHECK(skipped.outputPaused == false);
+        CHECK(skipped.outputTimecode.empty());
+        CHECK(skipped.outputDuration == 0);
+        CHECK(skipped.outputBytes == 0);
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testGetSceneCollectionList()
+    {
+        ObsRequests::GetSceneCollectionList request;
+        CHECK_EQ(std::string(request.kRequestType), "GetSceneCollectionList");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"sceneCollections\":{\"sceneCollections\":[1,true]},\"currentSceneCollectionName\":\"currentSceneCollectionName \\\"0\\\"\"}";
+        ObsRequests::GetSceneCollectionList::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK_EQ(text(response.currentSceneCollectionName), "currentSceneCollectionName \\\"0\\\"");
+        CHECK_EQ(text(response.sceneCollections), "{\"sceneCollections\":[1,true]}");
+
+        const std::string mismatched = "{\"currentSceneCollectionName\":1}";
+        ObsRequests::GetSceneCollectionList::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.currentSceneCollectionName.empty());
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testGetSceneItemEnabled()
+    {
+        ObsRequests::GetSceneItemEnabled request;
+        CHECK_EQ(std::string(request.kRequestType), "GetSceneItemEnabled");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{\"sceneItemId\":0}");
+        request.sceneName = "sceneName \"0\"";
+        request.sceneUuid = "sceneUuid \"1\"";
+        request.sceneItemId = 10000000002LL;
+        CHECK_EQ(written(request), "{\"sceneName\":\"sceneName \\\"0\\\"\",\"sceneUuid\":\"sceneUuid \\\"1\\\"\",\"sceneItemId\":10000000002}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"sceneItemEnabled\":true}";
+        ObsRequests::GetSceneItemEnabled::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK(response.sceneItemEnabled == true);
+
+        const std::string mismatched = "{\"sceneItemEnabled\":\"true\"}";
+        ObsRequests::GetSceneItemEnabled::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.sceneItemEnabled == false);
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testGetSceneItemId()
+    {
+        ObsRequests::GetSceneItemId request;
+        CHECK_EQ(std::string(request.kRequestType), "GetSceneItemId");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{}");
+        request.sceneName = "sceneName \"0\"";
+        request.sceneUuid = "sceneUuid \"1\"";
+        request.sourceName = "sourceName \"2\"";
+        request.searchOffset = 10000000003LL;
+        CHECK_EQ(written(request), "{\"sceneName\":\"sceneName \\\"0\\\"\",\"sceneUuid\":\"sceneUuid \\\"1\\\"\",\"sourceName\":\"sourceName \\\"2\\\"\",\"searchOffset\":10000000003}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"sceneItemId\":10000000000}";
+        ObsRequests::GetSceneItemId::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK(response.sceneItemId == 10000000000LL);
+
+        const std::string mismatched = "{\"sceneItemId\":\"1\"}";
+        ObsRequests::GetSceneItemId::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.sceneItemId == 0);
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testGetSceneList()
+    {
+        ObsRequests::GetSceneList request;
+        CHECK_EQ(std::string(request.kRequestType), "GetSceneList");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"scenes\":{\"scenes\":[4,true]},\"currentPreviewSceneUuid\":\"currentPreviewSceneUuid \\\"3\\\"\",\"currentPreviewSceneName\":\"currentPreviewSceneName \\\"2\\\"\",\"currentProgramSceneUuid\":\"currentProgramSceneUuid \\\"1\\\"\",\"currentProgramSceneName\":\"currentProgramSceneName \\\"0\\\"\"}";
+        ObsRequests::GetSceneList::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK_EQ(text(response.currentProgramSceneName), "currentProgramSceneName \\\"0\\\"");
+        CHECK_EQ(text(response.currentProgramSceneUuid), "currentProgramSceneUuid \\\"1\\\"");
+        CHECK_EQ(text(response.currentPreviewSceneName), "currentPreviewSceneName \\\"2\\\"");
+        CHECK_EQ(text(response.currentPreviewSceneUuid), "currentPreviewSceneUuid \\\"3\\\"");
+        CHECK_EQ(text(response.scenes), "{\"scenes\":[4,true]}");
+
+        const std::string mismatched = "{\"currentProgramSceneName\":1,\"currentProgramSceneUuid\":1,\"currentPreviewSceneName\":1,\"currentPreviewSceneUuid\":1}";
+        ObsRequests::GetSceneList::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.currentProgramSceneName.empty());
+        CHECK(skipped.currentProgramSceneUuid.empty());
+        CHECK(skipped.currentPreviewSceneName.empty());
+        CHECK(skipped.currentPreviewSceneUuid.empty());
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testGetStats()
+    {
+        ObsRequests::GetStats request;
+        CHECK_EQ(std::string(request.kRequestType), "GetStats");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"webSocketSessionOutgoingMessages\":10000000010,\"webSocketSessionIncomingMessages\":10000000009,\"outputTotalFrames\":10000000008,\"outputSkippedFrames\":10000000007,\"renderTotalFrames\":10000000006,\"renderSkippedFrames\":10000000005,\"averageFrameRenderTime\":4.25,\"activeFps\":3.25,\"availableDiskSpace\":2.25,\"memoryUsage\":1.25,\"cpuUsage\":0.25}";
+        ObsRequests::GetStats::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK(response.cpuUsage == 0.25);
+        CHECK(response.memoryUsage == 1.25);
+        CHECK(response.availableDiskSpace == 2.25);
+        CHECK(response.activeFps == 3.25);
+        CHECK(response.averageFrameRenderTime == 4.25);
+        CHECK(response.renderSkippedFrames == 10000000005LL);
+        CHECK(response.renderTotalFrames == 10000000006LL);
+        CHECK(response.outputSkippedFrames == 10000000007LL);
+        CHECK(response.outputTotalFrames == 10000000008LL);
+        CHECK(response.webSocketSessionIncomingMessages == 10000000009LL);
+        CHECK(response.webSocketSessionOutgoingMessages == 10000000010LL);
+
+        const std::string mismatched = "{\"cpuUsage\":false,\"memoryUsage\":false,\"availableDiskSpace\":false,\"activeFps\":false,\"averageFrameRenderTime\":false,\"renderSkippedFrames\":\"1\",\"renderTotalFrames\":\"1\",\"outputSkippedFrames\":\"1\",\"outputTotalFrames\":\"1\",\"webSocketSessionIncomingMessages\":\"1\",\"webSocketSessionOutgoingMessages\":\"1\"}";
+        ObsRequests::GetStats::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.cpuUsage == 0);
+        CHECK(skipped.memoryUsage == 0);
+        CHECK(skipped.availableDiskSpace == 0);
+        CHECK(skipped.activeFps == 0);
+        CHECK(skipped.averageFrameRenderTime == 0);
+        CHECK(skipped.renderSkippedFrames == 0);
+        CHECK(skipped.renderTotalFrames == 0);
+        CHECK(skipped.outputSkippedFrames == 0);
+        CHECK(skipped.outputTotalFrames == 0);
+        CHECK(skipped.webSocketSessionIncomingMessages == 0);
+        CHECK(skipped.webSocketSessionOutgoingMessages == 0);
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testGetStreamStatus()
+    {
+        ObsRequests::GetStreamStatus request;
+        CHECK_EQ(std::string(request.kRequestType), "GetStreamStatus");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"outputTotalFrames\":10000000007,\"outputSkippedFrames\":10000000006,\"outputBytes\":10000000005,\"outputCongestion\":4.25,\"outputDuration\":10000000003,\"outputTimecode\":\"outputTimecode \\\"2\\\"\",\"outputReconnecting\":true,\"outputActive\":true}";
+        ObsRequests::GetStreamStatus::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK(response.outputActive == true);
+        CHECK(response.outputReconnecting == true);
+        CHECK_EQ(text(response.outputTimecode), "outputTimecode \\\"2\\\"");
+        CHECK(response.outputDuration == 10000000003LL);
+        CHECK(response.outputCongestion == 4.25);
+        CHECK(response.outputBytes == 10000000005LL);
+        CHECK(response.outputSkippedFrames == 10000000006LL);
+        CHECK(response.outputTotalFrames == 10000000007LL);
+
+        const std::string mismatched = "{\"outputActive\":\"true\",\"outputReconnecting\":\"true\",\"outputTimecode\":1,\"outputDuration\":\"1\",\"outputCongestion\":false,\"outputBytes\":\"1\",\"outputSkippedFrames\":\"1\",\"outputTotalFrames\":\"1\"}";
+        ObsRequests::GetStreamStatus::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.outputActive == false);
+        CHECK(skipped.outputReconnecting == false);
+        CHECK(skipped.outputTimecode.empty());
+        CHECK(skipped.outputDuration == 0);
+        CHECK(skipped.outputCongestion == 0);
+        CHECK(skipped.outputBytes == 0);
+        CHECK(skipped.outputSkippedFrames == 0);
+        CHECK(skipped.outputTotalFrames == 0);
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testGetStudioModeEnabled()
+    {
+        ObsRequests::GetStudioModeEnabled request;
+        CHECK_EQ(std::string(request.kRequestType), "GetStudioModeEnabled");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"studioModeEnabled\":true}";
+        ObsRequests::GetStudioModeEnabled::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK(response.studioModeEnabled == true);
+
+        const std::string mismatched = "{\"studioModeEnabled\":\"true\"}";
+        ObsRequests::GetStudioModeEnabled::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.studioModeEnabled == false);
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testGetVersion()
+    {
+        ObsRequests::GetVersion request;
+        CHECK_EQ(std::string(request.kRequestType), "GetVersion");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"platformDescription\":\"platformDescription \\\"6\\\"\",\"platform\":\"platform \\\"5\\\"\",\"supportedImageFormats\":{\"supportedImageFormats\":[4,true]},\"availableRequests\":{\"availableRequests\":[3,true]},\"rpcVersion\":10000000002,\"obsWebSocketVersion\":\"obsWebSocketVersion \\\"1\\\"\",\"obsVersion\":\"obsVersion \\\"0\\\"\"}";
+        ObsRequests::GetVersion::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK_EQ(text(response.obsVersion), "obsVersion \\\"0\\\"");
+        CHECK_EQ(text(response.obsWebSocketVersion), "obsWebSocketVersion \\\"1\\\"");
+        CHECK(response.rpcVersion == 10000000002LL);
+        CHECK_EQ(text(response.availableRequests), "{\"availableRequests\":[3,true]}");
+        CHECK_EQ(text(response.supportedImageFormats), "{\"supportedImageFormats\":[4,true]}");
+        CHECK_EQ(text(response.platform), "platform \\\"5\\\"");
+        CHECK_EQ(text(response.platformDescription), "platformDescription \\\"6\\\"");
+
+        const std::string mismatched = "{\"obsVersion\":1,\"obsWebSocketVersion\":1,\"rpcVersion\":\"1\",\"platform\":1,\"platformDescription\":1}";
+        ObsRequests::GetVersion::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.obsVersion.empty());
+        CHECK(skipped.obsWebSocketVersion.empty());
+        CHECK(skipped.rpcVersion == 0);
+        CHECK(skipped.platform.empty());
+        CHECK(skipped.platformDescription.empty());
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testPauseRecord()
+    {
+        ObsRequests::PauseRecord request;
+        CHECK_EQ(std::string(request.kRequestType), "PauseRecord");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+    }
+
+    void testResumeRecord()
+    {
+        ObsRequests::ResumeRecord request;
+        CHECK_EQ(std::string(request.kRequestType), "ResumeRecord");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+    }
+
+    void testSaveReplayBuffer()
+    {
+        ObsRequests::SaveReplayBuffer request;
+        CHECK_EQ(std::string(request.kRequestType), "SaveReplayBuffer");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+    }
+
+    void testSetCurrentPreviewScene()
+    {
+        ObsRequests::SetCurrentPreviewScene request;
+        CHECK_EQ(std::string(request.kRequestType), "SetCurrentPreviewScene");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{}");
+        request.sceneName = "sceneName \"0\"";
+        request.sceneUuid = "sceneUuid \"1\"";
+        CHECK_EQ(written(request), "{\"sceneName\":\"sceneName \\\"0\\\"\",\"sceneUuid\":\"sceneUuid \\\"1\\\"\"}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+    }
+
+    void testSetCurrentProfile()
+    {
+        ObsRequests::SetCurrentProfile request;
+        CHECK_EQ(std::string(request.kRequestType), "SetCurrentProfile");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{}");
+        request.profileName = "profileName \"0\"";
+        CHECK_EQ(written(request), "{\"profileName\":\"profileName \\\"0\\\"\"}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+    }
+
+    void testSetCurrentProgramScene()
+    {
+        ObsRequests::SetCurrentProgramScene request;
+        CHECK_EQ(std::string(request.kRequestType), "SetCurrentProgramScene");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{}");
+        request.sceneName = "sceneName \"0\"";
+        request.sceneUuid = "sceneUuid \"1\"";
+        CHECK_EQ(written(request), "{\"sceneName\":\"sceneName \\\"0\\\"\",\"sceneUuid\":\"sceneUuid \\\"1\\\"\"}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+    }
+
+    void testSetCurrentSceneCollection()
+    {
+        ObsRequests::SetCurrentSceneCollection request;
+        CHECK_EQ(std::string(request.kRequestType), "SetCurrentSceneCollection");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{}");
+        request.sceneCollectionName = "sceneCollectionName \"0\"";
+        CHECK_EQ(written(request), "{\"sceneCollectionName\":\"sceneCollectionName \\\"0\\\"\"}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+    }
+
+    void testSetCurrentSceneTransition()
+    {
+        ObsRequests::SetCurrentSceneTransition request;
+        CHECK_EQ(std::string(request.kRequestType), "SetCurrentSceneTransition");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{}");
+        request.transitionName = "transitionName \"0\"";
+        CHECK_EQ(written(request), "{\"transitionName\":\"transitionName \\\"0\\\"\"}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+    }
+
+    void testSetCurrentSceneTransitionDuration()
+    {
+        ObsRequests::SetCurrentSceneTransitionDuration request;
+        CHECK_EQ(std::string(request.kRequestType), "SetCurrentSceneTransitionDuration");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{\"transitionDuration\":0}");
+        request.transitionDuration = 10000000000LL;
+        CHECK_EQ(written(request), "{\"transitionDuration\":10000000000}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+    }
+
+    void testSetInputMute()
+    {
+        ObsRequests::SetInputMute request;
+        CHECK_EQ(std::string(request.kRequestType), "SetInputMute");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{\"inputMuted\":false}");
+        request.inputName = "inputName \"0\"";
+        request.inputUuid = "inputUuid \"1\"";
+        request.inputMuted = true;
+        CHECK_EQ(written(request), "{\"inputName\":\"inputName \\\"0\\\"\",\"inputUuid\":\"inputUuid \\\"1\\\"\",\"inputMuted\":true}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+    }
+
+    void testSetInputVolume()
+    {
+        ObsRequests::SetInputVolume request;
+        CHECK_EQ(std::string(request.kRequestType), "SetInputVolume");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{}");
+        request.inputName = "inputName \"0\"";
+        request.inputUuid = "inputUuid \"1\"";
+        request.inputVolumeMul = 2.25;
+        request.inputVolumeDb = 3.25;
+        CHECK_EQ(written(request), "{\"inputName\":\"inputName \\\"0\\\"\",\"inputUuid\":\"inputUuid \\\"1\\\"\",\"inputVolumeMul\":2.25,\"inputVolumeDb\":3.25}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+    }
+
+    void testSetSceneItemEnabled()
+    {
+        ObsRequests::SetSceneItemEnabled request;
+        CHECK_EQ(std::string(request.kRequestType), "SetSceneItemEnabled");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{\"sceneItemId\":0,\"sceneItemEnabled\":false}");
+        request.sceneName = "sceneName \"0\"";
+        request.sceneUuid = "sceneUuid \"1\"";
+        request.sceneItemId = 10000000002LL;
+        request.sceneItemEnabled = true;
+        CHECK_EQ(written(request), "{\"sceneName\":\"sceneName \\\"0\\\"\",\"sceneUuid\":\"sceneUuid \\\"1\\\"\",\"sceneItemId\":10000000002,\"sceneItemEnabled\":true}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+    }
+
+    void testSetSourceFilterEnabled()
+    {
+        ObsRequests::SetSourceFilterEnabled request;
+        CHECK_EQ(std::string(request.kRequestType), "SetSourceFilterEnabled");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{\"filterEnabled\":false}");
+        request.sourceName = "sourceName \"0\"";
+        request.sourceUuid = "sourceUuid \"1\"";
+        request.filterName = "filterName \"2\"";
+        request.filterEnabled = true;
+        CHECK_EQ(written(request), "{\"sourceName\":\"sourceName \\\"0\\\"\",\"sourceUuid\":\"sourceUuid \\\"1\\\"\",\"filterName\":\"filterName \\\"2\\\"\",\"filterEnabled\":true}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+    }
+
+    void testSetStudioModeEnabled()
+    {
+        ObsRequests::SetStudioModeEnabled request;
+        CHECK_EQ(std::string(request.kRequestType), "SetStudioModeEnabled");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{\"studioModeEnabled\":false}");
+        request.studioModeEnabled = true;
+        CHECK_EQ(written(request), "{\"studioModeEnabled\":true}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+    }
+
+    void testStartRecord()
+    {
+        ObsRequests::StartRecord request;
+        CHECK_EQ(std::string(request.kRequestType), "StartRecord");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+    }
+
+    void testStartStream()
+    {
+        ObsRequests::StartStream request;
+        CHECK_EQ(std::string(request.kRequestType), "StartStream");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+    }
+
+    void testStopRecord()
+    {
+        ObsRequests::StopRecord request;
+        CHECK_EQ(std::string(request.kRequestType), "StopRecord");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"outputPath\":\"outputPath \\\"0\\\"\"}";
+        ObsRequests::StopRecord::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK_EQ(text(response.outputPath), "outputPath \\\"0\\\"");
+
+        const std::string mismatched = "{\"outputPath\":1}";
+        ObsRequests::StopRecord::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.outputPath.empty());
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testStopStream()
+    {
+        ObsRequests::StopStream request;
+        CHECK_EQ(std::string(request.kRequestType), "StopStream");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+    }
+
+    void testToggleInputMute()
+    {
+        ObsRequests::ToggleInputMute request;
+        CHECK_EQ(std::string(request.kRequestType), "ToggleInputMute");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{}");
+        request.inputName = "inputName \"0\"";
+        request.inputUuid = "inputUuid \"1\"";
+        CHECK_EQ(written(request), "{\"inputName\":\"inputName \\\"0\\\"\",\"inputUuid\":\"inputUuid \\\"1\\\"\"}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"inputMuted\":true}";
+        ObsRequests::ToggleInputMute::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK(response.inputMuted == true);
+
+        const std::string mismatched = "{\"inputMuted\":\"true\"}";
+        ObsRequests::ToggleInputMute::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.inputMuted == false);
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testToggleRecord()
+    {
+        ObsRequests::ToggleRecord request;
+        CHECK_EQ(std::string(request.kRequestType), "ToggleRecord");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"outputActive\":true}";
+        ObsRequests::ToggleRecord::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK(response.outputActive == true);
+
+        const std::string mismatched = "{\"outputActive\":\"true\"}";
+        ObsRequests::ToggleRecord::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.outputActive == false);
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testToggleRecordPause()
+    {
+        ObsRequests::ToggleRecordPause request;
+        CHECK_EQ(std::string(request.kRequestType), "ToggleRecordPause");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+    }
+
+    void testToggleReplayBuffer()
+    {
+        ObsRequests::ToggleReplayBuffer request;
+        CHECK_EQ(std::string(request.kRequestType), "ToggleReplayBuffer");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"outputActive\":true}";
+        ObsRequests::ToggleReplayBuffer::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK(response.outputActive == true);
+
+        const std::string mismatched = "{\"outputActive\":\"true\"}";
+        ObsRequests::ToggleReplayBuffer::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.outputActive == false);
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testToggleStream()
+    {
+        ObsRequests::ToggleStream request;
+        CHECK_EQ(std::string(request.kRequestType), "ToggleStream");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"outputActive\":true}";
+        ObsRequests::ToggleStream::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK(response.outputActive == true);
+
+        const std::string mismatched = "{\"outputActive\":\"true\"}";
+        ObsRequests::ToggleStream::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.outputActive == false);
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testToggleVirtualCam()
+    {
+        ObsRequests::ToggleVirtualCam request;
+        CHECK_EQ(std::string(request.kRequestType), "ToggleVirtualCam");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+
+        const std::string data = "{\"unknownMember\":[1,{\"a\":\"}\"}],\"outputActive\":true}";
+        ObsRequests::ToggleVirtualCam::Response response;
+        CHECK(response.parse(data.c_str(), data.size()));
+        CHECK(response.outputActive == true);
+
+        const std::string mismatched = "{\"outputActive\":\"true\"}";
+        ObsRequests::ToggleVirtualCam::Response skipped;
+        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));
+        CHECK(skipped.outputActive == false);
+        CHECK(!response.parse("[]", 2));
+    }
+
+    void testTriggerHotkeyByName()
+    {
+        ObsRequests::TriggerHotkeyByName request;
+        CHECK_EQ(std::string(request.kRequestType), "TriggerHotkeyByName");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{}");
+        request.hotkeyName = "hotkeyName \"0\"";
+        request.contextName = "contextName \"1\"";
+        CHECK_EQ(written(request), "{\"hotkeyName\":\"hotkeyName \\\"0\\\"\",\"contextName\":\"contextName \\\"1\\\"\"}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+    }
+
+    void testTriggerMediaInputAction()
+    {
+        ObsRequests::TriggerMediaInputAction request;
+        CHECK_EQ(std::string(request.kRequestType), "TriggerMediaInputAction");
+        CHECK(request.kHasData == true);
+        CHECK_EQ(written(request), "{}");
+        request.inputName = "inputName \"0\"";
+        request.inputUuid = "inputUuid \"1\"";
+        request.mediaAction = "mediaAction \"2\"";
+        CHECK_EQ(written(request), "{\"inputName\":\"inputName \\\"0\\\"\",\"inputUuid\":\"inputUuid \\\"1\\\"\",\"mediaAction\":\"mediaAction \\\"2\\\"\"}");
+        CHECK(request.valid());
+        CHECK_EQ(sent(request), written(request));
+    }
+
+    void testTriggerStudioModeTransition()
+    {
+        ObsRequests::TriggerStudioModeTransition request;
+        CHECK_EQ(std::string(request.kRequestType), "TriggerStudioModeTransition");
+        CHECK(request.kHasData == false);
+        CHECK_EQ(written(request), "{}");
+        CHECK_EQ(sent(request), "<none>");
+    }
+}
+
+int main()
+{
+    ObsWsClient::Config config;
+    CHECK(connectClient(client, config) > 0);
+    testBroadcastCustomEvent();
+    testGetCurrentPreviewScene();
+    testGetCurrentProgramScene();
+    testGetInputMute();
+    testGetInputVolume();
+    testGetProfileList();
+    testGetRecordStatus();
+    testGetSceneCollectionList();
+    testGetSceneItemEnabled();
+    testGetSceneItemId();
+    testGetSceneList();
+    testGetStats();
+    testGetStreamStatus();
+    testGetStudioModeEnabled();
+    testGetVersion();
+    testPauseRecord();
+    testResumeRecord();
+    testSaveReplayBuffer();
+    testSetCurrentPreviewScene();
+    testSetCurrentProfile();
+    testSetCurrentProgramScene();
+    testSetCurrentSceneCollection();
+    testSetCurrentSceneTransition();
+    testSetCurrentSceneTransitionDuration();
+    testSetInputMute();
+    testSetInputVolume();
+    testSetSceneItemEnabled();
+    testSetSourceFilterEnabled();
+    testSetStudioModeEnabled();
+    testStartRecord();
+    testStartStream();
+    testStopRecord();
+    testStopStream();
+    testToggleInputMute();
+    testToggleRecord();
+    testToggleRecordPause();
+    testToggleReplayBuffer();
+    testToggleStream();
+    testToggleVirtualCam();
+    testTriggerHotkeyByName();
+    testTriggerMediaInputAction();
+    testTriggerStudioModeTransition();
+    client.close();
+    return hostTestResult("requests");
+}
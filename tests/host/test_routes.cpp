@@ -0,0 +1,111 @@
+// Per-type event handlers: on() taking events away from onEvent, off() handing them back, and
+// the events dropped and counted in eventsFiltered when there is no onEvent to fall back to.
+
+#include "HostTest.h"
+
+namespace
+{
+    std::vector<std::string> delivered;
+
+    void recordEvent(const ObsEvent &event)
+    {
+        delivered.push_back(std::string("onEvent:") + event.id);
+    }
+
+    void recordRouted(const ObsEvent &event, void *context)
+    {
+        delivered.push_back(std::string(static_cast<const char *>(context)) + ":" + event.id);
+    }
+
+    char sceneHandler[] = "scene";
+    char muteHandler[] = "mute";
+
+    bool connect(ObsWsClient &client, ObsWsClient::Config &config)
+    {
+        hostConnection.reset();
+        delivered.clear();
+        return CHECK(connectClient(client, config) != 0);
+    }
+
+    // One of each: two types handlers may be registered for, one nobody handles and an
+    // event type ObsEventType does not list.
+    void receive(ObsWsClient &client)
+    {
+        hostConnection.feed(serverFrame(0x1, eventMessage("CurrentProgramSceneChanged", "{\"sceneName\":\"Live\"}")) +
+                            serverFrame(0x1, eventMessage("InputMuteStateChanged", "{\"inputMuted\":true,\"inputName\":\"Mic\"}")) +
+                            serverFrame(0x1, eventMessage("StudioModeStateChanged", "{\"studioModeEnabled\":true}")) + serverFrame(0x1, eventMessage("PluginCustomEvent", "{}")));
+        pollUntilDrained(client);
+    }
+
+    // Handled types reach their handler with its context and everything else reaches onEvent;
+    // nothing is filtered while onEvent is set.
+    void testWithOnEvent()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.onEvent = &recordEvent;
+        if (!connect(client, config))
+        {
+            return;
+        }
+
+        CHECK(client.on(ObsEventType::CurrentProgramSceneChanged, &recordRouted, sceneHandler));
+        CHECK(client.on("InputMuteStateChanged", &recordRouted, muteHandler));
+        receive(client);
+        CHECK(delivered == std::vector<std::string>({"scene:CurrentProgramSceneChanged", "mute:InputMuteStateChanged", "onEvent:StudioModeStateChanged", "onEvent:PluginCustomEvent"}));
+
+        delivered.clear();
+        client.off(ObsEventType::InputMuteStateChanged);
+        receive(client);
+        CHECK(delivered == std::vector<std::string>({"scene:CurrentProgramSceneChanged", "onEvent:InputMuteStateChanged", "onEvent:StudioModeStateChanged", "onEvent:PluginCustomEvent"}));
+        CHECK_EQ(client.stats().eventsFiltered, 0);
+    }
+
+    // Without onEvent only handled types are kept; the rest, unknown types included, are
+    // dropped and counted.
+    void testWithoutOnEvent()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        if (!connect(client, config))
+        {
+            return;
+        }
+
+        receive(client);
+        CHECK(delivered.empty());
+        CHECK_EQ(client.stats().eventsFiltered, 4);
+
+        CHECK(client.on(ObsEventType::CurrentProgramSceneChanged, &recordRouted, sceneHandler));
+        CHECK(client.on(ObsEventType::InputMuteStateChanged, &recordRouted, muteHandler));
+        receive(client);
+        CHECK(delivered == std::vector<std::string>({"scene:CurrentProgramSceneChanged", "mute:InputMuteStateChanged"}));
+        CHECK_EQ(client.stats().eventsFiltered, 6);
+        CHECK_EQ(client.stats().eventQueueHighWater, 2);
+
+        // Passing a null handler is the same as off().
+        delivered.clear();
+        client.off(ObsEventType::CurrentProgramSceneChanged);
+        CHECK(client.on(ObsEventType::InputMuteStateChanged, nullptr));
+        receive(client);
+        CHECK(delivered.empty());
+        CHECK_EQ(client.stats().eventsFiltered, 10);
+    }
+
+    // Only names ObsEventType lists can be routed.
+    void testUnknownName()
+    {
+        ObsWsClient client;
+        CHECK(!client.on("PluginCustomEvent", &recordRouted, sceneHandler));
+        CHECK(!client.on(static_cast<const char *>(nullptr), &recordRouted, sceneHandler));
+        CHECK(!client.on(ObsEventType::Unknown, &recordRouted, sceneHandler));
+    }
+}
+
+int main()
+{
+    testWithOnEvent();
+    testWithoutOnEvent();
+    testUnknownName();
+    return hostTestResult("routes");
+}
@@ -0,0 +1,393 @@
+// The local state cache (Config::enableStateCache): the snapshot seeded from GetSceneList,
+// GetInputList, GetInputMute and GetSceneItemList after Identified, the events of the
+// subscriptions it adds keeping it current, and everything forgotten when the connection drops.
+
+#include "HostTest.h"
+
+namespace
+{
+    std::vector<std::string> delivered;
+
+    void recordEvent(const ObsEvent &event)
+    {
+        delivered.push_back(event.id);
+    }
+
+    std::string text(const ObsJsonSlice &slice)
+    {
+        return slice.data != nullptr ? std::string(slice.data, slice.length) : std::string();
+    }
+
+    std::string unquoted(const ObsJsonSlice &slice)
+    {
+        return slice.length >= 2 ? std::string(slice.data + 1, slice.length - 2) : std::string();
+    }
+
+    // A request the client wrote, on its own (op 6) or as part of a batch (op 8).
+    struct Sent
+    {
+        std::string batchId;
+        std::string requestId;
+        std::string requestType;
+        std::string requestData;
+    };
+
+    Sent sentRequest(const ObsJsonSlice &request, const std::string &batchId)
+    {
+        Sent sent;
+        ObsJsonSlice value;
+        sent.batchId = batchId;
+        sent.requestId = ObsJsonReader::findMember(request, "requestId", value) ? unquoted(value) : std::string();
+        sent.requestType = ObsJsonReader::findMember(request, "requestType", value) ? unquoted(value) : std::string();
+        sent.requestData = ObsJsonReader::findMember(request, "requestData", value) ? text(value) : std::string();
+        return sent;
+    }
+
+    std::vector<Sent> sentRequests(size_t from)
+    {
+        std::vector<Sent> requests;
+        for (const ClientFrame &frame : clientFrames(from))
+        {
+            const ObsJsonSlice message{frame.payload.data(), frame.payload.size()};
+            ObsJsonSlice op;
+            ObsJsonSlice d;
+            if (!ObsJsonReader::findMember(message, "op", op) || !ObsJsonReader::findMember(message, "d", d))
+            {
+                continue;
+            }
+            if (op.equals("6"))
+            {
+                requests.push_back(sentRequest(d, std::string()));
+                continue;
+            }
+            ObsJsonSlice batchId;
+            ObsJsonSlice list;
+            if (!op.equals("8") || !ObsJsonReader::findMember(d, "requestId", batchId) || !ObsJsonReader::findMember(d, "requests", list))
+            {
+                continue;
+            }
+            ObsJsonReader reader(list);
+            ObsJsonSlice request;
+            if (reader.beginArray())
+            {
+                while (reader.nextElement() && reader.skipValue(&request))
+                {
+                    requests.push_back(sentRequest(request, unquoted(batchId)));
+                }
+            }
+        }
+        return requests;
+    }
+
+    std::string result(const Sent &request, const std::string &responseData)
+    {
+        return "{\"requestId\":\"" + request.requestId + "\",\"requestStatus\":{\"code\":100,\"result\":true},\"requestType\":\"" + request.requestType +
+               "\",\"responseData\":" + responseData + "}";
+    }
+
+    // Answers every request in `requests`: batches with one op 9 each, the rest with op 7.
+    void reply(ObsWsClient &client, const std::vector<Sent> &requests, const std::vector<std::string> &responseData)
+    {
+        std::string frames;
+        std::string batchId;
+        std::string results;
+        for (size_t i = 0; i <= requests.size(); ++i)
+        {
+            const bool batched = i < requests.size() && !requests[i].batchId.empty();
+            if (!batchId.empty() && (!batched || requests[i].batchId != batchId))
+            {
+                frames += serverFrame(0x1, "{\"d\":{\"requestId\":\"" + batchId + "\",\"results\":[" + results + "]},\"op\":9}");
+                batchId.clear();
+                results.clear();
+            }
+            if (i == requests.size())
+            {
+                break;
+            }
+            if (batched)
+            {
+                batchId = requests[i].batchId;
+                results += (results.empty() ? "" : ",") + result(requests[i], responseData[i]);
+            }
+            else
+            {
+                frames += serverFrame(0x1, "{\"d\":" + result(requests[i], responseData[i]) + ",\"op\":7}");
+            }
+        }
+        hostConnection.feed(frames);
+        pollUntilDrained(client);
+    }
+
+    void receive(ObsWsClient &client, const char *type, const std::string &data)
+    {
+        hostConnection.feed(serverFrame(0x1, eventMessage(type, data)));
+        pollUntilDrained(client);
+    }
+
+    std::string item(int id, const char *sourceName, bool enabled)
+    {
+        return "{\"sceneItemEnabled\":" + std::string(enabled ? "true" : "false") + ",\"sceneItemId\":" + std::to_string(id) + ",\"sourceName\":\"" + sourceName + "\"}";
+    }
+
+    std::string programScene(const ObsWsClient &client)
+    {
+        char name[32];
+        return client.state().programScene(name, sizeof(name)) ? std::string(name) : std::string("<unknown>");
+    }
+
+    std::string previewScene(const ObsWsClient &client)
+    {
+        char name[32];
+        return client.state().previewScene(name, sizeof(name)) ? std::string(name) : std::string("<unknown>");
+    }
+
+    std::string muted(const ObsWsClient &client, const char *inputName)
+    {
+        bool value = false;
+        return client.state().inputMuted(inputName, value) ? (value ? "muted" : "unmuted") : "<unknown>";
+    }
+
+    std::string enabled(const ObsWsClient &client, const char *sceneName, int64_t sceneItemId)
+    {
+        bool value = false;
+        return client.state().sceneItemEnabled(sceneName, sceneItemId, value) ? (value ? "shown" : "hidden") : "<unknown>";
+    }
+
+    // Returns the output offset before Identified, where the seed requests start, or 0.
+    size_t connect(ObsWsClient &client, ObsWsClient::Config &config)
+    {
+        hostConnection.reset();
+        delivered.clear();
+        config.host = "obs.local";
+        config.autoReconnect = false;
+        config.enableStateCache = true;
+        config.eventSubscriptions = ObsEventSubscription::General;
+        config.onEvent = &recordEvent;
+        if (!client.begin(config) || acceptUpgrade(client) == 0)
+        {
+            return 0;
+        }
+        hostConnection.feed(serverFrame(0x1, "{\"op\":0,\"d\":{\"obsWebSocketVersion\":\"5.5.0\",\"rpcVersion\":1}}"));
+        pollUntilDrained(client);
+        const size_t start = hostConnection.written().size();
+        hostConnection.feed(serverFrame(0x1, "{\"op\":2,\"d\":{\"negotiatedRpcVersion\":1}}"));
+        pollUntilDrained(client);
+        return client.status() == ObsWsStatus::Connected ? start : 0;
+    }
+
+    // Answers the snapshot requests: scenes Live and Intro with Live on program, inputs Mic
+    // (muted) and Desktop Audio, Camera and Mic in Live and Title in Intro.
+    bool seed(ObsWsClient &client, size_t start)
+    {
+        const std::vector<Sent> lists = sentRequests(start);
+        if (!CHECK_EQ(lists.size(), 2) || !CHECK_EQ(lists[0].requestType, "GetSceneList") || !CHECK_EQ(lists[1].requestType, "GetInputList"))
+        {
+            return false;
+        }
+        CHECK(lists[0].batchId == lists[1].batchId && !lists[0].batchId.empty());
+        const size_t next = hostConnection.written().size();
+        reply(client, lists,
+              {"{\"currentPreviewSceneName\":null,\"currentProgramSceneName\":\"Live\",\"scenes\":[{\"sceneIndex\":0,\"sceneName\":\"Intro\"},{\"sceneIndex\":1,\"sceneName\":\"Live\"}]}",
+               "{\"inputs\":[{\"inputKind\":\"coreaudio_input_capture\",\"inputName\":\"Mic\"},{\"inputKind\":\"coreaudio_output_capture\",\"inputName\":\"Desktop Audio\"}]}"});
+        CHECK(!client.state().ready());
+
+        const std::vector<Sent> details = sentRequests(next);
+        if (!CHECK_EQ(details.size(), 4))
+        {
+            return false;
+        }
+        std::vector<std::string> responses;
+        for (const Sent &request : details)
+        {
+            if (request.requestType == "GetInputMute")
+            {
+                CHECK(!request.batchId.empty());
+                responses.push_back(std::string("{\"inputMuted\":") + (request.requestData == "{\"inputName\":\"Mic\"}" ? "true" : "false") + "}");
+            }
+            else if (CHECK_EQ(request.requestType, "GetSceneItemList"))
+            {
+                CHECK(request.batchId.empty());
+                responses.push_back(request.requestData == "{\"sceneName\":\"Live\"}" ? "{\"sceneItems\":[" + item(1, "Camera", true) + "," + item(2, "Mic", false) + "]}"
+                                                                                     : "{\"sceneItems\":[" + item(3, "Title", true) + "]}");
+            }
+        }
+        reply(client, details, responses);
+        return CHECK(client.state().ready());
+    }
+
+    // The cache subscribes to what it follows, asks for the lists first and the per-input and
+    // per-scene details once the names are known, and is ready when every answer is in. None
+    // of its responses reach onEvent.
+    void testSeed()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        const size_t start = connect(client, config);
+        if (!CHECK(start != 0))
+        {
+            return;
+        }
+        CHECK_EQ(client.eventSubscriptions(), ObsEventSubscription::General | ObsEventSubscription::Config | ObsEventSubscription::Scenes | ObsEventSubscription::Inputs |
+                                                  ObsEventSubscription::SceneItems | ObsEventSubscription::Ui);
+        CHECK(!client.state().ready());
+        if (!seed(client, start))
+        {
+            return;
+        }
+
+        CHECK_EQ(programScene(client), "Live");
+        CHECK_EQ(previewScene(client), "<unknown>");
+        CHECK_EQ(muted(client, "Mic"), "muted");
+        CHECK_EQ(muted(client, "Desktop Audio"), "unmuted");
+        CHECK_EQ(enabled(client, "Live", 1), "shown");
+        CHECK_EQ(enabled(client, "Live", 2), "hidden");
+        CHECK_EQ(enabled(client, "Intro", 3), "shown");
+        CHECK_EQ(enabled(client, "Intro", 1), "<unknown>");
+        bool shown = false;
+        CHECK(client.state().sceneItemEnabled("Live", "Mic", shown) && !shown);
+        CHECK(delivered.empty());
+        client.close();
+    }
+
+    // Scene, input and scene item events update the snapshot in place; events it cannot
+    // describe alone are followed by a request for the missing part. The events still reach
+    // onEvent.
+    void testEvents()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        const size_t start = connect(client, config);
+        if (!CHECK(start != 0) || !seed(client, start))
+        {
+            return;
+        }
+
+        receive(client, "CurrentProgramSceneChanged", "{\"sceneName\":\"Intro\"}");
+        CHECK_EQ(programScene(client), "Intro");
+        receive(client, "StudioModeStateChanged", "{\"studioModeEnabled\":true}");
+        receive(client, "CurrentPreviewSceneChanged", "{\"sceneName\":\"Live\"}");
+        CHECK_EQ(previewScene(client), "Live");
+        receive(client, "StudioModeStateChanged", "{\"studioModeEnabled\":false}");
+        CHECK_EQ(previewScene(client), "<unknown>");
+
+        receive(client, "InputMuteStateChanged", "{\"inputMuted\":true,\"inputName\":\"Desktop Audio\"}");
+        CHECK_EQ(muted(client, "Desktop Audio"), "muted");
+        receive(client, "SceneItemEnableStateChanged", "{\"sceneItemEnabled\":true,\"sceneItemId\":2,\"sceneName\":\"Live\"}");
+        CHECK_EQ(enabled(client, "Live", 2), "shown");
+        receive(client, "SceneItemRemoved", "{\"sceneItemId\":1,\"sceneName\":\"Live\",\"sourceName\":\"Camera\"}");
+        CHECK_EQ(enabled(client, "Live", 1), "<unknown>");
+
+        receive(client, "SceneNameChanged", "{\"oldSceneName\":\"Intro\",\"sceneName\":\"Opening\"}");
+        CHECK_EQ(programScene(client), "Opening");
+        CHECK_EQ(enabled(client, "Opening", 3), "shown");
+        CHECK_EQ(enabled(client, "Intro", 3), "<unknown>");
+        receive(client, "InputNameChanged", "{\"inputName\":\"Voice\",\"oldInputName\":\"Mic\"}");
+        CHECK_EQ(muted(client, "Voice"), "muted");
+        CHECK_EQ(muted(client, "Mic"), "<unknown>");
+        receive(client, "InputRemoved", "{\"inputName\":\"Desktop Audio\"}");
+        CHECK_EQ(muted(client, "Desktop Audio"), "<unknown>");
+
+        size_t next = hostConnection.written().size();
+        receive(client, "InputCreated", "{\"inputKind\":\"coreaudio_input_capture\",\"inputName\":\"Aux\"}");
+        CHECK_EQ(muted(client, "Aux"), "<unknown>");
+        std::vector<Sent> followUp = sentRequests(next);
+        if (CHECK_EQ(followUp.size(), 1))
+        {
+            CHECK_EQ(followUp[0].requestType, "GetInputMute");
+            CHECK_EQ(followUp[0].requestData, "{\"inputName\":\"Aux\"}");
+            reply(client, followUp, {"{\"inputMuted\":false}"});
+            CHECK_EQ(muted(client, "Aux"), "unmuted");
+        }
+
+        next = hostConnection.written().size();
+        receive(client, "SceneItemCreated", "{\"sceneItemId\":4,\"sceneItemIndex\":2,\"sceneName\":\"Live\",\"sourceName\":\"Aux\"}");
+        CHECK_EQ(enabled(client, "Live", 4), "<unknown>");
+        followUp = sentRequests(next);
+        if (CHECK_EQ(followUp.size(), 1))
+        {
+            CHECK_EQ(followUp[0].requestType, "GetSceneItemList");
+            CHECK_EQ(followUp[0].requestData, "{\"sceneName\":\"Live\"}");
+            reply(client, followUp, {"{\"sceneItems\":[" + item(2, "Mic", true) + "," + item(4, "Aux", false) + "]}"});
+            CHECK_EQ(enabled(client, "Live", 4), "hidden");
+            CHECK_EQ(enabled(client, "Live", 2), "shown");
+        }
+
+        CHECK_EQ(delivered.size(), 12);
+        CHECK(client.state().ready());
+        client.close();
+    }
+
+    // A scene collection change empties the cache and seeds it again.
+    void testCollectionChange()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        const size_t start = connect(client, config);
+        if (!CHECK(start != 0) || !seed(client, start))
+        {
+            return;
+        }
+
+        receive(client, "CurrentSceneCollectionChanging", "{\"sceneCollectionName\":\"Show\"}");
+        CHECK(!client.state().ready());
+        const size_t next = hostConnection.written().size();
+        receive(client, "CurrentSceneCollectionChanged", "{\"sceneCollectionName\":\"Rehearsal\"}");
+        CHECK_EQ(programScene(client), "<unknown>");
+        CHECK_EQ(muted(client, "Mic"), "<unknown>");
+        seed(client, next);
+        CHECK_EQ(programScene(client), "Live");
+        client.close();
+    }
+
+    // Dropping the connection forgets the snapshot; the next session seeds a fresh one, and
+    // answers to the old session's requests are ignored.
+    void testDisconnect()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        const size_t start = connect(client, config);
+        if (!CHECK(start != 0) || !seed(client, start))
+        {
+            return;
+        }
+        const std::vector<Sent> stale = sentRequests(start);
+
+        {
+            std::lock_guard<std::mutex> guard(hostConnection.lock);
+            hostConnection.connected = false;
+        }
+        client.poll();
+        CHECK(client.status() == ObsWsStatus::Disconnected);
+        CHECK(!client.state().ready());
+        CHECK_EQ(programScene(client), "<unknown>");
+        CHECK_EQ(muted(client, "Mic"), "<unknown>");
+        CHECK_EQ(enabled(client, "Live", 1), "<unknown>");
+
+        const size_t restart = connect(client, config);
+        if (!CHECK(restart != 0))
+        {
+            return;
+        }
+        reply(client, std::vector<Sent>(stale.begin(), stale.begin() + 2),
+              {"{\"currentPreviewSceneName\":null,\"currentProgramSceneName\":\"Stale\",\"scenes\":[{\"sceneIndex\":0,\"sceneName\":\"Stale\"}]}", "{\"inputs\":[]}"});
+        CHECK(!client.state().ready());
+        CHECK_EQ(programScene(client), "<unknown>");
+        CHECK(delivered.empty());
+
+        if (seed(client, restart))
+        {
+            CHECK_EQ(programScene(client), "Live");
+            CHECK_EQ(muted(client, "Mic"), "muted");
+        }
+        client.close();
+    }
+}
+
+int main()
+{
+    testSeed();
+    testEvents();
+    testCollectionChange();
+    testDisconnect();
+    return hostTestResult("state");
+}
@@ -0,0 +1,137 @@
+// Event subscriptions: reidentify() sending op 3 on a live session, eventSubscriptions()
+// following the op 2 acknowledgements, and calls made before the handshake completes being
+// carried by Identify or sent right after Identified.
+
+#include "HostTest.h"
+
+namespace
+{
+    const char kHello[] = "{\"op\":0,\"d\":{\"obsWebSocketVersion\":\"5.5.0\",\"rpcVersion\":1}}";
+    const char kIdentified[] = "{\"op\":2,\"d\":{\"negotiatedRpcVersion\":1}}";
+
+    // "op:eventSubscriptions" for each Identify and Reidentify the client wrote after `from`.
+    std::vector<std::string> sentMasks(size_t from)
+    {
+        std::vector<std::string> masks;
+        for (const ClientFrame &frame : clientFrames(from))
+        {
+            const ObsJsonSlice message{frame.payload.data(), frame.payload.size()};
+            ObsJsonSlice op;
+            ObsJsonSlice d;
+            ObsJsonSlice subscriptions;
+            if (ObsJsonReader::findMember(message, "op", op) && (op.equals("1") || op.equals("3")) && ObsJsonReader::findMember(message, "d", d) &&
+                ObsJsonReader::findMember(d, "eventSubscriptions", subscriptions))
+            {
+                masks.push_back(std::string(op.data, op.length) + ":" + std::string(subscriptions.data, subscriptions.length));
+            }
+        }
+        return masks;
+    }
+
+    std::string mask(int op, uint64_t subscriptions)
+    {
+        return std::to_string(op) + ":" + std::to_string(subscriptions);
+    }
+
+    void identified(ObsWsClient &client)
+    {
+        hostConnection.feed(serverFrame(0x1, kIdentified));
+        pollUntilDrained(client);
+    }
+
+    // On a live session the new mask goes out with op 3 at once and becomes active with the
+    // op 2 answering the last Reidentify still in flight.
+    void testLiveSession()
+    {
+        hostConnection.reset();
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.eventSubscriptions = ObsEventSubscription::Scenes;
+        const size_t start = connectClient(client, config);
+        if (!CHECK(start != 0))
+        {
+            return;
+        }
+        CHECK_EQ(client.eventSubscriptions(), ObsEventSubscription::Scenes);
+
+        CHECK(client.reidentify(ObsEventSubscription::Inputs));
+        CHECK(sentMasks(start) == std::vector<std::string>({mask(3, ObsEventSubscription::Inputs)}));
+        CHECK_EQ(client.eventSubscriptions(), ObsEventSubscription::Scenes);
+        identified(client);
+        CHECK_EQ(client.eventSubscriptions(), ObsEventSubscription::Inputs);
+
+        const uint64_t meters = ObsEventSubscription::Inputs | ObsEventSubscription::InputVolumeMeters;
+        CHECK(client.reidentify(ObsEventSubscription::All));
+        CHECK(client.reidentify(meters));
+        identified(client);
+        CHECK_EQ(client.eventSubscriptions(), ObsEventSubscription::Inputs);
+        identified(client);
+        CHECK_EQ(client.eventSubscriptions(), meters);
+        CHECK(sentMasks(start) == std::vector<std::string>({mask(3, ObsEventSubscription::Inputs), mask(3, ObsEventSubscription::All), mask(3, meters)}));
+        CHECK(client.status() == ObsWsStatus::Connected);
+    }
+
+    // Before Identify goes out the new mask simply replaces the configured one.
+    void testBeforeIdentify()
+    {
+        hostConnection.reset();
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.host = "obs.local";
+        config.eventSubscriptions = ObsEventSubscription::Scenes;
+        if (!CHECK(client.begin(config)))
+        {
+            return;
+        }
+
+        CHECK(client.reidentify(ObsEventSubscription::Outputs));
+        const size_t start = acceptUpgrade(client);
+        hostConnection.feed(serverFrame(0x1, kHello));
+        pollUntilDrained(client);
+        identified(client);
+        CHECK(client.status() == ObsWsStatus::Connected);
+        CHECK(sentMasks(start) == std::vector<std::string>({mask(1, ObsEventSubscription::Outputs)}));
+        CHECK_EQ(client.eventSubscriptions(), ObsEventSubscription::Outputs);
+
+        // A new Config brings its own mask.
+        client.close();
+        hostConnection.reset();
+        CHECK(connectClient(client, config) != 0);
+        CHECK_EQ(client.eventSubscriptions(), ObsEventSubscription::Scenes);
+    }
+
+    // With Identify already sent, op 3 follows as soon as Identified arrives.
+    void testDuringIdentify()
+    {
+        hostConnection.reset();
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.host = "obs.local";
+        config.eventSubscriptions = ObsEventSubscription::Scenes;
+        if (!CHECK(client.begin(config)))
+        {
+            return;
+        }
+
+        const size_t start = acceptUpgrade(client);
+        hostConnection.feed(serverFrame(0x1, kHello));
+        pollUntilDrained(client);
+        CHECK(client.reidentify(ObsEventSubscription::Outputs));
+        CHECK(sentMasks(start) == std::vector<std::string>({mask(1, ObsEventSubscription::Scenes)}));
+
+        identified(client);
+        CHECK(client.status() == ObsWsStatus::Connected);
+        CHECK_EQ(client.eventSubscriptions(), ObsEventSubscription::Scenes);
+        CHECK(sentMasks(start) == std::vector<std::string>({mask(1, ObsEventSubscription::Scenes), mask(3, ObsEventSubscription::Outputs)}));
+        identified(client);
+        CHECK_EQ(client.eventSubscriptions(), ObsEventSubscription::Outputs);
+    }
+}
+
+int main()
+{
+    testLiveSession();
+    testBeforeIdentify();
+    testDuringIdentify();
+    return hostTestResult("subscriptions");
+}
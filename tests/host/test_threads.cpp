@@ -0,0 +1,300 @@
+// Several producer threads sending requests through the network task while another thread
+// plays OBS and the main thread polls: every request gets a unique id, reaches the socket as
+// an intact frame and completes exactly once.
+
+#include "HostTest.h"
+#include "ObsWsJson.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <thread>
+
+namespace
+{
+    constexpr int kProducers = 4;
+    constexpr int kRequestsPerProducer = 250;
+
+    struct Producer
+    {
+        int index = 0;
+        std::vector<uint32_t> sent;
+    };
+
+    std::mutex completionLock;
+    std::map<uint32_t, int> completions; // requestId -> times completed
+    std::vector<std::string> completionErrors;
+    std::atomic<int> inconsistentStats{0};
+
+    void recordCompletion(const ObsRequestResult &result, void *context)
+    {
+        const Producer *producer = static_cast<const Producer *>(context);
+        std::lock_guard<std::mutex> guard(completionLock);
+        ++completions[result.requestId];
+        const std::string expected = "{\"producer\":" + std::to_string(producer->index) + "}";
+        if (result.error != ObsWsError::None || !result.success ||
+            std::string(result.responseData, result.responseDataLength) != expected)
+        {
+            completionErrors.push_back(std::to_string(result.requestId));
+        }
+    }
+
+    size_t completedCount()
+    {
+        std::lock_guard<std::mutex> guard(completionLock);
+        return completions.size();
+    }
+
+    // Waits in real time for the network task; millis() stays put so nothing times out.
+    template <typename Condition>
+    bool waitFor(Condition condition, ObsWsClient *polled = nullptr)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (!condition())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                return false;
+            }
+            if (polled != nullptr)
+            {
+                polled->poll();
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        return true;
+    }
+
+    std::string memberText(const std::string &payload, const std::string &key)
+    {
+        const std::string marker = "\"" + key + "\":\"";
+        const size_t begin = payload.find(marker);
+        if (begin == std::string::npos)
+        {
+            return std::string();
+        }
+        const size_t valueBegin = begin + marker.size();
+        return payload.substr(valueBegin, payload.find('"', valueBegin) - valueBegin);
+    }
+
+    // Answers each op 6 request in the client's output, echoing the producer from its data,
+    // with an event between responses.
+    void playServer(size_t start, std::atomic<bool> &stop, std::atomic<int> &malformed)
+    {
+        size_t answered = 0;
+        while (!stop)
+        {
+            const std::vector<ClientFrame> frames = clientFrames(start);
+            for (; answered < frames.size(); ++answered)
+            {
+                const std::string &payload = frames[answered].payload;
+                if (frames[answered].first != 0x81 || !isJsonObject(payload.c_str(), payload.size()))
+                {
+                    ++malformed;
+                    continue;
+                }
+                const std::string id = memberText(payload, "requestId");
+                const std::string type = memberText(payload, "requestType");
+                const size_t producer = payload.find("\"producer\":");
+                if (id.empty() || producer == std::string::npos)
+                {
+                    ++malformed;
+                    continue;
+                }
+                const std::string data = "{\"producer\":" + payload.substr(producer + 11, 1) + "}";
+                hostConnection.feed(serverFrame(0x1, responseMessage(std::stoul(id), type, true, data)) +
+                                    serverFrame(0x1, eventMessage("Tick", "{}")));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Sends its share of requests, retrying while the send queue or the pending table is full,
+    // and reads status and stats in between as an application task would.
+    void produce(ObsWsClient &client, Producer &producer)
+    {
+        const std::string payload = "{\"producer\":" + std::to_string(producer.index) + "}";
+        const std::string type = "Producer" + std::to_string(producer.index);
+        while (producer.sent.size() < static_cast<size_t>(kRequestsPerProducer))
+        {
+            const uint32_t id = client.sendRequest(type.c_str(), payload.c_str(), &recordCompletion, &producer);
+            if (id != 0)
+            {
+                producer.sent.push_back(id);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+            if (client.status() != ObsWsStatus::Connected)
+            {
+                return;
+            }
+            // The depth and high-water mark come from one snapshot, so they always agree.
+            const ObsWsStats stats = client.stats();
+            if (stats.eventQueueDepth > stats.eventQueueHighWater || stats.eventQueueDepth > stats.eventQueueLength)
+            {
+                ++inconsistentStats;
+            }
+        }
+    }
+
+    // Starts the client on its network task, which reads the upgrade response, Hello and
+    // Identified. Returns where the client's frames after Identify start, or 0.
+    size_t connectNetworkTask(ObsWsClient &client, ObsWsClient::Config &config)
+    {
+        hostConnection.reset();
+        config.host = "obs.local";
+        config.useNetworkTask = true;
+        config.networkTaskIntervalMs = 1;
+        if (!CHECK(client.begin(config)))
+        {
+            return 0;
+        }
+
+        const size_t upgrade = acceptUpgrade(client);
+        hostConnection.feed(serverFrame(0x1, "{\"op\":0,\"d\":{\"obsWebSocketVersion\":\"5.5.0\",\"rpcVersion\":1}}"));
+        CHECK(waitFor([upgrade]()
+                      { return !clientFrames(upgrade).empty(); }));
+        hostConnection.feed(serverFrame(0x1, "{\"op\":2,\"d\":{\"negotiatedRpcVersion\":1}}"));
+        if (!CHECK(waitFor([&client]()
+                           { return client.status() == ObsWsStatus::Connected; })))
+        {
+            client.close();
+            return 0;
+        }
+        return hostConnection.written().size();
+    }
+
+    void testConcurrentProducers()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.maxPendingRequests = 32;
+        config.sendQueueLength = 32;
+        config.eventQueueLength = 64;
+        const size_t start = connectNetworkTask(client, config);
+        if (start == 0)
+        {
+            return;
+        }
+
+        std::atomic<bool> stopServer{false};
+        std::atomic<int> malformed{0};
+        std::thread server(playServer, start, std::ref(stopServer), std::ref(malformed));
+
+        Producer producers[kProducers];
+        std::vector<std::thread> threads;
+        for (int i = 0; i < kProducers; ++i)
+        {
+            producers[i].index = i;
+            threads.emplace_back(produce, std::ref(client), std::ref(producers[i]));
+        }
+
+        const size_t total = kProducers * kRequestsPerProducer;
+        const bool completed = waitFor([total]()
+                                       { return completedCount() == total; },
+                                       &client);
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        stopServer = true;
+        server.join();
+
+        CHECK(completed);
+        CHECK_EQ(malformed.load(), 0);
+        CHECK_EQ(inconsistentStats.load(), 0);
+        std::map<uint32_t, int> ids;
+        for (const Producer &producer : producers)
+        {
+            CHECK_EQ(producer.sent.size(), kRequestsPerProducer);
+            for (uint32_t id : producer.sent)
+            {
+                ++ids[id];
+            }
+        }
+        CHECK_EQ(ids.size(), total);
+        CHECK(ids == completions);
+        if (!CHECK(completionErrors.empty()))
+        {
+            std::printf("  first failed request %s\n", completionErrors.front().c_str());
+        }
+        client.close();
+        CHECK(client.status() == ObsWsStatus::Disconnected);
+    }
+
+    std::atomic<int> poolCompletions{0};
+    std::atomic<int> poolCompletionErrors{0};
+
+    void countPoolCompletion(const ObsRequestResult &result, void *)
+    {
+        ++poolCompletions;
+        if (result.error != ObsWsError::None || !result.success || result.responseData == nullptr)
+        {
+            ++poolCompletionErrors;
+        }
+    }
+
+    void ignoreEvent(const ObsEvent &)
+    {
+    }
+
+    // Events fill the slot pool while nobody polls, and eventPoolOverflow is Drop. Replies the
+    // network task reads meanwhile, small ones and ones too large for a slot, must all still
+    // complete from poll().
+    void testCompletionsWithFullPool()
+    {
+        constexpr int kRequests = 24;
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.onEvent = &ignoreEvent;
+        config.eventPoolSlots = 2;
+        config.eventPoolPayloadBytes = 64;
+        config.eventPoolOverflow = ObsWsPoolOverflow::Drop;
+        config.maxPendingRequests = kRequests;
+        config.sendQueueLength = kRequests;
+        const size_t start = connectNetworkTask(client, config);
+        if (start == 0)
+        {
+            return;
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+            hostConnection.feed(serverFrame(0x1, eventMessage("Tick", "{\"n\":" + std::to_string(i) + "}")));
+        }
+        CHECK(waitFor([&client]()
+                      { return client.stats().eventPoolInUse == 2 && client.stats().eventPoolDrops == 2; }));
+
+        std::vector<uint32_t> ids;
+        for (int i = 0; i < kRequests; ++i)
+        {
+            ids.push_back(client.sendRequest("GetStats", nullptr, &countPoolCompletion, nullptr));
+            CHECK(ids.back() != 0);
+        }
+        CHECK(waitFor([start]()
+                      { return clientFrames(start).size() == static_cast<size_t>(kRequests); }));
+        for (int i = 0; i < kRequests; ++i)
+        {
+            const std::string data = "{\"padding\":\"" + std::string(i % 2 == 0 ? 8 : 200, 'p') + "\"}";
+            hostConnection.feed(serverFrame(0x1, responseMessage(ids[i], "GetStats", true, data)));
+        }
+        CHECK(waitFor([]()
+                      { return hostConnection.drained(); }));
+
+        CHECK(waitFor([]()
+                      { return poolCompletions.load() == kRequests; },
+                      &client));
+        CHECK_EQ(poolCompletions.load(), kRequests);
+        CHECK_EQ(poolCompletionErrors.load(), 0);
+        client.close();
+    }
+}
+
+int main()
+{
+    testConcurrentProducers();
+    testCompletionsWithFullPool();
+    return hostTestResult("threads");
+}
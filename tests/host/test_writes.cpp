@@ -0,0 +1,163 @@
+// How many WiFiClient::write() calls outgoing frames take: one per message by default, one per
+// poll() with deferFlush, control frames sent straight away with the data ahead of them, and
+// the 4 KB bound on what deferFlush holds back.
+
+#include "HostTest.h"
+
+namespace
+{
+    // The frames and write() calls since the last mark().
+    struct Written
+    {
+        size_t start = 0;
+        int writes = 0;
+
+        void mark()
+        {
+            std::lock_guard<std::mutex> guard(hostConnection.lock);
+            start = hostConnection.output.size();
+            writes = hostConnection.writes;
+        }
+
+        int newWrites() const
+        {
+            std::lock_guard<std::mutex> guard(hostConnection.lock);
+            return hostConnection.writes - writes;
+        }
+
+        std::vector<ClientFrame> newFrames() const
+        {
+            return clientFrames(start);
+        }
+    };
+
+    bool connect(ObsWsClient &client, ObsWsClient::Config &config, Written &written)
+    {
+        hostConnection.reset();
+        if (!CHECK(connectClient(client, config) != 0))
+        {
+            return false;
+        }
+        written.mark();
+        return true;
+    }
+
+    std::string payload(size_t length)
+    {
+        return "{\"s\":\"" + std::string(length - 8, 'x') + "\"}";
+    }
+
+    // Every message is a single write, whatever its size.
+    void testImmediate()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        Written written;
+        if (!connect(client, config, written))
+        {
+            return;
+        }
+
+        for (const size_t length : {size_t(16), size_t(200), size_t(70000)})
+        {
+            written.mark();
+            CHECK(client.sendRequest("SetInputSettings", payload(length).c_str()));
+            CHECK_EQ(written.newWrites(), 1);
+            CHECK_EQ(written.newFrames().size(), 1);
+        }
+
+        written.mark();
+        client.poll();
+        CHECK_EQ(written.newWrites(), 0);
+    }
+
+    // Messages sent between polls leave together at the end of the next poll(); a pong goes
+    // out as soon as the ping is read, with the data frames queued before it.
+    void testDeferred()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.deferFlush = true;
+        Written written;
+        if (!connect(client, config, written))
+        {
+            return;
+        }
+
+        CHECK(client.sendRequest("GetVersion", nullptr));
+        CHECK(client.sendRequest("GetStats", nullptr));
+        CHECK(client.sendRequest("GetSceneList", nullptr));
+        CHECK_EQ(written.newWrites(), 0);
+        client.poll();
+        CHECK_EQ(written.newWrites(), 1);
+        CHECK_EQ(written.newFrames().size(), 3);
+
+        written.mark();
+        client.poll();
+        CHECK_EQ(written.newWrites(), 0);
+
+        CHECK(client.sendRequest("GetVersion", nullptr));
+        hostConnection.feed(serverFrame(0x9, "ping"));
+        client.poll();
+        CHECK_EQ(written.newWrites(), 1);
+        const std::vector<ClientFrame> frames = written.newFrames();
+        if (CHECK_EQ(frames.size(), 2))
+        {
+            CHECK_EQ(frames[0].first & 0x0F, 0x1);
+            CHECK_EQ(frames[1].first & 0x0F, 0xA);
+            CHECK_EQ(frames[1].payload, "ping");
+        }
+    }
+
+    // Deferred frames are written as soon as they reach 4 KB, in one write that includes the
+    // frame crossing the threshold; a single larger message goes out on its own at once.
+    void testThreshold()
+    {
+        ObsWsClient client;
+        ObsWsClient::Config config;
+        config.deferFlush = true;
+        Written written;
+        if (!connect(client, config, written))
+        {
+            return;
+        }
+
+        size_t sent = 0;
+        while (written.newWrites() == 0 && sent < 10)
+        {
+            CHECK(client.sendRequest("SetInputSettings", payload(900).c_str()));
+            ++sent;
+        }
+        CHECK_EQ(written.newWrites(), 1);
+        const std::vector<ClientFrame> frames = written.newFrames();
+        size_t bytes = 0;
+        {
+            std::lock_guard<std::mutex> guard(hostConnection.lock);
+            bytes = hostConnection.output.size() - written.start;
+        }
+        CHECK_EQ(frames.size(), sent);
+        CHECK(bytes >= 4096);
+        CHECK(!frames.empty() && bytes - (frames.back().payload.size() + 8) < 4096);
+
+        written.mark();
+        CHECK(client.sendRequest("SetInputSettings", payload(900).c_str()));
+        CHECK_EQ(written.newWrites(), 0);
+        client.poll();
+        CHECK_EQ(written.newWrites(), 1);
+
+        written.mark();
+        CHECK(client.sendRequest("SetInputSettings", payload(5000).c_str()));
+        CHECK_EQ(written.newWrites(), 1);
+        CHECK_EQ(written.newFrames().size(), 1);
+        client.poll();
+        CHECK_EQ(written.newWrites(), 1);
+    }
+}
+
+int main()
+{
+    testImmediate();
+    testDeferred();
+    testThreshold();
+    return hostTestResult("writes");
+}
@@ -0,0 +1,478 @@
+#!/usr/bin/env python3
+"""Generates src/ObsWsRequests.h, the typed request builders and response views.
+
+The input uses the layout of obs-websocket's docs/generated/protocol.json, so the full upstream
+file works as well as the trimmed tools/protocol-requests.json kept in this repository. The host
+test covering every generated type, tests/host/test_requests.cpp, is written alongside.
+
+    python3 tools/generate_requests.py [--protocol FILE] [--output FILE] [--tests FILE]
+"""
+
+import argparse
+import json
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# protocol.json only says "Number"; these fields carry fractional values and become double.
+# Every other Number is written and read as int64_t.
+FLOAT_FIELDS = {
+    "activeFps",
+    "availableDiskSpace",
+    "averageFrameRenderTime",
+    "cpuUsage",
+    "inputAudioBalance",
+    "inputVolumeDb",
+    "inputVolumeMul",
+    "memoryUsage",
+    "outputCongestion",
+}
+
+
+def field_kind(field):
+    value_type = field["valueType"]
+    if value_type == "String":
+        return "string"
+    if value_type == "Boolean":
+        return "bool"
+    if value_type == "Number":
+        return "double" if field["valueName"] in FLOAT_FIELDS else "int"
+    if value_type in ("Object", "Any") or value_type.startswith("Array"):
+        return "raw"
+    raise ValueError("unsupported valueType " + value_type)
+
+
+def request_member(field):
+    kind = field_kind(field)
+    name = field["valueName"]
+    optional = field.get("valueOptional", False)
+    if kind == "string":
+        return "const char *%s = nullptr;" % name
+    if kind == "raw":
+        return "const char *%s = nullptr; // JSON text, written verbatim" % name
+    ctype = {"bool": "bool", "int": "int64_t", "double": "double"}[kind]
+    if optional:
+        return "ObsOptional<%s> %s;" % (ctype, name)
+    return "%s %s = %s;" % (ctype, name, "false" if kind == "bool" else "0")
+
+
+def write_statements(field):
+    kind = field_kind(field)
+    name = field["valueName"]
+    optional = field.get("valueOptional", False)
+    put = {
+        "string": "json.string(%s);",
+        "raw": "json.raw(%s, std::strlen(%s));",
+        "bool": "json.boolean(%s);",
+        "int": "json.integer(%s);",
+        "double": "json.number(%s);",
+    }[kind]
+    if kind in ("string", "raw"):
+        value = name
+        condition = "%s != nullptr" % name
+    elif optional:
+        value = name + ".value"
+        condition = name + ".set"
+    else:
+        return ['json.key("%s");' % name, put % name]
+    body = ['json.key("%s");' % name, put.replace("%s", value)]
+    return ["if (%s)" % condition, "{"] + ["    " + line for line in body] + ["}"]
+
+
+def valid_statements(fields):
+    """The body of valid(): every JSON text field that is set must hold the JSON its type needs."""
+    checks = []
+    for field in fields:
+        if field_kind(field) == "raw":
+            check = "isJsonObject" if field["valueType"] == "Object" else "isJsonValue"
+            checks.append("(%s == nullptr || %s(%s, std::strlen(%s)))" % (field["valueName"], check, field["valueName"], field["valueName"]))
+    if not checks:
+        return None
+    return ["return " + " &&\n       ".join(checks) + ";"]
+
+
+def response_member(field):
+    kind = field_kind(field)
+    name = field["valueName"]
+    ctype = {
+        "string": "ObsJsonSlice",
+        "raw": "ObsJsonSlice",
+        "bool": "bool",
+        "int": "int64_t",
+        "double": "double",
+    }[kind]
+    initial = {"bool": " = false", "int": " = 0", "double": " = 0"}.get(kind, "")
+    return "%s %s%s;" % (ctype, name, initial)
+
+
+def emit_request(request, out):
+    name = request["requestType"]
+    fields = request.get("requestFields", [])
+    responses = request.get("responseFields", [])
+    try:
+        for field in fields + responses:
+            field_kind(field)
+    except ValueError as error:
+        sys.stderr.write("skipping %s: %s\n" % (name, error))
+        return False
+
+    out.append("    // %s" % request.get("description", "").strip().split("\n")[0])
+    out.append("    struct %s" % name)
+    out.append("    {")
+    out.append('        static constexpr const char *kRequestType = "%s";' % name)
+    out.append("        static constexpr bool kHasData = %s;" % ("true" if fields else "false"))
+    if fields:
+        out.append("")
+        for field in fields:
+            out.append("        " + request_member(field))
+        out.append("")
+        out.append("        void write(ObsJsonWriter &json) const")
+        out.append("        {")
+        for field in fields:
+            for line in write_statements(field):
+                out.append("            " + line)
+        out.append("        }")
+    else:
+        out.append("")
+        out.append("        void write(ObsJsonWriter &) const {}")
+    checks = valid_statements(fields)
+    if checks:
+        out.append("")
+        out.append("        // JSON text fields are spliced in verbatim, so send() refuses them when malformed.")
+        out.append("        bool valid() const")
+        out.append("        {")
+        for statement in checks:
+            for line in statement.split("\n"):
+                out.append("            " + line)
+        out.append("        }")
+    else:
+        if fields:
+            out.append("")
+        out.append("        bool valid() const { return true; }")
+
+    if responses:
+        out.append("")
+        out.append("        struct Response")
+        out.append("        {")
+        for field in responses:
+            out.append("            " + response_member(field))
+        out.append("")
+        out.append("            bool parse(const char *json, size_t length)")
+        out.append("            {")
+        out.append("                ObsJsonReader reader(json, length);")
+        out.append("                ObsJsonSlice key;")
+        out.append("                if (!reader.beginObject())")
+        out.append("                {")
+        out.append("                    return false;")
+        out.append("                }")
+        out.append("                while (reader.nextMember(key))")
+        out.append("                {")
+        for index, field in enumerate(responses):
+            keyword = "if" if index == 0 else "else if"
+            reader = "readRaw" if field_kind(field) == "raw" else "readField"
+            out.append('                    %s (key.equals("%s"))' % (keyword, field["valueName"]))
+            out.append("                    {")
+            out.append("                        detail::%s(reader, %s);" % (reader, field["valueName"]))
+            out.append("                    }")
+        out.append("                    else")
+        out.append("                    {")
+        out.append("                        reader.skipValue();")
+        out.append("                    }")
+        out.append("                }")
+        out.append("                return !reader.failed();")
+        out.append("            }")
+        out.append("        };")
+    out.append("    };")
+    out.append("")
+    return True
+
+
+def c_string(text):
+    return '"' + text.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def sample(field, index):
+    """A value for the field that differs from its default, as (C++ expression, JSON text)."""
+    kind = field_kind(field)
+    name = field["valueName"]
+    if kind == "string":
+        # The quotes check that builders escape and views keep escapes.
+        value = '%s "%d"' % (name, index)
+        return c_string(value), json.dumps(value)
+    if kind == "raw":
+        value = '{"%s":[%d,true]}' % (name, index)
+        return c_string(value), value
+    if kind == "bool":
+        return "true", "true"
+    if kind == "int":
+        value = 10000000000 + index  # Beyond 32 bits.
+        return "%dLL" % value, str(value)
+    value = index + 0.25
+    return repr(value), "%.9g" % value
+
+
+def default_json(field):
+    """The JSON an unassigned field is written as, or None when it is omitted."""
+    kind = field_kind(field)
+    if kind in ("string", "raw") or field.get("valueOptional", False):
+        return None
+    return {"bool": "false", "int": "0", "double": "0"}[kind]
+
+
+# A value of the wrong type for each kind; views skip it and keep the default.
+MISMATCHED = {"string": "1", "bool": '"true"', "int": '"1"', "double": "false"}
+
+
+def json_object(members):
+    return "{" + ",".join('"%s":%s' % member for member in members) + "}"
+
+
+def emit_request_test(request, out):
+    name = request["requestType"]
+    fields = request.get("requestFields", [])
+    responses = request.get("responseFields", [])
+    try:
+        for field in fields + responses:
+            field_kind(field)
+    except ValueError:
+        return None
+
+    function = "test" + name
+    out.append("    void %s()" % function)
+    out.append("    {")
+    out.append("        ObsRequests::%s request;" % name)
+    out.append("        CHECK_EQ(std::string(request.kRequestType), %s);" % c_string(name))
+    out.append("        CHECK(request.kHasData == %s);" % ("true" if fields else "false"))
+    defaults = [(f["valueName"], default_json(f)) for f in fields if default_json(f) is not None]
+    out.append("        CHECK_EQ(written(request), %s);" % c_string(json_object(defaults)))
+    if fields:
+        assigned = []
+        for index, field in enumerate(fields):
+            expression, text = sample(field, index)
+            out.append("        request.%s = %s;" % (field["valueName"], expression))
+            assigned.append((field["valueName"], text))
+        out.append("        CHECK_EQ(written(request), %s);" % c_string(json_object(assigned)))
+        out.append("        CHECK(request.valid());")
+        out.append("        CHECK_EQ(sent(request), written(request));")
+        raw_fields = [(index, field) for index, field in enumerate(fields) if field_kind(field) == "raw"]
+        for position, (index, field) in enumerate(raw_fields):
+            # Malformed JSON text is refused rather than sent for OBS to close the session on.
+            out.append("        request.%s = %s;" % (field["valueName"], c_string('{"%s":' % field["valueName"])))
+            out.append("        CHECK(!request.valid());")
+            out.append('        CHECK_EQ(sent(request), "<not sent>");')
+            if position + 1 < len(raw_fields):
+                out.append("        request.%s = %s;" % (field["valueName"], sample(field, index)[0]))
+    else:
+        out.append('        CHECK_EQ(sent(request), "<none>");')
+
+    if responses:
+        # Members arrive in any order, with unknown ones in between.
+        members = [("unknownMember", '[1,{"a":"}"}]')]
+        for index, field in reversed(list(enumerate(responses))):
+            members.append((field["valueName"], sample(field, index)[1]))
+        out.append("")
+        out.append("        const std::string data = %s;" % c_string(json_object(members)))
+        out.append("        ObsRequests::%s::Response response;" % name)
+        out.append("        CHECK(response.parse(data.c_str(), data.size()));")
+        for index, field in enumerate(responses):
+            kind = field_kind(field)
+            member = "response." + field["valueName"]
+            expression, text = sample(field, index)
+            if kind == "string":
+                out.append("        CHECK_EQ(text(%s), %s);" % (member, c_string(text[1:-1])))
+            elif kind == "raw":
+                out.append("        CHECK_EQ(text(%s), %s);" % (member, c_string(text)))
+            else:
+                out.append("        CHECK(%s == %s);" % (member, expression))
+
+        mismatched = [(f["valueName"], MISMATCHED[field_kind(f)]) for f in responses if field_kind(f) != "raw"]
+        if mismatched:
+            out.append("")
+            out.append("        const std::string mismatched = %s;" % c_string(json_object(mismatched)))
+            out.append("        ObsRequests::%s::Response skipped;" % name)
+            out.append("        CHECK(skipped.parse(mismatched.c_str(), mismatched.size()));")
+            for field in responses:
+                kind = field_kind(field)
+                member = "skipped." + field["valueName"]
+                if kind == "string":
+                    out.append("        CHECK(%s.empty());" % member)
+                elif kind != "raw":
+                    out.append("        CHECK(%s == %s);" % (member, {"bool": "false", "int": "0", "double": "0"}[kind]))
+        out.append("        CHECK(!response.parse(\"[]\", 2));")
+    out.append("    }")
+    out.append("")
+    return function
+
+
+TEST_PREAMBLE = """// Generated by tools/generate_requests.py from %s. Do not edit by hand.
+// Every typed request in ObsWsRequests.h: the requestData its builder writes with no field and
+// with every field assigned and sent through client.send(), and its response view reading each
+// field back, skipping members of the wrong type and rejecting data that is not an object.
+
+#include "HostTest.h"
+#include "ObsWsRequests.h"
+
+namespace
+{
+    template <typename Request>
+    std::string written(const Request &request)
+    {
+        char buffer[4096];
+        ObsJsonWriter json(buffer, sizeof(buffer));
+        json.beginObject();
+        request.write(json);
+        json.endObject();
+        return json.overflowed() ? std::string("<overflow>") : std::string(json.data(), json.length());
+    }
+
+    std::string text(const ObsJsonSlice &slice)
+    {
+        return slice.data != nullptr ? std::string(slice.data, slice.length) : std::string();
+    }
+
+    ObsWsClient client;
+
+    // The requestData member of the op 6 frame client.send() writes for `request`.
+    template <typename Request>
+    std::string sent(const Request &request)
+    {
+        const size_t start = hostConnection.written().size();
+        if (client.send(request) == 0)
+        {
+            return "<not sent>";
+        }
+        const std::vector<ClientFrame> frames = clientFrames(start);
+        ObsJsonSlice d;
+        ObsJsonSlice data;
+        if (frames.size() != 1 || !ObsJsonReader::findMember(ObsJsonSlice{frames[0].payload.data(), frames[0].payload.size()}, "d", d))
+        {
+            return "<no frame>";
+        }
+        return ObsJsonReader::findMember(d, "requestData", data) ? text(data) : std::string("<none>");
+    }
+
+"""
+
+
+PREAMBLE = """// Generated by tools/generate_requests.py from %s. Do not edit by hand.
+#pragma once
+
+#include <cstring>
+#include "ObsWsJson.h"
+
+// A request field that is only sent when assigned.
+template <typename T>
+struct ObsOptional
+{
+    bool set = false;
+    T value{};
+
+    ObsOptional &operator=(T next)
+    {
+        set = true;
+        value = next;
+        return *this;
+    }
+};
+
+// Typed builders for ObsWsClient::send(). String fields left as nullptr are omitted, so OBS
+// reports a missing required field instead of receiving an empty one. Response views parse
+// the responseData of an ObsRequestResult; their string slices point into that buffer and
+// keep JSON escapes as sent.
+namespace ObsRequests
+{
+    namespace detail
+    {
+        inline void readField(ObsJsonReader &reader, ObsJsonSlice &value)
+        {
+            if (!reader.readString(value))
+            {
+                reader.skipValue();
+            }
+        }
+
+        inline void readField(ObsJsonReader &reader, bool &value)
+        {
+            if (!reader.readBool(value))
+            {
+                reader.skipValue();
+            }
+        }
+
+        inline void readField(ObsJsonReader &reader, int64_t &value)
+        {
+            if (!reader.readInteger(value))
+            {
+                reader.skipValue();
+            }
+        }
+
+        inline void readField(ObsJsonReader &reader, double &value)
+        {
+            if (!reader.readNumber(value))
+            {
+                reader.skipValue();
+            }
+        }
+
+        inline void readRaw(ObsJsonReader &reader, ObsJsonSlice &value)
+        {
+            reader.skipValue(&value);
+        }
+    }
+
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--protocol", default=os.path.join(ROOT, "tools", "protocol-requests.json"))
+    parser.add_argument("--output", default=os.path.join(ROOT, "src", "ObsWsRequests.h"))
+    parser.add_argument("--tests", default=os.path.join(ROOT, "tests", "host", "test_requests.cpp"))
+    args = parser.parse_args()
+
+    with open(args.protocol, encoding="utf-8") as source:
+        protocol = json.load(source)
+
+    source_name = os.path.relpath(args.protocol, ROOT).replace(os.sep, "/")
+    out = (PREAMBLE % source_name).rstrip("\n").split("\n") + [""]
+    count = 0
+    for request in sorted(protocol["requests"], key=lambda r: r["requestType"]):
+        if emit_request(request, out):
+            count += 1
+    if out[-1] == "":
+        out.pop()
+    out.append("}")
+
+    with open(args.output, "w", encoding="utf-8", newline="\n") as target:
+        target.write("\n".join(out) + "\n")
+    print("wrote %d requests to %s" % (count, args.output))
+
+    tests = (TEST_PREAMBLE % source_name).rstrip("\n").split("\n") + [""]
+    functions = []
+    for request in sorted(protocol["requests"], key=lambda r: r["requestType"]):
+        function = emit_request_test(request, tests)
+        if function is not None:
+            functions.append(function)
+    if tests[-1] == "":
+        tests.pop()
+    tests.append("}")
+    tests.append("")
+    tests.append("int main()")
+    tests.append("{")
+    tests.append("    ObsWsClient::Config config;")
+    tests.append("    CHECK(connectClient(client, config) > 0);")
+    for function in functions:
+        tests.append("    %s();" % function)
+    tests.append("    client.close();")
+    tests.append('    return hostTestResult("requests");')
+    tests.append("}")
+
+    with open(args.tests, "w", encoding="utf-8", newline="\n") as target:
+        target.write("\n".join(tests) + "\n")
+    print("wrote %d request tests to %s" % (len(functions), args.tests))
+
+
+if __name__ == "__main__":
+    main()